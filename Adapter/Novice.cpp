@@ -1,15 +1,21 @@
 #include "Novice.h"
+#include "ActionMap.h"
+#include "Audio.h"
 #include "DebugText.h"
 #include "GameScene.h"
 #include "ImGuiManager.h"
+#include "Input.h"
+#include "InputEvents.h"
 #include "Matrix4x4.h"
 #include "TextureManager.h"
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
 #include "WinApp.h"
+#include "XInputGamepad.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <iterator>
 #include <span>
@@ -304,6 +310,15 @@ private:
 	    int srcW, int srcH, int textureHandle, unsigned int color);
 	int CheckHitKey(int keyCode);
 	void GetHitKeyStateAll(char* keyStateBuf);
+	bool IsTriggerKey(int keyCode);
+	bool IsReleaseKey(int keyCode);
+	int AddAction(const char* name);
+	bool BindAction(int action, const InputBinding& binding);
+	bool RebindActionToTriggeredInput(int action, int slot);
+	void ClearActionBindings(int action);
+	bool IsPressAction(int action);
+	bool IsTriggerAction(int action);
+	bool IsReleaseAction(int action);
 	bool IsPressMouse(int buttonNumber);
 	bool IsTriggerMouse(int buttonNumber);
 	const Vector2& GetMousePosition();
@@ -334,6 +349,12 @@ private:
 	HWND GetWindowHandle();
 	// 入力
 	Input* input_ = nullptr;
+	// フレームごとのキー・マウスの状態（ウィンドウのメッセージから作った入力イベントで進める）
+	InputEventState inputState_;
+	// フレームごとのパッド0の状態
+	GamepadState gamepad_;
+	// アクションへの入力の割り当て
+	ActionMap actionMap_;
 	// デバッグテキスト
 	DebugText* debugText_ = nullptr;
 	// オーディオ
@@ -1069,6 +1090,55 @@ void NoviceSystem::GetHitKeyStateAll(char* keyStateBuf) {
 	memcpy(keyStateBuf, keys.data(), size(keys));
 }
 
+bool NoviceSystem::IsTriggerKey(int keyCode) {
+	return keyCode >= 0 && keyCode < int(InputEventState::kKeyCount) &&
+	       inputState_.TriggerKey(uint8_t(keyCode));
+}
+
+bool NoviceSystem::IsReleaseKey(int keyCode) {
+	return keyCode >= 0 && keyCode < int(InputEventState::kKeyCount) &&
+	       inputState_.ReleaseKey(uint8_t(keyCode));
+}
+
+int NoviceSystem::AddAction(const char* name) { return actionMap_.AddAction(name); }
+
+bool NoviceSystem::BindAction(int action, const InputBinding& binding) {
+	if (action < 0 || uint32_t(action) >= actionMap_.GetActionCount()) {
+		return false;
+	}
+	return actionMap_.Bind(uint32_t(action), binding);
+}
+
+bool NoviceSystem::RebindActionToTriggeredInput(int action, int slot) {
+	InputBinding binding;
+	if (action < 0 || uint32_t(action) >= actionMap_.GetActionCount() || slot < 0 ||
+	    !actionMap_.FindTriggeredInput(inputState_, binding)) {
+		return false;
+	}
+	return actionMap_.Rebind(uint32_t(action), uint32_t(slot), binding);
+}
+
+void NoviceSystem::ClearActionBindings(int action) {
+	if (action >= 0 && uint32_t(action) < actionMap_.GetActionCount()) {
+		actionMap_.ClearBindings(uint32_t(action));
+	}
+}
+
+bool NoviceSystem::IsPressAction(int action) {
+	return action >= 0 && uint32_t(action) < actionMap_.GetActionCount() &&
+	       actionMap_.IsPressed(uint32_t(action));
+}
+
+bool NoviceSystem::IsTriggerAction(int action) {
+	return action >= 0 && uint32_t(action) < actionMap_.GetActionCount() &&
+	       actionMap_.IsTriggered(uint32_t(action));
+}
+
+bool NoviceSystem::IsReleaseAction(int action) {
+	return action >= 0 && uint32_t(action) < actionMap_.GetActionCount() &&
+	       actionMap_.IsReleased(uint32_t(action));
+}
+
 bool NoviceSystem::IsPressMouse(int buttonNumber) { return input_->IsPressMouse(buttonNumber); }
 
 bool NoviceSystem::IsTriggerMouse(int buttonNumber) { return input_->IsTriggerMouse(buttonNumber); }
@@ -1146,6 +1216,15 @@ int NoviceSystem::ProcessMessage() { return winApp_->ProcessMessage() ? 1 : 0; }
 void NoviceSystem::BeginFrame() {
 	imGuiManager_->Begin();
 	input_->Update(); // DirectX描画前処理
+
+	// 今までに起きた入力イベントでキーを進め、キーとパッド0からアクションの状態を作る
+	inputState_.Advance(winApp_->GetInputEvents(), InputClock::now());
+	XINPUT_STATE xInput{};
+	gamepad_ = GamepadState();
+	if (input_->GetJoystickState(0, xInput)) {
+		gamepad_ = ToGamepadState(xInput.Gamepad);
+	}
+	actionMap_.Update(inputState_, gamepad_);
 	dxCommon_->PreDraw();
 	SetBlendMode(kBlendModeNormal);
 }
@@ -1256,7 +1335,7 @@ void Novice::Initialize(const char* title, int width, int height) {
 
 	// ゲームシーンの初期化
 	sGameScene = new GameScene();
-	sGameScene->Initialize();
+	sGameScene->Initialize(&sNoviceSystem->inputState_, &sNoviceSystem->gamepad_);
 }
 
 void Novice::Finalize() {
@@ -1414,6 +1493,10 @@ void Novice::GetHitKeyStateAll(char* keyStateBuf) {
 	sNoviceSystem->GetHitKeyStateAll(keyStateBuf);
 }
 
+int Novice::IsTriggerKey(int keyCode) { return sNoviceSystem->IsTriggerKey(keyCode) ? 1 : 0; }
+
+int Novice::IsReleaseKey(int keyCode) { return sNoviceSystem->IsReleaseKey(keyCode) ? 1 : 0; }
+
 int Novice::IsPressMouse(int buttonNumber) {
 	return sNoviceSystem->IsPressMouse(buttonNumber) ? 1 : 0;
 }
@@ -1569,6 +1652,85 @@ void Novice::SetJoystickDeadZone(int stickNo, int deadZoneL, int deadZoneR) {
 	sNoviceSystem->SetJoystickDeadZone(stickNo, deadZoneL, deadZoneR);
 }
 
+int Novice::AddAction(const char* name) {
+	assert(name);
+	return sNoviceSystem->AddAction(name);
+}
+
+int Novice::BindKey(int action, int keyCode) {
+	if (keyCode < 0 || keyCode >= int(InputEventState::kKeyCount)) {
+		return 0;
+	}
+	return sNoviceSystem->BindAction(action, InputBinding::Key(uint8_t(keyCode))) ? 1 : 0;
+}
+
+int Novice::BindMouse(int action, int buttonNumber) {
+	if (buttonNumber < 0 || buttonNumber >= int(InputEventState::kMouseButtonCount)) {
+		return 0;
+	}
+	return sNoviceSystem->BindAction(action, InputBinding::Mouse(uint8_t(buttonNumber))) ? 1 : 0;
+}
+
+int Novice::BindPadButton(int action, PadButton button) {
+	// IsPressButton の XInput と同じ対応（L2/R2 はトリガーも見る）
+	bool bound = false;
+	if (button == kPadButton10) {
+		bound |=
+		    sNoviceSystem->BindAction(action, InputBinding::Axis(GamepadAxis::LeftTrigger, 1));
+	}
+	if (button == kPadButton11) {
+		bound |=
+		    sNoviceSystem->BindAction(action, InputBinding::Axis(GamepadAxis::RightTrigger, 1));
+	}
+	if (button < _countof(kXInputButtons)) {
+		GamepadButton bit = static_cast<GamepadButton>(std::countr_zero(kXInputButtons[button]));
+		bound |= sNoviceSystem->BindAction(action, InputBinding::Pad(bit));
+	}
+	return bound ? 1 : 0;
+}
+
+int Novice::BindAnalogInputLeft(int action, int directionX, int directionY) {
+	bool bound = false;
+	if (directionX != 0) {
+		bound |= sNoviceSystem->BindAction(
+		    action, InputBinding::Axis(GamepadAxis::LeftX, directionX > 0 ? 1 : -1));
+	}
+	if (directionY != 0) {
+		bound |= sNoviceSystem->BindAction(
+		    action, InputBinding::Axis(GamepadAxis::LeftY, directionY > 0 ? 1 : -1));
+	}
+	return bound ? 1 : 0;
+}
+
+int Novice::BindAnalogInputRight(int action, int directionX, int directionY) {
+	bool bound = false;
+	if (directionX != 0) {
+		bound |= sNoviceSystem->BindAction(
+		    action, InputBinding::Axis(GamepadAxis::RightX, directionX > 0 ? 1 : -1));
+	}
+	if (directionY != 0) {
+		bound |= sNoviceSystem->BindAction(
+		    action, InputBinding::Axis(GamepadAxis::RightY, directionY > 0 ? 1 : -1));
+	}
+	return bound ? 1 : 0;
+}
+
+int Novice::RebindActionToTriggeredInput(int action, int slot) {
+	return sNoviceSystem->RebindActionToTriggeredInput(action, slot) ? 1 : 0;
+}
+
+void Novice::ClearActionBindings(int action) { sNoviceSystem->ClearActionBindings(action); }
+
+int Novice::IsPressAction(int action) { return sNoviceSystem->IsPressAction(action) ? 1 : 0; }
+
+int Novice::IsTriggerAction(int action) {
+	return sNoviceSystem->IsTriggerAction(action) ? 1 : 0;
+}
+
+int Novice::IsReleaseAction(int action) {
+	return sNoviceSystem->IsReleaseAction(action) ? 1 : 0;
+}
+
 void Novice::ScreenPrintf(int x, int y, const char* format, ...) {
 
 	// 可変長引数をオブジェクトにまとめる
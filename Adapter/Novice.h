@@ -256,6 +256,20 @@ public:
 	/// <returns></returns>
 	static void GetHitKeyStateAll(char* keyStateBuf);
 
+	/// <summary>
+	/// 特定キーがこのフレームで押されたかを得る（フレームの間に押して離していても1）
+	/// </summary>
+	/// <param name="keyCode">入力状態を取得するキーコード( DIK_0 等)</param>
+	/// <returns>1: 押された 0: 押されていない</returns>
+	static int IsTriggerKey(int keyCode);
+
+	/// <summary>
+	/// 特定キーがこのフレームで離されたかを得る
+	/// </summary>
+	/// <param name="keyCode">入力状態を取得するキーコード( DIK_0 等)</param>
+	/// <returns>1: 離された 0: 離されていない</returns>
+	static int IsReleaseKey(int keyCode);
+
 	/// <summary>
 	/// 特定マウスボタンが押されているかを得る
 	/// </summary>
@@ -369,6 +383,91 @@ public:
 	/// <returns>正しく取得できたか</returns>
 	static void SetJoystickDeadZone(int stickNo, int deadZoneL, int deadZoneR);
 
+	/// <summary>
+	/// アクション（キー・マウス・ゲームパッドをまとめた名前付きの操作）を追加する。
+	/// 同じ名前があればそれを返す。ゲームパッドは0番のXInputのものだけ見る
+	/// </summary>
+	/// <param name="name">アクション名</param>
+	/// <returns>アクション番号。追加できなければ-1</returns>
+	static int AddAction(const char* name);
+
+	/// <summary>
+	/// アクションにキーを割り当てる
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="keyCode">キーコード( DIK_0 等)</param>
+	/// <returns>1: 割り当てた 0: 割り当てられなかった</returns>
+	static int BindKey(int action, int keyCode);
+
+	/// <summary>
+	/// アクションにマウスボタンを割り当てる
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="buttonNumber">マウスボタン番号(0:左,1:右,2:中,3~7:拡張マウスボタン)</param>
+	/// <returns>1: 割り当てた 0: 割り当てられなかった</returns>
+	static int BindMouse(int action, int buttonNumber);
+
+	/// <summary>
+	/// アクションにゲームパッドのボタンを割り当てる
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="button">ジョイスティックのボタン番号</param>
+	/// <returns>1: 割り当てた 0: 割り当てられなかった</returns>
+	static int BindPadButton(int action, PadButton button);
+
+	/// <summary>
+	/// アクションに左アナログスティックを倒す向きを割り当てる（半分以上倒したら押したことにする）
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="directionX">左右の向き 1:右 -1:左 0:割り当てない</param>
+	/// <param name="directionY">上下の向き 1:上 -1:下 0:割り当てない</param>
+	/// <returns>1: 割り当てた 0: 割り当てられなかった</returns>
+	static int BindAnalogInputLeft(int action, int directionX, int directionY);
+
+	/// <summary>
+	/// アクションに右アナログスティックを倒す向きを割り当てる（半分以上倒したら押したことにする）
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="directionX">左右の向き 1:右 -1:左 0:割り当てない</param>
+	/// <param name="directionY">上下の向き 1:上 -1:下 0:割り当てない</param>
+	/// <returns>1: 割り当てた 0: 割り当てられなかった</returns>
+	static int BindAnalogInputRight(int action, int directionX, int directionY);
+
+	/// <summary>
+	/// このフレームで押された入力を、アクションのslot番目の割り当てと差し替える（キーコンフィグ用）
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <param name="slot">何番目の割り当てか（今の数と同じなら追加）</param>
+	/// <returns>1: 差し替えた 0: 何も押されていないか、差し替えられなかった</returns>
+	static int RebindActionToTriggeredInput(int action, int slot);
+
+	/// <summary>
+	/// アクションの割り当てを全て解除する
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	static void ClearActionBindings(int action);
+
+	/// <summary>
+	/// アクションが押されているかを得る
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <returns>1: 押されている 0: 押されていない</returns>
+	static int IsPressAction(int action);
+
+	/// <summary>
+	/// アクションがトリガーされたかを得る
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <returns>1: トリガーされた 0: トリガーされていない</returns>
+	static int IsTriggerAction(int action);
+
+	/// <summary>
+	/// アクションが離されたかを得る
+	/// </summary>
+	/// <param name="action">アクション番号</param>
+	/// <returns>1: 離された 0: 離されていない</returns>
+	static int IsReleaseAction(int action);
+
 	/// <summary>
 	/// スクリーンにデバッグ用文字列を表示する
 	/// </summary>
@@ -0,0 +1,561 @@
+#include "BVH.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+Vector3 Add(const Vector3& a, const Vector3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+Vector3 Sub(const Vector3& a, const Vector3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+Vector3 Scale(const Vector3& a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Vector3 Cross(const Vector3& a, const Vector3& b) {
+	return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+Vector3 Min(const Vector3& a, const Vector3& b) {
+	return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+}
+Vector3 Max(const Vector3& a, const Vector3& b) {
+	return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+}
+float Component(const Vector3& v, uint32_t axis) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; }
+
+// 空のボックス
+AABB EmptyBox() { return {{1.0e30f, 1.0e30f, 1.0e30f}, {-1.0e30f, -1.0e30f, -1.0e30f}}; }
+
+// ボックスの拡張
+void Grow(AABB& box, const AABB& other) {
+	box.min = Min(box.min, other.min);
+	box.max = Max(box.max, other.max);
+}
+
+void Grow(AABB& box, const Vector3& point) {
+	box.min = Min(box.min, point);
+	box.max = Max(box.max, point);
+}
+
+// 表面積
+float SurfaceArea(const AABB& box) {
+	Vector3 d = Sub(box.max, box.min);
+	if (d.x < 0 || d.y < 0 || d.z < 0) {
+		return 0.0f;
+	}
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// レイとボックスのスラブ判定
+bool IntersectBox(const AABB& box, const Vector3& origin, const Vector3& invDir, float tMax) {
+	float tx0 = (box.min.x - origin.x) * invDir.x;
+	float tx1 = (box.max.x - origin.x) * invDir.x;
+	float tNear = std::min(tx0, tx1);
+	float tFar = std::max(tx0, tx1);
+	float ty0 = (box.min.y - origin.y) * invDir.y;
+	float ty1 = (box.max.y - origin.y) * invDir.y;
+	tNear = std::max(tNear, std::min(ty0, ty1));
+	tFar = std::min(tFar, std::max(ty0, ty1));
+	float tz0 = (box.min.z - origin.z) * invDir.z;
+	float tz1 = (box.max.z - origin.z) * invDir.z;
+	tNear = std::max(tNear, std::min(tz0, tz1));
+	tFar = std::min(tFar, std::max(tz0, tz1));
+	return tNear <= tFar && tFar >= 0.0f && tNear <= tMax;
+}
+
+// 点とボックスの距離の2乗
+float SqDistance(const AABB& box, const Vector3& p) {
+	Vector3 c = Min(Max(p, box.min), box.max);
+	Vector3 d = Sub(p, c);
+	return Dot(d, d);
+}
+
+// 三角形上の最近点
+Vector3 ClosestPointOnTriangle(
+    const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c) {
+	Vector3 ab = Sub(b, a);
+	Vector3 ac = Sub(c, a);
+	Vector3 ap = Sub(p, a);
+	float d1 = Dot(ab, ap);
+	float d2 = Dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f) {
+		return a;
+	}
+	Vector3 bp = Sub(p, b);
+	float d3 = Dot(ab, bp);
+	float d4 = Dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3) {
+		return b;
+	}
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		return Add(a, Scale(ab, d1 / (d1 - d3)));
+	}
+	Vector3 cp = Sub(p, c);
+	float d5 = Dot(ab, cp);
+	float d6 = Dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6) {
+		return c;
+	}
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		return Add(a, Scale(ac, d2 / (d2 - d6)));
+	}
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+		return Add(b, Scale(Sub(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+	}
+	float denom = 1.0f / (va + vb + vc);
+	return Add(a, Add(Scale(ab, vb * denom), Scale(ac, vc * denom)));
+}
+
+// 視錐台とボックスの判定 (0:外 1:交差 2:内)
+int Classify(const BVH::Frustum& frustum, const AABB& box) {
+	int result = 2;
+	for (const BVH::Plane& plane : frustum.planes) {
+		// 法線方向に最も遠い頂点 (p) と最も近い頂点 (n)
+		Vector3 p = {
+		    plane.normal.x >= 0 ? box.max.x : box.min.x,
+		    plane.normal.y >= 0 ? box.max.y : box.min.y,
+		    plane.normal.z >= 0 ? box.max.z : box.min.z};
+		if (Dot(plane.normal, p) + plane.distance < 0) {
+			return 0;
+		}
+		Vector3 n = {
+		    plane.normal.x >= 0 ? box.min.x : box.max.x,
+		    plane.normal.y >= 0 ? box.min.y : box.max.y,
+		    plane.normal.z >= 0 ? box.min.z : box.max.z};
+		if (Dot(plane.normal, n) + plane.distance < 0) {
+			result = 1;
+		}
+	}
+	return result;
+}
+
+// 再構築するまでに溜める追加待ちプリミティブの最小数
+const uint32_t kMinPendingForRebuild = 64;
+// トラバーサルのスタック深さ
+const uint32_t kStackSize = 64;
+
+} // namespace
+
+struct BVH::BuildNode {
+	AABB bounds;
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	uint16_t axis = 0;
+	std::unique_ptr<BuildNode> left;
+	std::unique_ptr<BuildNode> right;
+};
+
+uint32_t BVH::AddTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+	Primitive primitive;
+	primitive.bounds = EmptyBox();
+	Grow(primitive.bounds, v0);
+	Grow(primitive.bounds, v1);
+	Grow(primitive.bounds, v2);
+	primitive.v0 = v0;
+	primitive.v1 = v1;
+	primitive.v2 = v2;
+	primitive.isTriangle = true;
+	primitives_.push_back(primitive);
+	return static_cast<uint32_t>(primitives_.size() - 1);
+}
+
+uint32_t BVH::AddBox(const AABB& box) {
+	Primitive primitive{};
+	primitive.bounds = box;
+	primitive.isTriangle = false;
+	primitives_.push_back(primitive);
+	return static_cast<uint32_t>(primitives_.size() - 1);
+}
+
+void BVH::Build() {
+	builtCount_ = static_cast<uint32_t>(primitives_.size());
+	nodes_.clear();
+	primitiveIndices_.resize(builtCount_);
+	centroids_.resize(builtCount_);
+	for (uint32_t i = 0; i < builtCount_; i++) {
+		primitiveIndices_[i] = i;
+		centroids_[i] = Scale(Add(primitives_[i].bounds.min, primitives_[i].bounds.max), 0.5f);
+	}
+	if (builtCount_ == 0) {
+		return;
+	}
+
+	std::unique_ptr<BuildNode> root = BuildRecursive(0, builtCount_);
+	// ノード数は高々 2n-1
+	nodes_.reserve(size_t(builtCount_) * 2);
+	Flatten(*root);
+}
+
+void BVH::Update() {
+	uint32_t pending = static_cast<uint32_t>(primitives_.size()) - builtCount_;
+	if (pending == 0) {
+		return;
+	}
+	// 木の1/4を超えて追加されたら作り直す。それまでは追加分を総当たりで判定する
+	if (nodes_.empty() || pending >= std::max(kMinPendingForRebuild, builtCount_ / 4)) {
+		Build();
+	}
+}
+
+void BVH::Clear() {
+	primitives_.clear();
+	primitiveIndices_.clear();
+	centroids_.clear();
+	nodes_.clear();
+	builtCount_ = 0;
+}
+
+std::unique_ptr<BVH::BuildNode> BVH::BuildRecursive(uint32_t begin, uint32_t end) {
+	std::unique_ptr<BuildNode> node = std::make_unique<BuildNode>();
+	node->begin = begin;
+	node->end = end;
+
+	// 境界と重心の範囲を求める
+	AABB bounds = EmptyBox();
+	AABB centroidBounds = EmptyBox();
+	for (uint32_t i = begin; i < end; i++) {
+		uint32_t id = primitiveIndices_[i];
+		Grow(bounds, primitives_[id].bounds);
+		Grow(centroidBounds, centroids_[id]);
+	}
+	node->bounds = bounds;
+
+	uint32_t count = end - begin;
+	if (count <= kMaxLeafSize) {
+		return node;
+	}
+
+	// ビン分割によるSAHで最良の分割を探す
+	float bestCost = 1.0e30f;
+	uint32_t bestAxis = 0;
+	uint32_t bestSplit = 0;
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		float lo = Component(centroidBounds.min, axis);
+		float extent = Component(centroidBounds.max, axis) - lo;
+		if (extent <= 0.0f) {
+			continue;
+		}
+		float scale = kBinCount / extent;
+
+		AABB binBounds[kBinCount];
+		uint32_t binCounts[kBinCount] = {};
+		for (AABB& b : binBounds) {
+			b = EmptyBox();
+		}
+		for (uint32_t i = begin; i < end; i++) {
+			uint32_t id = primitiveIndices_[i];
+			uint32_t bin = std::min(
+			    kBinCount - 1,
+			    static_cast<uint32_t>((Component(centroids_[id], axis) - lo) * scale));
+			binCounts[bin]++;
+			Grow(binBounds[bin], primitives_[id].bounds);
+		}
+
+		// 右側からの累積
+		float rightArea[kBinCount] = {};
+		uint32_t rightCount[kBinCount] = {};
+		AABB accum = EmptyBox();
+		uint32_t accumCount = 0;
+		for (uint32_t b = kBinCount - 1; b > 0; b--) {
+			Grow(accum, binBounds[b]);
+			accumCount += binCounts[b];
+			rightArea[b] = SurfaceArea(accum);
+			rightCount[b] = accumCount;
+		}
+
+		// 左側からの累積と評価
+		accum = EmptyBox();
+		accumCount = 0;
+		for (uint32_t b = 0; b + 1 < kBinCount; b++) {
+			Grow(accum, binBounds[b]);
+			accumCount += binCounts[b];
+			if (accumCount == 0 || rightCount[b + 1] == 0) {
+				continue;
+			}
+			float cost = SurfaceArea(accum) * accumCount + rightArea[b + 1] * rightCount[b + 1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = b + 1;
+			}
+		}
+	}
+
+	uint32_t mid = begin;
+	if (bestSplit != 0) {
+		float lo = Component(centroidBounds.min, bestAxis);
+		float scale = kBinCount / (Component(centroidBounds.max, bestAxis) - lo);
+		uint32_t* it = std::partition(
+		    primitiveIndices_.data() + begin, primitiveIndices_.data() + end, [&](uint32_t id) {
+			    uint32_t bin = std::min(
+			        kBinCount - 1,
+			        static_cast<uint32_t>((Component(centroids_[id], bestAxis) - lo) * scale));
+			    return bin < bestSplit;
+		    });
+		mid = static_cast<uint32_t>(it - primitiveIndices_.data());
+	}
+	if (mid == begin || mid == end) {
+		// 重心が全て重なっている場合は個数で半分に分ける
+		mid = begin + count / 2;
+	}
+	node->axis = static_cast<uint16_t>(bestAxis);
+
+	// 大きな部分木はジョブで構築（範囲が重ならないので同期は不要）
+	if (count >= kParallelThreshold) {
+		JobSystem* jobSystem = JobSystem::GetInstance();
+		std::unique_ptr<BuildNode> left;
+		JobSystem::Job* job = jobSystem->CreateJob(
+		    [this, begin, mid, &left] { left = BuildRecursive(begin, mid); });
+		jobSystem->Run(job);
+		node->right = BuildRecursive(mid, end);
+		jobSystem->Wait(job);
+		node->left = std::move(left);
+	} else {
+		node->left = BuildRecursive(begin, mid);
+		node->right = BuildRecursive(mid, end);
+	}
+	return node;
+}
+
+void BVH::Flatten(const BuildNode& node) {
+	uint32_t index = static_cast<uint32_t>(nodes_.size());
+	nodes_.push_back({node.bounds, 0, 0, node.axis});
+	if (!node.left) {
+		nodes_[index].offset = node.begin;
+		nodes_[index].count = static_cast<uint16_t>(node.end - node.begin);
+		return;
+	}
+	Flatten(*node.left);
+	nodes_[index].offset = static_cast<uint32_t>(nodes_.size());
+	Flatten(*node.right);
+}
+
+bool BVH::IntersectPrimitive(uint32_t primitiveId, const Ray& ray, float& t) const {
+	const Primitive& primitive = primitives_[primitiveId];
+	if (!primitive.isTriangle) {
+		// ボックスは入射点
+		Vector3 invDir = {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+		if (!IntersectBox(primitive.bounds, ray.origin, invDir, ray.tMax)) {
+			return false;
+		}
+		float tNear = 0.0f;
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			float o = Component(ray.origin, axis);
+			float inv = Component(invDir, axis);
+			float t0 = (Component(primitive.bounds.min, axis) - o) * inv;
+			float t1 = (Component(primitive.bounds.max, axis) - o) * inv;
+			tNear = std::max(tNear, std::min(t0, t1));
+		}
+		t = tNear;
+		return true;
+	}
+
+	// Moller-Trumbore
+	const float kEpsilon = 1.0e-8f;
+	Vector3 e1 = Sub(primitive.v1, primitive.v0);
+	Vector3 e2 = Sub(primitive.v2, primitive.v0);
+	Vector3 p = Cross(ray.direction, e2);
+	float det = Dot(e1, p);
+	if (std::fabs(det) < kEpsilon) {
+		return false;
+	}
+	float invDet = 1.0f / det;
+	Vector3 s = Sub(ray.origin, primitive.v0);
+	float u = Dot(s, p) * invDet;
+	if (u < 0.0f || u > 1.0f) {
+		return false;
+	}
+	Vector3 q = Cross(s, e1);
+	float v = Dot(ray.direction, q) * invDet;
+	if (v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+	float hitT = Dot(e2, q) * invDet;
+	if (hitT < 0.0f || hitT > ray.tMax) {
+		return false;
+	}
+	t = hitT;
+	return true;
+}
+
+bool BVH::RayCast(const Ray& ray, RayHit& hit) const {
+	Ray current = ray;
+	hit.primitiveId = kInvalidId;
+
+	if (!nodes_.empty()) {
+		Vector3 invDir = {
+		    1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+		bool dirNegative[3] = {invDir.x < 0, invDir.y < 0, invDir.z < 0};
+
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+		uint32_t index = 0;
+		while (true) {
+			const Node& node = nodes_[index];
+			if (IntersectBox(node.bounds, current.origin, invDir, current.tMax)) {
+				if (node.count > 0) {
+					for (uint32_t i = 0; i < node.count; i++) {
+						uint32_t id = primitiveIndices_[node.offset + i];
+						float t;
+						if (IntersectPrimitive(id, current, t) && t <= current.tMax) {
+							current.tMax = t;
+							hit.primitiveId = id;
+							hit.t = t;
+						}
+					}
+				} else {
+					// 近い側の子を先に辿る
+					assert(stackSize < kStackSize);
+					if (dirNegative[node.axis]) {
+						stack[stackSize++] = index + 1;
+						index = node.offset;
+					} else {
+						stack[stackSize++] = node.offset;
+						index = index + 1;
+					}
+					continue;
+				}
+			}
+			if (stackSize == 0) {
+				break;
+			}
+			index = stack[--stackSize];
+		}
+	}
+
+	// 追加待ちのプリミティブ
+	for (uint32_t id = builtCount_; id < primitives_.size(); id++) {
+		float t;
+		if (IntersectPrimitive(id, current, t) && t <= current.tMax) {
+			current.tMax = t;
+			hit.primitiveId = id;
+			hit.t = t;
+		}
+	}
+	return hit.primitiveId != kInvalidId;
+}
+
+void BVH::OverlapSphere(
+    const Vector3& center, float radius, std::vector<uint32_t>& result) const {
+	float sqRadius = radius * radius;
+	auto test = [&](uint32_t id) {
+		const Primitive& primitive = primitives_[id];
+		if (SqDistance(primitive.bounds, center) > sqRadius) {
+			return false;
+		}
+		if (!primitive.isTriangle) {
+			return true;
+		}
+		Vector3 closest = ClosestPointOnTriangle(center, primitive.v0, primitive.v1, primitive.v2);
+		Vector3 d = Sub(closest, center);
+		return Dot(d, d) <= sqRadius;
+	};
+
+	if (!nodes_.empty()) {
+		uint32_t stack[kStackSize];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0) {
+			uint32_t index = stack[--stackSize];
+			const Node& node = nodes_[index];
+			if (SqDistance(node.bounds, center) > sqRadius) {
+				continue;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = 0; i < node.count; i++) {
+					uint32_t id = primitiveIndices_[node.offset + i];
+					if (test(id)) {
+						result.push_back(id);
+					}
+				}
+			} else {
+				assert(stackSize + 2 <= kStackSize);
+				stack[stackSize++] = node.offset;
+				stack[stackSize++] = index + 1;
+			}
+		}
+	}
+
+	for (uint32_t id = builtCount_; id < primitives_.size(); id++) {
+		if (test(id)) {
+			result.push_back(id);
+		}
+	}
+}
+
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const {
+	if (!nodes_.empty()) {
+		// 完全に内側の部分木は判定を省略する
+		struct Entry {
+			uint32_t index;
+			bool inside;
+		};
+		Entry stack[kStackSize];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = {0, false};
+		while (stackSize > 0) {
+			Entry entry = stack[--stackSize];
+			const Node& node = nodes_[entry.index];
+			bool inside = entry.inside;
+			if (!inside) {
+				int classification = Classify(frustum, node.bounds);
+				if (classification == 0) {
+					continue;
+				}
+				inside = classification == 2;
+			}
+			if (node.count > 0) {
+				for (uint32_t i = 0; i < node.count; i++) {
+					uint32_t id = primitiveIndices_[node.offset + i];
+					if (inside || Classify(frustum, primitives_[id].bounds) != 0) {
+						result.push_back(id);
+					}
+				}
+			} else {
+				assert(stackSize + 2 <= kStackSize);
+				stack[stackSize++] = {node.offset, inside};
+				stack[stackSize++] = {entry.index + 1, inside};
+			}
+		}
+	}
+
+	for (uint32_t id = builtCount_; id < primitives_.size(); id++) {
+		if (Classify(frustum, primitives_[id].bounds) != 0) {
+			result.push_back(id);
+		}
+	}
+}
+
+BVH::Frustum BVH::MakeFrustum(const Matrix4x4& m) {
+	// 行ベクトル規約 (clip = v * M) なので列から平面を取り出す
+	auto column = [&m](int j) {
+		return std::array<float, 4>{m.m[0][j], m.m[1][j], m.m[2][j], m.m[3][j]};
+	};
+	std::array<float, 4> c0 = column(0);
+	std::array<float, 4> c1 = column(1);
+	std::array<float, 4> c2 = column(2);
+	std::array<float, 4> c3 = column(3);
+
+	auto makePlane = [](const std::array<float, 4>& a, const std::array<float, 4>& b, float sign) {
+		Plane plane;
+		plane.normal = {a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2]};
+		plane.distance = a[3] + sign * b[3];
+		float length = std::sqrt(Dot(plane.normal, plane.normal));
+		if (length > 0.0f) {
+			plane.normal = Scale(plane.normal, 1.0f / length);
+			plane.distance /= length;
+		}
+		return plane;
+	};
+
+	Frustum frustum;
+	frustum.planes[0] = makePlane(c3, c0, 1.0f);  // 左
+	frustum.planes[1] = makePlane(c3, c0, -1.0f); // 右
+	frustum.planes[2] = makePlane(c3, c1, 1.0f);  // 下
+	frustum.planes[3] = makePlane(c3, c1, -1.0f); // 上
+	frustum.planes[4] = makePlane(c2, c2, 0.0f);  // 手前 (D3Dはz>=0)
+	frustum.planes[5] = makePlane(c3, c2, -1.0f); // 奥
+	return frustum;
+}
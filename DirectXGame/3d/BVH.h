@@ -0,0 +1,180 @@
+#pragma once
+
+#include "AABB.h"
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// 静的ジオメトリ用の境界ボリューム階層 (BVH)
+/// </summary>
+class BVH {
+public: // サブクラス
+	// レイ
+	struct Ray {
+		Vector3 origin;      // 始点
+		Vector3 direction;   // 方向（正規化不要）
+		float tMax = 1.0e30f; // 最大距離（directionの倍率）
+	};
+
+	// レイキャストの結果
+	struct RayHit {
+		uint32_t primitiveId = kInvalidId; // 当たったプリミティブ
+		float t = 0.0f;                    // 衝突位置の倍率
+	};
+
+	// 平面 (dot(normal, p) + distance >= 0 が表側)
+	struct Plane {
+		Vector3 normal;
+		float distance;
+	};
+
+	// 視錐台 (左,右,下,上,手前,奥)
+	struct Frustum {
+		Plane planes[6];
+	};
+
+	// ノード (32バイト)
+	struct Node {
+		AABB bounds;
+		// 葉なら最初のプリミティブ番号、内部ノードなら右の子の番号（左の子は直後）
+		uint32_t offset;
+		// 葉のプリミティブ数 (0なら内部ノード)
+		uint16_t count;
+		// 分割軸
+		uint16_t axis;
+	};
+
+	// 無効なID
+	static const uint32_t kInvalidId = 0xffffffffu;
+	// 葉に入れる最大プリミティブ数
+	static const uint32_t kMaxLeafSize = 4;
+	// SAHの分割候補数
+	static const uint32_t kBinCount = 16;
+	// これ以上のプリミティブ数なら別スレッドで構築する
+	static const uint32_t kParallelThreshold = 4096;
+
+public: // メンバ関数
+	/// <summary>
+	/// 三角形の追加
+	/// </summary>
+	/// <returns>プリミティブID</returns>
+	uint32_t AddTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+
+	/// <summary>
+	/// オブジェクトの境界ボックスの追加
+	/// </summary>
+	/// <returns>プリミティブID</returns>
+	uint32_t AddBox(const AABB& box);
+
+	/// <summary>
+	/// 格子状の頂点配列（Terrain::GetVertices()など）を三角形として追加
+	/// </summary>
+	/// <param name="vertices">頂点配列（前後×左右の二次元配列、要素は pos を持つ）</param>
+	template<class Vertex> void AddGrid(const std::vector<std::vector<Vertex>>& vertices) {
+		for (size_t z = 0; z + 1 < vertices.size(); z++) {
+			const std::vector<Vertex>& row0 = vertices[z];
+			const std::vector<Vertex>& row1 = vertices[z + 1];
+			for (size_t x = 0; x + 1 < row0.size() && x + 1 < row1.size(); x++) {
+				AddTriangle(row0[x].pos, row1[x].pos, row0[x + 1].pos);
+				AddTriangle(row0[x + 1].pos, row1[x].pos, row1[x + 1].pos);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 全プリミティブから再構築
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// 追加待ちのプリミティブが増えていれば再構築する
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 全消去
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// レイキャスト（最も近いもの）
+	/// </summary>
+	/// <param name="ray">レイ</param>
+	/// <param name="hit">結果</param>
+	/// <returns>当たったか</returns>
+	bool RayCast(const Ray& ray, RayHit& hit) const;
+
+	/// <summary>
+	/// 球と重なるプリミティブの列挙
+	/// </summary>
+	/// <param name="center">中心</param>
+	/// <param name="radius">半径</param>
+	/// <param name="result">プリミティブIDの出力先（追記）</param>
+	void OverlapSphere(const Vector3& center, float radius, std::vector<uint32_t>& result) const;
+
+	/// <summary>
+	/// 視錐台内（境界ボックス単位）のプリミティブの列挙
+	/// </summary>
+	/// <param name="frustum">視錐台</param>
+	/// <param name="result">プリミティブIDの出力先（追記）</param>
+	void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+
+	/// <summary>
+	/// ビュー×射影行列から視錐台を作成
+	/// </summary>
+	/// <param name="matViewProjection">matView * matProjection</param>
+	/// <returns>視錐台</returns>
+	static Frustum MakeFrustum(const Matrix4x4& matViewProjection);
+
+	/// <summary>
+	/// プリミティブ数を取得
+	/// </summary>
+	size_t GetPrimitiveCount() const { return primitives_.size(); }
+
+	/// <summary>
+	/// ノード配列の取得
+	/// </summary>
+	const std::vector<Node>& GetNodes() const { return nodes_; }
+
+private: // サブクラス
+	// プリミティブ
+	struct Primitive {
+		AABB bounds;
+		Vector3 v0, v1, v2; // 三角形の頂点
+		bool isTriangle;
+	};
+
+	// 構築用の一時ノード
+	struct BuildNode;
+
+private: // メンバ関数
+	/// <summary>
+	/// 部分木の構築
+	/// </summary>
+	std::unique_ptr<BuildNode> BuildRecursive(uint32_t begin, uint32_t end);
+
+	/// <summary>
+	/// 一時ノードをノード配列へ平坦化
+	/// </summary>
+	void Flatten(const BuildNode& node);
+
+	/// <summary>
+	/// プリミティブとレイの判定
+	/// </summary>
+	bool IntersectPrimitive(uint32_t primitiveId, const Ray& ray, float& t) const;
+
+private: // メンバ変数
+	// プリミティブ配列（追加順 = ID）
+	std::vector<Primitive> primitives_;
+	// 葉から参照するプリミティブIDの並び
+	std::vector<uint32_t> primitiveIndices_;
+	// 構築用の重心
+	std::vector<Vector3> centroids_;
+	// 平坦化したノード配列（深さ優先順）
+	std::vector<Node> nodes_;
+	// 木に入っているプリミティブ数（以降は追加待ち）
+	uint32_t builtCount_ = 0;
+};
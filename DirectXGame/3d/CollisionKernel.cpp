@@ -0,0 +1,193 @@
+#include "CollisionKernel.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define COLLISION_KERNEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_KERNEL_SSE2
+#endif
+
+namespace {
+
+// 1軸分の開区間を狭める（SweepAABB と同じ演算順）
+bool ClipAxis(float distance, float velocity, float radius, float& enter, float& exit) {
+	if (velocity == 0.0f) {
+		return std::fabs(distance) < radius;
+	}
+	float t0 = (-radius - distance) / velocity;
+	float t1 = (radius - distance) / velocity;
+	enter = std::max(enter, std::min(t0, t1));
+	exit = std::min(exit, std::max(t0, t1));
+	return true;
+}
+
+// 1件分のスカラー判定
+bool TestLane(const CollisionQuery& q, float x, float z, float moveX, float moveZ) {
+	float enter = -INFINITY;
+	float exit = INFINITY;
+	if (!ClipAxis(q.x - x, q.moveX - moveX, q.radius, enter, exit) ||
+	    !ClipAxis(q.z - z, q.moveZ - moveZ, q.radius, enter, exit)) {
+		return false;
+	}
+	return enter < exit && enter < 1.0f && exit > 0.0f;
+}
+
+uint32_t TestScalar(
+    const CollisionQuery& q, const float* x, const float* z, const float* moveX,
+    const float* moveZ, uint32_t count) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (TestLane(q, x[i], z[i], moveX[i], moveZ[i])) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+#if defined(COLLISION_KERNEL_AVX)
+
+// 1軸分 (8レーン)
+__m256 ClipAxis8(
+    __m256 distance, __m256 velocity, __m256 radius, __m256& enter, __m256& exit) {
+	const __m256 kZero = _mm256_setzero_ps();
+	const __m256 kInf = _mm256_set1_ps(INFINITY);
+	const __m256 kSignMask = _mm256_set1_ps(-0.0f);
+	__m256 isStatic = _mm256_cmp_ps(velocity, kZero, _CMP_EQ_OQ);
+	__m256 inRange = _mm256_cmp_ps(_mm256_andnot_ps(kSignMask, distance), radius, _CMP_LT_OQ);
+	__m256 t0 =
+	    _mm256_div_ps(_mm256_sub_ps(_mm256_xor_ps(radius, kSignMask), distance), velocity);
+	__m256 t1 = _mm256_div_ps(_mm256_sub_ps(radius, distance), velocity);
+	// 静止している軸は全時間で重なっている扱い（範囲外は ok で落とす）
+	__m256 lo =
+	    _mm256_blendv_ps(_mm256_min_ps(t0, t1), _mm256_xor_ps(kInf, kSignMask), isStatic);
+	__m256 hi = _mm256_blendv_ps(_mm256_max_ps(t0, t1), kInf, isStatic);
+	enter = _mm256_max_ps(enter, lo);
+	exit = _mm256_min_ps(exit, hi);
+	__m256 allOnes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	return _mm256_or_ps(_mm256_andnot_ps(isStatic, allOnes), inRange);
+}
+
+uint32_t Test8(
+    const CollisionQuery& q, const float* x, const float* z, const float* moveX,
+    const float* moveZ) {
+	__m256 enter = _mm256_set1_ps(-INFINITY);
+	__m256 exit = _mm256_set1_ps(INFINITY);
+	__m256 radius = _mm256_set1_ps(q.radius);
+	__m256 okX = ClipAxis8(
+	    _mm256_sub_ps(_mm256_set1_ps(q.x), _mm256_loadu_ps(x)),
+	    _mm256_sub_ps(_mm256_set1_ps(q.moveX), _mm256_loadu_ps(moveX)), radius, enter, exit);
+	__m256 okZ = ClipAxis8(
+	    _mm256_sub_ps(_mm256_set1_ps(q.z), _mm256_loadu_ps(z)),
+	    _mm256_sub_ps(_mm256_set1_ps(q.moveZ), _mm256_loadu_ps(moveZ)), radius, enter, exit);
+	__m256 hit = _mm256_and_ps(okX, okZ);
+	hit = _mm256_and_ps(hit, _mm256_cmp_ps(enter, exit, _CMP_LT_OQ));
+	hit = _mm256_and_ps(hit, _mm256_cmp_ps(enter, _mm256_set1_ps(1.0f), _CMP_LT_OQ));
+	hit = _mm256_and_ps(hit, _mm256_cmp_ps(exit, _mm256_setzero_ps(), _CMP_GT_OQ));
+	return static_cast<uint32_t>(_mm256_movemask_ps(hit));
+}
+
+#elif defined(COLLISION_KERNEL_SSE2)
+
+// SSE2には blendv が無いので and/andnot で選択する
+__m128 Select(__m128 a, __m128 b, __m128 mask) {
+	return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// 1軸分 (4レーン)
+__m128 ClipAxis4(__m128 distance, __m128 velocity, __m128 radius, __m128& enter, __m128& exit) {
+	const __m128 kZero = _mm_setzero_ps();
+	const __m128 kInf = _mm_set1_ps(INFINITY);
+	const __m128 kSignMask = _mm_set1_ps(-0.0f);
+	__m128 isStatic = _mm_cmpeq_ps(velocity, kZero);
+	__m128 inRange = _mm_cmplt_ps(_mm_andnot_ps(kSignMask, distance), radius);
+	__m128 t0 = _mm_div_ps(_mm_sub_ps(_mm_xor_ps(radius, kSignMask), distance), velocity);
+	__m128 t1 = _mm_div_ps(_mm_sub_ps(radius, distance), velocity);
+	__m128 lo = Select(_mm_min_ps(t0, t1), _mm_xor_ps(kInf, kSignMask), isStatic);
+	__m128 hi = Select(_mm_max_ps(t0, t1), kInf, isStatic);
+	enter = _mm_max_ps(enter, lo);
+	exit = _mm_min_ps(exit, hi);
+	return _mm_or_ps(_mm_andnot_ps(isStatic, _mm_castsi128_ps(_mm_set1_epi32(-1))), inRange);
+}
+
+uint32_t Test4(
+    const CollisionQuery& q, const float* x, const float* z, const float* moveX,
+    const float* moveZ) {
+	__m128 enter = _mm_set1_ps(-INFINITY);
+	__m128 exit = _mm_set1_ps(INFINITY);
+	__m128 radius = _mm_set1_ps(q.radius);
+	__m128 okX = ClipAxis4(
+	    _mm_sub_ps(_mm_set1_ps(q.x), _mm_loadu_ps(x)),
+	    _mm_sub_ps(_mm_set1_ps(q.moveX), _mm_loadu_ps(moveX)), radius, enter, exit);
+	__m128 okZ = ClipAxis4(
+	    _mm_sub_ps(_mm_set1_ps(q.z), _mm_loadu_ps(z)),
+	    _mm_sub_ps(_mm_set1_ps(q.moveZ), _mm_loadu_ps(moveZ)), radius, enter, exit);
+	__m128 hit = _mm_and_ps(okX, okZ);
+	hit = _mm_and_ps(hit, _mm_cmplt_ps(enter, exit));
+	hit = _mm_and_ps(hit, _mm_cmplt_ps(enter, _mm_set1_ps(1.0f)));
+	hit = _mm_and_ps(hit, _mm_cmpgt_ps(exit, _mm_setzero_ps()));
+	return static_cast<uint32_t>(_mm_movemask_ps(hit));
+}
+
+uint32_t Test8(
+    const CollisionQuery& q, const float* x, const float* z, const float* moveX,
+    const float* moveZ) {
+	return Test4(q, x, z, moveX, moveZ) | (Test4(q, x + 4, z + 4, moveX + 4, moveZ + 4) << 4);
+}
+
+#endif
+
+} // namespace
+
+void CollisionBatch::Clear() {
+	x.clear();
+	z.clear();
+	moveX.clear();
+	moveZ.clear();
+	ids.clear();
+}
+
+void CollisionBatch::Add(uint32_t id, const Vector3& position, const Vector3& move) {
+	x.push_back(position.x);
+	z.push_back(position.z);
+	moveX.push_back(move.x);
+	moveZ.push_back(move.z);
+	ids.push_back(id);
+}
+
+uint32_t TestSweepXZ8(
+    const CollisionQuery& query, const float* x, const float* z, const float* moveX,
+    const float* moveZ, uint32_t count) {
+	assert(count <= 8);
+#if defined(COLLISION_KERNEL_AVX) || defined(COLLISION_KERNEL_SSE2)
+	if (count == 8) {
+		return Test8(query, x, z, moveX, moveZ);
+	}
+#endif
+	return TestScalar(query, x, z, moveX, moveZ, count);
+}
+
+void TestSweepXZ(
+    const CollisionQuery& query, const CollisionBatch& batch, std::vector<uint32_t>& hitMask) {
+	uint32_t count = batch.Size();
+	hitMask.assign((count + 31) / 32, 0);
+	for (uint32_t i = 0; i < count; i += 8) {
+		uint32_t mask = TestSweepXZ8(
+		    query, &batch.x[i], &batch.z[i], &batch.moveX[i], &batch.moveZ[i],
+		    std::min(8u, count - i));
+		hitMask[i / 32] |= mask << (i % 32);
+	}
+}
+
+const char* GetCollisionKernelName() {
+#if defined(COLLISION_KERNEL_AVX)
+	return "AVX";
+#elif defined(COLLISION_KERNEL_SSE2)
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
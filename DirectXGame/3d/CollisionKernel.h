@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+///
+/// 衝突判定のナローフェーズ用SIMDカーネル。
+/// 1つの問い合わせに対してSoA配列の8件(AVX)/4件(SSE)をまとめて判定する。
+/// 判定は SweepAABB のXZ成分と一致する（静止時は abs(dx) < r && abs(dz) < r）。
+///
+
+/// <summary>
+/// 判定対象のSoA配列
+/// </summary>
+struct CollisionBatch {
+	std::vector<float> x;      // 移動前のX座標
+	std::vector<float> z;      // 移動前のZ座標
+	std::vector<float> moveX;  // X方向の移動量
+	std::vector<float> moveZ;  // Z方向の移動量
+	std::vector<uint32_t> ids; // 呼び出し側のID
+
+	/// <summary>
+	/// 消去
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 追加
+	/// </summary>
+	/// <param name="id">ID</param>
+	/// <param name="position">移動前の座標</param>
+	/// <param name="move">移動量</param>
+	void Add(uint32_t id, const Vector3& position, const Vector3& move);
+
+	/// <summary>
+	/// 件数を取得
+	/// </summary>
+	uint32_t Size() const { return static_cast<uint32_t>(ids.size()); }
+};
+
+/// <summary>
+/// 問い合わせ
+/// </summary>
+struct CollisionQuery {
+	float x;      // 移動前のX座標
+	float z;      // 移動前のZ座標
+	float moveX;  // X方向の移動量
+	float moveZ;  // Z方向の移動量
+	float radius; // 判定の半径の和
+};
+
+/// <summary>
+/// 問い合わせとバッチ全件の判定
+/// </summary>
+/// <param name="query">問い合わせ</param>
+/// <param name="batch">判定対象</param>
+/// <param name="hitMask">結果（i番目が当たっていれば hitMask[i / 32] の i % 32 ビットが立つ）</param>
+void TestSweepXZ(
+    const CollisionQuery& query, const CollisionBatch& batch, std::vector<uint32_t>& hitMask);
+
+/// <summary>
+/// 8件分の判定（端数はスカラー）
+/// </summary>
+/// <returns>当たったもののビットマスク</returns>
+uint32_t TestSweepXZ8(
+    const CollisionQuery& query, const float* x, const float* z, const float* moveX,
+    const float* moveZ, uint32_t count);
+
+/// <summary>
+/// 使用中のカーネル名を取得
+/// </summary>
+/// <returns>"AVX", "SSE2", "Scalar" のいずれか</returns>
+const char* GetCollisionKernelName();
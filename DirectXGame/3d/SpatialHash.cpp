@@ -0,0 +1,144 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// 最小バケット数
+const uint32_t kMinBucketCount = 64;
+// セル座標の絶対値の上限（外側の座標・無限大はこのセルに寄せる。範囲の幅も int32_t に収まる）
+const int32_t kMaxCell = (1 << 30) - 1;
+
+} // namespace
+
+void SpatialHash::Initialize(float cellSize) {
+	assert(cellSize > 0.0f);
+	cellSize_ = cellSize;
+	invCellSize_ = 1.0f / cellSize;
+	Clear();
+}
+
+void SpatialHash::Clear() {
+	entries_.clear();
+	sorted_.clear();
+	bucketStart_.clear();
+	bucketMask_ = 0;
+}
+
+void SpatialHash::Insert(uint32_t id, float x, float z) {
+	// NaN はどのセルにも入らないので登録しない
+	if (std::isnan(x) || std::isnan(z)) {
+		return;
+	}
+	entries_.push_back({id, ToCell(x), ToCell(z)});
+}
+
+void SpatialHash::Build() {
+	// 登録数の2倍以上の2のべき乗をバケット数にする
+	uint32_t bucketCount = kMinBucketCount;
+	while (bucketCount < entries_.size() * 2) {
+		bucketCount <<= 1;
+	}
+	bucketMask_ = bucketCount - 1;
+
+	// 計数ソート（同じバケット内は登録順のまま）
+	bucketStart_.assign(size_t(bucketCount) + 1, 0);
+	for (const Entry& entry : entries_) {
+		bucketStart_[Bucket(entry.cellX, entry.cellZ) + 1]++;
+	}
+	for (uint32_t b = 0; b < bucketCount; b++) {
+		bucketStart_[b + 1] += bucketStart_[b];
+	}
+	// 開始位置を書き込み位置として使い、終わったら1つずらして戻す
+	sorted_.resize(entries_.size());
+	for (const Entry& entry : entries_) {
+		sorted_[bucketStart_[Bucket(entry.cellX, entry.cellZ)]++] = entry;
+	}
+	for (uint32_t b = bucketCount; b > 0; b--) {
+		bucketStart_[b] = bucketStart_[b - 1];
+	}
+	bucketStart_[0] = 0;
+}
+
+void SpatialHash::Query(float x, float z, float radius, std::vector<uint32_t>& result) const {
+	result.clear();
+	Gather(x, z, radius, result);
+	std::sort(result.begin(), result.end());
+}
+
+void SpatialHash::FindPairs(
+    const float* x, const float* z, uint32_t count, float radius,
+    std::vector<Pair>& pairs) const {
+	pairs.clear();
+	std::vector<uint32_t> candidates;
+	for (uint32_t q = 0; q < count; q++) {
+		candidates.clear();
+		Gather(x[q], z[q], radius, candidates);
+		std::sort(candidates.begin(), candidates.end());
+		for (uint32_t id : candidates) {
+			pairs.push_back({q, id});
+		}
+	}
+}
+
+uint32_t SpatialHash::Bucket(int32_t cellX, int32_t cellZ) const {
+	uint32_t h =
+	    static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellZ) * 19349663u;
+	return h & bucketMask_;
+}
+
+int32_t SpatialHash::ToCell(float v) const {
+	// 整数にできない値を変換しないよう、先に範囲内に収める（NaN も端に寄る）
+	float cell = std::floor(v * invCellSize_);
+	if (!(cell > -static_cast<float>(kMaxCell))) {
+		return -kMaxCell;
+	}
+	if (!(cell < static_cast<float>(kMaxCell))) {
+		return kMaxCell;
+	}
+	return static_cast<int32_t>(cell);
+}
+
+void SpatialHash::Gather(float x, float z, float radius, std::vector<uint32_t>& result) const {
+	// NaN の範囲（無限大 - 無限大 を含む）は何も含まない
+	float left = x - radius;
+	float right = x + radius;
+	float back = z - radius;
+	float front = z + radius;
+	if (sorted_.empty() || std::isnan(left) || std::isnan(right) || std::isnan(back) ||
+	    std::isnan(front)) {
+		return;
+	}
+	int32_t minX = ToCell(left);
+	int32_t maxX = ToCell(right);
+	int32_t minZ = ToCell(back);
+	int32_t maxZ = ToCell(front);
+	if (minX > maxX || minZ > maxZ) {
+		return;
+	}
+
+	// 範囲のセルが登録数より多ければ、セルを回らずに全ての登録を調べる
+	uint64_t cellCount = static_cast<uint64_t>(maxX - minX + 1) * (maxZ - minZ + 1);
+	if (cellCount > sorted_.size()) {
+		for (const Entry& entry : sorted_) {
+			if (minX <= entry.cellX && entry.cellX <= maxX && minZ <= entry.cellZ &&
+			    entry.cellZ <= maxZ) {
+				result.push_back(entry.id);
+			}
+		}
+		return;
+	}
+	for (int32_t cz = minZ; cz <= maxZ; cz++) {
+		for (int32_t cx = minX; cx <= maxX; cx++) {
+			uint32_t bucket = Bucket(cx, cz);
+			for (uint32_t i = bucketStart_[bucket]; i < bucketStart_[bucket + 1]; i++) {
+				// ハッシュの衝突で混ざった別セルは除く（セルごとに1回しか拾わない）
+				const Entry& entry = sorted_[i];
+				if (entry.cellX == cx && entry.cellZ == cz) {
+					result.push_back(entry.id);
+				}
+			}
+		}
+	}
+}
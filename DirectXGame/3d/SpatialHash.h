@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// XZ平面の一様グリッドによる空間ハッシュ（衝突判定のブロードフェーズ用）
+/// </summary>
+class SpatialHash {
+public: // サブクラス
+	// 候補ペア
+	struct Pair {
+		uint32_t query; // 問い合わせ側のID
+		uint32_t id;    // 登録側のID
+	};
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="cellSize">セルの一辺の長さ</param>
+	void Initialize(float cellSize = 1.0f);
+
+	/// <summary>
+	/// 登録内容の消去（毎フレームの先頭で呼ぶ）
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 登録（座標が NaN なら登録しない。遠すぎる座標は端のセルに入れる）
+	/// </summary>
+	/// <param name="id">ID</param>
+	/// <param name="x">X座標</param>
+	/// <param name="z">Z座標</param>
+	void Insert(uint32_t id, float x, float z);
+
+	/// <summary>
+	/// 登録したものをセルごとに振り分ける
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// 範囲内のセルに入っているIDの列挙
+	/// 範囲のセルが登録数より多いときは、セルを回らずに全ての登録を調べる
+	/// </summary>
+	/// <param name="x">X座標</param>
+	/// <param name="z">Z座標</param>
+	/// <param name="radius">X,Z方向の半径</param>
+	/// <param name="result">IDの出力先（昇順、上書き）</param>
+	void Query(float x, float z, float radius, std::vector<uint32_t>& result) const;
+
+	/// <summary>
+	/// 候補ペアの列挙
+	/// </summary>
+	/// <param name="x">問い合わせ側のX座標の配列</param>
+	/// <param name="z">問い合わせ側のZ座標の配列</param>
+	/// <param name="count">問い合わせ側の数</param>
+	/// <param name="radius">X,Z方向の半径</param>
+	/// <param name="pairs">ペアの出力先（問い合わせ順、ID昇順、上書き）</param>
+	void FindPairs(
+	    const float* x, const float* z, uint32_t count, float radius,
+	    std::vector<Pair>& pairs) const;
+
+	/// <summary>
+	/// 登録数を取得
+	/// </summary>
+	size_t GetCount() const { return entries_.size(); }
+
+private: // サブクラス
+	struct Entry {
+		uint32_t id;
+		int32_t cellX;
+		int32_t cellZ;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// セル座標からバケット番号を求める
+	/// </summary>
+	uint32_t Bucket(int32_t cellX, int32_t cellZ) const;
+
+	/// <summary>
+	/// 座標からセル座標を求める
+	/// </summary>
+	int32_t ToCell(float v) const;
+
+	/// <summary>
+	/// 範囲内のIDを追記（未整列）
+	/// </summary>
+	void Gather(float x, float z, float radius, std::vector<uint32_t>& result) const;
+
+private: // メンバ変数
+	// セルの一辺の長さ
+	float cellSize_ = 1.0f;
+	// セルの一辺の長さの逆数
+	float invCellSize_ = 1.0f;
+	// 登録順のエントリ
+	std::vector<Entry> entries_;
+	// バケット順に並べたエントリ
+	std::vector<Entry> sorted_;
+	// バケットごとの開始位置（バケット数+1）
+	std::vector<uint32_t> bucketStart_;
+	// バケット数 - 1 (2のべき乗 - 1)
+	uint32_t bucketMask_ = 0;
+};
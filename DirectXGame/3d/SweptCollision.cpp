@@ -0,0 +1,63 @@
+#include "SweptCollision.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 1軸分の重なっている時間の開区間 (enter, exit) を狭める
+bool ClipAxis(float distance, float velocity, float radius, float& enter, float& exit) {
+	if (velocity == 0.0f) {
+		// 動かない軸は最初から重なっていなければ当たらない
+		return std::fabs(distance) < radius;
+	}
+	float t0 = (-radius - distance) / velocity;
+	float t1 = (radius - distance) / velocity;
+	if (t0 > t1) {
+		std::swap(t0, t1);
+	}
+	enter = std::max(enter, t0);
+	exit = std::min(exit, t1);
+	return enter < exit;
+}
+
+// 相対位置・相対移動量・半径和による判定
+bool Sweep(const Vector3& distance, const Vector3& velocity, const Vector3& radius, float& toi) {
+	float enter = -INFINITY;
+	float exit = INFINITY;
+	if (!ClipAxis(distance.x, velocity.x, radius.x, enter, exit) ||
+	    !ClipAxis(distance.y, velocity.y, radius.y, enter, exit) ||
+	    !ClipAxis(distance.z, velocity.z, radius.z, enter, exit)) {
+		return false;
+	}
+	// [0,1] のどこかで重なっていれば当たり
+	if (enter >= 1.0f || exit <= 0.0f) {
+		return false;
+	}
+	toi = std::max(enter, 0.0f);
+	return true;
+}
+
+} // namespace
+
+bool SweepAABB(
+    const AABB& a, const Vector3& moveA, const AABB& b, const Vector3& moveB,
+    float& timeOfImpact) {
+	// Bから見たAの中心の相対位置と相対移動量
+	Vector3 distance = {
+	    (a.min.x + a.max.x - b.min.x - b.max.x) * 0.5f,
+	    (a.min.y + a.max.y - b.min.y - b.max.y) * 0.5f,
+	    (a.min.z + a.max.z - b.min.z - b.max.z) * 0.5f};
+	Vector3 velocity = {moveA.x - moveB.x, moveA.y - moveB.y, moveA.z - moveB.z};
+	// 半径の和 (ミンコフスキー和)
+	Vector3 radius = {
+	    (a.max.x - a.min.x + b.max.x - b.min.x) * 0.5f,
+	    (a.max.y - a.min.y + b.max.y - b.min.y) * 0.5f,
+	    (a.max.z - a.min.z + b.max.z - b.min.z) * 0.5f};
+	return Sweep(distance, velocity, radius, timeOfImpact);
+}
+
+bool SegmentAABB(const Vector3& start, const Vector3& end, const AABB& box, float& timeOfImpact) {
+	AABB point = {start, start};
+	Vector3 move = {end.x - start.x, end.y - start.y, end.z - start.z};
+	return SweepAABB(point, move, box, {0, 0, 0}, timeOfImpact);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AABB.h"
+#include "Vector3.h"
+
+///
+/// 移動を考慮した連続衝突判定。
+/// ボックスは開区間として扱い、静止時は abs(d) < 半径和 の判定と一致する。
+///
+
+/// <summary>
+/// 移動するボックス同士の判定
+/// </summary>
+/// <param name="a">フレーム開始時のボックスA</param>
+/// <param name="moveA">フレーム中のAの移動量</param>
+/// <param name="b">フレーム開始時のボックスB</param>
+/// <param name="moveB">フレーム中のBの移動量</param>
+/// <param name="timeOfImpact">最初に重なる時刻 [0,1]</param>
+/// <returns>フレーム中に重なるか</returns>
+bool SweepAABB(
+    const AABB& a, const Vector3& moveA, const AABB& b, const Vector3& moveB,
+    float& timeOfImpact);
+
+/// <summary>
+/// 線分とボックスの判定
+/// </summary>
+/// <param name="start">始点</param>
+/// <param name="end">終点</param>
+/// <param name="box">ボックス</param>
+/// <param name="timeOfImpact">最初に重なる位置の割合 [0,1]</param>
+/// <returns>重なるか</returns>
+bool SegmentAABB(const Vector3& start, const Vector3& end, const AABB& box, float& timeOfImpact);
+
+/// <summary>
+/// 中心と半径からボックスを作成
+/// </summary>
+inline AABB MakeAABB(const Vector3& center, const Vector3& halfSize) {
+	return {
+	    {center.x - halfSize.x, center.y - halfSize.y, center.z - halfSize.z},
+	    {center.x + halfSize.x, center.y + halfSize.y, center.z + halfSize.z}};
+}
@@ -74,6 +74,12 @@ Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vecto
 	return matTransform;
 }
 
+Vector3 Lerp(const Vector3& start, const Vector3& end, float t) {
+	return {
+	    start.x + (end.x - start.x) * t, start.y + (end.y - start.y) * t,
+	    start.z + (end.z - start.z) * t};
+}
+
 Matrix4x4& operator*=(Matrix4x4& lhm, const Matrix4x4& rhm) {
 	Matrix4x4 result{};
 
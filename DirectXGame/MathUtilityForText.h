@@ -11,6 +11,9 @@
 // アフィン変換行列の作成
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rot, const Vector3& translate);
 
+// 線形補間
+Vector3 Lerp(const Vector3& start, const Vector3& end, float t);
+
 // 代入演算子オーバーロード
 Matrix4x4& operator*=(Matrix4x4& lhm, const Matrix4x4& rhm);
 
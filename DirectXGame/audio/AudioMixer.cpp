@@ -0,0 +1,742 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MIXER_KERNEL_AVX
+#define MIXER_KERNEL_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIXER_KERNEL_SSE2
+#endif
+
+namespace {
+
+// 固定小数点の1
+const uint64_t kFixedOne = 1ull << 32;
+// 再生ハンドルの下位に置く枠の番号のビット数（上位は枠を使った回数）
+const uint32_t kSlotBits = 8;
+const uint32_t kSlotMask = (1u << kSlotBits) - 1;
+static_assert(AudioMixer::kMaxVoices <= (1u << kSlotBits), "slot index must fit in handle");
+// 鳴り終わりは枠に入った音ごとに1回だけ積む。ゲームのスレッドは音を始める前に必ず受け取るので、
+// 受け取ってから積めるのは、そのとき枠にあった音と、溜まっていた命令で始まる音の分まで。
+// 知らせを溜めておける数がそれ以上あれば、積むのに失敗して枠が空かなくなることはない
+static_assert(
+    AudioMixer::kMaxVoices + AudioMixer::kMaxCommands <= AudioMixer::kMaxFinishedVoices,
+    "finished queue must hold every voice that can finish before the game thread collects");
+// これより小さい音量の音は混ぜない
+const float kInaudibleVolume = 1.0f / 1024.0f;
+// リミッターが抑え始める大きさ
+const float kLimiterThreshold = 0.98f;
+// リミッターが戻る速さ（処理単位ごとに残りの差に掛ける）
+const float kLimiterRelease = 0.02f;
+
+// 音量・パンから左右の倍率（パンは片側を絞るだけなので、中央では元の大きさのまま）
+void ComputeGain(float volume, float pan, float gain[AudioMixer::kChannels]) {
+	gain[0] = volume * std::min(1.0f, 1.0f - pan);
+	gain[1] = volume * std::min(1.0f, 1.0f + pan);
+}
+
+// 倍率を begin から end へ直線的に変えながら足す
+void MixAdd(
+    float* mix, const float* source, uint32_t frames, const float begin[2], const float end[2]) {
+	float deltaL = (end[0] - begin[0]) / frames;
+	float deltaR = (end[1] - begin[1]) / frames;
+	uint32_t i = 0;
+#if defined(MIXER_KERNEL_AVX)
+	// 4フレームずつ
+	__m256 gain = _mm256_setr_ps(
+	    begin[0] + deltaL * 1, begin[1] + deltaR * 1, begin[0] + deltaL * 2,
+	    begin[1] + deltaR * 2, begin[0] + deltaL * 3, begin[1] + deltaR * 3,
+	    begin[0] + deltaL * 4, begin[1] + deltaR * 4);
+	__m256 gainStep = _mm256_setr_ps(
+	    deltaL * 4, deltaR * 4, deltaL * 4, deltaR * 4, deltaL * 4, deltaR * 4, deltaL * 4,
+	    deltaR * 4);
+	for (; i + 4 <= frames; i += 4) {
+		__m256 m = _mm256_loadu_ps(mix + i * 2);
+		__m256 s = _mm256_loadu_ps(source + i * 2);
+		_mm256_storeu_ps(mix + i * 2, _mm256_add_ps(m, _mm256_mul_ps(s, gain)));
+		gain = _mm256_add_ps(gain, gainStep);
+	}
+#elif defined(MIXER_KERNEL_SSE2)
+	// 2フレームずつ
+	__m128 gain = _mm_setr_ps(
+	    begin[0] + deltaL * 1, begin[1] + deltaR * 1, begin[0] + deltaL * 2,
+	    begin[1] + deltaR * 2);
+	__m128 gainStep = _mm_setr_ps(deltaL * 2, deltaR * 2, deltaL * 2, deltaR * 2);
+	for (; i + 2 <= frames; i += 2) {
+		__m128 m = _mm_loadu_ps(mix + i * 2);
+		__m128 s = _mm_loadu_ps(source + i * 2);
+		_mm_storeu_ps(mix + i * 2, _mm_add_ps(m, _mm_mul_ps(s, gain)));
+		gain = _mm_add_ps(gain, gainStep);
+	}
+#endif
+	for (; i < frames; i++) {
+		mix[i * 2 + 0] += source[i * 2 + 0] * (begin[0] + deltaL * (i + 1));
+		mix[i * 2 + 1] += source[i * 2 + 1] * (begin[1] + deltaR * (i + 1));
+	}
+}
+
+// 絶対値の最大
+float PeakAbs(const float* samples, uint32_t count) {
+	float peak = 0.0f;
+	uint32_t i = 0;
+#if defined(MIXER_KERNEL_SSE2)
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 peak4 = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		peak4 = _mm_max_ps(peak4, _mm_and_ps(_mm_loadu_ps(samples + i), absMask));
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, peak4);
+	peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+	for (; i < count; i++) {
+		peak = std::max(peak, std::abs(samples[i]));
+	}
+	return peak;
+}
+
+// 倍率を begin から end へ直線的に変えながら掛けて、[-1, 1] に切り詰める
+void ScaleAndClip(
+    const float* source, float* output, uint32_t frames, float begin, float end) {
+	float delta = (end - begin) / frames;
+	uint32_t i = 0;
+#if defined(MIXER_KERNEL_SSE2)
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	__m128 gain = _mm_setr_ps(begin + delta, begin + delta, begin + delta * 2, begin + delta * 2);
+	__m128 gainStep = _mm_set1_ps(delta * 2);
+	for (; i + 2 <= frames; i += 2) {
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(source + i * 2), gain);
+		_mm_storeu_ps(output + i * 2, _mm_max_ps(_mm_min_ps(s, one), minusOne));
+		gain = _mm_add_ps(gain, gainStep);
+	}
+#endif
+	for (; i < frames; i++) {
+		float gain = begin + delta * (i + 1);
+		for (uint32_t c = 0; c < AudioMixer::kChannels; c++) {
+			output[i * 2 + c] = std::clamp(source[i * 2 + c] * gain, -1.0f, 1.0f);
+		}
+	}
+}
+
+} // namespace
+
+void AudioMixer::Initialize(uint32_t sampleRate) {
+	assert(sampleRate > 0);
+	sampleRate_ = sampleRate;
+
+	// 前の命令・終了の知らせは捨てる
+	Command command;
+	while (commands_.Pop(command)) {
+	}
+	uint32_t handle;
+	while (finishedVoices_.Pop(handle)) {
+	}
+	for (uint32_t i = 0; i < kMaxVoices; i++) {
+		slotHandles_[i] = 0;
+		freeSlots_[i] = kMaxVoices - 1 - i; // 番号の小さい枠から使う
+		voices_[i] = Voice();
+	}
+	freeSlotCount_ = kMaxVoices;
+	playCount_ = 0;
+	droppedCommandCount_ = 0;
+	stolenVoiceCount_ = 0;
+	buses_.fill(Bus());
+	limiterGain_.store(1.0f, std::memory_order_relaxed);
+	realVoiceCount_.store(0, std::memory_order_relaxed);
+	virtualVoiceCount_.store(0, std::memory_order_relaxed);
+
+	mixBuffer_.assign(kBusCount * kMaxRenderFrames * kChannels, 0.0f);
+	voiceBuffer_.assign(kMaxRenderFrames * kChannels, 0.0f);
+	// 窓と、最大の周波数比で進むぶん
+	sourceBuffer_.assign((kMaxRenderFrames * kMaxPitch + SincFilter::kMaxTaps) * kChannels, 0.0f);
+
+	// 音源の方が低い周波数はフィルターを共有し、高い周波数は周波数ごとに必要になったら作る
+	upsampleFilter_.Initialize(sampleRate_, sampleRate_);
+	downsampleFilterCount_ = 0;
+	resampleQuality_ = ResampleQuality::Sinc;
+}
+
+uint32_t AudioMixer::Play(
+    const WaveView& sound, bool loop, float volume, float pan, uint32_t priority, AudioBus bus) {
+	Command command;
+	command.format = sound.format;
+	command.data = sound.data.data();
+	command.frameCount =
+	    sound.format.blockAlign > 0
+	        ? static_cast<uint32_t>(sound.data.size() / sound.format.blockAlign)
+	        : 0;
+	command.loop = loop && command.frameCount > 0;
+	command.volume = volume;
+	command.pan = pan;
+	command.priority = priority;
+	command.bus = bus;
+	return StartVoice(command);
+}
+
+uint32_t AudioMixer::PlayStream(
+    WaveStream* stream, float volume, float pan, uint32_t priority, AudioBus bus) {
+	assert(stream && stream->IsOpen());
+	Command command;
+	command.format = stream->GetFormat();
+	command.stream = stream;
+	command.volume = volume;
+	command.pan = pan;
+	command.priority = priority;
+	command.bus = bus;
+	return StartVoice(command);
+}
+
+void AudioMixer::Stop(uint32_t voiceHandle) {
+	if (IsPlaying(voiceHandle)) {
+		Command command;
+		command.type = CommandType::Stop;
+		command.handle = voiceHandle;
+		PushCommand(command);
+	}
+}
+
+void AudioMixer::StopAll() {
+	Command command;
+	command.type = CommandType::StopAll;
+	PushCommand(command);
+}
+
+bool AudioMixer::IsPlaying(uint32_t voiceHandle) {
+	CollectFinishedVoices();
+	return voiceHandle != 0 && slotHandles_[voiceHandle & kSlotMask] == voiceHandle;
+}
+
+void AudioMixer::SetVolume(uint32_t voiceHandle, float volume) {
+	PushFade(voiceHandle, volume, 0.0f, false);
+}
+
+void AudioMixer::FadeVolume(uint32_t voiceHandle, float volume, float seconds) {
+	PushFade(voiceHandle, volume, seconds, false);
+}
+
+void AudioMixer::FadeOutAndStop(uint32_t voiceHandle, float seconds) {
+	PushFade(voiceHandle, 0.0f, seconds, true);
+}
+
+void AudioMixer::SetPan(uint32_t voiceHandle, float pan) {
+	if (IsPlaying(voiceHandle)) {
+		Command command;
+		command.type = CommandType::SetPan;
+		command.handle = voiceHandle;
+		command.pan = pan;
+		PushCommand(command);
+	}
+}
+
+void AudioMixer::SetBusVolume(AudioBus bus, float volume) {
+	assert(bus < AudioBus::Count);
+	Command command;
+	command.type = CommandType::SetBusVolume;
+	command.bus = bus;
+	command.volume = volume;
+	PushCommand(command);
+}
+
+void AudioMixer::SetBusMute(AudioBus bus, bool mute) {
+	assert(bus < AudioBus::Count);
+	Command command;
+	command.type = CommandType::SetBusMute;
+	command.bus = bus;
+	command.mute = mute;
+	PushCommand(command);
+}
+
+void AudioMixer::SetDucking(
+    AudioBus bus, AudioBus trigger, float gain, float attackSeconds, float releaseSeconds) {
+	assert(bus < AudioBus::Count && trigger < AudioBus::Count);
+	Command command;
+	command.type = CommandType::SetDucking;
+	command.bus = bus;
+	command.trigger = trigger;
+	command.volume = std::clamp(gain, 0.0f, 1.0f);
+	command.attackFrames = static_cast<uint32_t>(std::max(attackSeconds, 0.0f) * sampleRate_);
+	command.releaseFrames = static_cast<uint32_t>(std::max(releaseSeconds, 0.0f) * sampleRate_);
+	PushCommand(command);
+}
+
+uint32_t AudioMixer::GetPlayingVoiceCount() {
+	CollectFinishedVoices();
+	return kMaxVoices - freeSlotCount_;
+}
+
+void AudioMixer::Render(float* output, uint32_t frames) {
+	// ゲームのスレッドからの命令を順に実行する
+	Command command;
+	while (commands_.Pop(command)) {
+		ExecuteCommand(command);
+	}
+
+	while (frames > 0) {
+		uint32_t chunk = frames < kMaxRenderFrames ? frames : kMaxRenderFrames;
+		for (uint32_t b = 0; b < kBusCount; b++) {
+			std::fill_n(
+			    mixBuffer_.begin() + b * kMaxRenderFrames * kChannels, chunk * kChannels, 0.0f);
+			buses_[b].voiceCount = 0;
+		}
+		uint32_t activeCount = 0;
+		uint32_t realCount = SelectRealVoices(activeCount);
+		for (uint32_t i = 0; i < activeCount; i++) {
+			Voice& voice = voices_[activeSlots_[i]];
+			// 止めるまでのフェードを終えた音も、この処理単位は絞りながら混ぜる
+			bool keepsPlaying = UpdateFade(voice, chunk);
+			bool isPlaying = true;
+			if (i < realCount) {
+				if (voice.isVirtual) {
+					// 仮想から戻った音は補間の左右を読み直し、無音から上げる
+					voice.isVirtual = false;
+					voice.started = false;
+					std::fill_n(voice.gain, kChannels, 0.0f);
+				}
+				isPlaying = RenderVoice(voice, chunk, false);
+			} else if (voice.isVirtual) {
+				isPlaying = AdvanceVirtualVoice(voice, chunk);
+			} else if (!voice.started) {
+				// まだ鳴らしていない音はそのまま仮想に
+				voice.isVirtual = true;
+				std::fill_n(voice.gain, kChannels, 0.0f);
+				isPlaying = AdvanceVirtualVoice(voice, chunk);
+			} else {
+				// 鳴っていた音は、この処理単位で絞りきってから仮想に
+				isPlaying = RenderVoice(voice, chunk, true);
+				voice.isVirtual = true;
+			}
+			if (!isPlaying || !keepsPlaying) {
+				FinishVoice(voice);
+			} else if (voice.volume >= kInaudibleVolume) {
+				buses_[static_cast<size_t>(voice.bus)].voiceCount++;
+			}
+		}
+		realVoiceCount_.store(realCount, std::memory_order_relaxed);
+		virtualVoiceCount_.store(activeCount - realCount, std::memory_order_relaxed);
+		float masterGain = buses_[0].gain;
+		MixBuses(chunk);
+		ApplyLimiter(output, chunk, masterGain, buses_[0].gain);
+		output += chunk * kChannels;
+		frames -= chunk;
+	}
+}
+
+uint32_t AudioMixer::StartVoice(Command& command) {
+	const WaveFormat& format = command.format;
+	// IMA ADPCM は WaveFile・WaveStream が展開したものを受け取る
+	if (format.formatTag == kWaveFormatImaAdpcm || format.blockAlign == 0 ||
+	    format.samplesPerSec == 0 ||
+	    format.samplesPerSec > static_cast<uint64_t>(sampleRate_) * kMaxPitch) {
+		return 0;
+	}
+	CollectFinishedVoices();
+	uint32_t slot = kMaxVoices;
+	if (freeSlotCount_ > 0) {
+		slot = freeSlots_[freeSlotCount_ - 1];
+	} else {
+		// 埋まっていたら、優先度・音量の低い音の枠を奪う
+		slot = FindVictimSlot(command.priority, command.volume);
+		if (slot == kMaxVoices) {
+			return 0;
+		}
+	}
+
+	// 枠を使った回数をハンドルの上位に入れて、前の再生のハンドルと区別する（0は使わない）
+	uint32_t generation = (generations_[slot] + 1) & (0xffffffffu >> kSlotBits);
+	if (generation == 0) {
+		generation = 1;
+	}
+	command.type = CommandType::Play;
+	command.handle = generation << kSlotBits | slot;
+	command.filter = FindFilter(format.samplesPerSec);
+	if (!PushCommand(command)) {
+		return 0;
+	}
+	generations_[slot] = generation;
+	if (slotHandles_[slot] == 0) {
+		freeSlotCount_--;
+	} else {
+		stolenVoiceCount_++;
+	}
+	slotHandles_[slot] = command.handle;
+	slotPriorities_[slot] = command.priority;
+	slotVolumes_[slot] = command.volume;
+	slotPlayOrders_[slot] = playCount_++;
+	return command.handle;
+}
+
+void AudioMixer::PushFade(uint32_t voiceHandle, float volume, float seconds, bool stopAfterFade) {
+	if (IsPlaying(voiceHandle)) {
+		Command command;
+		command.type = CommandType::SetVolume;
+		command.handle = voiceHandle;
+		command.volume = volume;
+		command.fadeFrames = static_cast<uint32_t>(std::max(seconds, 0.0f) * sampleRate_);
+		command.stopAfterFade = stopAfterFade;
+		if (PushCommand(command)) {
+			// 奪う枠を選ぶときは、変え終わった後の音量で比べる
+			slotVolumes_[voiceHandle & kSlotMask] = volume;
+		}
+	}
+}
+
+bool AudioMixer::PushCommand(const Command& command) {
+	if (!commands_.Push(command)) {
+		droppedCommandCount_++;
+		return false;
+	}
+	return true;
+}
+
+void AudioMixer::CollectFinishedVoices() {
+	uint32_t handle;
+	while (finishedVoices_.Pop(handle)) {
+		uint32_t slot = handle & kSlotMask;
+		// 鳴り終わりを受け取る前に奪った枠は、もう次の音が使っている
+		if (slotHandles_[slot] == handle) {
+			slotHandles_[slot] = 0;
+			freeSlots_[freeSlotCount_++] = slot;
+		}
+	}
+}
+
+const SincFilter* AudioMixer::FindFilter(uint32_t sourceRate) {
+	// 同じ周波数は変換しないので窓を2フレームにしておく
+	if (resampleQuality_ == ResampleQuality::Linear || sourceRate == sampleRate_) {
+		return nullptr;
+	}
+	if (sourceRate <= sampleRate_) {
+		return &upsampleFilter_;
+	}
+	for (uint32_t i = 0; i < downsampleFilterCount_; i++) {
+		if (downsampleRates_[i] == sourceRate) {
+			return &downsampleFilters_[i];
+		}
+	}
+	// 作ったフィルターは初期化まで作り直さない（出力先のスレッドが参照している）
+	if (downsampleFilterCount_ == kMaxDownsampleFilters) {
+		return nullptr;
+	}
+	SincFilter& filter = downsampleFilters_[downsampleFilterCount_];
+	filter.Initialize(sourceRate, sampleRate_);
+	downsampleRates_[downsampleFilterCount_++] = sourceRate;
+	return &filter;
+}
+
+uint32_t AudioMixer::FindVictimSlot(uint32_t priority, float volume) const {
+	// 優先度が低い → 音量が小さい → 古い 順に選ぶ
+	uint32_t victim = kMaxVoices;
+	for (uint32_t slot = 0; slot < kMaxVoices; slot++) {
+		if (victim == kMaxVoices || slotPriorities_[slot] < slotPriorities_[victim] ||
+		    (slotPriorities_[slot] == slotPriorities_[victim] &&
+		     (slotVolumes_[slot] < slotVolumes_[victim] ||
+		      (slotVolumes_[slot] == slotVolumes_[victim] &&
+		       slotPlayOrders_[slot] - slotPlayOrders_[victim] > 0x7fffffffu)))) {
+			victim = slot;
+		}
+	}
+	// 新しい音の方が優先度が低い・同じ優先度で小さいなら奪わない
+	if (slotPriorities_[victim] > priority ||
+	    (slotPriorities_[victim] == priority && slotVolumes_[victim] > volume)) {
+		return kMaxVoices;
+	}
+	return victim;
+}
+
+void AudioMixer::ExecuteCommand(const Command& command) {
+	Voice* voice = nullptr;
+	if (command.handle != 0) {
+		voice = &voices_[command.handle & kSlotMask];
+		// 止めた後の命令など、もう鳴っていない音への命令は捨てる
+		if (command.type != CommandType::Play && voice->handle != command.handle) {
+			return;
+		}
+	}
+
+	switch (command.type) {
+	case CommandType::Play:
+		// 奪われた枠は知らせずに置き換える（ゲームのスレッドはもう次の音に使っている）
+		*voice = Voice();
+		voice->handle = command.handle;
+		voice->format = command.format;
+		voice->convert = GetSampleConverter(command.format);
+		voice->filter = command.filter;
+		voice->taps = command.filter ? command.filter->GetTaps() : 2;
+		voice->data = command.data;
+		voice->frameCount = command.frameCount;
+		voice->loop = command.loop;
+		voice->stream = command.stream;
+		voice->step = (static_cast<uint64_t>(command.format.samplesPerSec) << 32) / sampleRate_;
+		voice->volume = command.volume;
+		voice->pan = std::clamp(command.pan, -1.0f, 1.0f);
+		voice->priority = command.priority;
+		voice->bus = command.bus;
+		ComputeGain(voice->volume, voice->pan, voice->gain);
+		break;
+	case CommandType::Stop:
+		FinishVoice(*voice);
+		break;
+	case CommandType::StopAll:
+		for (Voice& v : voices_) {
+			if (v.handle != 0) {
+				FinishVoice(v);
+			}
+		}
+		break;
+	case CommandType::SetVolume:
+		if (command.fadeFrames == 0) {
+			if (command.stopAfterFade) {
+				FinishVoice(*voice);
+				break;
+			}
+			voice->volume = command.volume;
+			voice->fadeStep = 0.0f;
+		} else {
+			voice->fadeTarget = command.volume;
+			voice->fadeStep = (command.volume - voice->volume) / command.fadeFrames;
+			voice->stopAfterFade = command.stopAfterFade;
+		}
+		break;
+	case CommandType::SetPan:
+		voice->pan = std::clamp(command.pan, -1.0f, 1.0f);
+		break;
+	case CommandType::SetBusVolume:
+		buses_[static_cast<size_t>(command.bus)].volume = command.volume;
+		break;
+	case CommandType::SetBusMute:
+		buses_[static_cast<size_t>(command.bus)].mute = command.mute;
+		break;
+	case CommandType::SetDucking: {
+		// 絞る量を attack・release のフレーム数で割って、1フレームで動かす量にする
+		Bus& bus = buses_[static_cast<size_t>(command.bus)];
+		float range = 1.0f - command.volume;
+		bus.trigger = command.trigger;
+		bus.duckGain = command.volume;
+		bus.attackStep = command.attackFrames > 0 ? range / command.attackFrames : 1.0f;
+		bus.releaseStep = command.releaseFrames > 0 ? range / command.releaseFrames : 1.0f;
+		break;
+	}
+	}
+}
+
+void AudioMixer::FinishVoice(Voice& voice) {
+	// 溢れないことは kMaxFinishedVoices の static_assert で保証している
+	bool pushed = finishedVoices_.Push(voice.handle);
+	assert(pushed);
+	(void)pushed;
+	voice = Voice();
+}
+
+uint32_t AudioMixer::SelectRealVoices(uint32_t& activeCount) {
+	activeCount = 0;
+	for (uint32_t slot = 0; slot < kMaxVoices; slot++) {
+		if (voices_[slot].handle != 0) {
+			activeSlots_[activeCount++] = slot;
+		}
+	}
+	// 音量はバスの倍率（直前の処理単位の最後）をかけて比べる
+	float busGains[kBusCount];
+	for (uint32_t b = 0; b < kBusCount; b++) {
+		busGains[b] = b == 0 ? buses_[0].gain : buses_[b].gain * buses_[0].gain;
+	}
+	auto getVolume = [this, &busGains](uint32_t slot) {
+		return voices_[slot].volume * busGains[static_cast<size_t>(voices_[slot].bus)];
+	};
+
+	// 優先度が高い → 音量が大きい → 今混ぜている（入れ替わりを減らす）→ 枠の番号 の順
+	auto isLouder = [this, &getVolume](uint32_t a, uint32_t b) {
+		const Voice& va = voices_[a];
+		const Voice& vb = voices_[b];
+		if (va.priority != vb.priority) {
+			return va.priority > vb.priority;
+		}
+		float volumeA = getVolume(a);
+		float volumeB = getVolume(b);
+		if (volumeA != volumeB) {
+			return volumeA > volumeB;
+		}
+		if (va.isVirtual != vb.isVirtual) {
+			return !va.isVirtual;
+		}
+		return a < b;
+	};
+	uint32_t realCount = activeCount;
+	if (activeCount > kMaxRealVoices) {
+		std::nth_element(
+		    activeSlots_.begin(), activeSlots_.begin() + kMaxRealVoices,
+		    activeSlots_.begin() + activeCount, isLouder);
+		realCount = kMaxRealVoices;
+	}
+	// 聞こえない音は混ぜない（後ろに回す）
+	for (uint32_t i = 0; i < realCount;) {
+		if (getVolume(activeSlots_[i]) < kInaudibleVolume) {
+			std::swap(activeSlots_[i], activeSlots_[--realCount]);
+		} else {
+			i++;
+		}
+	}
+	return realCount;
+}
+
+uint32_t AudioMixer::FetchFrames(Voice& voice, float* output, uint32_t frames) {
+	uint32_t fetched = 0;
+	while (fetched < frames && !voice.sourceEnded) {
+		const uint8_t* source = nullptr;
+		uint32_t available = 0;
+		if (voice.stream) {
+			// ストリームはブロックを読み足す
+			if (voice.blockPosition >= voice.block.size) {
+				voice.block = voice.stream->ReadBlock();
+				voice.blockPosition = 0;
+				if (voice.block.size == 0) {
+					voice.sourceEnded = true;
+					break;
+				}
+			}
+			source = voice.block.data + voice.blockPosition;
+			available = (voice.block.size - voice.blockPosition) / voice.format.blockAlign;
+		} else {
+			if (voice.position >= voice.frameCount) {
+				if (!voice.loop) {
+					voice.sourceEnded = true;
+					break;
+				}
+				voice.position = 0;
+			}
+			source = voice.data + static_cast<size_t>(voice.position) * voice.format.blockAlign;
+			available = voice.frameCount - voice.position;
+		}
+
+		uint32_t count = std::min(frames - fetched, available);
+		if (output) {
+			voice.convert(source, voice.format, count, output + fetched * kChannels);
+		}
+		fetched += count;
+		if (voice.stream) {
+			voice.blockPosition += count * voice.format.blockAlign;
+		} else {
+			voice.position += count;
+		}
+	}
+	// 最後まで読んだ後は無音
+	if (output) {
+		std::fill(output + fetched * kChannels, output + frames * kChannels, 0.0f);
+	}
+	return fetched;
+}
+
+bool AudioMixer::UpdateFade(Voice& voice, uint32_t frames) {
+	if (voice.fadeStep == 0.0f) {
+		return true;
+	}
+	// 処理単位の最後の音量まで進める（処理単位の中は RenderVoice が直線的に変える）
+	float delta = voice.fadeStep * frames;
+	if (std::abs(voice.fadeTarget - voice.volume) > std::abs(delta)) {
+		voice.volume += delta;
+		return true;
+	}
+	voice.volume = voice.fadeTarget;
+	voice.fadeStep = 0.0f;
+	return !voice.stopAfterFade;
+}
+
+bool AudioMixer::RenderVoice(Voice& voice, uint32_t frames, bool fadeOut) {
+	float* source = sourceBuffer_.data();
+	uint32_t windowSize = voice.taps * kChannels;
+	if (!voice.started) {
+		// 最初のフレームを窓の中央に置く（その前は無音）
+		uint32_t center = voice.taps / 2 - 1;
+		std::fill_n(voice.window, center * kChannels, 0.0f);
+		FetchFrames(voice, voice.window + center * kChannels, voice.taps - center);
+		voice.started = true;
+	}
+
+	// 出力 frames フレームぶん進んだ位置までの音源を、前の窓に続けて読む
+	uint64_t end = voice.fraction + voice.step * frames;
+	uint32_t whole = static_cast<uint32_t>(end >> 32);
+	std::copy_n(voice.window, windowSize, source);
+	FetchFrames(voice, source + windowSize, whole);
+
+	float* output = voiceBuffer_.data();
+	if (voice.step == kFixedOne && voice.fraction == 0) {
+		// 同じ周波数は窓の中央からそのまま
+		std::copy_n(source + (voice.taps / 2 - 1) * kChannels, frames * kChannels, output);
+	} else if (voice.filter) {
+		voice.filter->Resample(source, voice.fraction, voice.step, frames, output);
+	} else {
+		ResampleLinear(source, voice.fraction, voice.step, frames, output);
+	}
+	std::copy_n(source + whole * kChannels, windowSize, voice.window);
+	voice.fraction = end & (kFixedOne - 1);
+
+	// 前の倍率から今の倍率へ変えながら足す
+	float gain[kChannels] = {};
+	if (!fadeOut) {
+		ComputeGain(voice.volume, voice.pan, gain);
+	}
+	float* bus = mixBuffer_.data() + static_cast<size_t>(voice.bus) * kMaxRenderFrames * kChannels;
+	MixAdd(bus, output, frames, voice.gain, gain);
+	std::copy_n(gain, kChannels, voice.gain);
+
+	// 音源を読み切ったら、この処理単位で鳴り終わる
+	return !voice.sourceEnded;
+}
+
+bool AudioMixer::AdvanceVirtualVoice(Voice& voice, uint32_t frames) {
+	// 混ぜたときと同じだけ音源を読み飛ばす（窓は戻るときに読み直す）
+	uint64_t end = voice.fraction + voice.step * frames;
+	FetchFrames(voice, nullptr, static_cast<uint32_t>(end >> 32));
+	voice.fraction = end & (kFixedOne - 1);
+	return !voice.sourceEnded;
+}
+
+void AudioMixer::MixBuses(uint32_t frames) {
+	for (uint32_t b = 0; b < kBusCount; b++) {
+		// きっかけのバスで鳴っている間は絞り、鳴り止んだら戻す
+		Bus& bus = buses_[b];
+		bool isTriggered = buses_[static_cast<size_t>(bus.trigger)].voiceCount > 0;
+		float duckTarget = isTriggered ? bus.duckGain : 1.0f;
+		if (bus.duck > duckTarget) {
+			bus.duck = std::max(duckTarget, bus.duck - bus.attackStep * frames);
+		} else {
+			bus.duck = std::min(duckTarget, bus.duck + bus.releaseStep * frames);
+		}
+		float gain = bus.mute ? 0.0f : bus.volume * bus.duck;
+
+		// Master の倍率はリミッターでかける
+		if (b != 0 && (gain != 0.0f || bus.gain != 0.0f)) {
+			const float begin[kChannels] = {bus.gain, bus.gain};
+			const float end[kChannels] = {gain, gain};
+			MixAdd(
+			    mixBuffer_.data(), mixBuffer_.data() + b * kMaxRenderFrames * kChannels, frames,
+			    begin, end);
+		}
+		bus.gain = gain;
+	}
+}
+
+void AudioMixer::ApplyLimiter(float* output, uint32_t frames, float masterBegin, float masterEnd) {
+	// 全体の音量をかけたときの最大が閾値を超えないように倍率を下げる（すぐ下げて、ゆっくり戻す）
+	float master = std::max(masterBegin, masterEnd);
+	float peak = PeakAbs(mixBuffer_.data(), frames * kChannels) * master;
+	float target = peak > kLimiterThreshold ? kLimiterThreshold / peak : 1.0f;
+	float previous = limiterGain_.load(std::memory_order_relaxed);
+	float gain = target < previous ? target : previous + (target - previous) * kLimiterRelease;
+	ScaleAndClip(mixBuffer_.data(), output, frames, previous * masterBegin, gain * masterEnd);
+	limiterGain_.store(gain, std::memory_order_relaxed);
+}
+
+const char* GetMixerKernelName() {
+#if defined(MIXER_KERNEL_AVX)
+	return "AVX";
+#elif defined(MIXER_KERNEL_SSE2)
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
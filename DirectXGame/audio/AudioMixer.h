@@ -0,0 +1,341 @@
+#pragma once
+
+#include "Resampler.h"
+#include "SpscQueue.h"
+#include "WaveFile.h"
+#include "WaveStream.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// ミキサーのバス（Master 以外のバスは Master に混ざる）
+/// </summary>
+enum class AudioBus : uint8_t {
+	Master,
+	BGM,
+	SE,
+	UI,
+	Count,
+};
+
+/// <summary>
+/// ソフトウェアミキサー
+/// 再生中の全ての音を出力の周波数に変換（窓付き sinc か線形補間）して、1本のステレオの float に混ぜる。
+/// 音ごとの音量・パンは処理単位の中で直線的に変えるので、途中で変えてもノイズが出ない。
+/// 音はバスごとに混ぜてから、バスの音量・ミュート・ダッキング（他のバスが鳴っている間だけ
+/// 絞る）をかけて Master に足す。最後にリミッターで音量を抑え、[-1, 1] に切り詰める。
+/// 出力先（XAudio2・無音・ファイル）は AudioOutput が Render を呼んで引き出す。
+/// ゲームのスレッドと出力先のスレッドはロックを取り合わない。再生・停止などは命令のキューで
+/// Render に渡し、鳴り終わった音は終了のキューでゲームのスレッドに返す。
+/// 音の枠は kMaxVoices 個を最初から持っておき、再生ハンドルから枠を直接引く。
+/// 実際に混ぜるのは優先度・音量の高い kMaxRealVoices 個までで、残りは混ぜずに再生位置だけ進める
+/// （仮想の音）。枠が埋まっていたら、優先度・音量の低い音から奪う。
+/// </summary>
+class AudioMixer {
+public: // 定数
+	// 出力のチャンネル数（ステレオ）
+	static const uint32_t kChannels = 2;
+	// 同時に再生できる数（仮想の音を含む）
+	static const uint32_t kMaxVoices = 128;
+	// 実際に混ぜる数の上限
+	static const uint32_t kMaxRealVoices = 32;
+	// 1回にまとめて処理するフレーム数
+	static const uint32_t kMaxRenderFrames = 256;
+	// 音の周波数 / 出力の周波数 の上限
+	static const uint32_t kMaxPitch = SincFilter::kMaxRatio;
+	// 出力より高い周波数の音のために作るフィルターの数
+	static const uint32_t kMaxDownsampleFilters = 4;
+	// Render までに溜めておける命令の数
+	static const uint32_t kMaxCommands = 512;
+	// 鳴り終わりの知らせを溜めておける数（ゲームのスレッドが受け取るまで）
+	static const uint32_t kMaxFinishedVoices = kMaxCommands * 2;
+	// バスの数
+	static const uint32_t kBusCount = static_cast<uint32_t>(AudioBus::Count);
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（出力先が Render を呼んでいない間に呼ぶ）
+	/// </summary>
+	/// <param name="sampleRate">出力の周波数</param>
+	void Initialize(uint32_t sampleRate = 48000);
+
+	/// <summary>
+	/// 再生（ゲームのスレッドから呼ぶ）
+	/// </summary>
+	/// <param name="sound">音（再生が終わるまで中身を保持しておく）</param>
+	/// <param name="loop">ループするか</param>
+	/// <param name="volume">音量（0で無音、1がそのまま）</param>
+	/// <param name="pan">パン（-1で左だけ、0で中央、1で右だけ）</param>
+	/// <param name="priority">優先度（大きいほど混ぜる音に選ばれ、奪われにくい）</param>
+	/// <param name="bus">混ぜるバス</param>
+	/// <returns>再生ハンドル（鳴らせなければ0）</returns>
+	uint32_t Play(
+	    const WaveView& sound, bool loop = false, float volume = 1.0f, float pan = 0.0f,
+	    uint32_t priority = 0, AudioBus bus = AudioBus::Master);
+
+	/// <summary>
+	/// ストリーミング再生（ゲームのスレッドから呼ぶ）
+	/// ブロックは出力先のスレッドで読み足す。ループするかは開いたときに決まる。
+	/// </summary>
+	/// <param name="stream">開いたストリーム（IsPlaying が false になるまで他で使わない）</param>
+	/// <returns>再生ハンドル（鳴らせなければ0）</returns>
+	uint32_t PlayStream(
+	    WaveStream* stream, float volume = 1.0f, float pan = 0.0f, uint32_t priority = 0,
+	    AudioBus bus = AudioBus::Master);
+
+	/// <summary>
+	/// 停止（次の Render で止まる。音源を手放してよいのは IsPlaying が false になってから）
+	/// </summary>
+	void Stop(uint32_t voiceHandle);
+
+	/// <summary>
+	/// 全て停止
+	/// </summary>
+	void StopAll();
+
+	/// <summary>
+	/// 再生中かどうか（鳴り終わりを出力先から受け取るまでは true）
+	/// </summary>
+	bool IsPlaying(uint32_t voiceHandle);
+
+	/// <summary>
+	/// 音量設定
+	/// </summary>
+	void SetVolume(uint32_t voiceHandle, float volume);
+
+	/// <summary>
+	/// 音量を時間をかけて変える
+	/// </summary>
+	/// <param name="volume">変えた後の音量</param>
+	/// <param name="seconds">かける秒数</param>
+	void FadeVolume(uint32_t voiceHandle, float volume, float seconds);
+
+	/// <summary>
+	/// 時間をかけて音量を0にしてから停止
+	/// </summary>
+	/// <param name="seconds">かける秒数</param>
+	void FadeOutAndStop(uint32_t voiceHandle, float seconds);
+
+	/// <summary>
+	/// パン設定
+	/// </summary>
+	void SetPan(uint32_t voiceHandle, float pan);
+
+	/// <summary>
+	/// 全体の音量設定（Master のバスの音量）
+	/// </summary>
+	void SetMasterVolume(float volume) { SetBusVolume(AudioBus::Master, volume); }
+
+	/// <summary>
+	/// バスの音量設定
+	/// </summary>
+	void SetBusVolume(AudioBus bus, float volume);
+
+	/// <summary>
+	/// バスのミュート設定
+	/// </summary>
+	void SetBusMute(AudioBus bus, bool mute);
+
+	/// <summary>
+	/// ダッキングの設定（trigger のバスで音が鳴っている間、bus を絞る）
+	/// </summary>
+	/// <param name="bus">絞るバス</param>
+	/// <param name="trigger">鳴っていたら絞るきっかけにするバス</param>
+	/// <param name="gain">絞ったときの倍率（1でダッキングしない）</param>
+	/// <param name="attackSeconds">絞りきるまでの秒数</param>
+	/// <param name="releaseSeconds">鳴り止んでから戻りきるまでの秒数</param>
+	void SetDucking(
+	    AudioBus bus, AudioBus trigger, float gain, float attackSeconds, float releaseSeconds);
+
+	/// <summary>
+	/// 周波数変換の品質設定（この後に再生した音から変わる）
+	/// </summary>
+	void SetResampleQuality(ResampleQuality quality) { resampleQuality_ = quality; }
+
+	/// <summary>
+	/// 混ぜた音の書き出し（出力先のスレッドから呼ぶ）
+	/// </summary>
+	/// <param name="output">書き出し先（左右交互に frames * kChannels 個）</param>
+	/// <param name="frames">フレーム数</param>
+	void Render(float* output, uint32_t frames);
+
+	uint32_t GetSampleRate() const { return sampleRate_; }
+	// 再生中の数
+	uint32_t GetPlayingVoiceCount();
+	// 命令のキューが溢れて捨てた命令の数
+	uint32_t GetDroppedCommandCount() const { return droppedCommandCount_; }
+	// 枠が埋まっていて他の音から奪った数
+	uint32_t GetStolenVoiceCount() const { return stolenVoiceCount_; }
+	// 直前の Render で混ぜた音の数
+	uint32_t GetRealVoiceCount() const { return realVoiceCount_.load(std::memory_order_relaxed); }
+	// 直前の Render で混ぜずに進めた音の数
+	uint32_t GetVirtualVoiceCount() const {
+		return virtualVoiceCount_.load(std::memory_order_relaxed);
+	}
+	// リミッターが今かけている倍率（1で抑えていない）
+	float GetLimiterGain() const { return limiterGain_.load(std::memory_order_relaxed); }
+
+private: // サブクラス
+	// 再生中の音（出力先のスレッドだけが触る）
+	struct Voice {
+		uint32_t handle = 0; // 0は空き
+
+		// 音源（メモリ上の音か、ストリーム）
+		WaveFormat format;
+		SampleConvertFunction convert = nullptr; // 再生の開始で音の形式から選ぶ
+		const uint8_t* data = nullptr;
+		uint32_t frameCount = 0;
+		uint32_t position = 0; // 次に読むフレーム
+		bool loop = false;
+		WaveStream* stream = nullptr;
+		WaveStream::Block block;    // 読んでいるブロック
+		uint32_t blockPosition = 0; // ブロック内の次に読む位置（バイト）
+		bool sourceEnded = false;   // 音源を最後まで読んだ
+
+		// 周波数の変換（32.32 の固定小数点）
+		const SincFilter* filter = nullptr; // nullptr なら線形補間
+		uint32_t taps = 2;                  // 窓のフレーム数
+		uint64_t step = 0;                  // 出力1フレームで進む音源のフレーム数
+		uint64_t fraction = 0;              // 窓の中央のフレームから次のフレームまでの位置
+		bool started = false;               // 窓を読んだか
+		float window[SincFilter::kMaxTaps * kChannels]; // 次に変換する位置の前後の音源
+
+		// 音量
+		float volume = 1.0f;
+		float pan = 0.0f;
+		float gain[kChannels];     // 前の処理単位の最後にかけた倍率
+		uint32_t priority = 0;
+		bool isVirtual = false;    // 混ぜずに再生位置だけ進めている
+		AudioBus bus = AudioBus::Master;
+
+		// 音量を時間をかけて変える
+		float fadeTarget = 0.0f;
+		float fadeStep = 0.0f;      // 1フレームで変える量（0なら変えていない）
+		bool stopAfterFade = false; // 変え終わったら止める
+	};
+
+	// バス（出力先のスレッドだけが触る）
+	struct Bus {
+		float volume = 1.0f;
+		bool mute = false;
+		// ダッキング
+		AudioBus trigger = AudioBus::Master;
+		float duckGain = 1.0f;    // 絞ったときの倍率
+		float attackStep = 0.0f;  // 1フレームで絞る量
+		float releaseStep = 0.0f; // 1フレームで戻す量
+		float duck = 1.0f;        // 今の絞り具合
+		float gain = 1.0f;        // 前の処理単位の最後にかけた倍率
+		uint32_t voiceCount = 0;  // この処理単位で鳴っている音の数
+	};
+
+	// 命令の種類
+	enum class CommandType : uint8_t {
+		Play,
+		Stop,
+		StopAll,
+		SetVolume,
+		SetPan,
+		SetBusVolume,
+		SetBusMute,
+		SetDucking,
+	};
+
+	// ゲームのスレッドから出力先のスレッドへの命令
+	struct Command {
+		CommandType type = CommandType::Stop;
+		uint32_t handle = 0;
+		float volume = 0.0f;
+		float pan = 0.0f;
+		AudioBus bus = AudioBus::Master; // 再生・バスの命令
+		// 音量を変える命令（fadeFrames が0ならすぐ変える）
+		uint32_t fadeFrames = 0;
+		bool stopAfterFade = false;
+		// ダッキングの命令
+		AudioBus trigger = AudioBus::Master;
+		uint32_t attackFrames = 0;
+		uint32_t releaseFrames = 0;
+		// バスを消す命令
+		bool mute = false;
+		// 再生の命令だけ使う
+		uint32_t priority = 0;
+		const SincFilter* filter = nullptr;
+		WaveFormat format;
+		const uint8_t* data = nullptr;
+		uint32_t frameCount = 0;
+		bool loop = false;
+		WaveStream* stream = nullptr;
+	};
+
+private: // メンバ関数
+	// ゲームのスレッド
+	uint32_t StartVoice(Command& command); // 枠を取って再生の命令を積む
+	bool PushCommand(const Command& command); // 溢れたら数えて false
+	void PushFade(uint32_t voiceHandle, float volume, float seconds, bool stopAfterFade);
+	void CollectFinishedVoices(); // 鳴り終わった枠を空きに戻す
+	uint32_t FindVictimSlot(uint32_t priority, float volume) const; // 奪う枠（なければ kMaxVoices）
+	const SincFilter* FindFilter(uint32_t sourceRate); // 周波数に合うフィルター（線形補間なら nullptr）
+
+	// 出力先のスレッド
+	void ExecuteCommand(const Command& command);
+	void FinishVoice(Voice& voice); // 枠を空けてゲームのスレッドに知らせる
+	// 再生中の枠を activeSlots_ に並べ、混ぜる音を先頭に集めてその数を返す
+	uint32_t SelectRealVoices(uint32_t& activeCount);
+	// 音源を float に変換して読む（output が nullptr なら読み飛ばす）
+	uint32_t FetchFrames(Voice& voice, float* output, uint32_t frames);
+	// 音量を時間をかけて変える。変え終わって止めるなら false
+	bool UpdateFade(Voice& voice, uint32_t frames);
+	// 1つの音をバスに足す（fadeOut なら倍率を0へ絞る）。鳴り終えたら false
+	bool RenderVoice(Voice& voice, uint32_t frames, bool fadeOut);
+	void MixBuses(uint32_t frames); // バスにダッキングと音量をかけて Master に足す
+	bool AdvanceVirtualVoice(Voice& voice, uint32_t frames); // 混ぜずに進める。鳴り終えたら false
+	// リミッターと切り詰め（Master のバスの倍率を masterBegin から masterEnd へ変えながらかける）
+	void ApplyLimiter(float* output, uint32_t frames, float masterBegin, float masterEnd);
+
+private: // メンバ変数
+	uint32_t sampleRate_ = 48000;
+
+	// ゲームのスレッドの持ち物
+	std::array<uint32_t, kMaxVoices> slotHandles_ = {}; // 枠ごとの再生ハンドル（0は空き）
+	std::array<uint32_t, kMaxVoices> generations_ = {}; // 枠ごとの使った回数
+	std::array<uint32_t, kMaxVoices> freeSlots_ = {};   // 空いている枠
+	uint32_t freeSlotCount_ = 0;
+	// 奪う枠を選ぶための、枠ごとの優先度・音量・再生した順
+	std::array<uint32_t, kMaxVoices> slotPriorities_ = {};
+	std::array<float, kMaxVoices> slotVolumes_ = {};
+	std::array<uint32_t, kMaxVoices> slotPlayOrders_ = {};
+	uint32_t playCount_ = 0;
+	uint32_t droppedCommandCount_ = 0;
+	uint32_t stolenVoiceCount_ = 0;
+	ResampleQuality resampleQuality_ = ResampleQuality::Sinc;
+	// 周波数変換のフィルター（作った後は出力先のスレッドも読む）
+	SincFilter upsampleFilter_;
+	std::array<SincFilter, kMaxDownsampleFilters> downsampleFilters_;
+	std::array<uint32_t, kMaxDownsampleFilters> downsampleRates_ = {};
+	uint32_t downsampleFilterCount_ = 0;
+
+	// スレッドの間
+	SpscQueue<Command, kMaxCommands> commands_; // ゲーム → 出力先
+	// 出力先 → ゲーム（鳴り終わったハンドル）
+	SpscQueue<uint32_t, kMaxFinishedVoices> finishedVoices_;
+	std::atomic<float> limiterGain_ = 1.0f;
+	std::atomic<uint32_t> realVoiceCount_ = 0;
+	std::atomic<uint32_t> virtualVoiceCount_ = 0;
+
+	// 出力先のスレッドの持ち物
+	std::array<Voice, kMaxVoices> voices_;
+	std::array<uint32_t, kMaxVoices> activeSlots_ = {}; // 再生中の枠（先頭が混ぜる音）
+	std::array<Bus, kBusCount> buses_;
+
+	// 作業用（初期化で確保する）
+	std::vector<float> mixBuffer_;    // バスごとに混ぜた音（Master が先頭）
+	std::vector<float> voiceBuffer_;  // 1つの音の周波数変換後
+	std::vector<float> sourceBuffer_; // 1つの音の変換前
+};
+
+/// <summary>
+/// ミキサーで使っている命令セットの取得
+/// </summary>
+/// <returns>"AVX", "SSE2", "Scalar" のいずれか</returns>
+const char* GetMixerKernelName();
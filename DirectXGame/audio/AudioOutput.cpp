@@ -0,0 +1,105 @@
+#include "AudioOutput.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// FNV-1a
+const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+} // namespace
+
+bool NullAudioOutput::Start(AudioMixer* mixer) {
+	assert(mixer);
+	mixer_ = mixer;
+	buffer_.assign(AudioMixer::kMaxRenderFrames * AudioMixer::kChannels, 0.0f);
+	samples_.assign(AudioMixer::kMaxRenderFrames * AudioMixer::kChannels, 0);
+	renderedFrames_ = 0;
+	peak_ = 0.0f;
+	checksum_ = kFnvOffsetBasis;
+	return true;
+}
+
+void NullAudioOutput::Stop() { mixer_ = nullptr; }
+
+void NullAudioOutput::Render(uint32_t frames) {
+	if (!mixer_) {
+		return;
+	}
+	while (frames > 0) {
+		uint32_t chunk =
+		    frames < AudioMixer::kMaxRenderFrames ? frames : AudioMixer::kMaxRenderFrames;
+		mixer_->Render(buffer_.data(), chunk);
+		for (uint32_t i = 0; i < chunk * AudioMixer::kChannels; i++) {
+			peak_ = std::max(peak_, std::abs(buffer_[i]));
+			samples_[i] = static_cast<int16_t>(std::lround(buffer_[i] * 32767.0f));
+			uint16_t sample = static_cast<uint16_t>(samples_[i]);
+			checksum_ = (checksum_ ^ (sample & 0xff)) * kFnvPrime;
+			checksum_ = (checksum_ ^ (sample >> 8)) * kFnvPrime;
+		}
+		OnRendered(samples_.data(), chunk);
+		renderedFrames_ += chunk;
+		frames -= chunk;
+	}
+}
+
+void NullAudioOutput::OnRendered(const int16_t*, uint32_t) {}
+
+bool WaveFileAudioOutput::Open(const std::string& fileName) {
+	file_.open(fileName, std::ios::binary);
+	dataSize_ = 0;
+	return static_cast<bool>(file_);
+}
+
+bool WaveFileAudioOutput::Start(AudioMixer* mixer) {
+	if (!file_.is_open() || !NullAudioOutput::Start(mixer)) {
+		return false;
+	}
+	// 大きさは止めるときに書き直す
+	sampleRate_ = mixer->GetSampleRate();
+	WriteHeader(0);
+	return true;
+}
+
+void WaveFileAudioOutput::Stop() {
+	NullAudioOutput::Stop();
+	if (file_.is_open()) {
+		// 大きさが決まったのでヘッダを書き直す
+		file_.seekp(0);
+		WriteHeader(dataSize_);
+		file_.close();
+	}
+}
+
+void WaveFileAudioOutput::OnRendered(const int16_t* samples, uint32_t frames) {
+	if (!file_.is_open()) {
+		return;
+	}
+	uint32_t size = frames * AudioMixer::kChannels * sizeof(int16_t);
+	file_.write(reinterpret_cast<const char*>(samples), size);
+	dataSize_ += size;
+}
+
+void WaveFileAudioOutput::WriteHeader(uint32_t dataSize) {
+	auto writeU32 = [this](uint32_t value) {
+		file_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+	auto writeU16 = [this](uint16_t value) {
+		file_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+	const uint16_t blockAlign = AudioMixer::kChannels * sizeof(int16_t);
+	file_.write("RIFF", 4);
+	writeU32(36 + dataSize);
+	file_.write("WAVEfmt ", 8);
+	writeU32(16);
+	writeU16(kWaveFormatPCM);
+	writeU16(AudioMixer::kChannels);
+	writeU32(sampleRate_);
+	writeU32(sampleRate_ * blockAlign);
+	writeU16(blockAlign);
+	writeU16(16);
+	file_.write("data", 4);
+	writeU32(dataSize);
+}
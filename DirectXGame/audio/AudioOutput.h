@@ -0,0 +1,95 @@
+#pragma once
+
+#include "AudioMixer.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// ミキサーの出力先
+/// </summary>
+class AudioOutput {
+public:
+	virtual ~AudioOutput() = default;
+
+	/// <summary>
+	/// 出力の開始（ミキサーから引き出し始める）
+	/// </summary>
+	/// <param name="mixer">ミキサー（停止するまで保持しておく）</param>
+	/// <returns>開始できたか</returns>
+	virtual bool Start(AudioMixer* mixer) = 0;
+
+	/// <summary>
+	/// 出力の停止（戻ったときにはミキサーを呼んでいない）
+	/// </summary>
+	virtual void Stop() = 0;
+};
+
+/// <summary>
+/// 無音の出力（ヘッドレス・テスト用）
+/// 呼ばれたぶんだけその場でミキサーから引き出し、大きさの最大とチェックサムだけ残す。
+/// </summary>
+class NullAudioOutput : public AudioOutput {
+public: // メンバ関数
+	bool Start(AudioMixer* mixer) override;
+	void Stop() override;
+
+	/// <summary>
+	/// 引き出す
+	/// </summary>
+	/// <param name="frames">フレーム数</param>
+	void Render(uint32_t frames);
+
+	// 引き出したフレーム数
+	uint64_t GetRenderedFrames() const { return renderedFrames_; }
+	// 大きさの最大
+	float GetPeak() const { return peak_; }
+	// 16ビットに丸めた出力のチェックサム（FNV-1a）
+	uint64_t GetChecksum() const { return checksum_; }
+
+protected: // メンバ関数
+	/// <summary>
+	/// 引き出した音を受け取る（16ビットに丸めたもの）
+	/// </summary>
+	virtual void OnRendered(const int16_t* samples, uint32_t frames);
+
+private: // メンバ変数
+	AudioMixer* mixer_ = nullptr;
+	std::vector<float> buffer_;
+	std::vector<int16_t> samples_;
+	uint64_t renderedFrames_ = 0;
+	float peak_ = 0.0f;
+	uint64_t checksum_ = 0;
+};
+
+/// <summary>
+/// WAVファイルへの出力（16ビットのステレオ）
+/// </summary>
+class WaveFileAudioOutput : public NullAudioOutput {
+public: // メンバ関数
+	/// <summary>
+	/// 書き出すファイルを開く（Start の前に呼ぶ）
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>開けたか</returns>
+	bool Open(const std::string& fileName);
+
+	bool Start(AudioMixer* mixer) override;
+
+	/// <summary>
+	/// 出力の停止（ヘッダの大きさを書いて閉じる）
+	/// </summary>
+	void Stop() override;
+
+protected: // メンバ関数
+	void OnRendered(const int16_t* samples, uint32_t frames) override;
+
+private: // メンバ関数
+	void WriteHeader(uint32_t dataSize); // RIFF・fmt・data チャンクのヘッダ
+
+private: // メンバ変数
+	std::ofstream file_;
+	uint32_t sampleRate_ = 0;
+	uint32_t dataSize_ = 0;
+};
@@ -0,0 +1,134 @@
+#include "ImaAdpcm.h"
+#include <algorithm>
+
+namespace {
+
+// チャンネルごとのブロックのヘッダのバイト数
+const uint32_t kHeaderSize = 4;
+// ヘッダの後にチャンネルごとに並べるバイト数（8サンプル）
+const uint32_t kGroupSize = 4;
+const uint32_t kSamplesPerGroup = kGroupSize * 2;
+// 展開できるチャンネル数の上限
+const uint32_t kMaxChannels = 8;
+
+// 4ビットの値ごとのステップの番号の増減
+const int32_t kIndexTable[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+// ステップの大きさ
+const int32_t kStepTable[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+// ステップの番号と4ビットの値から、予測値に足す差と次のステップの番号を引く表
+// （1サンプルごとの計算が表を1回引くだけになり、展開が速くなる）
+struct DecodeTable {
+	int32_t diffs[89 * 16];
+	uint8_t nextIndices[89 * 16];
+
+	DecodeTable() {
+		for (int32_t index = 0; index < 89; index++) {
+			int32_t step = kStepTable[index];
+			for (int32_t nibble = 0; nibble < 16; nibble++) {
+				// 規格の通りにビットごとに切り捨てて足す
+				int32_t diff = step >> 3;
+				if (nibble & 1) {
+					diff += step >> 2;
+				}
+				if (nibble & 2) {
+					diff += step >> 1;
+				}
+				if (nibble & 4) {
+					diff += step;
+				}
+				diffs[index * 16 + nibble] = nibble & 8 ? -diff : diff;
+				nextIndices[index * 16 + nibble] =
+				    static_cast<uint8_t>(std::clamp(index + kIndexTable[nibble], 0, 88));
+			}
+		}
+	}
+};
+const DecodeTable kDecodeTable;
+
+// 1チャンネルの展開の途中の状態
+struct ChannelState {
+	int32_t predictor;
+	int32_t index;
+};
+
+// 4ビットの値を1サンプルに
+inline int16_t DecodeNibble(ChannelState& state, uint32_t nibble) {
+	uint32_t entry = state.index * 16 + nibble;
+	state.predictor = std::clamp(state.predictor + kDecodeTable.diffs[entry], -32768, 32767);
+	state.index = kDecodeTable.nextIndices[entry];
+	return static_cast<int16_t>(state.predictor);
+}
+
+} // namespace
+
+uint32_t GetImaAdpcmBlockFrames(const WaveFormat& format, uint32_t blockSize) {
+	if (format.channels == 0 || format.channels > kMaxChannels) {
+		return 0;
+	}
+	uint32_t headerSize = kHeaderSize * format.channels;
+	if (blockSize < headerSize) {
+		return 0;
+	}
+	// ヘッダの最初のサンプルと、チャンネルごとに揃ったグループのサンプル
+	uint32_t groups = (blockSize - headerSize) / (kGroupSize * format.channels);
+	return 1 + groups * kSamplesPerGroup;
+}
+
+uint32_t GetImaAdpcmFrameCount(const WaveFormat& format, uint32_t dataSize) {
+	uint32_t blocks = dataSize / format.blockAlign;
+	uint32_t rest = dataSize % format.blockAlign;
+	return blocks * GetImaAdpcmBlockFrames(format, format.blockAlign) +
+	       GetImaAdpcmBlockFrames(format, rest);
+}
+
+WaveFormat GetImaAdpcmDecodedFormat(const WaveFormat& format) {
+	WaveFormat decoded = format;
+	decoded.formatTag = kWaveFormatPCM;
+	decoded.bitsPerSample = 16;
+	decoded.blockAlign = static_cast<uint16_t>(format.channels * sizeof(int16_t));
+	decoded.avgBytesPerSec = format.samplesPerSec * decoded.blockAlign;
+	return decoded;
+}
+
+uint32_t DecodeImaAdpcmBlock(
+    const uint8_t* block, uint32_t blockSize, const WaveFormat& format, int16_t* output) {
+	uint32_t frames = GetImaAdpcmBlockFrames(format, blockSize);
+	if (frames == 0) {
+		return 0;
+	}
+	uint32_t channels = format.channels;
+	ChannelState states[kMaxChannels];
+	for (uint32_t c = 0; c < channels; c++) {
+		// ヘッダ：最初のサンプル・ステップの番号・予約
+		const uint8_t* header = block + c * kHeaderSize;
+		states[c].predictor = static_cast<int16_t>(header[0] | header[1] << 8);
+		states[c].index = std::min<int32_t>(header[2], 88);
+		output[c] = static_cast<int16_t>(states[c].predictor);
+	}
+
+	// グループを順に、チャンネルごとに下位の4ビットから展開する
+	// （チャンネルの間は依存しないので、同じループに並べて重ねて計算させる）
+	const uint8_t* data = block + kHeaderSize * channels;
+	for (uint32_t sample = 1; sample < frames; sample += kSamplesPerGroup) {
+		int16_t* group = output + sample * channels;
+		for (uint32_t c = 0; c < channels; c++) {
+			int16_t* out = group + c;
+			for (uint32_t i = 0; i < kGroupSize; i++) {
+				out[0] = DecodeNibble(states[c], data[i] & 0x0F);
+				out[channels] = DecodeNibble(states[c], data[i] >> 4);
+				out += channels * 2;
+			}
+			data += kGroupSize;
+		}
+	}
+	return frames;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "WaveFile.h"
+#include <cstdint>
+
+/// <summary>
+/// IMA ADPCM の1ブロックのフレーム数
+/// ブロックはチャンネルごとの4バイトのヘッダ（最初のサンプル・ステップの番号）に続いて、
+/// チャンネルごとに4バイト（8サンプル）ずつ交互に並ぶ。
+/// </summary>
+/// <param name="format">IMA ADPCM の形式</param>
+/// <param name="blockSize">ブロックのバイト数（最後のブロックは blockAlign より短いことがある）</param>
+/// <returns>フレーム数（ヘッダに足りなければ0）</returns>
+uint32_t GetImaAdpcmBlockFrames(const WaveFormat& format, uint32_t blockSize);
+
+/// <summary>
+/// IMA ADPCM の data チャンク全体のフレーム数
+/// </summary>
+uint32_t GetImaAdpcmFrameCount(const WaveFormat& format, uint32_t dataSize);
+
+/// <summary>
+/// 展開した形式（同じチャンネル数・周波数の16ビットのPCM）
+/// </summary>
+WaveFormat GetImaAdpcmDecodedFormat(const WaveFormat& format);
+
+/// <summary>
+/// 1ブロックの展開
+/// </summary>
+/// <param name="block">ブロック</param>
+/// <param name="blockSize">ブロックのバイト数</param>
+/// <param name="format">IMA ADPCM の形式</param>
+/// <param name="output">出力（チャンネル交互の16ビット。GetImaAdpcmBlockFrames フレームぶん）</param>
+/// <returns>展開したフレーム数</returns>
+uint32_t DecodeImaAdpcmBlock(
+    const uint8_t* block, uint32_t blockSize, const WaveFormat& format, int16_t* output);
@@ -0,0 +1,333 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RESAMPLER_KERNEL_AVX
+#define RESAMPLER_KERNEL_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLER_KERNEL_SSE2
+#endif
+
+namespace {
+
+// 出力のチャンネル数（ステレオ）
+const uint32_t kChannels = 2;
+// 固定小数点の1
+const uint64_t kFixedOne = 1ull << 32;
+// 位相の番号に使う上位ビットの数（kPhases = 1 << kPhaseBits）
+const uint32_t kPhaseBits = 7;
+static_assert(SincFilter::kPhases == 1u << kPhaseBits, "kPhases must match kPhaseBits");
+const uint32_t kPhaseShift = 32 - kPhaseBits;
+// 通す帯域（音源の周波数の半分に対する割合）。残りは阻止域までの遷移
+const double kCutoff = 0.9;
+// カイザー窓の形（大きいほど阻止域が深く、遷移が広い）
+const double kKaiserBeta = 8.0;
+// 円周率
+const double kPi = 3.14159265358979323846;
+// 1/√2（中央・後ろのスピーカーを左右に分けるときの倍率）
+const float kHalfPower = 0.70710678f;
+
+// スピーカーごとの左右への倍率
+struct Downmix {
+	float left;
+	float right;
+};
+const Downmix kFrontLeft = {1.0f, 0.0f};
+const Downmix kFrontRight = {0.0f, 1.0f};
+const Downmix kCenter = {kHalfPower, kHalfPower};
+const Downmix kLowFrequency = {0.0f, 0.0f};
+const Downmix kLeft = {kHalfPower, 0.0f};
+const Downmix kRight = {0.0f, kHalfPower};
+const Downmix kBackCenter = {0.5f, 0.5f};
+// チャンネル数ごとのWAVEの既定の配置（8より多いときは前の左右だけ使う）
+const Downmix kDownmixes[9][8] = {
+    {},
+    {},
+    {},
+    {kFrontLeft, kFrontRight, kCenter},
+    {kFrontLeft, kFrontRight, kLeft, kRight},
+    {kFrontLeft, kFrontRight, kCenter, kLeft, kRight},
+    {kFrontLeft, kFrontRight, kCenter, kLowFrequency, kLeft, kRight},
+    {kFrontLeft, kFrontRight, kCenter, kLowFrequency, kLeft, kRight, kBackCenter},
+    {kFrontLeft, kFrontRight, kCenter, kLowFrequency, kLeft, kRight, kLeft, kRight},
+};
+const Downmix kFrontOnly[8] = {kFrontLeft, kFrontRight};
+
+// 24ビットの符号付き整数
+int32_t ReadInt24(const uint8_t* p) {
+	return static_cast<int32_t>(
+	           static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 |
+	           static_cast<uint32_t>(p[2]) << 24) >>
+	       8;
+}
+
+// 1チャンネル分のサンプルを float に
+float ReadSample(const uint8_t* p, const WaveFormat& format) {
+	if (format.formatTag == kWaveFormatFloat) {
+		float value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+	switch (format.bitsPerSample) {
+	case 8:
+		return (static_cast<int32_t>(p[0]) - 128) * (1.0f / 128.0f);
+	case 16: {
+		int16_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value * (1.0f / 32768.0f);
+	}
+	case 24:
+		return ReadInt24(p) * (1.0f / 8388608.0f);
+	default: {
+		int32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return static_cast<float>(value) * (1.0f / 2147483648.0f);
+	}
+	}
+}
+
+// PCMをステレオの float に変換
+void ConvertFrames(
+    const uint8_t* source, const WaveFormat& format, uint32_t frames, float* output) {
+	uint32_t bytesPerSample = format.bitsPerSample / 8;
+	if (format.channels <= 2) {
+		for (uint32_t i = 0; i < frames; i++) {
+			const uint8_t* frame = source + static_cast<size_t>(i) * format.blockAlign;
+			float left = ReadSample(frame, format);
+			float right = format.channels == 1 ? left : ReadSample(frame + bytesPerSample, format);
+			output[i * 2 + 0] = left;
+			output[i * 2 + 1] = right;
+		}
+		return;
+	}
+
+	// 3チャンネル以上はスピーカーの配置に合わせて左右に混ぜる
+	const Downmix* downmix = format.channels <= 8 ? kDownmixes[format.channels] : kFrontOnly;
+	uint32_t channels = format.channels <= 8 ? format.channels : 2;
+	for (uint32_t i = 0; i < frames; i++) {
+		const uint8_t* frame = source + static_cast<size_t>(i) * format.blockAlign;
+		float left = 0.0f;
+		float right = 0.0f;
+		for (uint32_t c = 0; c < channels; c++) {
+			float sample = ReadSample(frame + c * bytesPerSample, format);
+			left += sample * downmix[c].left;
+			right += sample * downmix[c].right;
+		}
+		output[i * 2 + 0] = left;
+		output[i * 2 + 1] = right;
+	}
+}
+
+// 16ビットのステレオ（一番多い形式）の変換
+void ConvertPcm16Stereo(
+    const uint8_t* source, const WaveFormat& format, uint32_t frames, float* output) {
+	uint32_t i = 0;
+#if defined(RESAMPLER_KERNEL_SSE2)
+	// 4フレーム(8サンプル)ずつ、上位16ビットに置いてから算術シフトで符号拡張する
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	for (; i + 4 <= frames; i += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		_mm_storeu_ps(output + i * 2, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(output + i * 2 + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#endif
+	ConvertFrames(source + i * 4, format, frames - i, output + i * 2);
+}
+
+// 正規化した sinc
+double Sinc(double x) {
+	if (std::abs(x) < 1e-9) {
+		return 1.0;
+	}
+	return std::sin(kPi * x) / (kPi * x);
+}
+
+// 0次の第1種変形ベッセル関数（級数展開）
+double BesselI0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 64 && term > sum * 1e-17; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// カイザー窓（x は -1 から 1）
+double Kaiser(double x) {
+	if (std::abs(x) >= 1.0) {
+		return 0.0;
+	}
+	return BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) / BesselI0(kKaiserBeta);
+}
+
+} // namespace
+
+SampleConvertFunction GetSampleConverter(const WaveFormat& format) {
+	if (format.formatTag == kWaveFormatPCM && format.bitsPerSample == 16 &&
+	    format.channels == 2) {
+		return ConvertPcm16Stereo;
+	}
+	return ConvertFrames;
+}
+
+void SincFilter::Initialize(uint32_t sourceRate, uint32_t outputRate) {
+	assert(sourceRate > 0 && outputRate > 0);
+	assert(sourceRate <= static_cast<uint64_t>(outputRate) * kMaxRatio);
+	// 出力の方が低いときは、出力の周波数の半分より上を落とす
+	double scale = std::min(1.0, static_cast<double>(outputRate) / sourceRate);
+	double cutoff = kCutoff * scale;
+	// 零点の数を保つようにタップを増やす（4フレームずつ処理するので4の倍数）
+	uint32_t taps = static_cast<uint32_t>(std::ceil(kZeroCrossings * 2 / scale));
+	taps = (taps + 3) / 4 * 4;
+	taps_ = taps < kMaxTaps ? taps : kMaxTaps;
+
+	// 位相ごとの係数（最後の位相の次との差のために1つ多く作る）
+	uint32_t width = taps_ * kChannels;
+	std::vector<double> rows((kPhases + 1) * taps_);
+	double halfWidth = taps_ / 2.0;
+	for (uint32_t p = 0; p <= kPhases; p++) {
+		double* row = rows.data() + p * taps_;
+		double sum = 0.0;
+		for (uint32_t k = 0; k < taps_; k++) {
+			// 窓の中央（taps_ / 2 - 1 フレーム目から位相だけ進んだ位置）からの距離
+			double t = static_cast<double>(k) - (taps_ / 2 - 1) - static_cast<double>(p) / kPhases;
+			row[k] = cutoff * Sinc(cutoff * t) * Kaiser(t / halfWidth);
+			sum += row[k];
+		}
+		// 直流がそのまま通るように揃える
+		for (uint32_t k = 0; k < taps_; k++) {
+			row[k] /= sum;
+		}
+	}
+	coefficients_.assign(kPhases * width, 0.0f);
+	deltas_.assign(kPhases * width, 0.0f);
+	for (uint32_t p = 0; p < kPhases; p++) {
+		for (uint32_t k = 0; k < taps_; k++) {
+			float coefficient = static_cast<float>(rows[p * taps_ + k]);
+			float delta = static_cast<float>(rows[(p + 1) * taps_ + k] - rows[p * taps_ + k]);
+			for (uint32_t c = 0; c < kChannels; c++) {
+				coefficients_[p * width + k * kChannels + c] = coefficient;
+				deltas_[p * width + k * kChannels + c] = delta;
+			}
+		}
+	}
+}
+
+void SincFilter::Resample(
+    const float* source, uint64_t position, uint64_t step, uint32_t frames,
+    float* output) const {
+	const uint32_t width = taps_ * kChannels;
+	for (uint32_t i = 0; i < frames; i++, position += step) {
+		const float* window = source + (position >> 32) * kChannels;
+		uint32_t fraction = static_cast<uint32_t>(position);
+		uint32_t phase = fraction >> kPhaseShift;
+		float t = static_cast<float>(fraction & ((1u << kPhaseShift) - 1)) *
+		          (1.0f / static_cast<float>(1u << kPhaseShift));
+		const float* coefficients = coefficients_.data() + phase * width;
+		const float* deltas = deltas_.data() + phase * width;
+
+		// 係数を位相の間で補間しながら、左右交互のまま掛けて足す
+#if defined(RESAMPLER_KERNEL_AVX)
+		__m256 t8 = _mm256_set1_ps(t);
+		__m256 sum8 = _mm256_setzero_ps();
+		for (uint32_t k = 0; k < width; k += 8) {
+			__m256 c = _mm256_add_ps(
+			    _mm256_loadu_ps(coefficients + k),
+			    _mm256_mul_ps(_mm256_loadu_ps(deltas + k), t8));
+			sum8 = _mm256_add_ps(sum8, _mm256_mul_ps(_mm256_loadu_ps(window + k), c));
+		}
+		__m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		_mm_storel_pi(reinterpret_cast<__m64*>(output + i * 2), sum);
+#elif defined(RESAMPLER_KERNEL_SSE2)
+		__m128 t4 = _mm_set1_ps(t);
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t k = 0; k < width; k += 4) {
+			__m128 c = _mm_add_ps(
+			    _mm_loadu_ps(coefficients + k), _mm_mul_ps(_mm_loadu_ps(deltas + k), t4));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(window + k), c));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		_mm_storel_pi(reinterpret_cast<__m64*>(output + i * 2), sum);
+#else
+		float left = 0.0f;
+		float right = 0.0f;
+		for (uint32_t k = 0; k < width; k += 2) {
+			left += window[k + 0] * (coefficients[k + 0] + deltas[k + 0] * t);
+			right += window[k + 1] * (coefficients[k + 1] + deltas[k + 1] * t);
+		}
+		output[i * 2 + 0] = left;
+		output[i * 2 + 1] = right;
+#endif
+	}
+}
+
+void ResampleLinear(
+    const float* source, uint64_t position, uint64_t step, uint32_t frames, float* output) {
+	for (uint32_t i = 0; i < frames; i++, position += step) {
+		const float* a = source + (position >> 32) * kChannels;
+		const float* b = a + kChannels;
+		float t = static_cast<float>(position & (kFixedOne - 1)) * (1.0f / 4294967296.0f);
+		output[i * 2 + 0] = a[0] + (b[0] - a[0]) * t;
+		output[i * 2 + 1] = a[1] + (b[1] - a[1]) * t;
+	}
+}
+
+bool ConvertSound(
+    const WaveView& sound, uint32_t sampleRate, ResampleQuality quality,
+    std::vector<float>& output) {
+	const WaveFormat& format = sound.format;
+	if (format.formatTag == kWaveFormatImaAdpcm || format.blockAlign == 0 ||
+	    format.samplesPerSec == 0 || sampleRate == 0 ||
+	    format.samplesPerSec > static_cast<uint64_t>(sampleRate) * SincFilter::kMaxRatio) {
+		return false;
+	}
+	uint32_t frames = static_cast<uint32_t>(sound.data.size() / format.blockAlign);
+	SampleConvertFunction convert = GetSampleConverter(format);
+	if (format.samplesPerSec == sampleRate) {
+		output.resize(static_cast<size_t>(frames) * kChannels);
+		convert(sound.data.data(), format, frames, output.data());
+		return true;
+	}
+
+	SincFilter filter;
+	uint32_t taps = 2;
+	if (quality == ResampleQuality::Sinc) {
+		filter.Initialize(format.samplesPerSec, sampleRate);
+		taps = filter.GetTaps();
+	}
+	// 前後を無音で埋め、最初のフレームを窓の中央に置く
+	uint32_t head = taps / 2 - 1;
+	std::vector<float> source((static_cast<size_t>(head) + frames + taps) * kChannels, 0.0f);
+	convert(sound.data.data(), format, frames, source.data() + head * kChannels);
+
+	uint64_t step = (static_cast<uint64_t>(format.samplesPerSec) << 32) / sampleRate;
+	uint32_t outputFrames = static_cast<uint32_t>(
+	    (static_cast<uint64_t>(frames) * sampleRate + format.samplesPerSec - 1) /
+	    format.samplesPerSec);
+	output.resize(static_cast<size_t>(outputFrames) * kChannels);
+	if (quality == ResampleQuality::Sinc) {
+		filter.Resample(source.data(), 0, step, outputFrames, output.data());
+	} else {
+		ResampleLinear(source.data(), 0, step, outputFrames, output.data());
+	}
+	return true;
+}
+
+const char* GetResamplerKernelName() {
+#if defined(RESAMPLER_KERNEL_AVX)
+	return "AVX";
+#elif defined(RESAMPLER_KERNEL_SSE2)
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
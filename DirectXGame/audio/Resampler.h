@@ -0,0 +1,96 @@
+#pragma once
+
+#include "WaveFile.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 周波数変換の品質
+/// </summary>
+enum class ResampleQuality {
+	Linear, // 線形補間（軽いが、高い音ほど濁る）
+	Sinc,   // 窓付き sinc のポリフェーズフィルター
+};
+
+/// <summary>
+/// 音源のフレームを float のステレオ（左右交互）に変換する処理
+/// </summary>
+using SampleConvertFunction =
+    void (*)(const uint8_t* source, const WaveFormat& format, uint32_t frames, float* output);
+
+/// <summary>
+/// 形式に合う変換の取得
+/// モノラルは左右に同じ音を、3チャンネル以上はWAVEの既定のスピーカー配置として左右に混ぜる。
+/// </summary>
+SampleConvertFunction GetSampleConverter(const WaveFormat& format);
+
+/// <summary>
+/// ポリフェーズの窓付き sinc フィルター（カイザー窓）
+/// フレームの間を kPhases 個に分けた係数を持ち、その間の位相は隣の係数から直線補間する。
+/// 出力の周波数が音源より低いときは、折り返しが出ないように通す帯域を狭めてタップを増やす。
+/// </summary>
+class SincFilter {
+public: // 定数
+	// 片側の零点の数（音源より出力が高いときのタップ数の半分）
+	static const uint32_t kZeroCrossings = 16;
+	// 音源の周波数 / 出力の周波数 の上限
+	static const uint32_t kMaxRatio = 4;
+	// タップ数の上限
+	static const uint32_t kMaxTaps = kZeroCrossings * 2 * kMaxRatio;
+	// フレームの間を分ける数
+	static const uint32_t kPhases = 128;
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（係数を作る）
+	/// </summary>
+	/// <param name="sourceRate">音源の周波数</param>
+	/// <param name="outputRate">出力の周波数</param>
+	void Initialize(uint32_t sourceRate, uint32_t outputRate);
+
+	/// <summary>
+	/// 変換
+	/// 出力の i フレーム目は、位置 position + step * i（32.32 の固定小数点）の音を
+	/// source のその位置から GetTaps() フレームで求める（窓の中央は GetTaps() / 2 - 1 フレーム目）。
+	/// </summary>
+	/// <param name="source">音源（ステレオの float）</param>
+	/// <param name="position">最初のフレームの位置</param>
+	/// <param name="step">出力1フレームで進む音源のフレーム数</param>
+	/// <param name="frames">出力のフレーム数</param>
+	/// <param name="output">出力（ステレオの float）</param>
+	void Resample(
+	    const float* source, uint64_t position, uint64_t step, uint32_t frames,
+	    float* output) const;
+
+	uint32_t GetTaps() const { return taps_; }
+
+private: // メンバ変数
+	uint32_t taps_ = 0;
+	// 位相ごとの係数と、次の位相との差（左右で使えるように同じ値を2つずつ並べる）
+	std::vector<float> coefficients_;
+	std::vector<float> deltas_;
+};
+
+/// <summary>
+/// 線形補間での変換（窓は2フレーム。引数は SincFilter::Resample と同じ）
+/// </summary>
+void ResampleLinear(
+    const float* source, uint64_t position, uint64_t step, uint32_t frames, float* output);
+
+/// <summary>
+/// 音全体の変換（読み込み時に出力の形式に揃える）
+/// </summary>
+/// <param name="sound">音</param>
+/// <param name="sampleRate">出力の周波数</param>
+/// <param name="quality">周波数変換の品質</param>
+/// <param name="output">出力（ステレオの float）</param>
+/// <returns>変換できたか</returns>
+bool ConvertSound(
+    const WaveView& sound, uint32_t sampleRate, ResampleQuality quality,
+    std::vector<float>& output);
+
+/// <summary>
+/// 周波数変換で使っている命令セットの取得
+/// </summary>
+/// <returns>"AVX", "SSE2", "Scalar" のいずれか</returns>
+const char* GetResamplerKernelName();
@@ -0,0 +1,62 @@
+#include "StreamDecoder.h"
+#include "WaveStream.h"
+#include <algorithm>
+#include <cassert>
+
+StreamDecoder* StreamDecoder::GetInstance() {
+	static StreamDecoder instance;
+	return &instance;
+}
+
+StreamDecoder::~StreamDecoder() { Finalize(); }
+
+void StreamDecoder::Initialize() {
+	assert(!thread_.joinable());
+	quit_.store(false, std::memory_order_relaxed);
+	thread_ = std::thread(&StreamDecoder::ThreadMain, this);
+	isRunning_.store(true, std::memory_order_release);
+}
+
+void StreamDecoder::Finalize() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	isRunning_.store(false, std::memory_order_release);
+	quit_.store(true, std::memory_order_relaxed);
+	Wake();
+	thread_.join();
+}
+
+void StreamDecoder::Register(WaveStream* stream) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (std::find(streams_.begin(), streams_.end(), stream) == streams_.end()) {
+			streams_.push_back(stream);
+		}
+	}
+	Wake();
+}
+
+void StreamDecoder::Unregister(WaveStream* stream) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	streams_.erase(std::remove(streams_.begin(), streams_.end(), stream), streams_.end());
+}
+
+void StreamDecoder::Wake() {
+	wakeCount_.fetch_add(1, std::memory_order_release);
+	wakeCount_.notify_one();
+}
+
+void StreamDecoder::ThreadMain() {
+	while (!quit_.load(std::memory_order_relaxed)) {
+		// 埋めている間に起こされたら、もう一周する
+		uint32_t wakeCount = wakeCount_.load(std::memory_order_acquire);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (WaveStream* stream : streams_) {
+				stream->FillBlocks();
+			}
+		}
+		wakeCount_.wait(wakeCount, std::memory_order_acquire);
+	}
+}
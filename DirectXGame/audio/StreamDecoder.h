@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WaveStream;
+
+/// <summary>
+/// ストリーミングの先読み用のスレッド
+/// 登録した WaveStream の空いているブロックを、ファイルからの読み込みや IMA ADPCM の展開で
+/// 埋めておく。出力先のスレッドは埋まったブロックを受け取って起こすだけで、読み込みを待たない。
+/// 初期化前は、WaveStream が ReadBlock の中でその場で読む。
+/// </summary>
+class StreamDecoder {
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	static StreamDecoder* GetInstance();
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（先読み用のスレッドを起動する。ストリームを再生し始める前に呼ぶ）
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// 終了処理（ストリームの再生を全て止めてから呼ぶ）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 先読みするストリームの登録
+	/// </summary>
+	void Register(WaveStream* stream);
+
+	/// <summary>
+	/// 登録の解除（先読み用のスレッドがそのストリームを触っていない状態で戻る）
+	/// </summary>
+	void Unregister(WaveStream* stream);
+
+	/// <summary>
+	/// 先読み用のスレッドを起こす（ロックを取らないので出力先のスレッドから呼べる）
+	/// </summary>
+	void Wake();
+
+	// 先読み用のスレッドが動いているか
+	bool IsRunning() const { return isRunning_.load(std::memory_order_acquire); }
+
+private: // メンバ関数
+	StreamDecoder() = default;
+	~StreamDecoder();
+	StreamDecoder(const StreamDecoder&) = delete;
+	StreamDecoder& operator=(const StreamDecoder&) = delete;
+
+	/// <summary>
+	/// 先読み用のスレッドの処理
+	/// </summary>
+	void ThreadMain();
+
+private: // メンバ変数
+	std::thread thread_;
+	std::mutex mutex_; // streams_ と、ストリームのブロックを埋めている間
+	std::vector<WaveStream*> streams_;
+	std::atomic<uint32_t> wakeCount_ = 0; // 起こされた回数
+	std::atomic<bool> quit_ = false;
+	std::atomic<bool> isRunning_ = false;
+};
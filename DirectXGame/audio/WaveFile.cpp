@@ -0,0 +1,147 @@
+#include "WaveFile.h"
+#include "ImaAdpcm.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// WAVE_FORMAT_EXTENSIBLE
+const uint16_t kWaveFormatExtensible = 0xFFFE;
+// WAVEFORMATEX の固定部の大きさ
+const uint32_t kFormatSize = 16;
+// WAVEFORMATEXTENSIBLE の拡張部（cbSize 以降）の大きさ
+const uint32_t kExtensibleSize = 2 + 22;
+
+// 境界をそろえずに読む（範囲は呼び出し側で確かめる）
+template<typename T> T ReadValue(const uint8_t* p) {
+	T value;
+	std::memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+bool IsChunk(const uint8_t* p, const char* id) { return std::memcmp(p, id, 4) == 0; }
+
+// fmt チャンクの中身の解析
+bool ParseFormat(const uint8_t* p, uint32_t size, WaveFormat& format) {
+	if (size < kFormatSize) {
+		return false;
+	}
+	format.formatTag = ReadValue<uint16_t>(p + 0);
+	format.channels = ReadValue<uint16_t>(p + 2);
+	format.samplesPerSec = ReadValue<uint32_t>(p + 4);
+	format.avgBytesPerSec = ReadValue<uint32_t>(p + 8);
+	format.blockAlign = ReadValue<uint16_t>(p + 12);
+	format.bitsPerSample = ReadValue<uint16_t>(p + 14);
+	if (format.formatTag == kWaveFormatExtensible) {
+		// サブフォーマットのGUIDの先頭2バイトが WAVE_FORMAT_PCM などの値になっている
+		if (size < kFormatSize + kExtensibleSize) {
+			return false;
+		}
+		format.formatTag = ReadValue<uint16_t>(p + kFormatSize + 8);
+	}
+
+	if (format.channels == 0 || format.samplesPerSec == 0) {
+		return false;
+	}
+	switch (format.formatTag) {
+	case kWaveFormatPCM:
+		if (format.bitsPerSample != 8 && format.bitsPerSample != 16 &&
+		    format.bitsPerSample != 24 && format.bitsPerSample != 32) {
+			return false;
+		}
+		break;
+	case kWaveFormatFloat:
+		if (format.bitsPerSample != 32) {
+			return false;
+		}
+		break;
+	case kWaveFormatImaAdpcm:
+		// ヘッダの後にチャンネルごとの4バイトのグループが並ぶ
+		return format.bitsPerSample == 4 && format.blockAlign % (4 * format.channels) == 0 &&
+		       GetImaAdpcmBlockFrames(format, format.blockAlign) > 1;
+	default:
+		return false;
+	}
+	return format.blockAlign == format.channels * (format.bitsPerSample / 8);
+}
+
+} // namespace
+
+bool ParseWave(std::span<const uint8_t> bytes, WaveView& view) {
+	view = {};
+	if (bytes.size() < 12 || !IsChunk(bytes.data(), "RIFF") ||
+	    !IsChunk(bytes.data() + 8, "WAVE")) {
+		return false;
+	}
+	// RIFF の大きさが実際より大きいファイルもあるので、短い方に合わせる
+	uint64_t end = std::min<uint64_t>(8ull + ReadValue<uint32_t>(bytes.data() + 4), bytes.size());
+
+	bool hasFormat = false;
+	const uint8_t* data = nullptr;
+	uint64_t dataSize = 0;
+	uint64_t position = 12;
+	while (position + 8 <= end && !(hasFormat && data)) {
+		const uint8_t* header = bytes.data() + position;
+		uint64_t size = ReadValue<uint32_t>(header + 4);
+		uint64_t body = position + 8;
+		uint64_t available = end - body;
+		if (IsChunk(header, "fmt ") && !hasFormat) {
+			if (size > available ||
+			    !ParseFormat(header + 8, static_cast<uint32_t>(size), view.format)) {
+				return false;
+			}
+			hasFormat = true;
+		} else if (IsChunk(header, "data") && !data) {
+			data = header + 8;
+			dataSize = std::min(size, available);
+		}
+		// LIST など知らないチャンクは読み飛ばす（チャンクは2バイト境界に並ぶ）
+		position = body + size + (size & 1);
+	}
+	if (!hasFormat || !data) {
+		return false;
+	}
+	// IMA ADPCM の最後のブロックは短くてもよい（ヘッダがあれば展開できる）
+	uint32_t rest = static_cast<uint32_t>(dataSize % view.format.blockAlign);
+	if (view.format.formatTag != kWaveFormatImaAdpcm ||
+	    GetImaAdpcmBlockFrames(view.format, rest) == 0) {
+		dataSize -= rest;
+	}
+	view.data = {data, static_cast<size_t>(dataSize)};
+	return true;
+}
+
+bool WaveFile::Open(const std::string& fileName) {
+	Close();
+	if (!file_.Open(fileName) || !ParseWave(file_.GetBytes(), view_)) {
+		Close();
+		return false;
+	}
+	if (view_.format.formatTag == kWaveFormatImaAdpcm) {
+		// ブロックごとに展開して、マップした領域は手放す
+		const WaveFormat format = view_.format;
+		std::span<const uint8_t> source = view_.data;
+		uint32_t frames = GetImaAdpcmFrameCount(format, static_cast<uint32_t>(source.size()));
+		decoded_.resize(static_cast<size_t>(frames) * format.channels);
+		int16_t* output = decoded_.data();
+		for (size_t position = 0; position < source.size(); position += format.blockAlign) {
+			uint32_t blockSize = static_cast<uint32_t>(
+			    std::min<size_t>(format.blockAlign, source.size() - position));
+			output +=
+			    DecodeImaAdpcmBlock(source.data() + position, blockSize, format, output) *
+			    format.channels;
+		}
+		view_.format = GetImaAdpcmDecodedFormat(format);
+		view_.data = {
+		    reinterpret_cast<const uint8_t*>(decoded_.data()), decoded_.size() * sizeof(int16_t)};
+		file_.Close();
+	}
+	return true;
+}
+
+void WaveFile::Close() {
+	file_.Close();
+	view_ = {};
+	decoded_.clear();
+	decoded_.shrink_to_fit();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 波形フォーマット（WAVEFORMATEX と同じ並び。プラットフォームに依存しない）
+/// </summary>
+struct WaveFormat {
+	uint16_t formatTag = 0;      // kWaveFormatPCM・kWaveFormatFloat・kWaveFormatImaAdpcm
+	uint16_t channels = 0;       // チャンネル数
+	uint32_t samplesPerSec = 0;  // サンプリング周波数
+	uint32_t avgBytesPerSec = 0; // 1秒あたりのバイト数
+	uint16_t blockAlign = 0;     // 1サンプル(全チャンネル)のバイト数
+	uint16_t bitsPerSample = 0;  // 量子化ビット数
+};
+
+// 整数のPCM（WAVE_FORMAT_PCM）
+const uint16_t kWaveFormatPCM = 1;
+// 浮動小数点のPCM（WAVE_FORMAT_IEEE_FLOAT）
+const uint16_t kWaveFormatFloat = 3;
+// 4ビットに圧縮したPCM（WAVE_FORMAT_IMA_ADPCM）
+const uint16_t kWaveFormatImaAdpcm = 0x11;
+
+/// <summary>
+/// WAVファイルの中身（解析元のメモリを指すだけでコピーしない）
+/// </summary>
+struct WaveView {
+	WaveFormat format;
+	// data チャンクのPCM（blockAlign の倍数。IMA ADPCM は最後のブロックだけ短いことがある）
+	std::span<const uint8_t> data;
+};
+
+/// <summary>
+/// RIFF/WAVE の解析
+/// fmt・data チャンクをその場で検証し、LIST など知らないチャンクは読み飛ばす。
+/// WAVE_FORMAT_EXTENSIBLE はサブフォーマットのPCM・浮動小数点に読み替える。
+/// ヘッダより中身が短い data チャンクはある所までにする。
+/// IMA ADPCM は展開せずにそのまま返す。
+/// </summary>
+/// <param name="bytes">ファイルの中身</param>
+/// <param name="view">解析結果</param>
+/// <returns>再生できるPCMか、展開できるIMA ADPCMか</returns>
+bool ParseWave(std::span<const uint8_t> bytes, WaveView& view);
+
+/// <summary>
+/// メモリマップしたWAVファイル
+/// PCMはマップした領域をそのまま指すので、読み込みでコピーが起きない。
+/// IMA ADPCM は開くときに16ビットのPCMへ展開して、ファイルは閉じる。
+/// </summary>
+class WaveFile {
+public: // メンバ関数
+	/// <summary>
+	/// 開く
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>再生できるWAVファイルを開けたか</returns>
+	bool Open(const std::string& fileName);
+
+	/// <summary>
+	/// 閉じる（GetData の領域は使えなくなる）
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return view_.format.channels != 0; }
+	// 形式（IMA ADPCM は展開した後の形式）
+	const WaveFormat& GetFormat() const { return view_.format; }
+	// PCM（マップした領域か、展開した領域）
+	std::span<const uint8_t> GetData() const { return view_.data; }
+
+private: // メンバ変数
+	MappedFile file_;
+	WaveView view_;
+	std::vector<int16_t> decoded_; // IMA ADPCM を展開したPCM
+};
@@ -0,0 +1,141 @@
+#include "WaveStream.h"
+#include "ImaAdpcm.h"
+#include "StreamDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+WaveStream::~WaveStream() { Close(); }
+
+bool WaveStream::Open(const std::string& fileName, bool loop) {
+	Close();
+	if (!file_.Open(fileName) || !ParseWave(file_.GetBytes(), view_)) {
+		Close();
+		return false;
+	}
+	// ブロックはサンプルの途中で切らない（IMA ADPCM は展開したブロックの途中で切らない）
+	uint32_t unitSize = view_.format.blockAlign;
+	format_ = view_.format;
+	if (view_.format.formatTag == kWaveFormatImaAdpcm) {
+		format_ = GetImaAdpcmDecodedFormat(view_.format);
+		unitSize = GetImaAdpcmBlockFrames(view_.format, view_.format.blockAlign) *
+		           format_.blockAlign;
+	}
+	if (unitSize > kBlockSize || format_.blockAlign * kUnderrunFrames > kBlockSize) {
+		Close();
+		return false;
+	}
+	loop_ = loop;
+	blockSize_ = kBlockSize / unitSize * unitSize;
+	if (!blocks_) {
+		blocks_ = std::make_unique<uint8_t[]>(kBlockSize * (kBlockCount + 1));
+	}
+	// 無音は 8 ビットなら中央の 0x80（符号なし）、それ以外は 0
+	int silence = format_.formatTag == kWaveFormatPCM && format_.bitsPerSample == 8 ? 0x80 : 0;
+	std::memset(&blocks_[kBlockSize * kBlockCount], silence, kBlockSize);
+	Rewind();
+	return true;
+}
+
+void WaveStream::Close() {
+	StreamDecoder::GetInstance()->Unregister(this);
+	file_.Close();
+	view_ = {};
+	format_ = {};
+	filledCount_.store(0, std::memory_order_relaxed);
+	readCount_.store(0, std::memory_order_relaxed);
+	position_ = 0;
+	sourceEnd_ = true;
+	end_ = false;
+}
+
+void WaveStream::Rewind() {
+	// 先読み用のスレッドから外してから戻す
+	StreamDecoder::GetInstance()->Unregister(this);
+	filledCount_.store(0, std::memory_order_relaxed);
+	readCount_.store(0, std::memory_order_relaxed);
+	position_ = 0;
+	sourceEnd_ = GetDataSize() == 0;
+	end_ = sourceEnd_;
+	// 再生し始めに待たないように、最初のブロックはここで埋める
+	FillBlocks();
+	StreamDecoder::GetInstance()->Register(this);
+}
+
+WaveStream::Block WaveStream::ReadBlock() {
+	Block block;
+	if (end_) {
+		block.endOfStream = true;
+		return block;
+	}
+	uint32_t read = readCount_.load(std::memory_order_relaxed);
+	if (filledCount_.load(std::memory_order_acquire) == read) {
+		if (StreamDecoder::GetInstance()->IsRunning()) {
+			// 間に合わなかったら短い無音でつなぐ
+			underrunCount_.fetch_add(1, std::memory_order_relaxed);
+			StreamDecoder::GetInstance()->Wake();
+			block.data = &blocks_[kBlockSize * kBlockCount];
+			block.size = format_.blockAlign * kUnderrunFrames;
+			return block;
+		}
+		FillBlocks();
+	}
+	uint32_t index = read % kBlockCount;
+	block.data = &blocks_[index * kBlockSize];
+	block.size = blockSizes_[index];
+	block.endOfStream = blockEnds_[index];
+	end_ = block.endOfStream;
+	// 返したブロックの1つ前が空くので、先読み用のスレッドに埋めてもらう
+	readCount_.store(read + 1, std::memory_order_release);
+	StreamDecoder::GetInstance()->Wake();
+	return block;
+}
+
+void WaveStream::FillBlocks() {
+	// 再生側が持っている（最後に返した）ブロックは上書きしない
+	uint32_t filled = filledCount_.load(std::memory_order_relaxed);
+	while (!sourceEnd_ && filled - readCount_.load(std::memory_order_acquire) < kBlockCount - 1) {
+		FillBlock(filled % kBlockCount);
+		filledCount_.store(++filled, std::memory_order_release);
+	}
+}
+
+void WaveStream::FillBlock(uint32_t index) {
+	uint8_t* data = &blocks_[index * kBlockSize];
+	const uint8_t* source = view_.data.data();
+	uint32_t dataSize = GetDataSize();
+	bool isAdpcm = view_.format.formatTag == kWaveFormatImaAdpcm;
+	uint32_t decodedSize =
+	    isAdpcm ? GetImaAdpcmBlockFrames(view_.format, view_.format.blockAlign) * format_.blockAlign
+	            : 0;
+	uint32_t size = 0;
+	while (size < blockSize_) {
+		if (isAdpcm) {
+			// 圧縮したブロックを1つずつ、展開して収まる間だけ展開する
+			if (size + decodedSize > blockSize_) {
+				break;
+			}
+			uint32_t blockSize = std::min<uint32_t>(view_.format.blockAlign, dataSize - position_);
+			uint32_t frames = DecodeImaAdpcmBlock(
+			    source + position_, blockSize, view_.format,
+			    reinterpret_cast<int16_t*>(data + size));
+			size += frames * format_.blockAlign;
+			position_ += blockSize;
+		} else {
+			uint32_t copySize = std::min(blockSize_ - size, dataSize - position_);
+			std::memcpy(data + size, source + position_, copySize);
+			size += copySize;
+			position_ += copySize;
+		}
+		if (position_ < dataSize) {
+			continue;
+		}
+		if (!loop_) {
+			sourceEnd_ = true;
+			break;
+		}
+		// 先頭に戻って同じブロックの続きを読む
+		position_ = 0;
+	}
+	blockSizes_[index] = size;
+	blockEnds_[index] = sourceEnd_;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "WaveFile.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// <summary>
+/// WAVファイルのストリーミング読み込み
+/// data チャンクを小さなブロックに分けて順に読み、リングで使い回す。
+/// 曲の長さに関係なく、常駐するのはブロック kBlockCount 個ぶんだけになる。
+/// ループ再生では末尾まで読んだら同じブロックの続きに先頭から読むので、継ぎ目が出ない。
+/// IMA ADPCM はブロックを埋めるときに16ビットのPCMへ展開する。
+/// StreamDecoder が動いていれば、ブロックは先読み用のスレッドで埋めておき、ReadBlock は
+/// 埋まったブロックを受け取るだけになる（ファイルの読み込みも展開も再生側では起きない）。
+/// </summary>
+class WaveStream {
+public: // 定数
+	// リングのブロック数（再生中・再生待ち・読み込み中）
+	static const uint32_t kBlockCount = 3;
+	// ブロックの大きさ
+	static const uint32_t kBlockSize = 32 * 1024;
+	// 先読みが間に合わなかったときに返す無音のフレーム数
+	static const uint32_t kUnderrunFrames = 256;
+
+public: // サブクラス
+	// 読み込んだブロック
+	struct Block {
+		const uint8_t* data = nullptr;
+		uint32_t size = 0;        // バイト数（ループしないときは最後のブロックだけ短い）
+		bool endOfStream = false; // 最後のブロックか
+	};
+
+public: // メンバ関数
+	WaveStream() = default;
+	~WaveStream();
+	WaveStream(const WaveStream&) = delete;
+	WaveStream& operator=(const WaveStream&) = delete;
+
+	/// <summary>
+	/// 開く（ヘッダと最初のブロックだけ読む）
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="loop">ループするか</param>
+	/// <returns>再生できるWAVファイルを開けたか</returns>
+	bool Open(const std::string& fileName, bool loop);
+
+	/// <summary>
+	/// 閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// 先頭に戻す（再生していないときに呼ぶ）
+	/// </summary>
+	void Rewind();
+
+	/// <summary>
+	/// 次のブロックの読み込み（再生側のスレッドから呼ぶ）
+	/// kBlockCount 回前に返したブロックの領域を上書きするので、
+	/// 再生側は kBlockCount - 1 個より多く先に読まないこと。
+	/// 先読みが間に合わなければ、短い無音を返す。
+	/// </summary>
+	/// <returns>読み込んだブロック（最後まで読んだあとは大きさ0）</returns>
+	Block ReadBlock();
+
+	/// <summary>
+	/// 空いているブロックを埋める（先読み用のスレッドから呼ぶ）
+	/// </summary>
+	void FillBlocks();
+
+	bool IsOpen() const { return file_.IsOpen(); }
+	// 最後まで読んだか（ループするときは常に false）
+	bool IsEnd() const { return end_; }
+	// 再生する形式（IMA ADPCM は展開した後の形式）
+	const WaveFormat& GetFormat() const { return format_; }
+	// data チャンクのバイト数（IMA ADPCM は展開する前）
+	uint32_t GetDataSize() const { return static_cast<uint32_t>(view_.data.size()); }
+	// 先読みが間に合わずに無音を返した回数
+	uint32_t GetUnderrunCount() const { return underrunCount_.load(std::memory_order_relaxed); }
+
+private: // メンバ関数
+	void FillBlock(uint32_t index); // 1つのブロックを埋める
+
+private: // メンバ変数
+	MappedFile file_;
+	WaveView view_;     // ファイルの中の形式と data チャンク
+	WaveFormat format_; // 再生する形式
+	bool loop_ = false;
+
+	// ブロックのリング（最後の1つは無音）
+	std::unique_ptr<uint8_t[]> blocks_;
+	uint32_t blockSize_ = 0; // 再生する形式の blockAlign の倍数に切り下げたブロックの大きさ
+	uint32_t blockSizes_[kBlockCount] = {};
+	bool blockEnds_[kBlockCount] = {};
+	std::atomic<uint32_t> filledCount_ = 0; // 埋めたブロックの数
+	std::atomic<uint32_t> readCount_ = 0;   // 再生側に返したブロックの数
+
+	// 埋める側の持ち物
+	uint32_t position_ = 0;   // 次に読む data チャンク内の位置
+	bool sourceEnd_ = false;  // 最後まで埋めた
+
+	// 再生側の持ち物
+	bool end_ = false;
+	std::atomic<uint32_t> underrunCount_ = 0;
+};
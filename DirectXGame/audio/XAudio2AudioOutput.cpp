@@ -0,0 +1,94 @@
+#include "XAudio2AudioOutput.h"
+#include <cassert>
+#include <chrono>
+
+#pragma comment(lib, "xaudio2.lib")
+
+namespace {
+
+// コールバックを取りこぼしても積み足せるように見回る間隔
+const std::chrono::milliseconds kPollInterval(5);
+
+} // namespace
+
+bool XAudio2AudioOutput::Start(AudioMixer* mixer) {
+	assert(mixer);
+	assert(!thread_.joinable());
+	mixer_ = mixer;
+
+	HRESULT result = XAudio2Create(&xAudio2_, 0, XAUDIO2_DEFAULT_PROCESSOR);
+	if (FAILED(result)) {
+		return false;
+	}
+	result = xAudio2_->CreateMasteringVoice(&masterVoice_);
+	if (FAILED(result)) {
+		Stop();
+		return false;
+	}
+
+	// ミキサーの出力と同じ float のステレオ
+	WAVEFORMATEX wfex = {};
+	wfex.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+	wfex.nChannels = AudioMixer::kChannels;
+	wfex.nSamplesPerSec = mixer_->GetSampleRate();
+	wfex.wBitsPerSample = 32;
+	wfex.nBlockAlign = wfex.nChannels * wfex.wBitsPerSample / 8;
+	wfex.nAvgBytesPerSec = wfex.nSamplesPerSec * wfex.nBlockAlign;
+	result = xAudio2_->CreateSourceVoice(
+	    &sourceVoice_, &wfex, 0, XAUDIO2_DEFAULT_FREQ_RATIO, &voiceCallback_);
+	if (FAILED(result)) {
+		Stop();
+		return false;
+	}
+
+	for (std::vector<float>& buffer : buffers_) {
+		buffer.assign(kBufferFrames * AudioMixer::kChannels, 0.0f);
+	}
+	nextBuffer_ = 0;
+	sourceVoice_->Start();
+
+	quit_ = false;
+	thread_ = std::thread(&XAudio2AudioOutput::ThreadMain, this);
+	return true;
+}
+
+void XAudio2AudioOutput::Stop() {
+	if (thread_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			quit_ = true;
+		}
+		wakeUp_.notify_one();
+		thread_.join();
+	}
+	if (sourceVoice_) {
+		sourceVoice_->DestroyVoice();
+		sourceVoice_ = nullptr;
+	}
+	if (masterVoice_) {
+		masterVoice_->DestroyVoice();
+		masterVoice_ = nullptr;
+	}
+	xAudio2_.Reset();
+	mixer_ = nullptr;
+}
+
+void XAudio2AudioOutput::ThreadMain() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (!quit_) {
+		// 再生待ちが kBufferCount 個未満なら、一番古いバッファの再生は終わっている
+		XAUDIO2_VOICE_STATE state;
+		sourceVoice_->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+		for (uint32_t queued = state.BuffersQueued; queued < kBufferCount; queued++) {
+			std::vector<float>& buffer = buffers_[nextBuffer_];
+			nextBuffer_ = (nextBuffer_ + 1) % kBufferCount;
+			mixer_->Render(buffer.data(), kBufferFrames);
+
+			XAUDIO2_BUFFER xaBuffer = {};
+			xaBuffer.AudioBytes = static_cast<UINT32>(buffer.size() * sizeof(float));
+			xaBuffer.pAudioData = reinterpret_cast<const BYTE*>(buffer.data());
+			sourceVoice_->SubmitSourceBuffer(&xaBuffer);
+		}
+		wakeUp_.wait_for(lock, kPollInterval);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "AudioOutput.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wrl.h>
+#include <xaudio2.h>
+
+/// <summary>
+/// XAudio2への出力
+/// ミキサーで混ぜた音を1つのソースボイスに流す。再生ごとにボイスを作らない。
+/// 出力用のスレッドがバッファ kBufferCount 個を切らさないように Render して積む。
+/// Audio の XAudio2 は外から使えないので、専用の XAudio2 を持つ。
+/// </summary>
+class XAudio2AudioOutput : public AudioOutput {
+public: // 定数
+	// 積んでおくバッファの数
+	static const uint32_t kBufferCount = 3;
+	// 1つのバッファのフレーム数（48kHzで10ms）
+	static const uint32_t kBufferFrames = 480;
+
+public: // メンバ関数
+	~XAudio2AudioOutput() override { Stop(); }
+
+	bool Start(AudioMixer* mixer) override;
+	void Stop() override;
+
+private: // サブクラス
+	// バッファの再生が終わったら出力用のスレッドを起こす
+	class VoiceCallback : public IXAudio2VoiceCallback {
+	public:
+		explicit VoiceCallback(XAudio2AudioOutput* owner) : owner_(owner) {}
+		STDMETHOD_(void, OnVoiceProcessingPassStart)(THIS_ UINT32) {}
+		STDMETHOD_(void, OnVoiceProcessingPassEnd)(THIS) {}
+		STDMETHOD_(void, OnStreamEnd)(THIS) {}
+		STDMETHOD_(void, OnBufferStart)(THIS_ void*) {}
+		STDMETHOD_(void, OnBufferEnd)(THIS_ void*) { owner_->wakeUp_.notify_one(); }
+		STDMETHOD_(void, OnLoopEnd)(THIS_ void*) {}
+		STDMETHOD_(void, OnVoiceError)(THIS_ void*, HRESULT) {}
+
+	private:
+		XAudio2AudioOutput* owner_;
+	};
+
+private: // メンバ関数
+	void ThreadMain(); // 出力用のスレッドの処理
+
+private: // メンバ変数
+	AudioMixer* mixer_ = nullptr;
+	Microsoft::WRL::ComPtr<IXAudio2> xAudio2_;
+	IXAudio2MasteringVoice* masterVoice_ = nullptr;
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+	VoiceCallback voiceCallback_{this};
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable wakeUp_; // バッファの再生が終わった・終了の要求
+	bool quit_ = false;
+	std::array<std::vector<float>, kBufferCount> buffers_;
+	uint32_t nextBuffer_ = 0;
+};
@@ -0,0 +1,81 @@
+#include "BackgroundLoader.h"
+#include <cassert>
+#include <utility>
+
+BackgroundLoader* BackgroundLoader::GetInstance() {
+	static BackgroundLoader instance;
+	return &instance;
+}
+
+BackgroundLoader::~BackgroundLoader() { Finalize(); }
+
+void BackgroundLoader::Initialize(
+    std::function<void()> threadBegin, std::function<void()> threadEnd) {
+	assert(!thread_.joinable());
+	quit_ = false;
+	thread_ = std::thread(
+	    &BackgroundLoader::ThreadMain, this, std::move(threadBegin), std::move(threadEnd));
+}
+
+void BackgroundLoader::Finalize() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_ = true;
+	}
+	queued_.notify_one();
+	thread_.join();
+}
+
+BackgroundLoader::Ticket BackgroundLoader::Submit(std::function<void()> task) {
+	Ticket ticket;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		ticket = submitted_++;
+		if (thread_.joinable()) {
+			tasks_.push_back(std::move(task));
+			queued_.notify_one();
+			return ticket;
+		}
+	}
+	// 初期化前はその場で実行
+	task();
+	completed_.fetch_add(1, std::memory_order_release);
+	return ticket;
+}
+
+void BackgroundLoader::Wait(Ticket ticket) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this, ticket] { return IsDone(ticket); });
+}
+
+void BackgroundLoader::ThreadMain(
+    std::function<void()> threadBegin, std::function<void()> threadEnd) {
+	if (threadBegin) {
+		threadBegin();
+	}
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			queued_.wait(lock, [this] { return quit_ || !tasks_.empty(); });
+			// 終了の要求が来ても積んである処理は終える
+			if (tasks_.empty()) {
+				break;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			completed_.fetch_add(1, std::memory_order_release);
+		}
+		done_.notify_all();
+	}
+	if (threadEnd) {
+		threadEnd();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// 読み込み用のスレッド
+/// ファイルの読み込みや画像の展開のような長い処理を、積んだ順に1本のスレッドで実行する。
+/// ジョブシステムに積むと待っているスレッドが途中で拾ってフレームが止まるので分けている。
+/// </summary>
+class BackgroundLoader {
+public: // サブクラス
+	// 積んだ処理の番号（積んだ順に増える）
+	using Ticket = uint64_t;
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	static BackgroundLoader* GetInstance();
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（読み込み用のスレッドを起動する）
+	/// </summary>
+	/// <param name="threadBegin">スレッドの開始時に呼ぶ処理（COMの初期化など）</param>
+	/// <param name="threadEnd">スレッドの終了時に呼ぶ処理</param>
+	void Initialize(
+	    std::function<void()> threadBegin = nullptr, std::function<void()> threadEnd = nullptr);
+
+	/// <summary>
+	/// 終了処理（積んである処理を全て終えてからスレッドを止める）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 処理を積む（初期化前はその場で実行する）
+	/// </summary>
+	Ticket Submit(std::function<void()> task);
+
+	/// <summary>
+	/// 処理が終わったか
+	/// </summary>
+	bool IsDone(Ticket ticket) const {
+		return ticket < completed_.load(std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// 処理が終わるまで待つ
+	/// </summary>
+	void Wait(Ticket ticket);
+
+private: // メンバ関数
+	BackgroundLoader() = default;
+	~BackgroundLoader();
+	BackgroundLoader(const BackgroundLoader&) = delete;
+	BackgroundLoader& operator=(const BackgroundLoader&) = delete;
+
+	/// <summary>
+	/// 読み込み用のスレッドの処理
+	/// </summary>
+	void ThreadMain(std::function<void()> threadBegin, std::function<void()> threadEnd);
+
+private: // メンバ変数
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable queued_; // 処理が積まれた・終了の要求
+	std::condition_variable done_;   // 処理が終わった
+	std::deque<std::function<void()>> tasks_;
+	bool quit_ = false;
+	Ticket submitted_ = 0;              // 積んだ数
+	std::atomic<Ticket> completed_ = 0; // 終わった数
+};
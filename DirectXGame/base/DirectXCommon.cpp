@@ -2,7 +2,6 @@
 #include "SafeDelete.h"
 #include <algorithm>
 #include <cassert>
-#include <thread>
 #include <timeapi.h>
 #include <vector>
 
@@ -18,19 +17,21 @@ DirectXCommon* DirectXCommon::GetInstance() {
 	return &instance;
 }
 
-void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t backBufferHeight) {
+void DirectXCommon::Initialize(
+    WinApp* winApp, int32_t backBufferWidth, int32_t backBufferHeight, uint32_t framesInFlight) {
 	// nullptrチェック
 	assert(winApp);
 	assert(4 <= backBufferWidth && backBufferWidth <= 4096);
 	assert(4 <= backBufferHeight && backBufferHeight <= 4096);
+	assert(1 <= framesInFlight && framesInFlight <= FrameResourceRing::kMaxFrameCount);
 
-	// sleepの分解能をあげておく
+	// sleepの分解能をあげておく（フレームレート制限で空回りする時間が減る）
 	timeBeginPeriod(1);
 
 	winApp_ = winApp;
 	backBufferWidth_ = backBufferWidth;
 	backBufferHeight_ = backBufferHeight;
-	reference_ = std::chrono::steady_clock::now();
+	framesInFlight_ = framesInFlight;
 
 	// DXGIデバイス初期化
 	InitializeDXGIDevice();
@@ -41,6 +42,10 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 	// スワップチェーンの生成
 	CreateSwapChain();
 
+	// 垂直同期しないモニタでは60fpsに制限する（垂直同期するなら Present が待つので制限しない）
+	framePacer_.SetTargetRate(refreshRate_ < kThreasholdRefreshRate ? 60.0 : 0.0);
+	framePacer_.Reset();
+
 	// レンダーターゲット生成
 	CreateFinalRenderTargets();
 
@@ -49,6 +54,9 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 
 	// フェンス生成
 	CreateFence();
+
+	// フレームごとのアップロード領域生成
+	CreateUploadBuffer();
 }
 
 void DirectXCommon::PreDraw() {
@@ -102,8 +110,7 @@ void DirectXCommon::PostDraw() {
 	ID3D12CommandList* cmdLists[] = {commandList_.Get()}; // コマンドリストの配列
 	commandQueue_->ExecuteCommandLists(1, cmdLists);
 
-	// バッファをフリップ。60fps固定のため、30fpsなどのモニタはティアリング覚悟で垂直同期無視
-	static constexpr int32_t kThreasholdRefreshRate = 58;
+	// バッファをフリップ。30fpsなどのモニタはティアリング覚悟で垂直同期無視
 	result = swapChain_->Present(refreshRate_ < kThreasholdRefreshRate ? 0 : 1, 0);
 #ifdef _DEBUG
 	if (FAILED(result)) {
@@ -119,47 +126,38 @@ void DirectXCommon::PostDraw() {
 	}
 #endif
 
-	// コマンドリストの実行完了を待つ
-	commandQueue_->Signal(fence_.Get(), ++fenceVal_);
-	if (fence_->GetCompletedValue() != fenceVal_) {
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
-		fence_->SetEventOnCompletion(fenceVal_, event);
-		WaitForSingleObject(event, INFINITE);
-		CloseHandle(event);
-	}
+	// このフレームの完了をシグナルし、次のフレームのリソースが空くまで待つ
+	// （待つのはCPUがフレーム数ぶん先行したときだけ）
+	frameRing_.Advance();
 
 	// ウィンドウ閉じるとframeLatencyWaitableObject_をインクリメントする対象がいなくなって0のままになるからInfiniteにしない
 	// 初期化時にframeLatencyWaitableObject_のカウンタを無理やり0にしたのでこの対応がいる。
 	WaitForSingleObject(frameLatencyWaitableObject_, 1000);
 
-	// max 60fps 固定
-	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-	std::chrono::microseconds elapsed =
-	    std::chrono::duration_cast<std::chrono::microseconds>(now - reference_);
-
-	// 60ギリギリだとちょっとばかし高いリフレッシュレートのモニタで逆にかくついてしまうので少しバッファを取る
-	static const std::chrono::microseconds kMinCheckTime(uint64_t(1000000.0f / 62.0f));
-	// 実際にwaitするのは60基準
-	static const std::chrono::microseconds kMinTime(uint64_t(1000000.0f / 60.0f));
-	std::chrono::microseconds check = kMinCheckTime - elapsed;
-	if (std::chrono::microseconds(0) < check) {
-		std::chrono::microseconds waitTime = kMinTime - elapsed;
-
-		// sleepは信用ならないので1uでポーリング
-		std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
-		do {
-			std::this_thread::sleep_for(std::chrono::microseconds(1));
-		} while (std::chrono::steady_clock::now() - waitStart < waitTime);
-	}
+	// フレームレート制限（制限しない場合もフレーム時間の統計は取る）
+	framePacer_.Wait();
 
-	elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
-	    std::chrono::steady_clock::now() - reference_);
-	reference_ = std::chrono::steady_clock::now();
+	// 次のフレームのコマンドアロケータで記録を始める
+	ID3D12CommandAllocator* commandAllocator =
+	    commandAllocators_[frameRing_.GetFrameIndex()].Get();
+	commandAllocator->Reset();
+	commandList_->Reset(commandAllocator, nullptr);
+}
 
-	commandAllocator_->Reset();
-	commandList_->Reset(commandAllocator_.Get(), nullptr);
+void* DirectXCommon::AllocateUpload(
+    size_t size, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress, size_t alignment) {
+	size_t offset = frameRing_.AllocateUpload(size, alignment);
+	if (offset == FrameResourceRing::kInvalidOffset) {
+		return nullptr;
+	}
+	if (gpuAddress) {
+		*gpuAddress = uploadBuffer_->GetGPUVirtualAddress() + offset;
+	}
+	return uploadMap_ + offset;
 }
 
+void DirectXCommon::WaitForGPU() { frameRing_.WaitIdle(); }
+
 void DirectXCommon::ClearRenderTarget() {
 	UINT bbIndex = swapChain_->GetCurrentBackBufferIndex();
 
@@ -297,7 +295,7 @@ void DirectXCommon::CreateSwapChain() {
 	swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; // 色情報の書式を一般的なものに
 	swapChainDesc.SampleDesc.Count = 1;                // マルチサンプルしない
 	swapChainDesc.BufferUsage = DXGI_USAGE_BACK_BUFFER; // バックバッファとして使えるように
-	swapChainDesc.BufferCount = 2;                      // バッファ数を２つに設定
+	swapChainDesc.BufferCount = std::max(2u, framesInFlight_); // 同時に扱うフレーム数以上
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // フリップ後は速やかに破棄
 	swapChainDesc.Flags =
 	    DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING |
@@ -316,8 +314,8 @@ void DirectXCommon::CreateSwapChain() {
 	swapChain1->QueryInterface(IID_PPV_ARGS(&swapChain_));
 	assert(SUCCEEDED(result));
 
-	// VSync共存型fps固定のためにレイテンシ1
-	swapChain_->SetMaximumFrameLatency(1);
+	// 同時に扱うフレーム数までPresentを積めるようにする
+	swapChain_->SetMaximumFrameLatency(framesInFlight_);
 
 	// 実際のflip用イベントを取得
 	frameLatencyWaitableObject_ = swapChain_->GetFrameLatencyWaitableObject();
@@ -333,14 +331,17 @@ void DirectXCommon::CreateSwapChain() {
 void DirectXCommon::InitializeCommand() {
 	HRESULT result = S_FALSE;
 
-	// コマンドアロケータを生成
-	result = device_->CreateCommandAllocator(
-	    D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	assert(SUCCEEDED(result));
+	// コマンドアロケータをフレーム数ぶん生成
+	commandAllocators_.resize(framesInFlight_);
+	for (ComPtr<ID3D12CommandAllocator>& commandAllocator : commandAllocators_) {
+		result = device_->CreateCommandAllocator(
+		    D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
+		assert(SUCCEEDED(result));
+	}
 
 	// コマンドリストを生成
 	result = device_->CreateCommandList(
-	    0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr,
+	    0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocators_[0].Get(), nullptr,
 	    IID_PPV_ARGS(&commandList_));
 	assert(SUCCEEDED(result));
 
@@ -421,6 +422,53 @@ void DirectXCommon::CreateFence() {
 	HRESULT result = S_FALSE;
 
 	// フェンスの生成
-	result = device_->CreateFence(fenceVal_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	result = device_->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
 	assert(SUCCEEDED(result));
+
+	// フレームの切り替えはフェンスの値で管理する
+	fenceTimeline_.Initialize(commandQueue_.Get(), fence_.Get());
+	frameRing_.Initialize(&fenceTimeline_, framesInFlight_, kUploadRegionSize);
+}
+
+void DirectXCommon::CreateUploadBuffer() {
+	HRESULT result = S_FALSE;
+
+	// フレーム数ぶんの領域を並べたアップロードバッファ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	    CD3DX12_RESOURCE_DESC::Buffer(kUploadRegionSize * framesInFlight_);
+	result = device_->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ,
+	    nullptr, IID_PPV_ARGS(&uploadBuffer_));
+	assert(SUCCEEDED(result));
+
+	// 書き込み用に常にマップしておく
+	result = uploadBuffer_->Map(0, nullptr, reinterpret_cast<void**>(&uploadMap_));
+	assert(SUCCEEDED(result));
+}
+
+DirectXCommon::FenceTimeline::~FenceTimeline() {
+	if (event_) {
+		CloseHandle(event_);
+	}
+}
+
+void DirectXCommon::FenceTimeline::Initialize(
+    ID3D12CommandQueue* commandQueue, ID3D12Fence* fence) {
+	commandQueue_ = commandQueue;
+	fence_ = fence;
+	if (!event_) {
+		event_ = CreateEvent(nullptr, false, false, nullptr);
+	}
+}
+
+void DirectXCommon::FenceTimeline::Signal(uint64_t value) {
+	commandQueue_->Signal(fence_, value);
+}
+
+uint64_t DirectXCommon::FenceTimeline::GetCompletedValue() { return fence_->GetCompletedValue(); }
+
+void DirectXCommon::FenceTimeline::WaitForValue(uint64_t value) {
+	fence_->SetEventOnCompletion(value, event_);
+	WaitForSingleObject(event_, INFINITE);
 }
@@ -8,6 +8,8 @@
 #include <dxgi1_6.h>
 #include <wrl.h>
 
+#include "FramePacer.h"
+#include "FrameResourceRing.h"
 #include "WinApp.h"
 
 /// <summary>
@@ -24,9 +26,10 @@ public: // メンバ関数
 	/// <summary>
 	/// 初期化
 	/// </summary>
+	/// <param name="framesInFlight">CPUとGPUで同時に扱うフレーム数（1〜3）</param>
 	void Initialize(
 	    WinApp* win, int32_t backBufferWidth = WinApp::kWindowWidth,
-	    int32_t backBufferHeight = WinApp::kWindowHeight);
+	    int32_t backBufferHeight = WinApp::kWindowHeight, uint32_t framesInFlight = 2);
 
 	/// <summary>
 	/// 描画前処理
@@ -75,6 +78,61 @@ public: // メンバ関数
 	// バックバッファの数を取得
 	size_t GetBackBufferCount() const { return backBuffers_.size(); }
 
+	/// <summary>
+	/// 現在のフレームの番号（0〜GetFramesInFlight()-1）
+	/// 毎フレーム書き換える定数バッファはこの番号ごとに持つと、GPUが読んでいる最中に上書きしない。
+	/// </summary>
+	uint32_t GetFrameIndex() const { return frameRing_.GetFrameIndex(); }
+
+	/// <summary>
+	/// CPUとGPUで同時に扱うフレーム数の取得
+	/// </summary>
+	uint32_t GetFramesInFlight() const { return frameRing_.GetFrameCount(); }
+
+	/// <summary>
+	/// 現在のフレームのアップロード領域から割り当て（次にこの番号のフレームが来るまで有効）
+	/// </summary>
+	/// <param name="size">大きさ</param>
+	/// <param name="gpuAddress">GPU仮想アドレスの格納先</param>
+	/// <param name="alignment">アライメント（定数バッファは256）</param>
+	/// <returns>書き込み先（足りなければnullptr）</returns>
+	void* AllocateUpload(
+	    size_t size, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress,
+	    size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/// <summary>
+	/// GPUが全てのフレームを終えるまで待つ（GPUが使うリソースを解放する前に呼ぶ）
+	/// </summary>
+	void WaitForGPU();
+
+	/// <summary>
+	/// フレームレート制限の取得（目標のフレームレートの変更や統計の取得に使う）
+	/// </summary>
+	/// <returns>フレームレート制限</returns>
+	FramePacer& GetFramePacer() { return framePacer_; }
+
+private: // サブクラス
+	/// <summary>
+	/// フェンスによるGPUのタイムライン
+	/// </summary>
+	class FenceTimeline : public FrameResourceRing::Timeline {
+	public:
+		~FenceTimeline();
+		void Initialize(ID3D12CommandQueue* commandQueue, ID3D12Fence* fence);
+		void Signal(uint64_t value) override;
+		uint64_t GetCompletedValue() override;
+		void WaitForValue(uint64_t value) override;
+
+	private:
+		ID3D12CommandQueue* commandQueue_ = nullptr;
+		ID3D12Fence* fence_ = nullptr;
+		HANDLE event_ = nullptr;
+	};
+
+private: // 定数
+	// フレームごとのアップロード領域の大きさ
+	static const size_t kUploadRegionSize = 1024 * 1024;
+
 private: // メンバ変数
 	// ウィンドウズアプリケーション管理
 	WinApp* winApp_;
@@ -83,7 +141,8 @@ private: // メンバ変数
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory_;
 	Microsoft::WRL::ComPtr<ID3D12Device> device_;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator_;
+	// フレームごとのコマンドアロケータ
+	std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> commandAllocators_;
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue_;
 	Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain_;
 	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> backBuffers_;
@@ -91,13 +150,21 @@ private: // メンバ変数
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtvHeap_;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
-	UINT64 fenceVal_ = 0;
+	FenceTimeline fenceTimeline_;
+	FrameResourceRing frameRing_;
+	uint32_t framesInFlight_ = 2;
+	// フレームごとのアップロード領域（フレーム数ぶんを1つのバッファに並べる）
+	Microsoft::WRL::ComPtr<ID3D12Resource> uploadBuffer_;
+	uint8_t* uploadMap_ = nullptr;
 	int32_t backBufferWidth_ = 0;
 	int32_t backBufferHeight_ = 0;
 	HANDLE frameLatencyWaitableObject_;
-	std::chrono::steady_clock::time_point reference_;
+	FramePacer framePacer_;
 	int32_t refreshRate_ = 0;
 
+	// これ未満のリフレッシュレートのモニタでは垂直同期しない
+	static constexpr int32_t kThreasholdRefreshRate = 58;
+
 private: // メンバ関数
 	DirectXCommon() = default;
 	~DirectXCommon() = default;
@@ -133,4 +200,9 @@ private: // メンバ関数
 	/// フェンス生成
 	/// </summary>
 	void CreateFence();
+
+	/// <summary>
+	/// フレームごとのアップロード領域の生成
+	/// </summary>
+	void CreateUploadBuffer();
 };
@@ -0,0 +1,210 @@
+#include "EcsWorld.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+// 登録済みのコンポーネント型
+std::mutex componentMutex;
+ComponentInfo componentInfos[kMaxComponentTypes];
+uint32_t componentCount = 0;
+
+// alignment の倍数に切り上げ
+size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ComponentId RegisterComponent(const ComponentInfo& info) {
+	std::lock_guard<std::mutex> lock(componentMutex);
+	assert(componentCount < kMaxComponentTypes);
+	assert(info.align <= alignof(std::max_align_t));
+	componentInfos[componentCount] = info;
+	return componentCount++;
+}
+
+const ComponentInfo& GetComponentInfo(ComponentId id) {
+	assert(id < kMaxComponentTypes);
+	return componentInfos[id];
+}
+
+//----------------------------------------------
+// アーキタイプ
+//----------------------------------------------
+
+Archetype::Archetype(ComponentMask mask) : mask_(mask) {
+	size_t bytesPerEntity = sizeof(Entity);
+	for (ComponentId id = 0; id < kMaxComponentTypes; id++) {
+		if (Has(id)) {
+			columnIndex_[id] = static_cast<uint8_t>(components_.size());
+			components_.push_back(id);
+			bytesPerEntity += GetComponentInfo(id).size;
+		}
+	}
+
+	// 配置を決める（先頭にエンティティ配列、続けて各コンポーネント配列）
+	auto layout = [this](uint32_t capacity) {
+		offsets_.clear();
+		size_t offset = sizeof(Entity) * capacity;
+		for (ComponentId id : components_) {
+			const ComponentInfo& info = GetComponentInfo(id);
+			offset = AlignUp(offset, info.align);
+			offsets_.push_back(offset);
+			offset += info.size * capacity;
+		}
+		return offset;
+	};
+	// チャンクに収まる最大数（大きすぎる型でも最低1つは入れる）
+	capacity_ = std::max<uint32_t>(1, static_cast<uint32_t>(kChunkBytes / bytesPerEntity));
+	while (capacity_ > 1 && layout(capacity_) > kChunkBytes) {
+		capacity_--;
+	}
+	size_t bytes = layout(capacity_);
+	chunkWords_ = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+}
+
+Archetype::~Archetype() { Clear(); }
+
+EntityLocation Archetype::Allocate(Entity entity) {
+	if (chunkCount_ == 0 || chunks_[chunkCount_ - 1].count == capacity_) {
+		if (chunkCount_ == chunks_.size()) {
+			chunks_.push_back({std::make_unique<std::max_align_t[]>(chunkWords_), 0});
+		}
+		chunkCount_++;
+	}
+	uint32_t chunk = chunkCount_ - 1;
+	uint32_t row = chunks_[chunk].count++;
+	GetEntities(chunk)[row] = entity;
+	return {this, chunk, row};
+}
+
+Entity Archetype::RemoveRow(uint32_t chunk, uint32_t row) {
+	assert(chunk < chunkCount_ && row < chunks_[chunk].count);
+	uint32_t lastChunk = chunkCount_ - 1;
+	uint32_t lastRow = chunks_[lastChunk].count - 1;
+	EntityLocation hole = {this, chunk, row};
+	EntityLocation last = {this, lastChunk, lastRow};
+	bool isLast = chunk == lastChunk && row == lastRow;
+
+	Entity moved = {};
+	for (ComponentId id : components_) {
+		const ComponentInfo& info = GetComponentInfo(id);
+		void* dst = GetComponent(hole, id);
+		info.destroy(dst);
+		if (!isLast) {
+			// 末尾の行を穴へ移す
+			void* src = GetComponent(last, id);
+			info.moveConstruct(dst, src);
+			info.destroy(src);
+		}
+	}
+	if (!isLast) {
+		moved = GetEntities(lastChunk)[lastRow];
+		GetEntities(chunk)[row] = moved;
+	}
+
+	if (--chunks_[lastChunk].count == 0) {
+		chunkCount_--;
+	}
+	return moved;
+}
+
+void Archetype::Clear() {
+	for (uint32_t c = 0; c < chunkCount_; c++) {
+		for (ComponentId id : components_) {
+			const ComponentInfo& info = GetComponentInfo(id);
+			std::byte* column = static_cast<std::byte*>(GetColumn(c, id));
+			for (uint32_t row = 0; row < chunks_[c].count; row++) {
+				info.destroy(column + info.size * row);
+			}
+		}
+		chunks_[c].count = 0;
+	}
+	chunkCount_ = 0;
+}
+
+size_t Archetype::Size() const {
+	if (chunkCount_ == 0) {
+		return 0;
+	}
+	return size_t(capacity_) * (chunkCount_ - 1) + chunks_[chunkCount_ - 1].count;
+}
+
+//----------------------------------------------
+// ワールド
+//----------------------------------------------
+
+void EcsWorld::Destroy(Entity entity) {
+	assert(iterating_ == 0);
+	const EntityLocation* location = entities_.Get(entity);
+	if (!location) {
+		return;
+	}
+	RemoveRow(*location);
+	entities_.Despawn(entity);
+}
+
+void EcsWorld::DestroyDeferred(Entity entity) {
+	std::lock_guard<std::mutex> lock(pendingMutex_);
+	pendingDestroy_.push_back(entity);
+}
+
+void EcsWorld::FlushDeferred() {
+	// 削除済み・重複したハンドルは Destroy が無視する
+	for (Entity entity : pendingDestroy_) {
+		Destroy(entity);
+	}
+	pendingDestroy_.clear();
+}
+
+void EcsWorld::DestroyAll(ComponentMask required) {
+	assert(iterating_ == 0);
+	for (Archetype* archetype : archetypes_) {
+		if ((archetype->GetMask() & required) != required) {
+			continue;
+		}
+		for (uint32_t c = 0; c < archetype->GetChunkCount(); c++) {
+			const Entity* chunkEntities = archetype->GetEntities(c);
+			for (uint32_t row = 0; row < archetype->GetChunkSize(c); row++) {
+				entities_.Despawn(chunkEntities[row]);
+			}
+		}
+		archetype->Clear();
+	}
+}
+
+Archetype* EcsWorld::GetOrCreateArchetype(ComponentMask mask) {
+	auto it = archetypeMap_.find(mask);
+	if (it != archetypeMap_.end()) {
+		return it->second.get();
+	}
+	auto archetype = std::make_unique<Archetype>(mask);
+	Archetype* result = archetype.get();
+	archetypeMap_.emplace(mask, std::move(archetype));
+	archetypes_.push_back(result);
+	return result;
+}
+
+EntityLocation EcsWorld::MoveEntity(Entity entity, Archetype* destination) {
+	EntityLocation source = *entities_.Get(entity);
+	EntityLocation moved = destination->Allocate(entity);
+	for (ComponentId id : source.archetype->GetComponents()) {
+		if (destination->Has(id)) {
+			GetComponentInfo(id).moveConstruct(
+			    destination->GetComponent(moved, id), source.archetype->GetComponent(source, id));
+		}
+	}
+	// 移動元の行を破棄（移した後の抜け殻も含めて）
+	RemoveRow(source);
+	*entities_.Get(entity) = moved;
+	return moved;
+}
+
+void EcsWorld::RemoveRow(const EntityLocation& location) {
+	Entity moved = location.archetype->RemoveRow(location.chunk, location.row);
+	if (EntityLocation* movedLocation = entities_.Get(moved)) {
+		movedLocation->chunk = location.chunk;
+		movedLocation->row = location.row;
+	}
+}
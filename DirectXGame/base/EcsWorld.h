@@ -0,0 +1,395 @@
+#pragma once
+
+#include "ObjectPool.h"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+///
+/// アーキタイプ型のエンティティ・コンポーネント・システム。
+/// 同じコンポーネントの組み合わせを持つエンティティを1つのアーキタイプにまとめ、
+/// 固定サイズのチャンクにコンポーネントごとの配列として詰めて格納する。
+/// システムはチャンク単位で連続した配列を回す。
+///
+
+class Archetype;
+
+// コンポーネント型の番号
+using ComponentId = uint32_t;
+// コンポーネントの組み合わせ（1ビットが1種類）
+using ComponentMask = uint64_t;
+// 登録できるコンポーネント型の数
+const uint32_t kMaxComponentTypes = 64;
+
+/// <summary>
+/// コンポーネント型の情報（型を消して扱うための関数表）
+/// </summary>
+struct ComponentInfo {
+	size_t size;
+	size_t align;
+	void (*moveConstruct)(void* dst, void* src);
+	void (*destroy)(void* ptr);
+};
+
+/// <summary>
+/// コンポーネント型の登録
+/// </summary>
+/// <returns>コンポーネント型の番号</returns>
+ComponentId RegisterComponent(const ComponentInfo& info);
+
+/// <summary>
+/// コンポーネント型の情報を取得
+/// </summary>
+const ComponentInfo& GetComponentInfo(ComponentId id);
+
+/// <summary>
+/// コンポーネント型の番号を取得（初回に登録される）
+/// </summary>
+template<class T> ComponentId GetComponentId() {
+	static_assert(std::is_move_constructible_v<T>, "component must be move constructible");
+	static const ComponentId id = RegisterComponent(
+	    {sizeof(T), alignof(T),
+	     [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+	     [](void* ptr) { static_cast<T*>(ptr)->~T(); }});
+	return id;
+}
+
+/// <summary>
+/// コンポーネント型の組み合わせを取得
+/// </summary>
+template<class... Ts> ComponentMask MakeComponentMask() {
+	return (ComponentMask(0) | ... | (ComponentMask(1) << GetComponentId<Ts>()));
+}
+
+/// <summary>
+/// エンティティの格納場所
+/// </summary>
+struct EntityLocation {
+	Archetype* archetype = nullptr;
+	uint32_t chunk = 0; // チャンク番号
+	uint32_t row = 0;   // チャンク内の行
+};
+
+// エンティティ（世代付きハンドル）
+using Entity = ObjectPool<EntityLocation>::Handle;
+
+/// <summary>
+/// アーキタイプ（同じコンポーネントの組み合わせを持つエンティティの格納先）
+/// </summary>
+class Archetype {
+public: // 定数
+	// チャンク1つの大きさ
+	static const size_t kChunkBytes = 16 * 1024;
+
+public: // メンバ関数
+	explicit Archetype(ComponentMask mask);
+	~Archetype();
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	/// <summary>
+	/// 行の確保（コンポーネントは呼び出し側で構築する）
+	/// </summary>
+	/// <param name="entity">エンティティ</param>
+	/// <returns>確保した場所</returns>
+	EntityLocation Allocate(Entity entity);
+
+	/// <summary>
+	/// 行の削除（コンポーネントを破棄し、末尾の行を移して詰める）
+	/// </summary>
+	/// <returns>移動したエンティティ（移動が無ければ無効なハンドル）</returns>
+	Entity RemoveRow(uint32_t chunk, uint32_t row);
+
+	/// <summary>
+	/// 全行の削除
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// コンポーネントの組み合わせを取得
+	/// </summary>
+	ComponentMask GetMask() const { return mask_; }
+
+	/// <summary>
+	/// コンポーネントを持っているか
+	/// </summary>
+	bool Has(ComponentId id) const { return (mask_ >> id & 1) != 0; }
+
+	/// <summary>
+	/// 使用中のチャンク数を取得
+	/// </summary>
+	uint32_t GetChunkCount() const { return chunkCount_; }
+
+	/// <summary>
+	/// チャンク内のエンティティ数を取得
+	/// </summary>
+	uint32_t GetChunkSize(uint32_t chunk) const { return chunks_[chunk].count; }
+
+	/// <summary>
+	/// チャンク1つに入るエンティティ数を取得
+	/// </summary>
+	uint32_t GetCapacity() const { return capacity_; }
+
+	/// <summary>
+	/// エンティティ数を取得
+	/// </summary>
+	size_t Size() const;
+
+	/// <summary>
+	/// チャンク内のエンティティ配列を取得
+	/// </summary>
+	Entity* GetEntities(uint32_t chunk) {
+		return reinterpret_cast<Entity*>(chunks_[chunk].data.get());
+	}
+
+	/// <summary>
+	/// チャンク内のコンポーネント配列を取得
+	/// </summary>
+	void* GetColumn(uint32_t chunk, ComponentId id) {
+		assert(Has(id));
+		return reinterpret_cast<std::byte*>(chunks_[chunk].data.get()) +
+		       offsets_[columnIndex_[id]];
+	}
+	template<class T> T* GetColumn(uint32_t chunk) {
+		return static_cast<T*>(GetColumn(chunk, GetComponentId<T>()));
+	}
+
+	/// <summary>
+	/// 1行分のコンポーネントを取得
+	/// </summary>
+	void* GetComponent(const EntityLocation& location, ComponentId id) {
+		return static_cast<std::byte*>(GetColumn(location.chunk, id)) +
+		       GetComponentInfo(id).size * location.row;
+	}
+
+	/// <summary>
+	/// 持っているコンポーネント型の一覧を取得
+	/// </summary>
+	const std::vector<ComponentId>& GetComponents() const { return components_; }
+
+private: // サブクラス
+	struct Chunk {
+		std::unique_ptr<std::max_align_t[]> data;
+		uint32_t count = 0;
+	};
+
+private: // メンバ変数
+	// コンポーネントの組み合わせ
+	ComponentMask mask_ = 0;
+	// 持っているコンポーネント型（番号順）
+	std::vector<ComponentId> components_;
+	// チャンク先頭からの各配列の位置
+	std::vector<size_t> offsets_;
+	// コンポーネント型の番号 → components_ の番号
+	uint8_t columnIndex_[kMaxComponentTypes] = {};
+	// チャンク1つに入るエンティティ数
+	uint32_t capacity_ = 0;
+	// チャンク1つの確保サイズ（max_align_t 単位）
+	size_t chunkWords_ = 0;
+	// チャンク（使用中の後ろに空のチャンクを残して再利用する）
+	std::vector<Chunk> chunks_;
+	// 使用中のチャンク数（末尾以外は満杯）
+	uint32_t chunkCount_ = 0;
+};
+
+/// <summary>
+/// エンティティとアーキタイプの管理
+/// </summary>
+class EcsWorld {
+public: // メンバ関数
+	EcsWorld() = default;
+	~EcsWorld() = default;
+	EcsWorld(const EcsWorld&) = delete;
+	EcsWorld& operator=(const EcsWorld&) = delete;
+
+	/// <summary>
+	/// エンティティの生成
+	/// </summary>
+	/// <param name="components">初期値（型の重複は不可）</param>
+	template<class... Ts> Entity Create(Ts&&... components) {
+		assert(iterating_ == 0);
+		Archetype* archetype =
+		    GetOrCreateArchetype(MakeComponentMask<std::remove_cvref_t<Ts>...>());
+		Entity entity = entities_.Spawn();
+		EntityLocation location = archetype->Allocate(entity);
+		*entities_.Get(entity) = location;
+		(new (archetype->GetComponent(location, GetComponentId<std::remove_cvref_t<Ts>>()))
+		     std::remove_cvref_t<Ts>(std::forward<Ts>(components)),
+		 ...);
+		return entity;
+	}
+
+	/// <summary>
+	/// エンティティの削除
+	/// </summary>
+	void Destroy(Entity entity);
+
+	/// <summary>
+	/// エンティティの削除を予約（ForEach の中で使う。複数スレッドから呼べる）
+	/// </summary>
+	void DestroyDeferred(Entity entity);
+
+	/// <summary>
+	/// 予約した削除の実行
+	/// </summary>
+	void FlushDeferred();
+
+	/// <summary>
+	/// 指定したコンポーネントを全て持つエンティティの一括削除
+	/// </summary>
+	template<class... Ts> void DestroyAll() { DestroyAll(MakeComponentMask<Ts...>()); }
+	void DestroyAll(ComponentMask required);
+
+	/// <summary>
+	/// 全エンティティの削除
+	/// </summary>
+	void Clear() { DestroyAll(0); }
+
+	/// <summary>
+	/// エンティティが生存しているか
+	/// </summary>
+	bool IsAlive(Entity entity) const { return entities_.IsAlive(entity); }
+
+	/// <summary>
+	/// エンティティ数を取得
+	/// </summary>
+	size_t Size() const { return entities_.Size(); }
+
+	/// <summary>
+	/// アーキタイプ数を取得（アーキタイプは削除されないので増えるだけ）
+	/// </summary>
+	size_t GetArchetypeCount() const { return archetypes_.size(); }
+
+	/// <summary>
+	/// アーキタイプのコンポーネントの組み合わせを取得
+	/// </summary>
+	ComponentMask GetArchetypeMask(size_t index) const { return archetypes_[index]->GetMask(); }
+
+	/// <summary>
+	/// コンポーネントを持っているか
+	/// </summary>
+	template<class T> bool Has(Entity entity) const {
+		const EntityLocation* location = entities_.Get(entity);
+		return location && location->archetype->Has(GetComponentId<T>());
+	}
+
+	/// <summary>
+	/// コンポーネントの取得
+	/// </summary>
+	/// <returns>持っていなければnullptr</returns>
+	template<class T> T* Get(Entity entity) {
+		EntityLocation* location = entities_.Get(entity);
+		ComponentId id = GetComponentId<T>();
+		if (!location || !location->archetype->Has(id)) {
+			return nullptr;
+		}
+		return static_cast<T*>(location->archetype->GetComponent(*location, id));
+	}
+
+	/// <summary>
+	/// コンポーネントの追加（既に持っていれば上書き）
+	/// </summary>
+	template<class T> void Add(Entity entity, T component) {
+		assert(iterating_ == 0);
+		if (T* current = Get<T>(entity)) {
+			*current = std::move(component);
+			return;
+		}
+		EntityLocation* location = entities_.Get(entity);
+		assert(location);
+		ComponentId id = GetComponentId<T>();
+		Archetype* archetype =
+		    GetOrCreateArchetype(location->archetype->GetMask() | ComponentMask(1) << id);
+		EntityLocation moved = MoveEntity(entity, archetype);
+		new (archetype->GetComponent(moved, id)) T(std::move(component));
+	}
+
+	/// <summary>
+	/// コンポーネントの削除
+	/// </summary>
+	template<class T> void Remove(Entity entity) {
+		assert(iterating_ == 0);
+		if (!Has<T>(entity)) {
+			return;
+		}
+		EntityLocation* location = entities_.Get(entity);
+		ComponentMask mask = location->archetype->GetMask();
+		mask &= ~(ComponentMask(1) << GetComponentId<T>());
+		MoveEntity(entity, GetOrCreateArchetype(mask));
+	}
+
+	/// <summary>
+	/// チャンク単位の反復
+	/// fn(uint32_t count, const Entity* entities, Ts*... columns)
+	/// 構造を変更しない反復同士は別スレッドから同時に呼べる
+	/// </summary>
+	/// <param name="exclude">このコンポーネントを持つアーキタイプは除く</param>
+	template<class... Ts, class Fn> void ForEachChunk(Fn&& fn, ComponentMask exclude = 0) {
+		ComponentMask required = MakeComponentMask<Ts...>();
+		iterating_++;
+		for (Archetype* archetype : archetypes_) {
+			ComponentMask mask = archetype->GetMask();
+			if ((mask & required) != required || (mask & exclude) != 0) {
+				continue;
+			}
+			for (uint32_t c = 0; c < archetype->GetChunkCount(); c++) {
+				const Entity* entities = archetype->GetEntities(c);
+				fn(archetype->GetChunkSize(c), entities, archetype->GetColumn<Ts>(c)...);
+			}
+		}
+		iterating_--;
+	}
+
+	/// <summary>
+	/// エンティティ単位の反復
+	/// fn(Entity entity, Ts&... components)
+	/// </summary>
+	/// <param name="exclude">このコンポーネントを持つアーキタイプは除く</param>
+	template<class... Ts, class Fn> void ForEach(Fn&& fn, ComponentMask exclude = 0) {
+		ForEachChunk<Ts...>(
+		    [&fn](uint32_t count, const Entity* entities, Ts*... columns) {
+			    for (uint32_t i = 0; i < count; i++) {
+				    fn(entities[i], columns[i]...);
+			    }
+		    },
+		    exclude);
+	}
+
+private: // メンバ関数
+	/// <summary>
+	/// アーキタイプの取得（無ければ生成）
+	/// </summary>
+	Archetype* GetOrCreateArchetype(ComponentMask mask);
+
+	/// <summary>
+	/// エンティティを別のアーキタイプへ移す（共通のコンポーネントだけ移し、残りは破棄）
+	/// </summary>
+	/// <returns>移動先の場所（移動先にしか無いコンポーネントは未構築）</returns>
+	EntityLocation MoveEntity(Entity entity, Archetype* destination);
+
+	/// <summary>
+	/// 行の削除と、詰めるために移動したエンティティの場所の更新
+	/// </summary>
+	void RemoveRow(const EntityLocation& location);
+
+private: // メンバ変数
+	// エンティティ → 格納場所
+	ObjectPool<EntityLocation> entities_;
+	// コンポーネントの組み合わせ → アーキタイプ
+	std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> archetypeMap_;
+	// 生成順のアーキタイプ（反復用）
+	std::vector<Archetype*> archetypes_;
+	// 削除の予約
+	std::vector<Entity> pendingDestroy_;
+	std::mutex pendingMutex_;
+	// 反復中の数（反復中の構造変更を検出する）
+	std::atomic<int> iterating_ = 0;
+};
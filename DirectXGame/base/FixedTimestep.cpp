@@ -0,0 +1,56 @@
+#include "FixedTimestep.h"
+#include <cassert>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double stepSeconds, uint32_t maxStepsPerFrame)
+    : stepSeconds_(stepSeconds), maxStepsPerFrame_(maxStepsPerFrame) {
+	assert(stepSeconds_ > 0.0);
+	assert(maxStepsPerFrame_ > 0);
+	Reset();
+}
+
+void FixedTimestep::Reset() {
+	accumulator_ = 0.0;
+	reference_ = std::chrono::steady_clock::now();
+}
+
+uint32_t FixedTimestep::Advance() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed = now - reference_;
+	uint32_t steps = Advance(elapsed.count());
+	// 秒数への変換の丸めが積もらないよう、基準は今の時刻に揃える
+	reference_ = now;
+	return steps;
+}
+
+uint32_t FixedTimestep::Advance(double elapsedSeconds) {
+	if (elapsedSeconds > 0.0) {
+		accumulator_ += elapsedSeconds;
+		// 時計を使わない場合も、ステップの終わりの時刻は経過秒数ぶん進める
+		reference_ += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		    std::chrono::duration<double>(elapsedSeconds));
+	}
+
+	uint32_t steps = 0;
+	while (accumulator_ >= stepSeconds_ && steps < maxStepsPerFrame_) {
+		accumulator_ -= stepSeconds_;
+		steps++;
+	}
+
+	// 処理落ちで追いつけない分は捨てる（捨てないと1フレームのステップ数が増え続ける）
+	if (accumulator_ >= stepSeconds_) {
+		// 1ステップ未満の端数は補間用に残す
+		double dropped = std::floor(accumulator_ / stepSeconds_) * stepSeconds_;
+		droppedSeconds_ += dropped;
+		accumulator_ -= dropped;
+	}
+	steps_ = steps;
+	return steps;
+}
+
+std::chrono::steady_clock::time_point FixedTimestep::GetStepEndTime(uint32_t step) const {
+	assert(step < steps_);
+	double secondsBefore = accumulator_ + double(steps_ - 1 - step) * stepSeconds_;
+	return reference_ - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+	                        std::chrono::duration<double>(secondsBefore));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/// <summary>
+/// 固定刻みのシミュレーション時間の管理
+/// 経過した実時間を貯めておき、刻み幅ぶん貯まるごとに1ステップ進める。
+/// 余りは描画時の補間係数として使う。
+/// </summary>
+class FixedTimestep {
+public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="stepSeconds">1ステップの秒数</param>
+	/// <param name="maxStepsPerFrame">1フレームで進める最大ステップ数（超えた分は捨てる）</param>
+	explicit FixedTimestep(double stepSeconds = 1.0 / 60.0, uint32_t maxStepsPerFrame = 5);
+
+	/// <summary>
+	/// 貯めた時間を捨てて、計測の基準を現在時刻にする
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 前回からの実時間を貯めて、このフレームで進めるステップ数を返す
+	/// </summary>
+	uint32_t Advance();
+
+	/// <summary>
+	/// 指定した時間を貯めて、このフレームで進めるステップ数を返す（時計を使わない場合）
+	/// GetStepEndTime の基準の時刻も経過秒数ぶん進める。
+	/// </summary>
+	/// <param name="elapsedSeconds">経過秒数</param>
+	uint32_t Advance(double elapsedSeconds);
+
+	/// <summary>
+	/// 直前の2ステップの間のどこを描画するか（0で1つ前、1で最新のステップ）
+	/// </summary>
+	float GetAlpha() const { return static_cast<float>(accumulator_ / stepSeconds_); }
+
+	/// <summary>
+	/// 1ステップの秒数を取得
+	/// </summary>
+	double GetStepSeconds() const { return stepSeconds_; }
+
+	/// <summary>
+	/// 捨てた時間の合計を取得（処理落ちの目安）
+	/// </summary>
+	double GetDroppedSeconds() const { return droppedSeconds_; }
+
+	/// <summary>
+	/// 直前の Advance で進めるステップの終わりの実時刻を取得（入力イベントをステップに振り分ける）
+	/// 最後のステップは「今 - 余り」で終わり、その前のステップは刻み幅ずつ前で終わる。
+	/// 「今」は Advance() なら時計の時刻、Advance(double) なら Reset からの経過秒数の合計。
+	/// </summary>
+	/// <param name="step">何ステップ目か（0 から Advance() が返した数 - 1）</param>
+	std::chrono::steady_clock::time_point GetStepEndTime(uint32_t step) const;
+
+private: // メンバ変数
+	double stepSeconds_;
+	uint32_t maxStepsPerFrame_;
+	// まだステップに変換していない時間
+	double accumulator_ = 0.0;
+	double droppedSeconds_ = 0.0;
+	// 直前の Advance で進めるステップ数
+	uint32_t steps_ = 0;
+	std::chrono::steady_clock::time_point reference_;
+};
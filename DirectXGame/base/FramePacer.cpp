@@ -0,0 +1,158 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using Clock = FramePacer::Clock;
+
+// 眠りすぎの見積もりの初期値
+const Clock::duration kInitialOversleep = std::chrono::milliseconds(1);
+// 見積もりに加えて空回りする時間
+const Clock::duration kSpinGuard = std::chrono::microseconds(100);
+// 見積もりを上げるとき・下げるときの速さ（1回の計測で差の何分の1だけ動かすか）
+const int kOversleepRise = 2;
+const int kOversleepDecay = 16;
+// 眠らなかったフレームで見積もりを下げる速さ（下げないと計測できず大きいまま戻らない）
+const int kOversleepIdleDecay = 64;
+
+// steady_clock と sleep_for による時計
+class SystemTimer : public FramePacer::Timer {
+public:
+	Clock::time_point Now() override { return Clock::now(); }
+	void SleepFor(Clock::duration duration) override { std::this_thread::sleep_for(duration); }
+	void Spin() override { std::this_thread::yield(); }
+};
+
+double ToMilliseconds(Clock::duration duration) {
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+FramePacer::FramePacer(double targetRate, Timer* timer) : timer_(timer) {
+	if (!timer_) {
+		static SystemTimer systemTimer;
+		timer_ = &systemTimer;
+	}
+	history_.reserve(kHistorySize);
+	SetTargetRate(targetRate);
+	Reset();
+}
+
+void FramePacer::SetTargetRate(double targetRate) {
+	assert(targetRate >= 0.0);
+	targetRate_ = targetRate;
+	period_ = targetRate > 0.0 ? std::chrono::duration_cast<Clock::duration>(
+	                                 std::chrono::duration<double>(1.0 / targetRate))
+	                           : Clock::duration::zero();
+	// 前のフレームから数え直す
+	deadline_ = lastFrame_ + period_;
+}
+
+void FramePacer::Reset() {
+	started_ = false;
+	oversleep_ = kInitialOversleep;
+	history_.clear();
+	historyNext_ = 0;
+	missedDeadlines_ = 0;
+}
+
+void FramePacer::Wait() {
+	Clock::time_point now = timer_->Now();
+	if (!started_) {
+		// 最初のフレームは基準の時刻を決めるだけ
+		started_ = true;
+		lastFrame_ = now;
+		deadline_ = now + period_;
+		return;
+	}
+
+	if (period_ > Clock::duration::zero()) {
+		if (now < deadline_) {
+			// 手前までは眠り、残りは空回りする
+			Clock::time_point before = now;
+			now = SleepUntil(deadline_, now);
+			if (now == before) {
+				oversleep_ -= oversleep_ / kOversleepIdleDecay;
+			}
+			while (now < deadline_) {
+				timer_->Spin();
+				now = timer_->Now();
+			}
+			// 締め切りは前の締め切りから数える（起きた時刻から数えると遅れが積もる）
+			deadline_ += period_;
+		} else {
+			missedDeadlines_++;
+			// 1フレーム以上遅れたら今から数え直す（遅れを取り戻そうと連続で急がない）
+			deadline_ = now - deadline_ >= period_ ? now + period_ : deadline_ + period_;
+		}
+	}
+	Record(now);
+}
+
+FramePacer::Clock::time_point
+    FramePacer::SleepUntil(Clock::time_point deadline, Clock::time_point now) {
+	while (deadline - now > oversleep_ + kSpinGuard) {
+		Clock::duration request = deadline - now - oversleep_ - kSpinGuard;
+		timer_->SleepFor(request);
+		Clock::time_point woke = timer_->Now();
+
+		// 眠りすぎた時間で見積もりを更新（増えたら早めに、減ったらゆっくり合わせる）
+		Clock::duration observed = std::min(
+		    std::max(Clock::duration::zero(), woke - now - request), period_);
+		if (observed > oversleep_) {
+			oversleep_ += (observed - oversleep_) / kOversleepRise;
+		} else {
+			oversleep_ -= (oversleep_ - observed) / kOversleepDecay;
+		}
+		now = woke;
+	}
+	return now;
+}
+
+void FramePacer::Record(Clock::time_point now) {
+	Clock::duration frameTime = now - lastFrame_;
+	lastFrame_ = now;
+	if (history_.size() < kHistorySize) {
+		history_.push_back(frameTime);
+	} else {
+		history_[historyNext_] = frameTime;
+	}
+	historyNext_ = (historyNext_ + 1) % kHistorySize;
+}
+
+FramePacer::Stats FramePacer::GetStats() const {
+	Stats stats;
+	stats.missedDeadlines = missedDeadlines_;
+	stats.oversleepMs = ToMilliseconds(oversleep_);
+	if (history_.empty()) {
+		return stats;
+	}
+
+	std::vector<double> frameTimes(history_.size());
+	std::transform(history_.begin(), history_.end(), frameTimes.begin(), ToMilliseconds);
+	stats.frameCount = static_cast<uint32_t>(frameTimes.size());
+
+	double sum = 0.0;
+	for (double frameTime : frameTimes) {
+		sum += frameTime;
+	}
+	stats.meanMs = sum / frameTimes.size();
+	double variance = 0.0;
+	for (double frameTime : frameTimes) {
+		variance += (frameTime - stats.meanMs) * (frameTime - stats.meanMs);
+	}
+	stats.stdDevMs = std::sqrt(variance / frameTimes.size());
+
+	auto [minIt, maxIt] = std::minmax_element(frameTimes.begin(), frameTimes.end());
+	stats.minMs = *minIt;
+	stats.maxMs = *maxIt;
+
+	size_t p99 = static_cast<size_t>(std::ceil(frameTimes.size() * 0.99)) - 1;
+	std::nth_element(frameTimes.begin(), frameTimes.begin() + p99, frameTimes.end());
+	stats.p99Ms = frameTimes[p99];
+	return stats;
+}
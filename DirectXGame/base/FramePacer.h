@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// フレームレートの制限
+/// 締め切りの手前までは粗く眠り、残りは空回りして締め切りに合わせる。
+/// 眠りすぎた時間を計測して、空回りに切り替える余裕を自動で調整する。
+/// 時計は差し替えられるので、OSに依存せずに計測・検証できる。
+/// </summary>
+class FramePacer {
+public: // サブクラス
+	using Clock = std::chrono::steady_clock;
+
+	/// <summary>
+	/// 時計と待機（テストでは仮想の時計に差し替える）
+	/// </summary>
+	class Timer {
+	public:
+		virtual ~Timer() = default;
+		// 現在時刻
+		virtual Clock::time_point Now() = 0;
+		// 指定時間眠る（長めに眠ることがある）
+		virtual void SleepFor(Clock::duration duration) = 0;
+		// 空回り1回分
+		virtual void Spin() = 0;
+	};
+
+	/// <summary>
+	/// フレーム時間の統計（直近 kHistorySize フレーム）
+	/// </summary>
+	struct Stats {
+		uint32_t frameCount = 0;
+		double meanMs = 0.0;
+		double stdDevMs = 0.0; // ジッター
+		double minMs = 0.0;
+		double maxMs = 0.0;
+		double p99Ms = 0.0;
+		uint32_t missedDeadlines = 0; // 締め切りに間に合わなかった回数（累計）
+		double oversleepMs = 0.0;     // 眠りすぎの見積もり
+	};
+
+public: // 定数
+	// 統計に使うフレーム数
+	static const uint32_t kHistorySize = 240;
+
+public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="targetRate">目標のフレームレート（0なら制限しない）</param>
+	/// <param name="timer">時計（nullptrなら steady_clock と sleep_for を使う。所有しない）</param>
+	explicit FramePacer(double targetRate = 60.0, Timer* timer = nullptr);
+
+	/// <summary>
+	/// 目標のフレームレートの設定（0なら制限しない）
+	/// </summary>
+	void SetTargetRate(double targetRate);
+
+	/// <summary>
+	/// 目標のフレームレートの取得
+	/// </summary>
+	double GetTargetRate() const { return targetRate_; }
+
+	/// <summary>
+	/// 次の締め切りまで待つ（毎フレーム1回呼ぶ）
+	/// </summary>
+	void Wait();
+
+	/// <summary>
+	/// 締め切りと統計のリセット
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 統計の取得
+	/// </summary>
+	Stats GetStats() const;
+
+private: // メンバ関数
+	/// <summary>
+	/// 締め切りの手前まで眠る
+	/// </summary>
+	Clock::time_point SleepUntil(Clock::time_point deadline, Clock::time_point now);
+
+	/// <summary>
+	/// フレーム時間の記録
+	/// </summary>
+	void Record(Clock::time_point now);
+
+private: // メンバ変数
+	Timer* timer_;
+	double targetRate_ = 0.0;
+	Clock::duration period_{};
+
+	// 次の締め切り
+	Clock::time_point deadline_{};
+	// 前回 Wait を抜けた時刻
+	Clock::time_point lastFrame_{};
+	bool started_ = false;
+
+	// 眠りすぎの見積もり（この分だけ早めに起きて空回りする）
+	Clock::duration oversleep_;
+
+	// 直近のフレーム時間（リングバッファ）
+	std::vector<Clock::duration> history_;
+	uint32_t historyNext_ = 0;
+	uint32_t missedDeadlines_ = 0;
+};
@@ -0,0 +1,49 @@
+#include "FrameResourceRing.h"
+#include <cassert>
+
+void FrameResourceRing::Initialize(
+    Timeline* timeline, uint32_t frameCount, size_t uploadRegionSize) {
+	assert(timeline);
+	assert(1 <= frameCount && frameCount <= kMaxFrameCount);
+	timeline_ = timeline;
+	frameCount_ = frameCount;
+	frameIndex_ = 0;
+	lastSignaledValue_ = timeline_->GetCompletedValue();
+	frameValues_.fill(0);
+	waitCount_ = 0;
+	uploadRegionSize_ = uploadRegionSize;
+	uploadUsed_ = 0;
+}
+
+uint32_t FrameResourceRing::Advance() {
+	// 現在のフレームが終わったらこの値になる
+	frameValues_[frameIndex_] = ++lastSignaledValue_;
+	timeline_->Signal(lastSignaledValue_);
+
+	// 次のフレームのリソースを前に使ったフレームがGPUで終わるまで待つ
+	frameIndex_ = (frameIndex_ + 1) % frameCount_;
+	uint64_t value = frameValues_[frameIndex_];
+	if (timeline_->GetCompletedValue() < value) {
+		waitCount_++;
+		timeline_->WaitForValue(value);
+	}
+	uploadUsed_ = 0;
+	return frameIndex_;
+}
+
+void FrameResourceRing::WaitIdle() {
+	if (timeline_ && timeline_->GetCompletedValue() < lastSignaledValue_) {
+		timeline_->WaitForValue(lastSignaledValue_);
+	}
+}
+
+size_t FrameResourceRing::AllocateUpload(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	size_t offset = (uploadUsed_ + alignment - 1) & ~(alignment - 1);
+	// 大きすぎる size でも桁あふれしないよう、残りの大きさと比べる
+	if (offset > uploadRegionSize_ || size > uploadRegionSize_ - offset) {
+		return kInvalidOffset;
+	}
+	uploadUsed_ = offset + size;
+	return frameIndex_ * uploadRegionSize_ + offset;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// フレームごとのリソースの切り替え（複数フレームの同時実行）
+/// GPUの進み具合をタイムライン（D3D12ならフェンス）の値で追い、
+/// CPUがフレーム数ぶん先行して、次に使うリソースがまだGPUで使われているときだけ待つ。
+/// フレームごとのアップロード領域の割り当ても行う。
+/// </summary>
+class FrameResourceRing {
+public: // 定数
+	// 同時に実行するフレーム数の上限
+	static const uint32_t kMaxFrameCount = 3;
+	// 割り当てに失敗したときのオフセット
+	static const size_t kInvalidOffset = SIZE_MAX;
+
+public: // サブクラス
+	/// <summary>
+	/// GPUのタイムライン（テストでは仮想のGPUに差し替える）
+	/// </summary>
+	class Timeline {
+	public:
+		virtual ~Timeline() = default;
+		// ここまでに積んだ処理が終わったら完了値を value にする
+		virtual void Signal(uint64_t value) = 0;
+		// 完了値の取得
+		virtual uint64_t GetCompletedValue() = 0;
+		// 完了値が value 以上になるまで待つ
+		virtual void WaitForValue(uint64_t value) = 0;
+	};
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="timeline">GPUのタイムライン（所有しない）</param>
+	/// <param name="frameCount">同時に実行するフレーム数（1〜kMaxFrameCount）</param>
+	/// <param name="uploadRegionSize">フレームごとのアップロード領域の大きさ</param>
+	void Initialize(Timeline* timeline, uint32_t frameCount, size_t uploadRegionSize = 0);
+
+	/// <summary>
+	/// 現在のフレームを締めて、次のフレームのリソースが空くまで待つ
+	/// </summary>
+	/// <returns>次のフレームの番号</returns>
+	uint32_t Advance();
+
+	/// <summary>
+	/// GPUが全てのフレームを終えるまで待つ
+	/// </summary>
+	void WaitIdle();
+
+	/// <summary>
+	/// 現在のフレームのアップロード領域から割り当て
+	/// </summary>
+	/// <param name="size">大きさ</param>
+	/// <param name="alignment">アライメント（2の累乗）</param>
+	/// <returns>アップロードバッファ全体の先頭からのオフセット（足りなければ kInvalidOffset）</returns>
+	size_t AllocateUpload(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 現在のフレームの番号を取得
+	/// </summary>
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+
+	/// <summary>
+	/// 同時に実行するフレーム数を取得
+	/// </summary>
+	uint32_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 最後に積んだタイムラインの値を取得
+	/// </summary>
+	uint64_t GetLastSignaledValue() const { return lastSignaledValue_; }
+
+	/// <summary>
+	/// GPUを待った回数を取得
+	/// </summary>
+	uint64_t GetWaitCount() const { return waitCount_; }
+
+private: // メンバ変数
+	Timeline* timeline_ = nullptr;
+	uint32_t frameCount_ = 1;
+	uint32_t frameIndex_ = 0;
+	uint64_t lastSignaledValue_ = 0;
+	// 各フレームのリソースを最後に使ったフレームのタイムラインの値
+	std::array<uint64_t, kMaxFrameCount> frameValues_ = {};
+	uint64_t waitCount_ = 0;
+
+	// アップロード領域
+	size_t uploadRegionSize_ = 0;
+	size_t uploadUsed_ = 0;
+};
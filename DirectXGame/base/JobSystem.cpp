@@ -0,0 +1,313 @@
+#include "JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// 現在のスレッドの番号（ジョブシステム外のスレッドは-1）
+thread_local int32_t currentThreadIndex = -1;
+
+// 眠る前に空回りする回数
+const uint32_t kSpinCount = 64;
+
+// xorshift32
+uint32_t NextRandom(uint32_t& state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+} // namespace
+
+//----------------------------------------------
+// 両端キュー
+//----------------------------------------------
+
+bool JobSystem::WorkStealingQueue::Push(Job* job) {
+	int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	int64_t top = top_.load(std::memory_order_acquire);
+	if (bottom - top >= kCapacity) {
+		return false;
+	}
+	buffer_[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+	// ジョブの中身を盗む側から見えるようにしてから公開する
+	bottom_.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::WorkStealingQueue::Pop() {
+	int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	bottom_.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = top_.load(std::memory_order_relaxed);
+	if (top > bottom) {
+		// 空だった
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	Job* job = buffer_[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// 最後の1つは盗む側と取り合う
+		if (!top_.compare_exchange_strong(
+		        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			job = nullptr;
+		}
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::WorkStealingQueue::Steal() {
+	int64_t top = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = bottom_.load(std::memory_order_acquire);
+	if (top >= bottom) {
+		return nullptr;
+	}
+	Job* job = buffer_[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+	if (!top_.compare_exchange_strong(
+	        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		// 他のスレッドに先を越された
+		return nullptr;
+	}
+	return job;
+}
+
+int64_t JobSystem::WorkStealingQueue::Size() const {
+	int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	int64_t top = top_.load(std::memory_order_relaxed);
+	return std::max<int64_t>(0, bottom - top);
+}
+
+//----------------------------------------------
+// ジョブシステム
+//----------------------------------------------
+
+JobSystem* JobSystem::GetInstance() {
+	static JobSystem instance;
+	return &instance;
+}
+
+JobSystem::~JobSystem() { Finalize(); }
+
+void JobSystem::Initialize(
+    uint32_t workerCount, std::function<void()> threadBegin, std::function<void()> threadEnd) {
+	Finalize();
+	if (workerCount == 0) {
+		uint32_t hardware = std::thread::hardware_concurrency();
+		workerCount = hardware > 1 ? hardware - 1 : 0;
+	}
+	threadBegin_ = std::move(threadBegin);
+	threadEnd_ = std::move(threadEnd);
+	quit_ = false;
+	queuedJobs_ = 0;
+
+	for (uint32_t i = 0; i < workerCount + 1; i++) {
+		auto thread = std::make_unique<ThreadData>();
+		thread->jobs = std::make_unique<Job[]>(kMaxJobsPerThread);
+		thread->random = 0x9e3779b9u * (i + 1);
+		threads_.push_back(std::move(thread));
+	}
+	currentThreadIndex = 0;
+	for (uint32_t i = 1; i <= workerCount; i++) {
+		workers_.emplace_back(&JobSystem::WorkerMain, this, static_cast<int32_t>(i));
+	}
+}
+
+void JobSystem::Finalize() {
+	if (threads_.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		quit_ = true;
+	}
+	wakeUp_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+	threads_.clear();
+	externalQueue_.clear();
+	externalQueueSize_ = 0;
+	currentThreadIndex = -1;
+}
+
+int32_t JobSystem::GetCurrentThreadIndex() const {
+	if (currentThreadIndex < 0 || currentThreadIndex >= static_cast<int32_t>(threads_.size())) {
+		return -1;
+	}
+	return currentThreadIndex;
+}
+
+JobSystem::Job* JobSystem::AllocateJob() {
+	int32_t index = GetCurrentThreadIndex();
+	while (true) {
+		Job* job = nullptr;
+		if (index >= 0) {
+			ThreadData& thread = *threads_[index];
+			job = FindFreeJob(thread.jobs, thread.nextJob);
+		} else {
+			// ジョブシステム外のスレッド（初期化前も含む）は共有の領域から確保する
+			std::lock_guard<std::mutex> lock(externalMutex_);
+			if (!externalJobs_) {
+				externalJobs_ = std::make_unique<Job[]>(kMaxJobsPerThread);
+			}
+			job = FindFreeJob(externalJobs_, externalNextJob_);
+		}
+		if (job) {
+			return job;
+		}
+
+		// 同時に生きているジョブが多すぎる。生きているジョブを上書きしないよう、
+		// 実行待ちのジョブを実行して空くのを待つ
+		if (Job* next = FindJob(index)) {
+			Execute(next);
+		} else if (threads_.empty()) {
+			// 初期化前は Run でその場で実行するので、作っただけで実行していないジョブで
+			// 埋まっている。空くことはない
+			std::fprintf(stderr, "JobSystem: more than %u jobs are alive\n", kMaxJobsPerThread);
+			std::abort();
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+JobSystem::Job* JobSystem::FindFreeJob(std::unique_ptr<Job[]>& jobs, uint32_t& nextJob) {
+	// 普段は次のジョブが空いている。一周して未完了のジョブに当たったら飛ばす
+	for (uint32_t i = 0; i < kMaxJobsPerThread; i++) {
+		Job* job = &jobs[nextJob++ % kMaxJobsPerThread];
+		// 完了させたスレッドの書き込みが済んでから再利用する
+		if (job->unfinished.load(std::memory_order_acquire) == 0) {
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::Run(Job* job) {
+	if (threads_.empty()) {
+		// 初期化前はその場で実行
+		Execute(job);
+		return;
+	}
+	int32_t index = GetCurrentThreadIndex();
+	queuedJobs_.fetch_add(1, std::memory_order_seq_cst);
+	if (index >= 0) {
+		if (!threads_[index]->queue.Push(job)) {
+			// キューが一杯ならその場で実行
+			queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+			Execute(job);
+			return;
+		}
+	} else {
+		std::lock_guard<std::mutex> lock(externalMutex_);
+		externalQueue_.push_back(job);
+		externalQueueSize_.fetch_add(1, std::memory_order_release);
+	}
+	// 眠っているワーカーがいれば起こす
+	if (sleepingWorkers_.load(std::memory_order_seq_cst) > 0) {
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		wakeUp_.notify_one();
+	}
+}
+
+void JobSystem::Wait(const Job* job) {
+	int32_t index = GetCurrentThreadIndex();
+	while (job->unfinished.load(std::memory_order_acquire) > 0) {
+		if (Job* next = FindJob(index)) {
+			Execute(next);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+JobSystem::Job* JobSystem::FindJob(int32_t threadIndex) {
+	if (threads_.empty()) {
+		return nullptr;
+	}
+	Job* job = nullptr;
+	if (threadIndex >= 0) {
+		job = threads_[threadIndex]->queue.Pop();
+	}
+	if (!job && externalQueueSize_.load(std::memory_order_acquire) > 0) {
+		std::lock_guard<std::mutex> lock(externalMutex_);
+		if (!externalQueue_.empty()) {
+			job = externalQueue_.front();
+			externalQueue_.pop_front();
+			externalQueueSize_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+	if (!job) {
+		// 乱数で選んだ相手から順に盗む
+		uint32_t count = static_cast<uint32_t>(threads_.size());
+		uint32_t start = threadIndex >= 0 ? NextRandom(threads_[threadIndex]->random) : 0;
+		for (uint32_t i = 0; i < count && !job; i++) {
+			uint32_t victim = (start + i) % count;
+			if (static_cast<int32_t>(victim) != threadIndex) {
+				job = threads_[victim]->queue.Steal();
+			}
+		}
+	}
+	if (job) {
+		queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+void JobSystem::Execute(Job* job) {
+	job->function(job);
+	Finish(job);
+}
+
+void JobSystem::Finish(Job* job) {
+	// 最後の1つが終わったら親へ伝える（完了後のジョブは再利用され得るので先に親を読む）
+	while (job) {
+		Job* parent = job->parent;
+		if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+			break;
+		}
+		job = parent;
+	}
+}
+
+bool JobSystem::IsLocalQueueEmpty() const {
+	int32_t index = GetCurrentThreadIndex();
+	return index < 0 || threads_[index]->queue.Size() == 0;
+}
+
+void JobSystem::WorkerMain(int32_t threadIndex) {
+	currentThreadIndex = threadIndex;
+	if (threadBegin_) {
+		threadBegin_();
+	}
+
+	uint32_t idle = 0;
+	while (!quit_.load(std::memory_order_relaxed)) {
+		if (Job* job = FindJob(threadIndex)) {
+			Execute(job);
+			idle = 0;
+			continue;
+		}
+		if (++idle < kSpinCount) {
+			std::this_thread::yield();
+			continue;
+		}
+		// しばらく仕事が無ければ眠る（投入時に起こされる）
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+		wakeUp_.wait(lock, [this] {
+			return quit_.load(std::memory_order_relaxed) ||
+			       queuedJobs_.load(std::memory_order_seq_cst) > 0;
+		});
+		sleepingWorkers_.fetch_sub(1, std::memory_order_relaxed);
+		idle = 0;
+	}
+
+	if (threadEnd_) {
+		threadEnd_();
+	}
+}
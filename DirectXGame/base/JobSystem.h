@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// ワークスティーリング型のジョブシステム
+/// スレッドごとに Chase-Lev 型の両端キューを持ち、自分のキューは後ろから(LIFO)、
+/// 空になったら他スレッドのキューの前から(FIFO)盗んで実行する。
+/// ジョブは親を持てて、親は自分と全ての子が終わるまで完了しない。
+/// </summary>
+class JobSystem {
+public: // 定数
+	// ジョブに埋め込める関数オブジェクトの大きさ
+	static const size_t kJobDataSize = 96;
+	// スレッドごとのジョブの数（全て生きているときに作ると、空くまで他のジョブを実行して待つ）
+	static const uint32_t kMaxJobsPerThread = 4096;
+
+public: // サブクラス
+	// ジョブ
+	struct alignas(64) Job {
+		void (*function)(Job* job) = nullptr;
+		Job* parent = nullptr;
+		// 自分と子の未完了数（0で完了）
+		std::atomic<int32_t> unfinished = 0;
+		alignas(16) unsigned char data[kJobDataSize];
+	};
+
+public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	static JobSystem* GetInstance();
+
+public: // メンバ関数
+	/// <summary>
+	/// 初期化（呼び出したスレッドがメインスレッドになる）
+	/// </summary>
+	/// <param name="workerCount">ワーカースレッド数（0ならハードウェアのスレッド数 - 1）</param>
+	/// <param name="threadBegin">ワーカースレッドの開始時に呼ぶ処理（COMの初期化など）</param>
+	/// <param name="threadEnd">ワーカースレッドの終了時に呼ぶ処理</param>
+	void Initialize(
+	    uint32_t workerCount = 0, std::function<void()> threadBegin = nullptr,
+	    std::function<void()> threadEnd = nullptr);
+
+	/// <summary>
+	/// 終了処理（ワーカーを止める。実行待ちのジョブは捨てる）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// ジョブの生成
+	/// </summary>
+	/// <param name="function">処理（kJobDataSize 以下の関数オブジェクト）</param>
+	/// <param name="parent">親ジョブ（親はこのジョブが終わるまで完了しない）</param>
+	template<class Fn> Job* CreateJob(Fn&& function, Job* parent = nullptr) {
+		using Function = std::decay_t<Fn>;
+		static_assert(sizeof(Function) <= kJobDataSize, "job function is too large");
+		static_assert(alignof(Function) <= 16, "job function is over-aligned");
+		Job* job = AllocateJob();
+		job->function = [](Job* self) {
+			Function* stored = std::launder(reinterpret_cast<Function*>(self->data));
+			(*stored)();
+			stored->~Function();
+		};
+		job->parent = parent;
+		job->unfinished.store(1, std::memory_order_relaxed);
+		if (parent) {
+			parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+		}
+		new (job->data) Function(std::forward<Fn>(function));
+		return job;
+	}
+
+	/// <summary>
+	/// ジョブの実行を予約（キューが一杯ならその場で実行）
+	/// </summary>
+	void Run(Job* job);
+
+	/// <summary>
+	/// ジョブの完了待ち（待つ間は他のジョブを実行する）
+	/// </summary>
+	void Wait(const Job* job);
+
+	/// <summary>
+	/// 範囲を分割して並列実行し、全て終わるまで待つ
+	/// 自分のキューが空のとき（他スレッドが盗んでいったとき）だけ残りを半分に分けるので、
+	/// 暇なスレッドの数に合わせて分割の細かさが決まる。
+	/// </summary>
+	/// <param name="begin">開始</param>
+	/// <param name="end">終了（含まない）</param>
+	/// <param name="function">function(uint32_t begin, uint32_t end)</param>
+	/// <param name="minGrain">これ以上は分割しない個数（0なら自動）</param>
+	template<class Fn>
+	void ParallelFor(uint32_t begin, uint32_t end, const Fn& function, uint32_t minGrain = 0) {
+		if (begin >= end) {
+			return;
+		}
+		if (threads_.empty()) {
+			// 初期化前はそのまま実行
+			function(begin, end);
+			return;
+		}
+		if (minGrain == 0) {
+			minGrain = std::max(1u, (end - begin) / (GetThreadCount() * 32));
+		}
+		Job* root = CreateJob([] {});
+		ParallelForRange(root, begin, end, minGrain, function);
+		Run(root);
+		Wait(root);
+	}
+
+	/// <summary>
+	/// メインスレッドを含むスレッド数を取得
+	/// </summary>
+	uint32_t GetThreadCount() const {
+		return std::max<uint32_t>(1, static_cast<uint32_t>(threads_.size()));
+	}
+
+	/// <summary>
+	/// 現在のスレッドの番号を取得（0がメインスレッド、ジョブシステム外のスレッドは-1）
+	/// </summary>
+	int32_t GetCurrentThreadIndex() const;
+
+private: // サブクラス
+	/// <summary>
+	/// Chase-Lev 型の両端キュー（固定長）
+	/// </summary>
+	class WorkStealingQueue {
+	public:
+		static const int64_t kCapacity = 4096;
+
+		// 持ち主が後ろに積む
+		bool Push(Job* job);
+		// 持ち主が後ろから取る
+		Job* Pop();
+		// 他スレッドが前から盗む
+		Job* Steal();
+		// 持ち主から見たおおよその数
+		int64_t Size() const;
+
+	private:
+		alignas(64) std::atomic<int64_t> top_ = 0;
+		alignas(64) std::atomic<int64_t> bottom_ = 0;
+		std::atomic<Job*> buffer_[kCapacity] = {};
+	};
+
+	// スレッドごとのデータ
+	struct ThreadData {
+		WorkStealingQueue queue;
+		std::unique_ptr<Job[]> jobs;
+		uint32_t nextJob = 0;
+		uint32_t random = 0; // 盗む相手を選ぶ乱数の状態
+	};
+
+private: // メンバ関数
+	JobSystem() = default;
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/// <summary>
+	/// ジョブの確保（空きが無ければ、実行待ちのジョブを実行しながら空くのを待つ）
+	/// </summary>
+	Job* AllocateJob();
+
+	/// <summary>
+	/// 空いているジョブを1周分探す（全て生きていれば nullptr）
+	/// </summary>
+	Job* FindFreeJob(std::unique_ptr<Job[]>& jobs, uint32_t& nextJob);
+
+	/// <summary>
+	/// 実行できるジョブを探す（自分のキュー → 外部からの投入 → 他スレッドから盗む）
+	/// </summary>
+	Job* FindJob(int32_t threadIndex);
+
+	/// <summary>
+	/// ジョブの実行と完了の伝播
+	/// </summary>
+	void Execute(Job* job);
+	void Finish(Job* job);
+
+	/// <summary>
+	/// 自分のキューが空か（ジョブシステム外のスレッドは常に空扱い）
+	/// </summary>
+	bool IsLocalQueueEmpty() const;
+
+	/// <summary>
+	/// ParallelFor の1区間の処理
+	/// </summary>
+	template<class Fn>
+	void ParallelForRange(
+	    Job* root, uint32_t begin, uint32_t end, uint32_t grain, const Fn& function) {
+		while (begin < end) {
+			if (end - begin > grain && IsLocalQueueEmpty()) {
+				// 後ろ半分を盗まれる用に積む
+				uint32_t mid = begin + (end - begin) / 2;
+				Run(CreateJob(
+				    [this, root, mid, end, grain, &function] {
+					    ParallelForRange(root, mid, end, grain, function);
+				    },
+				    root));
+				end = mid;
+				continue;
+			}
+			uint32_t stop = std::min(end, begin + grain);
+			function(begin, stop);
+			begin = stop;
+		}
+	}
+
+	/// <summary>
+	/// ワーカースレッドの処理
+	/// </summary>
+	void WorkerMain(int32_t threadIndex);
+
+private: // メンバ変数
+	// スレッドごとのデータ（0がメインスレッド）
+	std::vector<std::unique_ptr<ThreadData>> threads_;
+	std::vector<std::thread> workers_;
+	std::function<void()> threadBegin_;
+	std::function<void()> threadEnd_;
+	std::atomic<bool> quit_ = false;
+
+	// ジョブシステム外のスレッドから投入されたジョブ
+	std::mutex externalMutex_;
+	std::deque<Job*> externalQueue_;
+	std::atomic<int32_t> externalQueueSize_ = 0;
+	std::unique_ptr<Job[]> externalJobs_;
+	uint32_t externalNextJob_ = 0;
+
+	// 実行待ちのジョブ数（眠っているワーカーを起こすかの判断用）
+	std::atomic<int64_t> queuedJobs_ = 0;
+	std::atomic<int32_t> sleepingWorkers_ = 0;
+	std::mutex sleepMutex_;
+	std::condition_variable wakeUp_;
+};
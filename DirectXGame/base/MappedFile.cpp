@@ -0,0 +1,129 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { Swap(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Close();
+		Swap(other);
+	}
+	return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept {
+	std::swap(data_, other.data_);
+	std::swap(size_, other.size_);
+	std::swap(isOpen_, other.isOpen_);
+#ifdef _WIN32
+	std::swap(fileHandle_, other.fileHandle_);
+	std::swap(mappingHandle_, other.mappingHandle_);
+#else
+	std::swap(fileDescriptor_, other.fileDescriptor_);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& fileName) {
+	Close();
+	HANDLE file = CreateFileA(
+	    fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	    FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	fileHandle_ = file;
+	isOpen_ = true;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		Close();
+		return false;
+	}
+	// 空のファイルはマップできないので中身が空のまま開いたことにする
+	if (fileSize.QuadPart == 0) {
+		return true;
+	}
+	mappingHandle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle_) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		Close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle_) {
+		CloseHandle(mappingHandle_);
+	}
+	if (fileHandle_) {
+		CloseHandle(fileHandle_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+	fileHandle_ = nullptr;
+	mappingHandle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& fileName) {
+	Close();
+	fileDescriptor_ = open(fileName.c_str(), O_RDONLY);
+	if (fileDescriptor_ < 0) {
+		return false;
+	}
+	isOpen_ = true;
+
+	struct stat status;
+	if (fstat(fileDescriptor_, &status) != 0 || !S_ISREG(status.st_mode)) {
+		Close();
+		return false;
+	}
+	if (status.st_size == 0) {
+		return true;
+	}
+	void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor_, 0);
+	if (data == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(data);
+	size_ = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+	if (fileDescriptor_ >= 0) {
+		close(fileDescriptor_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+	fileDescriptor_ = -1;
+}
+
+#endif
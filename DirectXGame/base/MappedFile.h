@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/// <summary>
+/// 読み込み専用のメモリマップトファイル
+/// ファイルの中身をコピーせずにアドレス空間へ割り当てる。触れたページだけOSが読み込む。
+/// </summary>
+class MappedFile {
+public: // メンバ関数
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/// <summary>
+	/// 開く
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>開けたか（空のファイルは中身が空のまま開ける）</returns>
+	bool Open(const std::string& fileName);
+
+	/// <summary>
+	/// 閉じる（中身を指すポインタは使えなくなる）
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return isOpen_; }
+	// ファイルの中身
+	std::span<const uint8_t> GetBytes() const { return {data_, size_}; }
+
+private: // メンバ関数
+	void Swap(MappedFile& other) noexcept;
+
+private: // メンバ変数
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+	bool isOpen_ = false;
+#ifdef _WIN32
+	void* fileHandle_ = nullptr;    // HANDLE
+	void* mappingHandle_ = nullptr; // HANDLE
+#else
+	int fileDescriptor_ = -1;
+#endif
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// 世代付きハンドルで参照するオブジェクトプール
+/// 生存中のオブジェクトは配列の先頭に詰めて並べ、削除は末尾との入れ替えで行う。
+/// 削除したオブジェクトは末尾に残して次の生成で再利用する（定数バッファ等を作り直さない）。
+/// 世代が一周したスロットは使わなくする（一周前の古いハンドルが有効に戻らないように）。
+/// </summary>
+/// <typeparam name="Generation">世代の型（符号なし整数）</typeparam>
+template<class T, class Generation = uint32_t> class ObjectPool {
+	static_assert(std::is_unsigned_v<Generation>, "Generation must be an unsigned integer");
+
+public: // サブクラス
+	// ハンドル
+	struct Handle {
+		uint32_t index = kInvalidIndex; // スロット番号
+		Generation generation = 0;      // 世代（削除のたびに増える）
+
+		bool operator==(const Handle& other) const {
+			return index == other.index && generation == other.generation;
+		}
+	};
+
+	// 無効なスロット番号
+	static const uint32_t kInvalidIndex = 0xffffffffu;
+
+public: // メンバ関数
+	/// <summary>
+	/// 生成（空きスロットの取得はO(1)）
+	/// </summary>
+	/// <returns>ハンドル</returns>
+	Handle Spawn() {
+		uint32_t slotIndex;
+		if (freeHead_ != kInvalidIndex) {
+			// 空きリストから取り出す
+			slotIndex = freeHead_;
+			freeHead_ = slots_[slotIndex].dense;
+		} else {
+			slotIndex = static_cast<uint32_t>(slots_.size());
+			slots_.push_back({});
+		}
+
+		// 削除済みの領域が残っていれば再利用する
+		if (count_ == dense_.size()) {
+			dense_.emplace_back();
+			denseToSlot_.push_back(slotIndex);
+		} else {
+			denseToSlot_[count_] = slotIndex;
+		}
+		slots_[slotIndex].dense = static_cast<uint32_t>(count_);
+		count_++;
+		return {slotIndex, slots_[slotIndex].generation};
+	}
+
+	/// <summary>
+	/// 削除（末尾の生存オブジェクトと入れ替える）
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	/// <returns>削除できたか</returns>
+	bool Despawn(Handle handle) {
+		if (!IsAlive(handle)) {
+			return false;
+		}
+		uint32_t dense = slots_[handle.index].dense;
+		uint32_t last = static_cast<uint32_t>(count_ - 1);
+		if (dense != last) {
+			std::swap(dense_[dense], dense_[last]);
+			std::swap(denseToSlot_[dense], denseToSlot_[last]);
+			slots_[denseToSlot_[dense]].dense = dense;
+		}
+		count_--;
+
+		// 世代を進めて古いハンドルを無効にし、空きリストへ
+		Slot& slot = slots_[handle.index];
+		slot.generation++;
+		if (slot.generation == 0) {
+			// 一周したスロットは空きリストに戻さない
+			slot.dense = kInvalidIndex;
+			retiredCount_++;
+			return true;
+		}
+		slot.dense = freeHead_;
+		freeHead_ = handle.index;
+		return true;
+	}
+
+	/// <summary>
+	/// 全削除
+	/// </summary>
+	void Clear() {
+		while (count_ > 0) {
+			Despawn(GetHandle(count_ - 1));
+		}
+	}
+
+	/// <summary>
+	/// ハンドルが有効か
+	/// </summary>
+	bool IsAlive(Handle handle) const {
+		if (handle.index >= slots_.size()) {
+			return false;
+		}
+		const Slot& slot = slots_[handle.index];
+		return slot.generation == handle.generation && slot.dense < count_ &&
+		       denseToSlot_[slot.dense] == handle.index;
+	}
+
+	/// <summary>
+	/// ハンドルからオブジェクトを取得
+	/// </summary>
+	/// <returns>無効なハンドルならnullptr</returns>
+	T* Get(Handle handle) {
+		return IsAlive(handle) ? &dense_[slots_[handle.index].dense] : nullptr;
+	}
+	const T* Get(Handle handle) const {
+		return IsAlive(handle) ? &dense_[slots_[handle.index].dense] : nullptr;
+	}
+
+	/// <summary>
+	/// 生存数を取得
+	/// </summary>
+	size_t Size() const { return count_; }
+
+	/// <summary>
+	/// 世代が一周して使わなくしたスロットの数を取得
+	/// </summary>
+	size_t GetRetiredCount() const { return retiredCount_; }
+
+	/// <summary>
+	/// 詰めて並べた配列の番号でアクセス
+	/// </summary>
+	T& operator[](size_t denseIndex) {
+		assert(denseIndex < count_);
+		return dense_[denseIndex];
+	}
+	const T& operator[](size_t denseIndex) const {
+		assert(denseIndex < count_);
+		return dense_[denseIndex];
+	}
+
+	/// <summary>
+	/// 詰めて並べた配列の番号からハンドルを取得
+	/// </summary>
+	Handle GetHandle(size_t denseIndex) const {
+		assert(denseIndex < count_);
+		uint32_t slotIndex = denseToSlot_[denseIndex];
+		return {slotIndex, slots_[slotIndex].generation};
+	}
+
+	// 生存中のオブジェクトだけを範囲forで回す
+	T* begin() { return dense_.data(); }
+	T* end() { return dense_.data() + count_; }
+	const T* begin() const { return dense_.data(); }
+	const T* end() const { return dense_.data() + count_; }
+
+private: // サブクラス
+	struct Slot {
+		// 生存中は dense_ の番号、空きのときは次の空きスロット
+		uint32_t dense = kInvalidIndex;
+		Generation generation = 0;
+	};
+
+private: // メンバ変数
+	// 詰めて並べたオブジェクト（count_ 以降は削除済みで再利用待ち）
+	std::vector<T> dense_;
+	// dense_ の番号 → スロット番号
+	std::vector<uint32_t> denseToSlot_;
+	// スロット
+	std::vector<Slot> slots_;
+	// 空きリストの先頭
+	uint32_t freeHead_ = kInvalidIndex;
+	// 生存数
+	size_t count_ = 0;
+	// 使わなくしたスロットの数
+	size_t retiredCount_ = 0;
+};
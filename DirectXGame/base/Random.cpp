@@ -0,0 +1,187 @@
+#include "Random.h"
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RANDOM_SSE2
+#endif
+
+namespace {
+
+// 種から状態を作る (SplitMix64)
+uint64_t SplitMix64(uint64_t& x) {
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+inline uint32_t Rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+// 1ステップ進めて出力
+inline uint32_t Next(uint32_t s[4]) {
+	uint32_t result = Rotl(s[1] * 5, 7) * 9;
+	uint32_t t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = Rotl(s[3], 11);
+	return result;
+}
+
+// 多項式に従って進める（Jump・LongJump の共通部分）
+void JumpBy(uint32_t s[4], const uint32_t (&polynomial)[4]) {
+	uint32_t jumped[4] = {};
+	for (uint32_t word : polynomial) {
+		for (int b = 0; b < 32; b++) {
+			if (word >> b & 1) {
+				for (int i = 0; i < 4; i++) {
+					jumped[i] ^= s[i];
+				}
+			}
+			Next(s);
+		}
+	}
+	std::memcpy(s, jumped, sizeof(jumped));
+}
+
+const uint32_t kJump[4] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+const uint32_t kLongJump[4] = {0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662};
+
+#if defined(RANDOM_SSE2)
+
+inline __m128i Rotl4(__m128i x, int k) {
+	return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+}
+
+// 4レーンを1ステップ進めて出力（x * 5 と x * 9 はシフトと加算）
+inline __m128i Next4(__m128i s[4]) {
+	__m128i times5 = _mm_add_epi32(_mm_slli_epi32(s[1], 2), s[1]);
+	__m128i rotated = Rotl4(times5, 7);
+	__m128i result = _mm_add_epi32(_mm_slli_epi32(rotated, 3), rotated);
+	__m128i t = _mm_slli_epi32(s[1], 9);
+	s[2] = _mm_xor_si128(s[2], s[0]);
+	s[3] = _mm_xor_si128(s[3], s[1]);
+	s[1] = _mm_xor_si128(s[1], s[2]);
+	s[0] = _mm_xor_si128(s[0], s[3]);
+	s[2] = _mm_xor_si128(s[2], t);
+	s[3] = Rotl4(s[3], 11);
+	return result;
+}
+
+#endif
+
+} // namespace
+
+void Random::Seed(uint64_t seed, uint64_t stream) {
+	// ストリーム番号を混ぜてから種を広げる
+	uint64_t streamState = stream;
+	uint64_t x = seed ^ SplitMix64(streamState);
+	uint64_t a = SplitMix64(x);
+	uint64_t b = SplitMix64(x);
+	state_[0] = static_cast<uint32_t>(a);
+	state_[1] = static_cast<uint32_t>(a >> 32);
+	state_[2] = static_cast<uint32_t>(b);
+	state_[3] = static_cast<uint32_t>(b >> 32);
+	// 状態が全て0だと0しか出ない
+	if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0) {
+		state_[0] = 1;
+	}
+}
+
+uint32_t Random::NextU32() { return Next(state_); }
+
+uint32_t Random::NextBelow(uint32_t bound) {
+	assert(bound > 0);
+	// 掛け算の上位32ビットを使い、偏る端だけ引き直す (Lemire)
+	uint64_t m = static_cast<uint64_t>(NextU32()) * bound;
+	uint32_t low = static_cast<uint32_t>(m);
+	if (low < bound) {
+		uint32_t threshold = (0u - bound) % bound;
+		while (low < threshold) {
+			m = static_cast<uint64_t>(NextU32()) * bound;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+	return static_cast<uint32_t>(m >> 32);
+}
+
+int Random::NextInt(int min, int max) {
+	assert(min <= max);
+	uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+	uint32_t offset = range == UINT32_MAX ? NextU32() : NextBelow(range + 1);
+	return static_cast<int>(static_cast<uint32_t>(min) + offset);
+}
+
+float Random::NextFloat() {
+	// 上位24ビットを仮数に使う
+	return static_cast<float>(NextU32() >> 8) * (1.0f / 16777216.0f);
+}
+
+void Random::Jump() { JumpBy(state_, kJump); }
+
+void Random::LongJump() { JumpBy(state_, kLongJump); }
+
+Random Random::Split() {
+	Random result = *this;
+	Jump();
+	return result;
+}
+
+void Random::Fill(uint32_t* out, size_t count) {
+	// レーン j は自身を j 回 Jump した列
+	uint32_t lanes[4][4];
+	std::memcpy(lanes[0], state_, sizeof(state_));
+	for (int j = 1; j < 4; j++) {
+		std::memcpy(lanes[j], lanes[j - 1], sizeof(state_));
+		JumpBy(lanes[j], kJump);
+	}
+
+#if defined(RANDOM_SSE2)
+	// 状態の k 番目の語を4レーン分まとめる
+	__m128i s[4];
+	for (int k = 0; k < 4; k++) {
+		s[k] = _mm_set_epi32(
+		    static_cast<int>(lanes[3][k]), static_cast<int>(lanes[2][k]),
+		    static_cast<int>(lanes[1][k]), static_cast<int>(lanes[0][k]));
+	}
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Next4(s));
+	}
+	if (i < count) {
+		alignas(16) uint32_t tail[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(tail), Next4(s));
+		std::memcpy(out + i, tail, (count - i) * sizeof(uint32_t));
+	}
+	// レーン0の状態を取り出す
+	for (int k = 0; k < 4; k++) {
+		state_[k] = static_cast<uint32_t>(_mm_cvtsi128_si32(s[k]));
+	}
+#else
+	for (size_t i = 0; i < count; i += 4) {
+		for (int j = 0; j < 4; j++) {
+			uint32_t value = Next(lanes[j]);
+			if (i + j < count) {
+				out[i + j] = value;
+			}
+		}
+	}
+	std::memcpy(state_, lanes[0], sizeof(state_));
+#endif
+}
+
+bool Random::operator==(const Random& other) const {
+	return std::memcmp(state_, other.state_, sizeof(state_)) == 0;
+}
+
+const char* GetRandomKernelName() {
+#if defined(RANDOM_SSE2)
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
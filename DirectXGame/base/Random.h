@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 乱数生成器（xoshiro128**）
+/// 状態は128ビットで、種とストリーム番号が同じなら同じ列になる。
+/// システムごとに別のストリームを持てば、実行順やスレッドによらず結果が決まる。
+/// </summary>
+class Random {
+public: // メンバ関数
+	Random() { Seed(0); }
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="seed">種</param>
+	/// <param name="stream">ストリーム番号（同じ種でも番号ごとに別の列になる）</param>
+	explicit Random(uint64_t seed, uint64_t stream = 0) { Seed(seed, stream); }
+
+	/// <summary>
+	/// 種の設定
+	/// </summary>
+	void Seed(uint64_t seed, uint64_t stream = 0);
+
+	/// <summary>
+	/// 32ビットの乱数
+	/// </summary>
+	uint32_t NextU32();
+
+	/// <summary>
+	/// [0, bound) の整数（偏りなし）
+	/// </summary>
+	uint32_t NextBelow(uint32_t bound);
+
+	/// <summary>
+	/// [min, max] の整数
+	/// </summary>
+	int NextInt(int min, int max);
+
+	/// <summary>
+	/// [0, 1) の実数
+	/// </summary>
+	float NextFloat();
+
+	/// <summary>
+	/// [min, max) の実数
+	/// </summary>
+	float NextFloat(float min, float max) { return min + (max - min) * NextFloat(); }
+
+	/// <summary>
+	/// 2^64 回分進める（並列のワーカーに重ならない列を配る）
+	/// </summary>
+	void Jump();
+
+	/// <summary>
+	/// 2^96 回分進める（Jump で配る列のまとまりを更に分ける）
+	/// </summary>
+	void LongJump();
+
+	/// <summary>
+	/// 現在の列を複製して返し、自身は Jump する
+	/// </summary>
+	Random Split();
+
+	/// <summary>
+	/// まとめて生成（4本の列をSIMDで並べて進める）
+	/// out[4 * i + j] は自身を j 回 Jump した列の i 番目になり、SIMDの有無で結果は変わらない。
+	/// 生成後は自身の列がその分だけ進む。
+	/// </summary>
+	void Fill(uint32_t* out, size_t count);
+
+	/// <summary>
+	/// 状態が等しいか
+	/// </summary>
+	bool operator==(const Random& other) const;
+
+private: // メンバ変数
+	uint32_t state_[4] = {};
+};
+
+/// <summary>
+/// 使用中のまとめて生成のカーネル名を取得
+/// </summary>
+/// <returns>"SSE2", "Scalar" のいずれか</returns>
+const char* GetRandomKernelName();
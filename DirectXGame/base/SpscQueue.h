@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 1対1のスレッド間のロックフリーなキュー（固定長のリング）
+/// 積むのは1つのスレッドだけ、取り出すのも1つのスレッドだけ。確保もロックもしない。
+/// </summary>
+/// <typeparam name="T">要素（コピーできる型）</typeparam>
+/// <typeparam name="Capacity">容量（2の累乗）</typeparam>
+template<class T, size_t Capacity> class SpscQueue {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
+
+public: // メンバ関数
+	/// <summary>
+	/// 積む（積む側のスレッドから呼ぶ）
+	/// </summary>
+	/// <returns>積めたか（満杯なら false）</returns>
+	bool Push(const T& value) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		items_[tail & (Capacity - 1)] = value;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// 取り出す（取り出す側のスレッドから呼ぶ）
+	/// </summary>
+	/// <returns>取り出せたか（空なら false）</returns>
+	bool Pop(T& value) {
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = items_[head & (Capacity - 1)];
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// 積んである数（他方のスレッドが動いている間は目安）
+	/// </summary>
+	size_t Size() const {
+		return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+	}
+
+private: // メンバ変数
+	// 積む側と取り出す側が同じキャッシュラインを書き合わないように離す
+	alignas(64) std::atomic<size_t> head_ = 0;
+	alignas(64) std::atomic<size_t> tail_ = 0;
+	alignas(64) std::array<T, Capacity> items_ = {};
+};
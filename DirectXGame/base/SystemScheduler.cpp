@@ -0,0 +1,133 @@
+#include "SystemScheduler.h"
+
+namespace {
+
+// アーキタイプが対象に含まれるか
+bool Matches(const SystemAccess& access, ComponentMask mask) {
+	return (mask & access.required) == access.required && (mask & access.exclude) == 0;
+}
+
+} // namespace
+
+void SystemScheduler::AddSystem(
+    std::string name, const SystemAccess& access, std::function<void()> function) {
+	systems_.push_back({std::move(name), access, std::move(function), {}, 0});
+	segmentsDirty_ = true;
+}
+
+bool SystemScheduler::Conflicts(
+    const SystemAccess& a, const SystemAccess& b, const EcsWorld& world) {
+	if (a.structural || b.structural) {
+		return true;
+	}
+	if ((a.resourceWrite & (b.resourceRead | b.resourceWrite)) != 0 ||
+	    (b.resourceWrite & a.resourceRead) != 0) {
+		return true;
+	}
+	// 両方が触るアーキタイプで、片方が書くコンポーネントをもう片方が触るか
+	for (size_t i = 0; i < world.GetArchetypeCount(); i++) {
+		ComponentMask mask = world.GetArchetypeMask(i);
+		if (!Matches(a, mask) || !Matches(b, mask)) {
+			continue;
+		}
+		if ((a.write & (b.read | b.write) & mask) != 0 || (b.write & a.read & mask) != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void SystemScheduler::BuildSegments() {
+	segments_.clear();
+	uint32_t count = static_cast<uint32_t>(systems_.size());
+	for (uint32_t begin = 0; begin < count;) {
+		Segment segment;
+		segment.begin = begin;
+		segment.structural = systems_[begin].access.structural;
+		uint32_t end = begin + 1;
+		if (!segment.structural) {
+			while (end < count && !systems_[end].access.structural) {
+				end++;
+			}
+		}
+		segment.end = end;
+		segments_.push_back(segment);
+		begin = end;
+	}
+	remaining_ = std::make_unique<std::atomic<uint32_t>[]>(systems_.size());
+	segmentsDirty_ = false;
+}
+
+void SystemScheduler::BuildGraph(Segment& segment, const EcsWorld& world) {
+	for (uint32_t i = segment.begin; i < segment.end; i++) {
+		systems_[i].dependents.clear();
+		systems_[i].dependencyCount = 0;
+	}
+	// 区間の中で衝突する組を登録順に並べる（推移的に決まる辺も残すが、数十個なので問題ない）
+	for (uint32_t later = segment.begin; later < segment.end; later++) {
+		for (uint32_t earlier = later; earlier-- > segment.begin;) {
+			if (Conflicts(systems_[earlier].access, systems_[later].access, world)) {
+				systems_[earlier].dependents.push_back(later);
+				systems_[later].dependencyCount++;
+			}
+		}
+	}
+	segment.graphArchetypeCount = world.GetArchetypeCount();
+	segment.hasGraph = true;
+}
+
+void SystemScheduler::Run(const EcsWorld& world) {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (!parallel_ || jobSystem->GetThreadCount() == 1) {
+		for (System& system : systems_) {
+			system.function();
+		}
+		return;
+	}
+
+	if (segmentsDirty_) {
+		BuildSegments();
+	}
+
+	for (Segment& segment : segments_) {
+		// 構造を変えるシステムは呼び出したスレッドで単独で実行する
+		if (segment.structural) {
+			systems_[segment.begin].function();
+			continue;
+		}
+
+		// アーキタイプが増えると衝突の有無が変わるので、直前の構造の変更も反映して作り直す
+		if (!segment.hasGraph || segment.graphArchetypeCount != world.GetArchetypeCount()) {
+			BuildGraph(segment, world);
+		}
+
+		// 区間のシステムを root の子にして、root の完了を待つ
+		for (uint32_t i = segment.begin; i < segment.end; i++) {
+			remaining_[i].store(systems_[i].dependencyCount, std::memory_order_relaxed);
+		}
+		JobSystem::Job* root = jobSystem->CreateJob([] {});
+		for (uint32_t i = segment.begin; i < segment.end; i++) {
+			if (systems_[i].dependencyCount == 0) {
+				Schedule(i, root);
+			}
+		}
+		jobSystem->Run(root);
+		jobSystem->Wait(root);
+	}
+}
+
+void SystemScheduler::Schedule(uint32_t index, JobSystem::Job* root) {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	JobSystem::Job* job = jobSystem->CreateJob(
+	    [this, index, root] {
+		    systems_[index].function();
+		    // 自分が root を完了させないうちに後続を root の子として投入する
+		    for (uint32_t dependent : systems_[index].dependents) {
+			    if (remaining_[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				    Schedule(dependent, root);
+			    }
+		    }
+	    },
+	    root);
+	jobSystem->Run(job);
+}
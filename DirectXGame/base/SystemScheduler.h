@@ -0,0 +1,109 @@
+#pragma once
+
+#include "EcsWorld.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// システムが触るデータの宣言
+/// </summary>
+struct SystemAccess {
+	// 対象のアーキタイプ（required を全て持ち、exclude を持たないもの）
+	ComponentMask required = 0;
+	ComponentMask exclude = 0;
+	// 読み書きするコンポーネント
+	ComponentMask read = 0;
+	ComponentMask write = 0;
+	// ECS の外のデータ（呼び出し側でビットを割り当てる）
+	uint64_t resourceRead = 0;
+	uint64_t resourceWrite = 0;
+	// エンティティの生成・削除やコンポーネントの追加・削除をするか
+	// （他の全てと排他で、Run を呼んだスレッドで実行される）
+	bool structural = false;
+};
+
+/// <summary>
+/// 毎フレームのシステムを依存関係に従ってジョブシステム上で並列に実行する
+/// 登録順が実行順の基準で、読み書きが衝突するシステム同士だけ登録順に並べる。
+/// </summary>
+class SystemScheduler {
+public: // メンバ関数
+	SystemScheduler() = default;
+	SystemScheduler(const SystemScheduler&) = delete;
+	SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+	/// <summary>
+	/// システムの登録
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="access">触るデータ</param>
+	/// <param name="function">処理</param>
+	void AddSystem(std::string name, const SystemAccess& access, std::function<void()> function);
+
+	/// <summary>
+	/// 全システムの実行（終わるまで戻らない。呼び出したスレッドも実行に加わる）
+	/// </summary>
+	/// <param name="world">アーキタイプの一覧を参照するワールド</param>
+	void Run(const EcsWorld& world);
+
+	/// <summary>
+	/// 並列実行の有効・無効（無効なら登録順に直列実行）
+	/// </summary>
+	void SetParallel(bool parallel) { parallel_ = parallel; }
+
+	/// <summary>
+	/// 2つのシステムが同時に実行できないか
+	/// </summary>
+	/// <param name="world">アーキタイプの一覧を参照するワールド</param>
+	static bool Conflicts(const SystemAccess& a, const SystemAccess& b, const EcsWorld& world);
+
+private: // サブクラス
+	struct System {
+		std::string name;
+		SystemAccess access;
+		std::function<void()> function;
+		// このシステムの後に実行するシステム
+		std::vector<uint32_t> dependents;
+		// 先に終わる必要があるシステムの数
+		uint32_t dependencyCount = 0;
+	};
+
+	// 構造を変えるシステムで区切った区間（構造を変えるシステムは1つで1区間）
+	struct Segment {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		bool structural = false;
+		// 依存グラフを作ったときのアーキタイプ数（変わっていたら作り直す）
+		size_t graphArchetypeCount = 0;
+		bool hasGraph = false;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 区間の分割（システムの登録が変わったとき）
+	/// </summary>
+	void BuildSegments();
+
+	/// <summary>
+	/// 区間の中の依存グラフの構築
+	/// </summary>
+	void BuildGraph(Segment& segment, const EcsWorld& world);
+
+	/// <summary>
+	/// システムをジョブとして投入（終わると後続のうち依存が揃ったものを投入する）
+	/// </summary>
+	void Schedule(uint32_t index, JobSystem::Job* root);
+
+private: // メンバ変数
+	std::vector<System> systems_;
+	std::vector<Segment> segments_;
+	// 実行中の残り依存数（システムごと）
+	std::unique_ptr<std::atomic<uint32_t>[]> remaining_;
+	bool segmentsDirty_ = true;
+	bool parallel_ = true;
+};
@@ -1,13 +1,63 @@
 #include "TextureManager.h"
+#include "JobSystem.h"
 #include <DirectXTex.h>
+#include <algorithm>
 #include <cassert>
 
 using namespace DirectX;
 
+namespace {
+
+// 画像の展開（WICテクスチャのロードとミップマップ生成。どのスレッドからでも呼べる）
+void DecodeTexture(const std::wstring& fullPath, ScratchImage& image) {
+	HRESULT result;
+
+	// WICテクスチャのロード
+	result = LoadFromWICFile(fullPath.c_str(), WIC_FLAGS_NONE, nullptr, image);
+	assert(SUCCEEDED(result));
+
+	ScratchImage mipChain{};
+	// ミップマップ生成
+	result = GenerateMipMaps(
+	    image.GetImages(), image.GetImageCount(), image.GetMetadata(), TEX_FILTER_DEFAULT, 0,
+	    mipChain);
+	if (SUCCEEDED(result)) {
+		image = std::move(mipChain);
+	}
+}
+
+} // namespace
+
 uint32_t TextureManager::Load(const std::string& fileName) {
 	return TextureManager::GetInstance()->LoadInternal(fileName);
 }
 
+std::vector<uint32_t> TextureManager::LoadBatch(const std::vector<std::string>& fileNames) {
+	return TextureManager::GetInstance()->LoadBatchInternal(fileNames);
+}
+
+TextureManager::DecodedTexture TextureManager::Decode(const std::string& fileName) {
+	DecodedTexture decoded;
+	decoded.fileName = fileName;
+	decoded.image = std::make_shared<ScratchImage>();
+	DecodeTexture(TextureManager::GetInstance()->GetFullPath(fileName), *decoded.image);
+	return decoded;
+}
+
+uint32_t TextureManager::LoadDecoded(const DecodedTexture& decoded) {
+	TextureManager* instance = TextureManager::GetInstance();
+	uint32_t loaded = instance->FindLoaded(decoded.fileName);
+	if (loaded < kNumDescriptors) {
+		return loaded;
+	}
+	assert(decoded.image);
+	return instance->CreateTexture(decoded.fileName, *decoded.image);
+}
+
+bool TextureManager::IsLoaded(const std::string& fileName) {
+	return TextureManager::GetInstance()->FindLoaded(fileName) < kNumDescriptors;
+}
+
 bool TextureManager::Unload(uint32_t textureHandle) {
 	return TextureManager::GetInstance()->UnloadInternal(textureHandle);
 }
@@ -74,21 +124,70 @@ void TextureManager::SetGraphicsRootDescriptorTable(
 uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 
 	// 読み込み済みテクスチャを検索
+	uint32_t loaded = FindLoaded(fileName);
+	if (loaded < kNumDescriptors) {
+		return loaded;
+	}
+
+	ScratchImage scratchImg{};
+	DecodeTexture(GetFullPath(fileName), scratchImg);
+	return CreateTexture(fileName, scratchImg);
+}
+
+std::vector<uint32_t> TextureManager::LoadBatchInternal(const std::vector<std::string>& fileNames) {
+	std::vector<uint32_t> handles(fileNames.size(), uint32_t(kNumDescriptors));
+
+	// 未読み込みのファイルを重複なしで集める
+	std::vector<size_t> pending;
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		handles[i] = FindLoaded(fileNames[i]);
+		if (handles[i] < kNumDescriptors) {
+			continue;
+		}
+		bool duplicated = std::any_of(pending.begin(), pending.end(), [&](size_t index) {
+			return fileNames[index] == fileNames[i];
+		});
+		if (!duplicated) {
+			pending.push_back(i);
+		}
+	}
+
+	// 展開は並列に（1ファイルが重いので1つずつ分ける）
+	std::vector<ScratchImage> images(pending.size());
+	JobSystem::GetInstance()->ParallelFor(
+	    0, static_cast<uint32_t>(pending.size()),
+	    [&](uint32_t begin, uint32_t end) {
+		    for (uint32_t i = begin; i < end; i++) {
+			    DecodeTexture(GetFullPath(fileNames[pending[i]]), images[i]);
+		    }
+	    },
+	    1);
+
+	// リソースの生成と転送はデバイスとヒープを触るので呼び出したスレッドで順に行う
+	for (size_t i = 0; i < pending.size(); i++) {
+		handles[pending[i]] = CreateTexture(fileNames[pending[i]], images[i]);
+	}
+	// 重複していたものは読み込み済みになっている
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		if (handles[i] >= kNumDescriptors) {
+			handles[i] = FindLoaded(fileNames[i]);
+		}
+	}
+	return handles;
+}
+
+uint32_t TextureManager::FindLoaded(const std::string& fileName) const {
 	auto it = std::find_if(textures_.begin(), textures_.end(), [&](const auto& texture) {
 		return texture.name == fileName;
 	});
-	if (it != textures_.end()) {
-		// 読み込み済みテクスチャの要素番号を取得
-		return static_cast<uint32_t>(std::distance(textures_.begin(), it));
+	if (it == textures_.end()) {
+		return uint32_t(kNumDescriptors);
 	}
+	// 読み込み済みテクスチャの要素番号を取得
+	return static_cast<uint32_t>(std::distance(textures_.begin(), it));
+}
 
-	// 書き込むテクスチャの参照
-	uint32_t handle = uint32_t(useTable_.FindFirst());
-	assert(handle < kNumDescriptors);
-
-	Texture& texture = textures_.at(handle);
-	texture.name = fileName;
-
+std::wstring TextureManager::GetFullPath(const std::string& fileName) const {
 	// ディレクトリパスとファイル名を連結してフルパスを得る
 	bool currentRelative = false;
 	if (2 < fileName.size()) {
@@ -99,25 +198,19 @@ uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 	// ユニコード文字列に変換
 	wchar_t wfilePath[256];
 	MultiByteToWideChar(CP_ACP, 0, fullPath.c_str(), -1, wfilePath, _countof(wfilePath));
+	return wfilePath;
+}
 
-	HRESULT result;
-
-	TexMetadata metadata{};
-	ScratchImage scratchImg{};
+uint32_t TextureManager::CreateTexture(const std::string& fileName, const ScratchImage& image) {
+	// 書き込むテクスチャの参照
+	uint32_t handle = uint32_t(useTable_.FindFirst());
+	assert(handle < kNumDescriptors);
 
-	// WICテクスチャのロード
-	result = LoadFromWICFile(wfilePath, WIC_FLAGS_NONE, &metadata, scratchImg);
-	assert(SUCCEEDED(result));
+	Texture& texture = textures_.at(handle);
+	texture.name = fileName;
 
-	ScratchImage mipChain{};
-	// ミップマップ生成
-	result = GenerateMipMaps(
-	    scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
-	    TEX_FILTER_DEFAULT, 0, mipChain);
-	if (SUCCEEDED(result)) {
-		scratchImg = std::move(mipChain);
-		metadata = scratchImg.GetMetadata();
-	}
+	HRESULT result;
+	TexMetadata metadata = image.GetMetadata();
 
 	// 読み込んだディフューズテクスチャをSRGBとして扱う
 	metadata.format = MakeSRGB(metadata.format);
@@ -140,7 +233,7 @@ uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 
 	// テクスチャバッファにデータ転送
 	for (size_t i = 0; i < metadata.mipLevels; i++) {
-		const Image* img = scratchImg.GetImage(i, 0, 0); // 生データ抽出
+		const Image* img = image.GetImage(i, 0, 0); // 生データ抽出
 		result = texture.resource->WriteToSubresource(
 		    (UINT)i,
 		    nullptr,              // 全領域へコピー
@@ -2,10 +2,16 @@
 
 #include <array>
 #include <d3dx12.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <wrl.h>
 
+namespace DirectX {
+class ScratchImage;
+}
+
 /// <summary>
 /// テクスチャマネージャ
 /// </summary>
@@ -35,6 +41,40 @@ public:
 	/// <returns>テクスチャハンドル</returns>
 	static uint32_t Load(const std::string& fileName);
 
+	/// <summary>
+	/// まとめて読み込み（画像の展開はジョブシステムで並列に行う）
+	/// </summary>
+	/// <param name="fileNames">ファイル名の一覧</param>
+	/// <returns>ファイル名と同じ並びのテクスチャハンドル</returns>
+	static std::vector<uint32_t> LoadBatch(const std::vector<std::string>& fileNames);
+
+	/// <summary>
+	/// 展開済みの画像
+	/// </summary>
+	struct DecodedTexture {
+		std::string fileName;
+		std::shared_ptr<DirectX::ScratchImage> image;
+	};
+
+	/// <summary>
+	/// 画像の展開だけ行う（テクスチャは作らないので、どのスレッドからでも呼べる）
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	static DecodedTexture Decode(const std::string& fileName);
+
+	/// <summary>
+	/// 展開済みの画像から読み込み（読み込み済みならそのハンドルを返す）
+	/// </summary>
+	/// <param name="decoded">展開済みの画像</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t LoadDecoded(const DecodedTexture& decoded);
+
+	/// <summary>
+	/// 読み込み済みか
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	static bool IsLoaded(const std::string& fileName);
+
 	/// <summary>
 	/// 読み込み解除
 	/// </summary>
@@ -122,6 +162,33 @@ private:
 	/// <param name="fileName">ファイル名</param>
 	uint32_t LoadInternal(const std::string& fileName);
 
+	/// <summary>
+	/// まとめて読み込み
+	/// </summary>
+	/// <param name="fileNames">ファイル名の一覧</param>
+	std::vector<uint32_t> LoadBatchInternal(const std::vector<std::string>& fileNames);
+
+	/// <summary>
+	/// 読み込み済みテクスチャの検索
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>テクスチャハンドル（無ければ kNumDescriptors）</returns>
+	uint32_t FindLoaded(const std::string& fileName) const;
+
+	/// <summary>
+	/// ファイル名からフルパスを得る
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	std::wstring GetFullPath(const std::string& fileName) const;
+
+	/// <summary>
+	/// 展開済みの画像からテクスチャを生成
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="image">展開済みの画像</param>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t CreateTexture(const std::string& fileName, const DirectX::ScratchImage& image);
+
 	/// <summary>
 	/// 読み込み解除
 	/// </summary>
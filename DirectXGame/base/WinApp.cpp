@@ -21,6 +21,20 @@ BOOL UnadjustWindowRectEx(LPRECT prc, DWORD dwStyle, BOOL fMenu, DWORD dwExStyle
 	}
 	return fRc;
 }
+
+// これより古いメッセージの時刻は信用しない（ミリ秒）
+const DWORD kMaxMessageAgeMs = 1000;
+
+// 処理中のメッセージが起きた時刻
+// GetMessageTime は GetTickCount 基準のミリ秒なので、今との差を steady_clock の今から引く。
+InputClock::time_point GetMessageTimePoint() {
+	InputClock::time_point now = InputClock::now();
+	DWORD age = GetTickCount() - static_cast<DWORD>(GetMessageTime());
+	if (age > kMaxMessageAgeMs) {
+		return now;
+	}
+	return now - std::chrono::milliseconds(age);
+}
 } // namespace
 
 const wchar_t WinApp::kWindowClassName[] = L"DirectXGame";
@@ -37,6 +51,10 @@ LRESULT WinApp::WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
 	if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam))
 		return true;
 
+	if (app) {
+		app->TranslateInputMessage(msg, wparam, lparam);
+	}
+
 	// メッセージで分岐
 	switch (msg) {
 	case WM_DESTROY:        // ウィンドウが破棄された
@@ -117,6 +135,13 @@ void WinApp::CreateGameWindow(
 	    nullptr);                // オプション
 	SetWindowLongPtr(hwnd_, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
 
+	// マウスの移動量は加速のかからない Raw Input で受け取る
+	RAWINPUTDEVICE mouseDevice{};
+	mouseDevice.usUsagePage = 0x01; // HID_USAGE_PAGE_GENERIC
+	mouseDevice.usUsage = 0x02;     // HID_USAGE_GENERIC_MOUSE
+	mouseDevice.hwndTarget = hwnd_;
+	RegisterRawInputDevices(&mouseDevice, 1, sizeof(mouseDevice));
+
 	// ウィンドウ表示
 	ShowWindow(hwnd_, SW_NORMAL);
 }
@@ -129,20 +154,113 @@ void WinApp::TerminateGameWindow() {
 	CoUninitialize();
 }
 
+void WinApp::TranslateInputMessage(UINT msg, WPARAM wparam, LPARAM lparam) {
+	InputEvent event;
+
+	switch (msg) {
+	case WM_KEYDOWN:
+	case WM_SYSKEYDOWN:
+	case WM_KEYUP:
+	case WM_SYSKEYUP: {
+		// 押しっぱなしの繰り返し
+		bool isDown = msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN;
+		if (isDown && (lparam & (1 << 30))) {
+			return;
+		}
+		// スキャンコードと拡張キーのフラグから DIK_ と同じキー番号を作る
+		uint8_t code = static_cast<uint8_t>((lparam >> 16) & 0x7F);
+		if (code == 0) {
+			return;
+		}
+		if (lparam & (1 << 24)) {
+			code |= 0x80;
+		}
+		// Pause と NumLock だけは拡張キーのフラグが DIK_ と逆になる
+		if ((code & 0x7F) == 0x45) {
+			code ^= 0x80;
+		}
+		event.type = isDown ? InputEventType::KeyDown : InputEventType::KeyUp;
+		event.code = code;
+		break;
+	}
+
+	case WM_LBUTTONDOWN:
+	case WM_LBUTTONUP:
+		event.type = msg == WM_LBUTTONDOWN ? InputEventType::MouseButtonDown
+		                                   : InputEventType::MouseButtonUp;
+		event.code = 0;
+		break;
+	case WM_RBUTTONDOWN:
+	case WM_RBUTTONUP:
+		event.type = msg == WM_RBUTTONDOWN ? InputEventType::MouseButtonDown
+		                                   : InputEventType::MouseButtonUp;
+		event.code = 1;
+		break;
+	case WM_MBUTTONDOWN:
+	case WM_MBUTTONUP:
+		event.type = msg == WM_MBUTTONDOWN ? InputEventType::MouseButtonDown
+		                                   : InputEventType::MouseButtonUp;
+		event.code = 2;
+		break;
+	case WM_XBUTTONDOWN:
+	case WM_XBUTTONUP:
+		event.type = msg == WM_XBUTTONDOWN ? InputEventType::MouseButtonDown
+		                                   : InputEventType::MouseButtonUp;
+		event.code = GET_XBUTTON_WPARAM(wparam) == XBUTTON1 ? 3 : 4;
+		break;
+
+	case WM_MOUSEWHEEL:
+		event.type = InputEventType::MouseWheel;
+		event.x = GET_WHEEL_DELTA_WPARAM(wparam);
+		break;
+
+	case WM_INPUT: {
+		RAWINPUT raw{};
+		UINT size = sizeof(raw);
+		if (GetRawInputData(
+		        reinterpret_cast<HRAWINPUT>(lparam), RID_INPUT, &raw, &size,
+		        sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1) ||
+		    raw.header.dwType != RIM_TYPEMOUSE) {
+			return;
+		}
+		// 絶対座標で来るもの（タブレット・リモートデスクトップ）は移動量にしない
+		const RAWMOUSE& mouse = raw.data.mouse;
+		if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) || (mouse.lLastX == 0 && mouse.lLastY == 0)) {
+			return;
+		}
+		event.type = InputEventType::MouseMove;
+		event.x = mouse.lLastX;
+		event.y = mouse.lLastY;
+		break;
+	}
+
+	case WM_KILLFOCUS:
+		event.type = InputEventType::FocusLost;
+		break;
+
+	default:
+		return;
+	}
+
+	event.time = GetMessageTimePoint();
+	inputEvents_.Push(event);
+}
+
 bool WinApp::ProcessMessage() {
 	MSG msg{}; // メッセージ
 
-	if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) // メッセージがある？
+	// 溜まっているメッセージを全て処理する（1つずつだと入力イベントが次のフレームに遅れる）
+	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) // メッセージがある？
 	{
+		if (msg.message == WM_QUIT) // 終了メッセージが来たらループを抜ける
+		{
+			return true;
+		}
+
 		TranslateMessage(&msg); // キー入力メッセージの処理
 		DispatchMessage(&msg);  // ウィンドウプロシージャにメッセージを送る
 	}
 
-	if (msg.message == WM_QUIT) // 終了メッセージが来たらループを抜ける
-	{
-		return true;
-	}
-
 	return false;
 }
 
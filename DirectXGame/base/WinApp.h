@@ -1,4 +1,5 @@
 #pragma once
+#include "InputEvents.h"
 #include <Windows.h>
 #include <cstdint>
 
@@ -91,12 +92,22 @@ public: // メンバ関数
 	/// <returns></returns>
 	SizeChangeMode GetSizeChangeMode() const;
 
+	/// <summary>
+	/// ウィンドウのメッセージから作った入力イベントのキューの取得
+	/// </summary>
+	InputEventQueue& GetInputEvents() { return inputEvents_; }
+
 private: // メンバ関数
 	WinApp() = default;
 	~WinApp() = default;
 	WinApp(const WinApp&) = delete;
 	const WinApp& operator=(const WinApp&) = delete;
 
+	/// <summary>
+	/// キー・マウスのメッセージを入力イベントにして積む
+	/// </summary>
+	void TranslateInputMessage(UINT msg, WPARAM wparam, LPARAM lparam);
+
 private: // メンバ変数
 	// Window関連
 	HWND hwnd_ = nullptr;   // ウィンドウハンドル
@@ -106,4 +117,6 @@ private: // メンバ変数
 	RECT windowRect_;
 	SizeChangeMode sizeChangeMode_ = SizeChangeMode::kNormal;
 	float aspectRatio_;
+	// 入力イベント
+	InputEventQueue inputEvents_;
 };
@@ -0,0 +1,164 @@
+#include "HeadlessGame.h"
+#include "JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+// コマンドラインの設定
+struct Options {
+	uint32_t seed = 1;
+	uint32_t steps = 100000;
+	bool useJobs = false;       // ジョブシステムを使うか
+	uint32_t workerCount = 0;   // ワーカースレッド数（0ならハードウェアのスレッド数 - 1）
+	std::string audioDirectory; // 空なら無音
+	std::string recordFileName; // 空でなければ入力を記録して保存する
+	std::string replayFileName; // 空でなければ記録を再生して最後の状態を確かめる
+	uint32_t repeat = 1;        // 繰り返す回数（ベンチマーク用）
+};
+
+void PrintUsage() {
+	fprintf(
+	    stderr, "usage: HeadlessRunner [--seed N] [--steps N] [--jobs WORKERS] [--audio DIR]\n"
+	            "                      [--record FILE | --replay FILE] [--repeat N]\n"
+	            "  --seed    乱数の種（既定 1）\n"
+	            "  --steps   進めるステップ数（既定 100000）\n"
+	            "  --jobs    ジョブシステムで更新する（0ならハードウェアのスレッド数 - 1）\n"
+	            "  --audio   音を読み込んでミキサーで混ぜる（サウンド格納ディレクトリ）\n"
+	            "  --record  自動プレイの入力と最後の状態を記録して保存する\n"
+	            "  --replay  記録を最後まで再生し、最後の状態が記録と違えば失敗にする\n"
+	            "            （乱数の種とステップ数は記録のものを使う）\n"
+	            "  --repeat  繰り返して一番速かった回を表示する（既定 1）\n");
+}
+
+// 引数の解析（全て「--名前 値」の組）
+bool ParseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const char* name = argv[i];
+		const char* value = argv[i + 1];
+		if (strcmp(name, "--seed") == 0) {
+			options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		} else if (strcmp(name, "--steps") == 0) {
+			options.steps = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		} else if (strcmp(name, "--jobs") == 0) {
+			options.useJobs = true;
+			options.workerCount = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		} else if (strcmp(name, "--audio") == 0) {
+			options.audioDirectory = value;
+		} else if (strcmp(name, "--record") == 0) {
+			options.recordFileName = value;
+		} else if (strcmp(name, "--replay") == 0) {
+			options.replayFileName = value;
+		} else if (strcmp(name, "--repeat") == 0) {
+			options.repeat = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		} else {
+			return false;
+		}
+	}
+	// 値の無い引数が残っていたら誤り
+	if (argc % 2 == 0 || options.repeat == 0) {
+		return false;
+	}
+	// 記録しながら再生はできない
+	return options.recordFileName.empty() || options.replayFileName.empty();
+}
+
+void PrintResult(const HeadlessGame::Result& result, bool isAudioEnabled) {
+	printf(
+	    "steps %u games %u clears %u score %lld checksum %016llx %.3fs %.0f steps/s\n",
+	    result.steps, result.games, result.clears, static_cast<long long>(result.totalScore),
+	    static_cast<unsigned long long>(result.checksum), result.seconds,
+	    result.seconds > 0.0 ? result.steps / result.seconds : 0.0);
+	if (isAudioEnabled) {
+		printf(
+		    "audio checksum %016llx peak %.3f\n",
+		    static_cast<unsigned long long>(result.audioChecksum), result.audioPeak);
+	}
+}
+
+// 1回の実行（失敗したら終了コードを返す）
+int RunOnce(
+    const Options& options, const InputRecording* replay, HeadlessGame::Result& result) {
+	HeadlessGame game;
+	bool isAudioEnabled = !options.audioDirectory.empty();
+	if (isAudioEnabled && !game.InitializeAudio(options.audioDirectory)) {
+		fprintf(stderr, "failed to load sounds from %s\n", options.audioDirectory.c_str());
+		return 1;
+	}
+
+	if (replay) {
+		game.InitializeReplay(replay);
+		result = game.RunReplay();
+		PrintResult(result, isAudioEnabled);
+		if (result.isReplayMismatch) {
+			fprintf(
+			    stderr, "replay checksum mismatch: recorded %016llx, replayed %016llx\n",
+			    static_cast<unsigned long long>(replay->GetChecksum()),
+			    static_cast<unsigned long long>(result.checksum));
+			return 1;
+		}
+		return 0;
+	}
+
+	InputRecording recording;
+	bool isRecording = !options.recordFileName.empty();
+	if (isRecording) {
+		game.InitializeRecording(options.seed, &recording);
+	} else {
+		game.Initialize(options.seed);
+	}
+	result = game.Run(options.steps);
+	PrintResult(result, isAudioEnabled);
+	if (isRecording && !recording.SaveFile(options.recordFileName)) {
+		fprintf(stderr, "failed to save %s\n", options.recordFileName.c_str());
+		return 1;
+	}
+	return 0;
+}
+
+} // namespace
+
+// ヘッドレス実行のエントリーポイント
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		PrintUsage();
+		return 2;
+	}
+
+	InputRecording replay;
+	bool isReplay = !options.replayFileName.empty();
+	if (isReplay && !replay.LoadFile(options.replayFileName)) {
+		fprintf(stderr, "failed to load %s\n", options.replayFileName.c_str());
+		return 1;
+	}
+
+	if (options.useJobs) {
+		JobSystem::GetInstance()->Initialize(options.workerCount);
+	}
+
+	// 繰り返すときは一番速かった回を表示する（同じ入力なので結果は毎回同じはず）
+	int exitCode = 0;
+	double bestSeconds = 0.0;
+	uint32_t steps = 0;
+	for (uint32_t i = 0; i < options.repeat && exitCode == 0; i++) {
+		HeadlessGame::Result result;
+		exitCode = RunOnce(options, isReplay ? &replay : nullptr, result);
+		if (i == 0 || result.seconds < bestSeconds) {
+			bestSeconds = result.seconds;
+		}
+		steps = result.steps;
+	}
+	if (exitCode == 0 && options.repeat > 1) {
+		printf(
+		    "best of %u: %.3fs %.0f steps/s\n", options.repeat, bestSeconds,
+		    bestSeconds > 0.0 ? steps / bestSeconds : 0.0);
+	}
+
+	if (options.useJobs) {
+		JobSystem::GetInstance()->Finalize();
+	}
+	return exitCode;
+}
@@ -0,0 +1,163 @@
+#include "ActionMap.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace {
+
+// 軸が割り当ての向きに傾いているか
+bool IsAxisPressed(const GamepadState& pad, uint8_t axis, int8_t direction) {
+	int32_t value = pad.axes[axis];
+	return direction > 0 ? value >= ActionMap::kAxisThreshold
+	                     : value <= -ActionMap::kAxisThreshold;
+}
+
+} // namespace
+
+int32_t ActionMap::AddAction(const std::string& name) {
+	int32_t action = FindAction(name);
+	if (action >= 0) {
+		return action;
+	}
+	if (actions_.size() >= kMaxActions) {
+		return -1;
+	}
+	actions_.emplace_back().name = name;
+	return static_cast<int32_t>(actions_.size() - 1);
+}
+
+int32_t ActionMap::FindAction(const std::string& name) const {
+	for (size_t i = 0; i < actions_.size(); i++) {
+		if (actions_[i].name == name) {
+			return static_cast<int32_t>(i);
+		}
+	}
+	return -1;
+}
+
+bool ActionMap::Bind(uint32_t action, const InputBinding& binding) {
+	Action& target = actions_[action];
+	std::span<const InputBinding> bindings = GetBindings(action);
+	if (std::find(bindings.begin(), bindings.end(), binding) != bindings.end()) {
+		return true;
+	}
+	if (target.bindingCount == kMaxBindings) {
+		return false;
+	}
+	target.bindings[target.bindingCount++] = binding;
+	return true;
+}
+
+bool ActionMap::Unbind(uint32_t action, const InputBinding& binding) {
+	Action& target = actions_[action];
+	auto end = target.bindings.begin() + target.bindingCount;
+	auto it = std::find(target.bindings.begin(), end, binding);
+	if (it == end) {
+		return false;
+	}
+	// 割り当ての順番（キーコンフィグの表示順）は保つ
+	std::copy(it + 1, end, it);
+	target.bindingCount--;
+	return true;
+}
+
+bool ActionMap::Rebind(uint32_t action, uint32_t slot, const InputBinding& binding) {
+	Action& target = actions_[action];
+	if (slot > target.bindingCount || slot == kMaxBindings) {
+		return false;
+	}
+	// 他の番号にある同じ入力は外す（外した分だけ slot が前にずれることがある）
+	for (uint32_t i = 0; i < target.bindingCount; i++) {
+		if (i != slot && target.bindings[i] == binding) {
+			Unbind(action, binding);
+			if (i < slot) {
+				slot--;
+			}
+			break;
+		}
+	}
+	if (slot == target.bindingCount) {
+		target.bindingCount++;
+	}
+	target.bindings[slot] = binding;
+	return true;
+}
+
+void ActionMap::ClearBindings(uint32_t action) { actions_[action].bindingCount = 0; }
+
+std::span<const InputBinding> ActionMap::GetBindings(uint32_t action) const {
+	const Action& target = actions_[action];
+	return {target.bindings.data(), target.bindingCount};
+}
+
+void ActionMap::Update(const InputEventState& keyboard, const GamepadState& pad) {
+	padPrevious_ = pad_;
+	pad_ = pad;
+	previous_ = pressed_;
+
+	pressed_.Clear();
+	for (uint32_t i = 0; i < actions_.size(); i++) {
+		for (const InputBinding& binding : GetBindings(i)) {
+			if (IsBindingPressed(binding, keyboard, pad)) {
+				pressed_.Set(i);
+				break;
+			}
+		}
+	}
+
+	DiffInputBits(pressed_, previous_, triggered_, released_);
+}
+
+void ActionMap::Reset() {
+	pressed_.Clear();
+	previous_.Clear();
+	triggered_.Clear();
+	released_.Clear();
+	pad_ = {};
+	padPrevious_ = {};
+}
+
+bool ActionMap::FindTriggeredInput(const InputEventState& keyboard, InputBinding& binding) const {
+	int32_t key = keyboard.GetKeyTriggers().FindFirst();
+	if (key >= 0) {
+		binding = InputBinding::Key(static_cast<uint8_t>(key));
+		return true;
+	}
+	for (uint8_t button = 0; button < InputEventState::kMouseButtonCount; button++) {
+		if (keyboard.IsTriggerMouse(button)) {
+			binding = InputBinding::Mouse(button);
+			return true;
+		}
+	}
+	uint16_t padTriggered = pad_.buttons & ~padPrevious_.buttons;
+	if (padTriggered != 0) {
+		binding = InputBinding::Pad(static_cast<GamepadButton>(std::countr_zero(padTriggered)));
+		return true;
+	}
+	for (uint8_t axis = 0; axis < pad_.axes.size(); axis++) {
+		for (int8_t direction : {int8_t(1), int8_t(-1)}) {
+			if (IsAxisPressed(pad_, axis, direction) &&
+			    !IsAxisPressed(padPrevious_, axis, direction)) {
+				binding = InputBinding::Axis(static_cast<GamepadAxis>(axis), direction);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool ActionMap::IsBindingPressed(
+    const InputBinding& binding, const InputEventState& keyboard, const GamepadState& pad) const {
+	switch (binding.source) {
+	case InputSource::Key:
+		return keyboard.PushKey(binding.code) || keyboard.TriggerKey(binding.code);
+	case InputSource::MouseButton:
+		return keyboard.IsPressMouse(binding.code) || keyboard.IsTriggerMouse(binding.code);
+	case InputSource::PadButton:
+		return (pad.buttons >> binding.code) & 1;
+	case InputSource::PadAxis:
+		assert(binding.code < pad.axes.size());
+		return IsAxisPressed(pad, binding.code, binding.direction);
+	}
+	return false;
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "InputBits.h"
+#include "InputEvents.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// パッドのボタン（XINPUT_GAMEPAD_ のビットの番号）
+/// </summary>
+enum class GamepadButton : uint8_t {
+	DpadUp = 0,
+	DpadDown = 1,
+	DpadLeft = 2,
+	DpadRight = 3,
+	Start = 4,
+	Back = 5,
+	LeftThumb = 6,
+	RightThumb = 7,
+	LeftShoulder = 8,
+	RightShoulder = 9,
+	A = 12,
+	B = 13,
+	X = 14,
+	Y = 15,
+};
+
+/// <summary>
+/// パッドの軸
+/// </summary>
+enum class GamepadAxis : uint8_t {
+	LeftX,
+	LeftY, // 上が +
+	RightX,
+	RightY, // 上が +
+	LeftTrigger,
+	RightTrigger,
+	Count,
+};
+
+/// <summary>
+/// 1ステップ分のパッドの状態（プラットフォームに依存しない形）
+/// </summary>
+struct GamepadState {
+	// XINPUT_GAMEPAD の wButtons と同じ並び
+	uint16_t buttons = 0;
+	// スティックは -32768~32767、トリガーは 0~32767
+	std::array<int16_t, static_cast<size_t>(GamepadAxis::Count)> axes = {};
+};
+
+/// <summary>
+/// 入力の出どころ
+/// </summary>
+enum class InputSource : uint8_t {
+	Key,         // code: キー番号（DIK_ と同じ）
+	MouseButton, // code: 0:左 1:右 2:中 3~:拡張
+	PadButton,   // code: GamepadButton
+	PadAxis,     // code: GamepadAxis、direction: 押したことにする向き（+1 か -1）
+};
+
+/// <summary>
+/// アクションへの入力の割り当て
+/// </summary>
+struct InputBinding {
+	InputSource source = InputSource::Key;
+	uint8_t code = 0;
+	int8_t direction = 0;
+
+	bool operator==(const InputBinding&) const = default;
+
+	static InputBinding Key(uint8_t key) { return {InputSource::Key, key, 0}; }
+	static InputBinding Mouse(uint8_t button) { return {InputSource::MouseButton, button, 0}; }
+	static InputBinding Pad(GamepadButton button) {
+		return {InputSource::PadButton, static_cast<uint8_t>(button), 0};
+	}
+	static InputBinding Axis(GamepadAxis axis, int8_t direction) {
+		return {InputSource::PadAxis, static_cast<uint8_t>(axis), direction};
+	}
+};
+
+/// <summary>
+/// 名前付きのアクションと、それに割り当てたキー・マウス・パッドの入力
+/// ステップごとに割り当てを評価してアクションの押下を256ビットに詰め、
+/// 前のステップとの差から押した・離したを求める。
+/// キーは入力イベントの状態から読むので、1ステップより短い押下もそのステップで押したことになる。
+/// 押した・離したは押下の差だけから作る（押したままのアクションを別の入力で押し直しても
+/// 押したことにはならない）。リプレイはステップごとの押下だけを記録して押した瞬間を
+/// その差から作り直すので、それと同じ結果になる。
+/// </summary>
+class ActionMap {
+public: // 定数
+	// アクションの最大数（状態のビット数）
+	static const uint32_t kMaxActions = InputBits::kBitCount;
+	// 1つのアクションに割り当てられる入力の最大数
+	static const uint32_t kMaxBindings = 8;
+	// 軸を押したことにする傾き（最大の半分）
+	static const int32_t kAxisThreshold = 16384;
+
+public: // メンバ関数
+	/// <summary>
+	/// アクションの追加（同じ名前があればそれを返す）
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <returns>アクションの番号（追加できなければ -1）</returns>
+	int32_t AddAction(const std::string& name);
+
+	/// <summary>
+	/// 名前からアクションの番号を探す
+	/// </summary>
+	/// <returns>アクションの番号（無ければ -1）</returns>
+	int32_t FindAction(const std::string& name) const;
+
+	const std::string& GetActionName(uint32_t action) const { return actions_[action].name; }
+	uint32_t GetActionCount() const { return static_cast<uint32_t>(actions_.size()); }
+
+	/// <summary>
+	/// 入力の割り当て（割り当て済みなら何もしない）
+	/// </summary>
+	/// <returns>割り当てたか（満杯なら false）</returns>
+	bool Bind(uint32_t action, const InputBinding& binding);
+
+	/// <summary>
+	/// 入力の割り当ての解除
+	/// </summary>
+	/// <returns>解除したか</returns>
+	bool Unbind(uint32_t action, const InputBinding& binding);
+
+	/// <summary>
+	/// 割り当ての差し替え（キーコンフィグ用）
+	/// 他の番号で割り当て済みの入力なら、そちらを外して slot に置く。
+	/// </summary>
+	/// <param name="action">アクションの番号</param>
+	/// <param name="slot">何番目の割り当てか（今の数と同じなら追加）</param>
+	/// <param name="binding">新しい入力</param>
+	/// <returns>差し替えたか</returns>
+	bool Rebind(uint32_t action, uint32_t slot, const InputBinding& binding);
+
+	/// <summary>
+	/// アクションの割り当てを全て解除
+	/// </summary>
+	void ClearBindings(uint32_t action);
+
+	/// <summary>
+	/// アクションに割り当てた入力の取得
+	/// </summary>
+	std::span<const InputBinding> GetBindings(uint32_t action) const;
+
+	/// <summary>
+	/// 次のステップへ進める（割り当てを評価してアクションの状態を作る）
+	/// </summary>
+	/// <param name="keyboard">このステップのキー・マウスの状態</param>
+	/// <param name="pad">このステップのパッドの状態</param>
+	void Update(const InputEventState& keyboard, const GamepadState& pad);
+
+	/// <summary>
+	/// 全て離した状態に戻す
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// このステップで押した入力を探す（キーコンフィグで次に押した入力を割り当てる用）
+	/// キー、マウス、パッドのボタン、パッドの軸の順に探す。
+	/// </summary>
+	/// <param name="keyboard">Update に渡したキー・マウスの状態</param>
+	/// <param name="binding">見つけた入力</param>
+	/// <returns>見つけたか</returns>
+	bool FindTriggeredInput(const InputEventState& keyboard, InputBinding& binding) const;
+
+	bool IsPressed(uint32_t action) const { return pressed_.Test(action); }
+	bool IsTriggered(uint32_t action) const { return triggered_.Test(action); }
+	bool IsReleased(uint32_t action) const { return released_.Test(action); }
+
+	/// <summary>
+	/// 全アクションの状態（ビットの番号がアクションの番号）
+	/// </summary>
+	const InputBits& GetPressed() const { return pressed_; }
+	const InputBits& GetTriggered() const { return triggered_; }
+	const InputBits& GetReleased() const { return released_; }
+
+private: // サブクラス
+	struct Action {
+		std::string name;
+		std::array<InputBinding, kMaxBindings> bindings;
+		uint32_t bindingCount = 0;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 入力を押しているか（キーはステップの間に押して離したものも含む）
+	/// </summary>
+	bool IsBindingPressed(
+	    const InputBinding& binding, const InputEventState& keyboard,
+	    const GamepadState& pad) const;
+
+private: // メンバ変数
+	std::vector<Action> actions_;
+	InputBits pressed_;
+	InputBits previous_;
+	InputBits triggered_;
+	InputBits released_;
+	GamepadState pad_;
+	GamepadState padPrevious_;
+};
@@ -0,0 +1,60 @@
+#include "InputBits.h"
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define INPUT_BITS_AVX2
+#define INPUT_BITS_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INPUT_BITS_SSE2
+#endif
+
+void InputBits::Clear() {
+	for (uint64_t& word : words) {
+		word = 0;
+	}
+}
+
+bool InputBits::Any() const { return (words[0] | words[1] | words[2] | words[3]) != 0; }
+
+int32_t InputBits::FindFirst() const {
+	for (uint32_t i = 0; i < kWordCount; i++) {
+		if (words[i] != 0) {
+			return int32_t(i * 64 + std::countr_zero(words[i]));
+		}
+	}
+	return -1;
+}
+
+InputBits& InputBits::operator|=(const InputBits& other) {
+	for (uint32_t i = 0; i < kWordCount; i++) {
+		words[i] |= other.words[i];
+	}
+	return *this;
+}
+
+void DiffInputBits(
+    const InputBits& current, const InputBits& previous, InputBits& triggered,
+    InputBits& released) {
+#if defined(INPUT_BITS_AVX2)
+	__m256i now = _mm256_load_si256(reinterpret_cast<const __m256i*>(current.words));
+	__m256i pre = _mm256_load_si256(reinterpret_cast<const __m256i*>(previous.words));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(triggered.words), _mm256_andnot_si256(pre, now));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(released.words), _mm256_andnot_si256(now, pre));
+#elif defined(INPUT_BITS_SSE2)
+	for (uint32_t i = 0; i < InputBits::kWordCount; i += 2) {
+		__m128i now = _mm_load_si128(reinterpret_cast<const __m128i*>(current.words + i));
+		__m128i pre = _mm_load_si128(reinterpret_cast<const __m128i*>(previous.words + i));
+		__m128i* triggeredWords = reinterpret_cast<__m128i*>(triggered.words + i);
+		__m128i* releasedWords = reinterpret_cast<__m128i*>(released.words + i);
+		_mm_store_si128(triggeredWords, _mm_andnot_si128(pre, now));
+		_mm_store_si128(releasedWords, _mm_andnot_si128(now, pre));
+	}
+#else
+	for (uint32_t i = 0; i < InputBits::kWordCount; i++) {
+		triggered.words[i] = current.words[i] & ~previous.words[i];
+		released.words[i] = ~current.words[i] & previous.words[i];
+	}
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// 256ビットの入力の状態（キー・アクションの押下を1ビットずつ持つ）
+/// 前回との差は DiffInputBits でまとめて求める。
+/// </summary>
+struct alignas(32) InputBits {
+	static const uint32_t kBitCount = 256;
+	static const uint32_t kWordCount = kBitCount / 64;
+
+	uint64_t words[kWordCount] = {};
+
+	bool Test(uint32_t index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+	void Set(uint32_t index) { words[index >> 6] |= 1ull << (index & 63); }
+	void Reset(uint32_t index) { words[index >> 6] &= ~(1ull << (index & 63)); }
+
+	/// <summary>
+	/// 全て0にする
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// どれかのビットが立っているか
+	/// </summary>
+	bool Any() const;
+
+	/// <summary>
+	/// 一番小さい立っているビットの番号（無ければ -1）
+	/// </summary>
+	int32_t FindFirst() const;
+
+	InputBits& operator|=(const InputBits& other);
+};
+
+/// <summary>
+/// 前回と今回の差の取得（SIMD で256ビットをまとめて求める）
+/// </summary>
+/// <param name="current">今回</param>
+/// <param name="previous">前回</param>
+/// <param name="triggered">押した（今回 &amp; ~前回）</param>
+/// <param name="released">離した（~今回 &amp; 前回）</param>
+void DiffInputBits(
+    const InputBits& current, const InputBits& previous, InputBits& triggered,
+    InputBits& released);
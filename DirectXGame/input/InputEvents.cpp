@@ -0,0 +1,211 @@
+#include "InputEvents.h"
+
+//----------------------------------------------
+// InputEventQueue
+//----------------------------------------------
+
+namespace {
+
+// 量を足してまとめられるイベントか（マウスの移動・ホイール）
+bool IsMotion(InputEventType type) {
+	return type == InputEventType::MouseMove || type == InputEventType::MouseWheel;
+}
+
+} // namespace
+
+bool InputEventQueue::Push(const InputEvent& event) {
+	// 取り出しは時刻順の前提なので、時刻が戻るイベントは前のイベントと同時に起きたことにする
+	InputClock::time_point time = count_ > 0 && event.time < lastTime_ ? lastTime_ : event.time;
+
+	if (IsMotion(event.type)) {
+		// 最後のイベントと同じ種類ならまとめる（起きた時刻は新しい方にする）
+		if (count_ > 0 && At(count_ - 1).type == event.type) {
+			InputEvent& last = At(count_ - 1);
+			last.x += event.x;
+			last.y += event.y;
+			last.time = time;
+			lastTime_ = time;
+			return true;
+		}
+		// 残りが空けておく分だけなら、前の同じ種類のイベントに足す（少し早く動いたことになる）
+		if (count_ >= kCapacity - kReservedCapacity) {
+			uint32_t index = FindLast(event.type);
+			if (index == count_) {
+				droppedCount_++;
+				return false;
+			}
+			At(index).x += event.x;
+			At(index).y += event.y;
+			return true;
+		}
+	} else if (count_ == kCapacity && !EvictMotion()) {
+		// キー・ボタン・フォーカスのイベントだけで満杯（1ステップの間に kCapacity 回）
+		if (event.type != InputEventType::FocusLost) {
+			droppedCount_++;
+			return false;
+		}
+		// フォーカスを失えば全て離すので、最後のイベントの代わりに積んでも押しっぱなしは残らない
+		count_--;
+		droppedCount_++;
+	}
+
+	InputEvent& slot = At(count_);
+	slot = event;
+	slot.time = time;
+	lastTime_ = time;
+	count_++;
+	return true;
+}
+
+bool InputEventQueue::Pop(InputClock::time_point until, InputEvent& event) {
+	if (count_ == 0 || events_[head_].time > until) {
+		return false;
+	}
+	event = events_[head_];
+	head_ = (head_ + 1) & (kCapacity - 1);
+	count_--;
+	return true;
+}
+
+void InputEventQueue::Clear() {
+	head_ = 0;
+	count_ = 0;
+}
+
+uint32_t InputEventQueue::FindLast(InputEventType type) {
+	for (uint32_t i = count_; i > 0; i--) {
+		if (At(i - 1).type == type) {
+			return i - 1;
+		}
+	}
+	return count_;
+}
+
+bool InputEventQueue::EvictMotion() {
+	// 後に同じ種類のイベントがあれば、そちらに量を足して消す（少し遅く動いたことになる）
+	for (uint32_t i = 0; i < count_; i++) {
+		const InputEvent& event = At(i);
+		if (!IsMotion(event.type)) {
+			continue;
+		}
+		for (uint32_t j = i + 1; j < count_; j++) {
+			InputEvent& later = At(j);
+			if (later.type == event.type) {
+				later.x += event.x;
+				later.y += event.y;
+				Erase(i);
+				return true;
+			}
+		}
+	}
+	// まとめる先が無ければ、一番古いものを捨てる
+	for (uint32_t i = 0; i < count_; i++) {
+		if (IsMotion(At(i).type)) {
+			Erase(i);
+			droppedCount_++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void InputEventQueue::Erase(uint32_t index) {
+	for (uint32_t i = index; i + 1 < count_; i++) {
+		At(i) = At(i + 1);
+	}
+	count_--;
+}
+
+//----------------------------------------------
+// InputEventState
+//----------------------------------------------
+
+void InputEventState::Advance(InputEventQueue& queue, InputClock::time_point until) {
+	keyTriggers_.Clear();
+	keyReleases_.Clear();
+	mouseTriggers_.reset();
+	mouseReleases_.reset();
+	mouseMoveX_ = 0;
+	mouseMoveY_ = 0;
+	wheel_ = 0;
+	eventCount_ = 0;
+
+	InputEvent event;
+	while (eventCount_ < events_.size() && queue.Pop(until, event)) {
+		events_[eventCount_++] = event;
+		Apply(event);
+	}
+}
+
+void InputEventState::Reset() {
+	keys_.Clear();
+	keyTriggers_.Clear();
+	keyReleases_.Clear();
+	mouseButtons_.reset();
+	mouseTriggers_.reset();
+	mouseReleases_.reset();
+	mouseMoveX_ = 0;
+	mouseMoveY_ = 0;
+	wheel_ = 0;
+	eventCount_ = 0;
+}
+
+bool InputEventState::IsPressMouse(int32_t mouseNumber) const {
+	return mouseNumber >= 0 && mouseNumber < int32_t(kMouseButtonCount) &&
+	       mouseButtons_[mouseNumber];
+}
+
+bool InputEventState::IsTriggerMouse(int32_t mouseNumber) const {
+	return mouseNumber >= 0 && mouseNumber < int32_t(kMouseButtonCount) &&
+	       mouseTriggers_[mouseNumber];
+}
+
+void InputEventState::Apply(const InputEvent& event) {
+	switch (event.type) {
+	case InputEventType::KeyDown:
+		// 押しっぱなしの繰り返しはトリガーにしない
+		if (!keys_.Test(event.code)) {
+			keys_.Set(event.code);
+			keyTriggers_.Set(event.code);
+		}
+		break;
+
+	case InputEventType::KeyUp:
+		if (keys_.Test(event.code)) {
+			keys_.Reset(event.code);
+			keyReleases_.Set(event.code);
+		}
+		break;
+
+	case InputEventType::MouseButtonDown:
+		if (event.code < kMouseButtonCount && !mouseButtons_[event.code]) {
+			mouseButtons_.set(event.code);
+			mouseTriggers_.set(event.code);
+		}
+		break;
+
+	case InputEventType::MouseButtonUp:
+		if (event.code < kMouseButtonCount && mouseButtons_[event.code]) {
+			mouseButtons_.reset(event.code);
+			mouseReleases_.set(event.code);
+		}
+		break;
+
+	case InputEventType::MouseMove:
+		mouseMoveX_ += event.x;
+		mouseMoveY_ += event.y;
+		break;
+
+	case InputEventType::MouseWheel:
+		wheel_ += event.x;
+		break;
+
+	case InputEventType::FocusLost:
+		// 離したメッセージは他のウィンドウに行くので、ここで全て離す
+		keyReleases_ |= keys_;
+		keys_.Clear();
+		mouseReleases_ |= mouseButtons_;
+		mouseButtons_.reset();
+		break;
+	}
+}
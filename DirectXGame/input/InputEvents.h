@@ -0,0 +1,206 @@
+#pragma once
+
+#include "InputBits.h"
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// 入力イベントの時計（FixedTimestep と同じ）
+/// </summary>
+using InputClock = std::chrono::steady_clock;
+
+/// <summary>
+/// 入力イベントの種類
+/// </summary>
+enum class InputEventType : uint8_t {
+	KeyDown,         // code: キー番号（DIK_ と同じ）
+	KeyUp,           // code: キー番号（DIK_ と同じ）
+	MouseButtonDown, // code: 0:左 1:右 2:中 3~:拡張
+	MouseButtonUp,   // code: 0:左 1:右 2:中 3~:拡張
+	MouseMove,       // x, y: 移動量
+	MouseWheel,      // x: 回転量
+	FocusLost,       // 押しているキー・ボタンを全て離したことにする
+};
+
+/// <summary>
+/// 時刻付きの入力イベント
+/// </summary>
+struct InputEvent {
+	InputClock::time_point time;
+	InputEventType type = InputEventType::KeyDown;
+	uint8_t code = 0;
+	int32_t x = 0;
+	int32_t y = 0;
+};
+
+/// <summary>
+/// 入力イベントのキュー（固定長のリング、時刻順）
+/// ウィンドウのメッセージから積み、シミュレーションのステップごとにその終わりの時刻まで取り出す。
+/// 同じスレッドで積んで取り出す。
+/// マウスの移動・ホイールは最後のイベントと同じ種類なら量を足してまとめる。
+/// キー・ボタン・フォーカスのイベントは捨てない（捨てると押しっぱなしが残る）ので、
+/// 最後の kReservedCapacity 個はこれらのために空けておき、満杯ならマウスの移動・ホイールを減らす。
+/// </summary>
+class InputEventQueue {
+public: // 定数
+	// 容量（2の累乗）
+	static const uint32_t kCapacity = 256;
+	// キー・ボタン・フォーカスのイベントのために空けておく数
+	static const uint32_t kReservedCapacity = 32;
+
+public: // メンバ関数
+	/// <summary>
+	/// 積む（時刻が前のイベントより戻るときは前のイベントの時刻に揃える）
+	/// </summary>
+	/// <returns>積めたか（捨てたら false）</returns>
+	bool Push(const InputEvent& event);
+
+	/// <summary>
+	/// 指定した時刻までに起きた一番古いイベントを取り出す
+	/// </summary>
+	/// <param name="until">この時刻以前のイベントだけ取り出す</param>
+	/// <param name="event">取り出したイベント</param>
+	/// <returns>取り出せたか</returns>
+	bool Pop(InputClock::time_point until, InputEvent& event);
+
+	/// <summary>
+	/// 全て捨てる
+	/// </summary>
+	void Clear();
+
+	uint32_t GetSize() const { return count_; }
+
+	/// <summary>
+	/// 満杯で捨てたイベントの数の取得
+	/// （マウスの移動・ホイールを減らしきれなかったときだけ増える）
+	/// </summary>
+	uint32_t GetDroppedCount() const { return droppedCount_; }
+
+private: // メンバ関数
+	// 古い方から index 番目のイベント
+	InputEvent& At(uint32_t index) { return events_[(head_ + index) & (kCapacity - 1)]; }
+
+	/// <summary>
+	/// 同じ種類のイベントの一番新しいものを探す
+	/// </summary>
+	/// <returns>古い方からの番号（無ければ count_）</returns>
+	uint32_t FindLast(InputEventType type);
+
+	/// <summary>
+	/// マウスの移動・ホイールを1つ減らす（後の同じ種類のイベントに量を足して消す）
+	/// </summary>
+	/// <returns>減らせたか</returns>
+	bool EvictMotion();
+
+	/// <summary>
+	/// index 番目のイベントを消して後ろを詰める
+	/// </summary>
+	void Erase(uint32_t index);
+
+private: // メンバ変数
+	std::array<InputEvent, kCapacity> events_;
+	uint32_t head_ = 0;
+	uint32_t count_ = 0;
+	uint32_t droppedCount_ = 0;
+	InputClock::time_point lastTime_;
+};
+
+/// <summary>
+/// 入力イベントから作る1ステップ分の入力の状態
+/// ステップの終わりの時刻までのイベントを順に反映するので、
+/// 1ステップより短い押下もトリガーとして残る（押して離したステップでは押下中ではない）。
+/// </summary>
+class InputEventState {
+public: // 定数
+	static const uint32_t kKeyCount = InputBits::kBitCount;
+	static const uint32_t kMouseButtonCount = 8;
+
+public: // メンバ関数
+	/// <summary>
+	/// 次のステップへ進める（前回からこの時刻までのイベントを取り出して反映する）
+	/// </summary>
+	/// <param name="queue">入力イベントのキュー</param>
+	/// <param name="until">このステップの終わりの時刻</param>
+	void Advance(InputEventQueue& queue, InputClock::time_point until);
+
+	/// <summary>
+	/// 全て離した状態に戻す
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// ステップの終わりにキーを押しているか
+	/// </summary>
+	/// <param name="keyNumber">キー番号( DIK_0 等)</param>
+	bool PushKey(uint8_t keyNumber) const { return keys_.Test(keyNumber); }
+
+	/// <summary>
+	/// このステップの間にキーを押したか（同じステップの間に離していても true）
+	/// </summary>
+	/// <param name="keyNumber">キー番号( DIK_0 等)</param>
+	bool TriggerKey(uint8_t keyNumber) const { return keyTriggers_.Test(keyNumber); }
+
+	/// <summary>
+	/// このステップの間にキーを離したか
+	/// </summary>
+	/// <param name="keyNumber">キー番号( DIK_0 等)</param>
+	bool ReleaseKey(uint8_t keyNumber) const { return keyReleases_.Test(keyNumber); }
+
+	/// <summary>
+	/// 全キーの状態（ビットの番号がキー番号）
+	/// </summary>
+	const InputBits& GetKeys() const { return keys_; }
+	const InputBits& GetKeyTriggers() const { return keyTriggers_; }
+	const InputBits& GetKeyReleases() const { return keyReleases_; }
+
+	/// <summary>
+	/// ステップの終わりにマウスのボタンを押しているか
+	/// </summary>
+	/// <param name="mouseNumber">0:左 1:右 2:中 3~:拡張</param>
+	bool IsPressMouse(int32_t mouseNumber) const;
+
+	/// <summary>
+	/// このステップの間にマウスのボタンを押したか
+	/// </summary>
+	/// <param name="mouseNumber">0:左 1:右 2:中 3~:拡張</param>
+	bool IsTriggerMouse(int32_t mouseNumber) const;
+
+	/// <summary>
+	/// このステップの間のマウスの移動量
+	/// </summary>
+	int32_t GetMouseMoveX() const { return mouseMoveX_; }
+	int32_t GetMouseMoveY() const { return mouseMoveY_; }
+
+	/// <summary>
+	/// このステップの間のホイールの回転量
+	/// </summary>
+	int32_t GetWheel() const { return wheel_; }
+
+	/// <summary>
+	/// このステップで取り出したイベント（時刻順）
+	/// </summary>
+	std::span<const InputEvent> GetEvents() const { return {events_.data(), eventCount_}; }
+
+private: // メンバ関数
+	/// <summary>
+	/// イベント1つの反映
+	/// </summary>
+	void Apply(const InputEvent& event);
+
+private: // メンバ変数
+	InputBits keys_;
+	InputBits keyTriggers_;
+	InputBits keyReleases_;
+	std::bitset<kMouseButtonCount> mouseButtons_;
+	std::bitset<kMouseButtonCount> mouseTriggers_;
+	std::bitset<kMouseButtonCount> mouseReleases_;
+	int32_t mouseMoveX_ = 0;
+	int32_t mouseMoveY_ = 0;
+	int32_t wheel_ = 0;
+	// このステップのイベント（キューの容量を超えて取り出すことはない）
+	std::array<InputEvent, InputEventQueue::kCapacity> events_;
+	uint32_t eventCount_ = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ActionMap.h"
+#include <Windows.h>
+#include <XInput.h>
+
+/// <summary>
+/// XInput のパッドの状態をアクションの評価用に変換
+/// </summary>
+/// <param name="gamepad">XInput のパッドの状態</param>
+/// <returns>プラットフォームに依存しない形のパッドの状態</returns>
+inline GamepadState ToGamepadState(const XINPUT_GAMEPAD& gamepad) {
+	GamepadState pad;
+	pad.buttons = gamepad.wButtons;
+	pad.axes[static_cast<size_t>(GamepadAxis::LeftX)] = gamepad.sThumbLX;
+	pad.axes[static_cast<size_t>(GamepadAxis::LeftY)] = gamepad.sThumbLY;
+	pad.axes[static_cast<size_t>(GamepadAxis::RightX)] = gamepad.sThumbRX;
+	pad.axes[static_cast<size_t>(GamepadAxis::RightY)] = gamepad.sThumbRY;
+	pad.axes[static_cast<size_t>(GamepadAxis::LeftTrigger)] =
+	    static_cast<int16_t>(gamepad.bLeftTrigger * 32767 / 255);
+	pad.axes[static_cast<size_t>(GamepadAxis::RightTrigger)] =
+	    static_cast<int16_t>(gamepad.bRightTrigger * 32767 / 255);
+	return pad;
+}
@@ -1,11 +1,55 @@
 #include "Audio.h"
 #include "AxisIndicator.h"
+#include "BackgroundLoader.h"
 #include "DirectXCommon.h"
+#include "FixedTimestep.h"
 #include "GameScene.h"
 #include "ImGuiManager.h"
+#include "Input.h"
+#include "JobSystem.h"
 #include "PrimitiveDrawer.h"
+#include "StreamDecoder.h"
 #include "TextureManager.h"
 #include "WinApp.h"
+#include "XInputGamepad.h"
+#include <cwchar>
+#include <shellapi.h>
+#include <string>
+
+namespace {
+
+// リプレイを再生するコマンドラインのオプション（"-replay ファイル名"）
+const wchar_t kReplayOption[] = L"-replay";
+// 終了時に入力の記録を保存するファイル
+const char kLastReplayFileName[] = "last_replay.bin";
+
+// コマンドラインからリプレイのファイル名を取り出す（無ければ空）
+// 引用符で囲んだ空白入りのパスや、後ろに続く他の引数は CommandLineToArgvW に任せて分ける。
+std::string FindReplayFileName() {
+	std::string fileName;
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (!argv) {
+		return fileName;
+	}
+	for (int i = 1; i + 1 < argc; i++) {
+		if (wcscmp(argv[i], kReplayOption) == 0) {
+			// ファイルは narrow の std::string で開くので、ANSI のコードページに変換する
+			int size =
+			    WideCharToMultiByte(CP_ACP, 0, argv[i + 1], -1, nullptr, 0, nullptr, nullptr);
+			if (size > 1) {
+				fileName.resize(size - 1);
+				WideCharToMultiByte(
+				    CP_ACP, 0, argv[i + 1], -1, fileName.data(), size, nullptr, nullptr);
+			}
+			break;
+		}
+	}
+	LocalFree(argv);
+	return fileName;
+}
+
+} // namespace
 
 // Windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
@@ -26,6 +70,15 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	dxCommon = DirectXCommon::GetInstance();
 	dxCommon->Initialize(win);
 
+	// ジョブシステムの初期化（ワーカーでもWICを使うのでCOMを初期化する）
+	JobSystem::GetInstance()->Initialize(
+	    0, [] { CoInitializeEx(nullptr, COINIT_MULTITHREADED); }, [] { CoUninitialize(); });
+	// 読み込み用のスレッドの初期化（画像の展開にWICを使う）
+	BackgroundLoader::GetInstance()->Initialize(
+	    [] { CoInitializeEx(nullptr, COINIT_MULTITHREADED); }, [] { CoUninitialize(); });
+	// BGMの先読み・展開用のスレッドの初期化
+	StreamDecoder::GetInstance()->Initialize();
+
 #pragma region 汎用機能初期化
 	// ImGuiの初期化
 	ImGuiManager* imguiManager = ImGuiManager::GetInstance();
@@ -58,8 +111,16 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 #pragma endregion
 
 	// ゲームシーンの初期化
+	std::string replayFileName = FindReplayFileName();
+	// ステップごとのキーボードの状態（ウィンドウのメッセージから作った入力イベントで進める）
+	InputEventState inputState;
+	// ステップごとのパッド0の状態
+	GamepadState gamepad;
 	gameScene = new GameScene();
-	gameScene->Initialize();
+	gameScene->Initialize(&inputState, &gamepad, replayFileName);
+
+	// シミュレーションは60Hzの固定刻みで進め、描画はモニタのリフレッシュレートに任せる
+	FixedTimestep timestep(1.0 / 60.0);
 
 	// メインループ
 	while (true) {
@@ -70,10 +131,21 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 		// ImGui受付開始
 		imguiManager->Begin();
-		// 入力関連の毎フレーム処理
-		input->Update();
-		// ゲームシーンの毎フレーム処理
-		gameScene->Update();
+		// 貯まった時間の分だけシミュレーションを進める
+		uint32_t steps = timestep.Advance();
+		for (uint32_t i = 0; i < steps; i++) {
+			// 入力関連の毎ステップ処理
+			input->Update();
+			// このステップの終わりまでに起きた入力イベントを反映する
+			inputState.Advance(win->GetInputEvents(), timestep.GetStepEndTime(i));
+			XINPUT_STATE xInput{};
+			gamepad = input->GetJoystickState(0, xInput) ? ToGamepadState(xInput.Gamepad)
+			                                             : GamepadState();
+			// ゲームシーンの毎ステップ処理
+			gameScene->Update();
+		}
+		// 直前の2ステップの間を補間して描画する
+		gameScene->Interpolate(timestep.GetAlpha());
 		// 軸表示の更新
 		axisIndicator->Update();
 		// ImGui受付終了
@@ -93,8 +165,13 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		dxCommon->PostDraw();
 	}
 
-	// 各種解放
+	// 各種解放（GPUが使い終わるのを待ってから）
+	dxCommon->WaitForGPU();
+	gameScene->SaveRecording(kLastReplayFileName);
 	SafeDelete(gameScene);
+	StreamDecoder::GetInstance()->Finalize();
+	BackgroundLoader::GetInstance()->Finalize();
+	JobSystem::GetInstance()->Finalize();
 	audio->Finalize();
 	// ImGui解放
 	imguiManager->Finalize();
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Vector3.h"
+
+/// <summary>
+/// 軸平行境界ボックス
+/// </summary>
+struct AABB final {
+	Vector3 min; // 最小点
+	Vector3 max; // 最大点
+};
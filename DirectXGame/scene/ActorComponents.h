@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Vector3.h"
+#include <cstdint>
+
+class Model;
+
+///
+/// ゲームシーンのアクター（ステージ・ビーム・敵）のコンポーネント
+///
+
+/// <summary>
+/// 位置・回転・スケール
+/// </summary>
+struct TransformComponent {
+	Vector3 scale = {1, 1, 1};
+	Vector3 rotation = {0, 0, 0};
+	Vector3 translation = {0, 0, 0};
+	Vector3 prevTranslation = {0, 0, 0}; // 移動前の座標(連続衝突判定・描画の補間用)
+	Vector3 prevRotation = {0, 0, 0};    // 移動前の回転(描画の補間用)
+};
+
+/// <summary>
+/// 1ステップ(1/60秒)あたりの移動量・回転量
+/// </summary>
+struct VelocityComponent {
+	Vector3 linear = {0, 0, 0};
+	Vector3 angular = {0, 0, 0};
+};
+
+/// <summary>
+/// 寿命
+/// </summary>
+struct LifetimeComponent {
+	float remaining = 0.0f; // 残りステップ数（負になると消滅）
+};
+
+/// <summary>
+/// 当たり判定
+/// </summary>
+struct ColliderComponent {
+	float radius = 0.5f; // XZ方向の半径
+};
+
+/// <summary>
+/// 描画
+/// </summary>
+struct RenderableComponent {
+	Model* model = nullptr;
+	uint32_t textureHandle = 0;
+};
+
+/// <summary>
+/// 敵ジャンプ（消滅演出中）
+/// </summary>
+struct EnemyJumpComponent {
+	float jumpSpeed = 0.0f; // 敵ジャンプの移動速度
+};
+
+// 種類を表すタグ
+struct StageTag {};
+struct BeamTag {};
+struct EnemyTag {};
@@ -0,0 +1,99 @@
+#include "ActorSystems.h"
+
+void SavePreviousPositionSystem(EcsWorld& world) {
+	world.ForEachChunk<TransformComponent>(
+	    [](uint32_t count, const Entity*, TransformComponent* transforms) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    transforms[i].prevTranslation = transforms[i].translation;
+			    transforms[i].prevRotation = transforms[i].rotation;
+		    }
+	    });
+}
+
+void StageScrollSystem(EcsWorld& world) {
+	world.ForEachChunk<StageTag, TransformComponent, VelocityComponent>(
+	    [](uint32_t count, const Entity*, StageTag*, TransformComponent* transforms,
+	       VelocityComponent* velocities) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    // 手前に移動
+			    transforms[i].translation.z += velocities[i].linear.z;
+			    // 端まで来たら奥へ戻る（補間で画面を横切らないよう移動前の座標もずらす）
+			    if (transforms[i].translation.z < -5) {
+				    transforms[i].translation.z += 40;
+				    transforms[i].prevTranslation.z += 40;
+			    }
+		    }
+	    });
+}
+
+void BeamMoveSystem(EcsWorld& world) {
+	world.ForEachChunk<BeamTag, TransformComponent, VelocityComponent>(
+	    [](uint32_t count, const Entity*, BeamTag*, TransformComponent* transforms,
+	       VelocityComponent* velocities) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    transforms[i].translation.z += velocities[i].linear.z;
+			    transforms[i].rotation.x += velocities[i].angular.x;
+		    }
+	    });
+}
+
+void LifetimeSystem(EcsWorld& world) {
+	world.ForEachChunk<LifetimeComponent>(
+	    [&world](uint32_t count, const Entity* entities, LifetimeComponent* lifetimes) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    lifetimes[i].remaining -= 1.0f;
+			    if (lifetimes[i].remaining < 0.0f) {
+				    world.DestroyDeferred(entities[i]);
+			    }
+		    }
+	    });
+}
+
+void EnemyMoveSystem(EcsWorld& world, int gameTimer) {
+	world.ForEachChunk<EnemyTag, TransformComponent, VelocityComponent>(
+	    [&world, gameTimer](
+	        uint32_t count, const Entity* entities, EnemyTag*, TransformComponent* transforms,
+	        VelocityComponent* velocities) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    TransformComponent& transform = transforms[i];
+			    VelocityComponent& velocity = velocities[i];
+			    transform.translation.z += velocity.linear.z;
+			    transform.rotation.x += velocity.angular.x;
+			    transform.translation.x += velocity.linear.x;
+			    transform.translation.z -= gameTimer / 1000.0f;
+			    if (transform.translation.z < -5) {
+				    world.DestroyDeferred(entities[i]);
+				    continue;
+			    }
+
+			    if (transform.translation.x >= 4) {
+				    velocity.linear.x = -0.1f;
+			    }
+
+			    if (transform.translation.x <= -4) {
+				    velocity.linear.x = 0.1f;
+			    }
+		    }
+	    },
+	    MakeComponentMask<EnemyJumpComponent>());
+}
+
+void EnemyJumpSystem(EcsWorld& world) {
+	world.ForEachChunk<EnemyTag, TransformComponent, VelocityComponent, EnemyJumpComponent>(
+	    [&world](
+	        uint32_t count, const Entity* entities, EnemyTag*, TransformComponent* transforms,
+	        VelocityComponent* velocities, EnemyJumpComponent* jumps) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    // 移動(Y座標に速度を加える)
+			    transforms[i].translation.y += jumps[i].jumpSpeed;
+			    // 速度を減らす
+			    jumps[i].jumpSpeed -= 0.1f;
+			    // 斜め移動
+			    transforms[i].translation.x += velocities[i].linear.x * 4;
+			    // 下へ落ちると消滅
+			    if (transforms[i].translation.y < -3) {
+				    world.DestroyDeferred(entities[i]);
+			    }
+		    }
+	    });
+}
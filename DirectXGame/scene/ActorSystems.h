@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ActorComponents.h"
+#include "EcsWorld.h"
+
+///
+/// ゲームシーンのアクターを更新するシステム。
+/// 削除は DestroyDeferred で予約するので、呼び出し側で FlushDeferred すること。
+///
+
+/// <summary>
+/// 移動前の座標を記録
+/// </summary>
+void SavePreviousPositionSystem(EcsWorld& world);
+
+/// <summary>
+/// ステージのスクロール
+/// </summary>
+void StageScrollSystem(EcsWorld& world);
+
+/// <summary>
+/// ビーム移動
+/// </summary>
+void BeamMoveSystem(EcsWorld& world);
+
+/// <summary>
+/// 寿命が尽きたものを削除
+/// </summary>
+void LifetimeSystem(EcsWorld& world);
+
+/// <summary>
+/// 敵移動（消滅演出中の敵は除く）
+/// </summary>
+/// <param name="gameTimer">ゲームタイマー（経過するほど速くなる）</param>
+void EnemyMoveSystem(EcsWorld& world, int gameTimer);
+
+/// <summary>
+/// 敵ジャンプ（消滅演出）
+/// </summary>
+void EnemyJumpSystem(EcsWorld& world);
@@ -1,13 +1,27 @@
 #include "GameScene.h"
 #include "MathUtilityForText.h"
 #include "TextureManager.h"
+#include <algorithm>
 #include <cassert>
 
+// キーの番号（DIK_*）
+#define DIRECTINPUT_VERSION 0x0800
+#include <dinput.h>
+
+namespace {
+
+// ゲームのボタンのアクション名（GameButton の順）
+const char* const kButtonActionNames[] = {"Left", "Right", "Fire", "Decide"};
+static_assert(std::size(kButtonActionNames) == static_cast<size_t>(GameButton::Count));
+
+} // namespace
+
 // コントストラクタ
 GameScene::GameScene() {}
 
 // デストラクタ
 GameScene::~GameScene() {
+	audioOutput_.Stop();    // ミキサーを呼ばなくなってから解放する
 	delete spriteBG_;       // BG
 	delete modelStage_;     // ステージ
 	delete modelPlayer_;    // プレイヤー
@@ -19,14 +33,13 @@ GameScene::~GameScene() {
 }
 
 // 初期化
-void GameScene::Initialize() {
+void GameScene::Initialize(
+    const InputEventState* inputState, const GamepadState* gamepad,
+    const std::string& replayFileName) {
 
 	dxCommon_ = DirectXCommon::GetInstance();
-	input_ = Input::GetInstance();
-	audio_ = Audio::GetInstance();
-
-	textureHandleBG_ = TextureManager::Load("bg.jpg");
-	spriteBG_ = Sprite::Create(textureHandleBG_, {0, 0});
+	inputState_ = inputState;
+	gamepad_ = gamepad;
 
 	// ビュープロジェクションの初期化
 	viewProjection_.Initialize();
@@ -35,6 +48,58 @@ void GameScene::Initialize() {
 	viewProjection_.translation_.z = -6;
 	viewProjection_.Initialize();
 
+	// プレイヤー
+	worldTransformPlayer_.scale_ = {0.5f, 0.5f, 0.5f};
+	worldTransformPlayer_.Initialize();
+
+	// 描画用のワールド変換はCPUとGPUで同時に扱うフレーム数ぶん持つ
+	playerRenderTransforms_.resize(dxCommon_->GetFramesInFlight());
+	for (WorldTransform& worldTransform : playerRenderTransforms_) {
+		worldTransform.Initialize();
+	}
+	renderTransforms_.resize(dxCommon_->GetFramesInFlight());
+
+	// デバッグテキスト
+	debugText_ = DebugText::GetInstance();
+	debugText_->Initialize();
+
+	// サウンド
+	sceneAudio_.Initialize();
+	audioOutput_.Start(&sceneAudio_.GetMixer());
+
+	// 画面ごとの素材（起動時はタイトルの分だけ読み込み、残りは前の画面の間に先読みする）
+	assetLoader_.SetManifest(
+	    GameSceneId::Title, {{"title.png", "enter.png"}, [this] { LoadTitleAssets(); }});
+	assetLoader_.SetManifest(
+	    GameSceneId::GamePlay,
+	    {{"bg.jpg", "score.png", "number.png", "stage2.jpg", "player.png", "beam.png",
+	      "enemy.png"},
+	     [this] { LoadGamePlayAssets(); }});
+	assetLoader_.SetManifest(
+	    GameSceneId::GameOver, {{"gameover.png"}, [this] { LoadGameOverAssets(); }});
+	assetLoader_.SetManifest(GameSceneId::GameClear, {{}, [this] { LoadGameClearAssets(); }});
+	assetLoader_.Load(GameSceneId::Title);
+
+	// 入力（リプレイがあればその乱数の種と入力で再生し、無ければキーボードを記録する）
+	isReplay_ = !replayFileName.empty() && recording_.LoadFile(replayFileName);
+	if (isReplay_) {
+		replayInput_.SetScript([this](uint32_t step) { return recording_.GetButtons(step); });
+	} else {
+		recording_.Reset(static_cast<uint32_t>(time(NULL)));
+		actionInput_.Initialize(&actionMap_);
+		recordingInput_.Initialize(&actionInput_, &recording_);
+	}
+	GameInput* gameInput = isReplay_ ? static_cast<GameInput*>(&replayInput_) : &recordingInput_;
+
+	// ゲームの更新（タイトルBGMの再生もここから）
+	// アクターの見た目はゲームプレイの素材を読み込んだときに設定する
+	simulation_.Initialize(
+	    gameInput, &sceneAudio_, &assetLoader_, GameSimulation::Appearances{},
+	    recording_.GetSeed());
+}
+
+// タイトルの素材（読み込み後）
+void GameScene::LoadTitleAssets() {
 	// タイトル(2Dスプライト)
 	textureHandleTitle_ = TextureManager::Load("title.png");
 	spriteTitle_ = Sprite::Create(textureHandleTitle_, {0, 0});
@@ -42,62 +107,36 @@ void GameScene::Initialize() {
 	textureHandleEnter_ = TextureManager::Load("enter.png");
 	spriteEnter_ = Sprite::Create(textureHandleEnter_, {390, 500});
 
-	textureHandleGameOver_ = TextureManager::Load("gameover.png");
-	spriteGameOver_ = Sprite::Create(textureHandleGameOver_, {0, 0});
+	sceneAudio_.LoadSound(GameSound::TitleBGM);
+}
 
-	for (int n = 0; n < 5; n++) {
-		textureHandleNumber_ = TextureManager::Load("score.png");
-		spriteNumber_[n] = Sprite::Create(textureHandleNumber_, {0, 0});
-	}
+// ゲームプレイの素材（読み込み後）
+void GameScene::LoadGamePlayAssets() {
+	// BG(2Dスプライト)
+	textureHandleBG_ = TextureManager::Load("bg.jpg");
+	spriteBG_ = Sprite::Create(textureHandleBG_, {0, 0});
 
 	// ステージ
 	textureHandleStage_ = TextureManager::Load("stage2.jpg");
 	modelStage_ = Model::Create();
-	for (int s = 0; s < 20; s++) {
-		worldTransformStage_[s].Initialize();
-
-		// ステージの位置を変更
-		worldTransformStage_[s].translation_ = {0, -1.5f, 2.0f * s - 5};
-		worldTransformStage_[s].scale_ = {4.5f, 1, 1};
-
-		// 変数行列を更新
-		worldTransformStage_[s].matWorld_ = MakeAffineMatrix(
-		    worldTransformStage_[s].scale_,
-			worldTransformStage_[s].rotation_,
-		    worldTransformStage_[s].translation_);
-
-		// 変更行列を定数バッファに転送
-		worldTransformStage_[s].TransferMatrix();
-	}
 
 	// プレイヤー
 	textureHandlePlayer_ = TextureManager::Load("player.png");
 	modelPlayer_ = Model::Create();
-	worldTransformPlayer_.scale_ = {0.5f, 0.5f, 0.5f};
-	worldTransformPlayer_.Initialize();
 
 	// ビーム
 	textureHandleBeam_ = TextureManager::Load("beam.png");
 	modelBeam_ = Model::Create();
-	for (int i = 0; i < 10; i++) {
-		worldTransformBeam_[i].scale_ = {0.3f, 0.3f, 0.3f};
-		worldTransformBeam_[i].Initialize();
-	}
 
 	// 敵
 	textureHandleEnemy_ = TextureManager::Load("enemy.png");
 	modelEnemy_ = Model::Create();
-	// 敵の数ループする
-	for (int i = 0; i < 10; i++) {
-		worldTransformEnemy_[i].scale_ = {0.5f, 0.5f, 0.5f};
-		worldTransformEnemy_[i].Initialize();
-	}
 
-	srand((unsigned int)time(NULL));
-
-	// デバッグテキスト
-	debugText_ = DebugText::GetInstance();
-	debugText_->Initialize();
+	simulation_.SetAppearances({
+	    {modelStage_, textureHandleStage_},
+	    {modelBeam_, textureHandleBeam_},
+	    {modelEnemy_, textureHandleEnemy_},
+	});
 
 	// スコア数値(2Dスプライト)
 	textureHandleScore_ = TextureManager::Load("score.png");
@@ -113,425 +152,132 @@ void GameScene::Initialize() {
 		spriteLife_[i]->SetSize({40, 40});
 	}
 
-	// サウンドデータの読み込み
-	soundDataHandleTitleBGM_ = audio_->LoadWave("Audio/Ring05.wav");
-	soundDataHandleGamePlayBGM_ = audio_->LoadWave("Audio/Ring08.wav");
-	soundDataHandleGameOverBGM_ = audio_->LoadWave("Audio/Ring09.wav");
-	soundDataHandleGameClearBGM_ = audio_->LoadWave("Audio/fanfare.wav");
-	soundDataHandleEnemyHitSE_ = audio_->LoadWave("Audio/chord.wav");
-	soundDataHandlePlayerHitSE_ = audio_->LoadWave("Audio/tada.wav");
+	sceneAudio_.LoadSound(GameSound::GamePlayBGM);
+	sceneAudio_.LoadSound(GameSound::EnemyHitSE);
+	sceneAudio_.LoadSound(GameSound::PlayerHitSE);
+}
+
+// ゲームオーバーの素材（読み込み後）
+void GameScene::LoadGameOverAssets() {
+	textureHandleGameOver_ = TextureManager::Load("gameover.png");
+	spriteGameOver_ = Sprite::Create(textureHandleGameOver_, {0, 0});
+
+	sceneAudio_.LoadSound(GameSound::GameOverBGM);
+}
 
-	// タイトルBGMを再生
-	voiceHandleBGM_ = audio_->PlayWave(soundDataHandleTitleBGM_, true);
+// ゲームクリアの素材（読み込み後）
+void GameScene::LoadGameClearAssets() {
+	sceneAudio_.LoadSound(GameSound::GameClearBGM);
 }
 
 // 更新
 void GameScene::Update() {
-	// 各シーンの更新処理を呼び出す
-	switch (sceneMode_) {
-	case 0:
-		GamePlayUpdate(); // ゲームプレイ更新
-		// ゲームタイマー
-		gameTimer_++;
-		break;
-	case 1:
-		TitleUpdate(); // タイトル更新
-		gameTimer_++;
-		break;
-	case 2:
-		GameOverUpdate();
-		gameTimer_++;
-		break;
-	case 3:
-		GameClearUpdate();
-		gameTimer_++;
-		break;
+	// このステップの入力（キーボードはこのステップの終わりまでの入力イベントを反映した状態を記録する）
+	if (isReplay_) {
+		replayInput_.Advance();
+	} else {
+		actionMap_.Update(*inputState_, *gamepad_);
+		recordingInput_.Advance();
+	}
+
+	// 入力と音は Initialize で渡した窓口を通す
+	simulation_.Update();
+
+	// リプレイを最後まで再生したら、記録した最後の状態と比べる
+	if (isReplay_ && ++replayStep_ == recording_.GetStepCount()) {
+		uint64_t checksum = simulation_.ComputeChecksum();
+		isReplayMismatch_ = !recording_.MatchesChecksum(checksum);
+		if (isReplayMismatch_) {
+			debugText_->ConsolePrintf(
+			    "replay checksum mismatch: recorded %016llx, replayed %016llx\n",
+			    static_cast<unsigned long long>(recording_.GetChecksum()),
+			    static_cast<unsigned long long>(checksum));
+		}
 	}
 }
 
-void GameScene::GamePlayUpdate() {
-	PlayerUpdate();
-	BeamUpdate();
-	EnemyUpdate();
-	StageUpdate();
-	Collision();
-
-	// プレイヤーライフが0以下になったとき
-	if (playerLife_ <= 0) {
-		sceneMode_ = 2;
-
-		// BGM切り替え
-		audio_->StopWave(voiceHandleBGM_); // 現在のBGMを停止
-		voiceHandleBGM_ =
-		    audio_->PlayWave(soundDataHandleGameOverBGM_, true); // ゲームオーバーBGMを再生
-	}
-
-	if (gameScore_ > 100) {
-		gameScore_ = 100;
-		sceneMode_ = 3;
-
-		// BGM切り替え
-		audio_->StopWave(voiceHandleBGM_); // 現在のBGMを停止
-		voiceHandleBGM_ =
-		    audio_->PlayWave(soundDataHandleGameClearBGM_, true); // ゲームオーバーBGMを再生
+// 記録した入力の保存
+bool GameScene::SaveRecording(const std::string& fileName) {
+	if (isReplay_) {
+		return false;
 	}
+	// 再生したときに同じ結果になったか確かめられるよう、最後の状態も残す
+	recording_.SetChecksum(simulation_.ComputeChecksum());
+	return recording_.SaveFile(fileName);
 }
 
 //----------------------------------------------
 // タイトル
 //----------------------------------------------
 
-// タイトル更新
-void GameScene::TitleUpdate() {
-	// エンターキーを押した瞬間
-	if (input_->TriggerKey(DIK_RETURN)) {
-		// モードをゲームプレイへ変更
-		sceneMode_ = 0;
-		GamePlayStart();
-
-		// BGM切り替え
-		audio_->StopWave(voiceHandleBGM_); // 現在のBGMを停止
-		voiceHandleBGM_ =
-		    audio_->PlayWave(soundDataHandleGamePlayBGM_, true); // ゲームプレイBGMを再生
-	}
-}
-
 // タイトル表示
 void GameScene::TitleDraw2DNear() {
 	// タイトル表示
 	spriteTitle_->Draw();
 
 	// エンター表示
-	if (gameTimer_ % 40 >= 20) {
+	if (simulation_.GetGameTimer() % 40 >= 20) {
 		spriteEnter_->Draw();
 	}
 }
 
-void GameScene::GameOverUpdate() {
-	// エンターキーを押した瞬間
-	if (input_->TriggerKey(DIK_RETURN)) {
-		// モードをゲームプレイへ変更
-		sceneMode_ = 1;
-		// BGM切り替え
-		audio_->StopWave(voiceHandleBGM_);	// 現在のBGMを停止
-		voiceHandleBGM_ = audio_->PlayWave(soundDataHandleTitleBGM_, true); // タイトルBGMを再生
-	}
-}
-
 void GameScene::GameOverDraw2DNear() {
 	// タイトル表示
 	spriteGameOver_->Draw();
 
 	// エンター表示
-	if (gameTimer_ % 40 >= 20) {
+	if (simulation_.GetGameTimer() % 40 >= 20) {
 		spriteEnter_->Draw();
 	}
 }
 
-void GameScene::GameClearUpdate() {
-	// エンターキーを押した瞬間
-	if (input_->TriggerKey(DIK_RETURN)) {
-		// モードをゲームプレイへ変更
-		sceneMode_ = 1;
-		// BGM切り替え
-		audio_->StopWave(voiceHandleBGM_);		// 現在のBGMを停止
-		voiceHandleBGM_ = audio_->PlayWave(soundDataHandleTitleBGM_, true); // タイトルBGMを再生
-	}
-}
-
 void GameScene::GameClearDraw2DNear() {
-
-	// エンター表示
-	if (gameTimer_ % 40 >= 20) {
-		spriteEnter_->Draw();
-	}
+	char str[100];
+	sprintf_s(str, "GAME CREAL");
+	debugText_->Print(str, 550, 200, 2); // ゲームクリア表示
 }
 
-//----------------------------------------------
-// ステージ
-//----------------------------------------------
-
-// ステージ更新
-void GameScene::StageUpdate() {
-	// 各ステージでループ
-	for (int s = 0; s < 20; s++) {
-		// 手前に移動
-		worldTransformStage_[s].translation_.z -= 0.1f;
-		// 端まで来たら奥へ戻る
-		if (worldTransformStage_[s].translation_.z < -5) {
-			worldTransformStage_[s].translation_.z += 40;
-		}
-		// 変換行列を更新
-		worldTransformStage_[s].matWorld_ = MakeAffineMatrix(
-		    worldTransformStage_[s].scale_,
-			worldTransformStage_[s].rotation_,
-		    worldTransformStage_[s].translation_);
-		// 変数行列を定数バッファに転送
-		worldTransformStage_[s].TransferMatrix();
-	}
-}
-
-//----------------------------------------------
-// プレイヤー
-//----------------------------------------------
-
-// プレイヤー更新
-void GameScene::PlayerUpdate() {
-	// 移動
-
-	// 右へ移動
-	if (input_->PushKey(DIK_RIGHT)) {
-		worldTransformPlayer_.translation_.x += 0.1f;
-	}
-
-	// 左へ移動
-	if (input_->PushKey(DIK_LEFT)) {
-		worldTransformPlayer_.translation_.x -= 0.1f;
-	}
-
-	// 右への移動制限
-	if (worldTransformPlayer_.translation_.x > 4) {
-		worldTransformPlayer_.translation_.x = 4;
-	}
-
-	// 左への移動制限
-	if (worldTransformPlayer_.translation_.x < -4) {
-		worldTransformPlayer_.translation_.x = -4;
-	}
-
-	// 変数行列を更新
-	worldTransformPlayer_.matWorld_ = MakeAffineMatrix(
-	    worldTransformPlayer_.scale_, worldTransformPlayer_.rotation_,
-	    worldTransformPlayer_.translation_);
-
-	if (playerTimer_ > 0) {
-		playerTimer_--;
-	}
+// 描画用の補間
+void GameScene::Interpolate(float alpha) {
+	// プレイヤー
+	WorldTransform& playerTransform = playerRenderTransforms_[dxCommon_->GetFrameIndex()];
+	playerTransform.scale_ = worldTransformPlayer_.scale_;
+	playerTransform.rotation_ = worldTransformPlayer_.rotation_;
+	playerTransform.translation_ = Lerp(
+	    simulation_.GetPlayerPreviousPosition(), simulation_.GetPlayerPosition(), alpha);
+	playerTransform.matWorld_ = MakeAffineMatrix(
+	    playerTransform.scale_, playerTransform.rotation_, playerTransform.translation_);
 
 	// 変数行列を定数バッファに転送
-	worldTransformPlayer_.TransferMatrix();
-}
-
-//----------------------------------------------
-// ビーム
-//----------------------------------------------
+	playerTransform.TransferMatrix();
 
-// ビーム更新
-void GameScene::BeamUpdate() {
-	// ビーム移動
-	BeamMove();
-	// ビーム発生
-	BeamBorn();
-	// 変数行列を更新
-	for (int b = 0; b < 10; b++) {
-		worldTransformBeam_[b].matWorld_ = MakeAffineMatrix(
-		    worldTransformBeam_[b].scale_, worldTransformBeam_[b].rotation_,
-		    worldTransformBeam_[b].translation_);
-
-		// 変数行列を定数バッファに転送
-		worldTransformBeam_[b].TransferMatrix();
-	}
-}
-
-// ビーム移動
-void GameScene::BeamMove() {
-	for (int b = 0; b < 10; b++) {
-		if (beamFlag_[b] == 1) {
-			worldTransformBeam_[b].translation_.z += 0.3f;
-		}
-		worldTransformBeam_[b].rotation_.x += 0.1f;
-	}
-}
-
-// ビーム発生 (発射)
-void GameScene::BeamBorn() {
-	for (int b = 0; b < 10; b++) {
-		if (beamTimer_ == 0) {
-			if (input_->PushKey(DIK_SPACE)) {
-				if (beamFlag_[b] == 0) {
-					worldTransformBeam_[b].translation_.x = worldTransformPlayer_.translation_.x;
-					worldTransformBeam_[b].translation_.y = worldTransformPlayer_.translation_.y;
-					worldTransformBeam_[b].translation_.z = worldTransformPlayer_.translation_.z;
-					beamFlag_[b] = 1;
-					beamTimer_ = 1;
-					break;
-				}
-			}
-			if (worldTransformBeam_[b].translation_.z > 40) {
-				beamFlag_[b] = 0;
-			}
-		} else {
-			// 発射タイマーが1以上
-			// 10を超えると再び発射が可能
-			beamTimer_++;
-			if (beamTimer_ > 100) {
-				beamTimer_ = 0;
-			}
-		}
-	}
+	// ステージ・ビーム・敵
+	UpdateRenderTransforms(alpha);
 }
 
-//----------------------------------------------
-// 敵
-//----------------------------------------------
-
-// 敵更新
-void GameScene::EnemyUpdate() {
-	// 敵移動
-	EnemyMove();
-	// 敵発生
-	EnemyBorn();
-	// 敵ジャンプ
-	EnemyJump();
-	// 変数行列を更新
-	for (int e = 0; e < 10; e++) {
-		worldTransformEnemy_[e].matWorld_ = MakeAffineMatrix(
-		    worldTransformEnemy_[e].scale_, worldTransformEnemy_[e].rotation_,
-		    worldTransformEnemy_[e].translation_);
-
-		// 変数行列を定数バッファに転送
-		worldTransformEnemy_[e].TransferMatrix();
-	}
-}
-
-// 敵移動
-void GameScene::EnemyMove() {
-	for (int e = 0; e < 10; e++) {
-		if (enemyFlag_[e] == 1) {
-			worldTransformEnemy_[e].translation_.z -= 0.1f;
-			worldTransformEnemy_[e].rotation_.x -= 0.1f;
-			worldTransformEnemy_[e].translation_.x += enemySpeed_[e];
-			worldTransformEnemy_[e].translation_.z -= gameTimer_ / 1000.0f;
-			if (worldTransformEnemy_[e].translation_.z < -5) {
-				enemyFlag_[e] = 0;
-			}
-
-			if (worldTransformEnemy_[e].translation_.x >= 4) {
-				enemySpeed_[e] = -0.1f;
-			}
-
-			if (worldTransformEnemy_[e].translation_.x <= -4) {
-				enemySpeed_[e] = 0.1f;
-			}
-		}
-	}
-}
-
-// 敵発生
-void GameScene::EnemyBorn() {
-	// 乱数で発生
-	if (rand() % 10 == 0) {
-		for (int e = 0; e < 10; e++) {
-			if (enemyFlag_[e] == 0) {
-				enemyFlag_[e] = 1;
-				worldTransformEnemy_[e].translation_.z = 40;
-				worldTransformEnemy_[e].translation_.y = 0;
-
-				// 乱数でX座標の指定
-				int x = rand() % 80;          // 80は4の10倍の2倍
-				float x2 = (float)x / 10 - 4; // 10で割り、4を引く
-				worldTransformEnemy_[e].translation_.x = x2;
-
-				// 敵スピード
-				if (rand() % 2 == 0) {
-					enemySpeed_[e] = 0.1f;
-				} else {
-					enemySpeed_[e] = -0.1f;
-				}
-
-				// ループ処理終了
-				break;
-			}
-		}
-	}
-}
-
-void GameScene::EnemyJump() {
-	// 敵でループ
-	for (int j = 0; j < 10; j++) {
-		// 消滅演出ならば
-		if (enemyFlag_[j] == 2) {
-			// 移動(Y座標に速度を加える)
-			worldTransformEnemy_[j].translation_.y += enemyJumpSpeed_[j];
-			// 速度を減らす
-			enemyJumpSpeed_[j] -= 0.1f;
-			// 斜め移動
-			worldTransformEnemy_[j].translation_.x += enemySpeed_[j] * 4;
-			// 下へ落ちると消滅
-			if (worldTransformEnemy_[j].translation_.y < -3) {
-				enemyFlag_[j] = 0; // 存在しない
-			}
-		}
-	}
-}
-
-//----------------------------------------------
-// 衝突判定
-//----------------------------------------------
-
-// 衝突判定
-void GameScene::Collision() {
-	// 衝突判定(プレイヤーと敵)
-	CollisionPlayerEnemy();
-	CollisionBeamEnemy();
-}
-
-// 衝突判定(プレイヤーと敵)
-void GameScene::CollisionPlayerEnemy() {
-	// 敵が存在すれば
-	for (int e = 0; e < 10; e++) {
-		if (enemyFlag_[e] == 1) {
-			// 差を求める
-			float dx =
-			    abs(worldTransformPlayer_.translation_.x - worldTransformEnemy_[e].translation_.x);
-			float dz =
-			    abs(worldTransformPlayer_.translation_.z - worldTransformEnemy_[e].translation_.z);
-			// 衝突したら
-			if (dx < 1 && dz < 1) {
-				// 存在しない
-				enemyFlag_[e] = 0;
-
-				// ライフ減算
-				playerLife_ -= 1;
-
-				playerTimer_ = 60;
-
-				// プレイヤーヒットSE
-				audio_->PlayWave(soundDataHandlePlayerHitSE_);
-			}
-		}
-	}
-}
-
-// 衝突判定(ビームと敵)
-void GameScene::CollisionBeamEnemy() {
-	// 敵が存在すれば
-	for (int e = 0; e < 10; e++) {
-		if (enemyFlag_[e] == 1) {
-			for (int b = 0; b < 10; b++) {
-				if (beamFlag_[b] == 1) {
-					// 差を求める
-					float ex =
-					    abs(worldTransformBeam_[b].translation_.x -
-					        worldTransformEnemy_[e].translation_.x);
-					float ez =
-					    abs(worldTransformBeam_[b].translation_.z -
-					        worldTransformEnemy_[e].translation_.z);
-					// 衝突したら
-					if (ex < 1 && ez < 1) {
-						// 存在しない
-						beamFlag_[b] = 0;
-						enemyFlag_[e] = 2;
-						gameScore_ += 1;
-						enemyJumpSpeed_[e] = 1;
-
-						// バレットヒットSE
-						audio_->PlayWave(soundDataHandleEnemyHitSE_);
-					}
-				}
-			}
-		}
-	}
+// 描画用のワールド変換を更新
+void GameScene::UpdateRenderTransforms(float alpha) {
+	drawItems_.clear();
+	std::vector<WorldTransform>& renderTransforms = renderTransforms_[dxCommon_->GetFrameIndex()];
+	simulation_.GetWorld().ForEach<TransformComponent, RenderableComponent>(
+	    [this, alpha, &renderTransforms](
+	        Entity, const TransformComponent& transform, const RenderableComponent& renderable) {
+		    // 定数バッファは描画する数だけ確保して使い回す
+		    if (renderTransforms.size() <= drawItems_.size()) {
+			    renderTransforms.emplace_back().Initialize();
+		    }
+		    WorldTransform& worldTransform = renderTransforms[drawItems_.size()];
+		    worldTransform.scale_ = transform.scale;
+		    worldTransform.rotation_ = Lerp(transform.prevRotation, transform.rotation, alpha);
+		    worldTransform.translation_ =
+		        Lerp(transform.prevTranslation, transform.translation, alpha);
+		    worldTransform.matWorld_ = MakeAffineMatrix(
+		        worldTransform.scale_, worldTransform.rotation_, worldTransform.translation_);
+
+		    // 変数行列を定数バッファに転送
+		    worldTransform.TransferMatrix();
+		    drawItems_.push_back({renderable.model, renderable.textureHandle});
+	    });
 }
 
 // 描画
@@ -548,17 +294,7 @@ void GameScene::Draw() {
 	/// </summary>
 
 	// 各シーンの背景2D表示を呼び出す
-	switch (sceneMode_) {
-	case 0:
-		GamePlayDraw2DBack(); // ゲームプレイ2D背景表示
-		break;
-	case 2:
-		GamePlayDraw2DBack(); // ゲームプレイ2D背景表示
-		break;
-	case 3:
-		GamePlayDraw2DBack(); // ゲームプレイ2D背景表示
-		break;
-	}
+	DrawScene(simulation_.GetScene(), kDrawLayer2DBack);
 
 	// スプライト描画後処理
 	Sprite::PostDraw();
@@ -577,17 +313,7 @@ void GameScene::Draw() {
 	/// </summary>
 
 	// 各ステージの3D表示を呼び出す
-	switch (sceneMode_) {
-	case 0:
-		GamePlayDraw3D();
-		break;
-	case 2:
-		GamePlayDraw3D();
-		break;
-	case 3:
-		GamePlayDraw3D();
-		break;
-	}
+	DrawScene(simulation_.GetScene(), kDrawLayer3D);
 
 	Model::PostDraw();
 #pragma endregion
@@ -600,26 +326,14 @@ void GameScene::Draw() {
 	/// ここに前景スプライトの描画処理を追加できる
 	/// </summary>
 
+	// リプレイが記録とずれたことの表示
+	if (isReplayMismatch_) {
+		debugText_->Print("REPLAY DESYNC", 20, 20, 2);
+	}
 	debugText_->DrawAll();
 
 	// 各シーンの近景2D表示を呼び出す
-	switch (sceneMode_) {
-	case 0:
-		GamePlayDraw2DNear(); // ゲームプレイ2D近景表示
-		break;
-	case 1:
-		TitleDraw2DNear(); // タイトル2D表示
-		break;
-	case 2:
-		GamePlayDraw2DNear(); // ゲームプレイ2D近景表示
-		GameOverDraw2DNear(); // ゲームオーバー
-		break;
-	case 3:
-		GamePlayDraw2DNear(); // ゲームプレイ2D近景表示
-		char str[100];
-		sprintf_s(str, "GAME CREAL");
-		debugText_->Print(str, 550, 200, 2);// ゲームクリア表示
-	}
+	DrawScene(simulation_.GetScene(), kDrawLayer2DNear);
 
 	// スプライト描画後処理
 	Sprite::PostDraw();
@@ -627,30 +341,44 @@ void GameScene::Draw() {
 #pragma endregion
 }
 
-// ゲームプレイ表示3D
-void GameScene::GamePlayDraw3D() {
-	// ステージ
-	for (int s = 0; s < 20; s++) {
-		modelStage_->Draw(worldTransformStage_[s], viewProjection_, textureHandleStage_);
+// 画面ごとの描画（GameSceneId の順）
+const GameScene::SceneDraw GameScene::kSceneDraws[static_cast<size_t>(GameSceneId::Count)] = {
+    // ゲームプレイ
+    {GameSceneId::Count,
+     {&GameScene::GamePlayDraw2DBack, &GameScene::GamePlayDraw3D, &GameScene::GamePlayDraw2DNear}},
+    // タイトル
+    {GameSceneId::Count, {nullptr, nullptr, &GameScene::TitleDraw2DNear}},
+    // ゲームオーバー（ゲームプレイの上に重ねる）
+    {GameSceneId::GamePlay, {nullptr, nullptr, &GameScene::GameOverDraw2DNear}},
+    // ゲームクリア（ゲームプレイの上に重ねる）
+    {GameSceneId::GamePlay, {nullptr, nullptr, &GameScene::GameClearDraw2DNear}},
+};
+
+// 画面の1層分の描画（下に重ねる画面から順に）
+void GameScene::DrawScene(GameSceneId scene, DrawLayer layer) {
+	const SceneDraw& sceneDraw = kSceneDraws[static_cast<size_t>(scene)];
+	if (sceneDraw.under != GameSceneId::Count) {
+		DrawScene(sceneDraw.under, layer);
+	}
+	if (void (GameScene::*draw)() = sceneDraw.layers[layer]) {
+		(this->*draw)();
 	}
+}
 
-	// プレイヤー
-	if (playerTimer_ % 4 < 2) {
-		modelPlayer_->Draw(worldTransformPlayer_, viewProjection_, textureHandlePlayer_);
-	}
+// ゲームプレイ表示3D
+void GameScene::GamePlayDraw3D() {
+	uint32_t frameIndex = dxCommon_->GetFrameIndex();
 
-	// ビーム
-	for (int b = 0; b < 10; b++) {
-		if (beamFlag_[b] == 1) {
-			modelBeam_->Draw(worldTransformBeam_[b], viewProjection_, textureHandleBeam_);
-		}
+	// ステージ・ビーム・敵
+	for (size_t i = 0; i < drawItems_.size(); i++) {
+		const DrawItem& item = drawItems_[i];
+		item.model->Draw(renderTransforms_[frameIndex][i], viewProjection_, item.textureHandle);
 	}
 
-	// 敵
-	for (int e = 0; e < 10; e++) {
-		if (enemyFlag_[e] >= 1) {
-			modelEnemy_->Draw(worldTransformEnemy_[e], viewProjection_, textureHandleEnemy_);
-		}
+	// プレイヤー
+	if (simulation_.GetPlayerTimer() % 4 < 2) {
+		modelPlayer_->Draw(
+		    playerRenderTransforms_[frameIndex], viewProjection_, textureHandlePlayer_);
 	}
 }
 
@@ -667,26 +395,10 @@ void GameScene::GamePlayDraw2DNear() {
 	DrawLife();
 }
 
-// ゲームプレイ初期化
-void GameScene::GamePlayStart() {
-	gameScore_ = 0;
-	playerLife_ = 3;
-	gameTimer_ = 0;
-	playerTimer_ = 0;
-	for (int e = 0; e < 10; e++) {
-		enemyFlag_[e] = 0;
-	}
-	for (int b = 0; b < 10; b++) {
-		beamFlag_[b] = 0;
-	}
-	worldTransformPlayer_.translation_.x = 0;
-	PlayerUpdate();
-}
-
 void GameScene::DrawScore() {
 	// 各所の値を取り出す
 	int eachNumber[5] = {};
-	int number = gameScore_;
+	int number = simulation_.GetGameScore();
 
 	int keta = 10000;
 	for (int i = 0; i < 5; i++) {
@@ -707,7 +419,50 @@ void GameScene::DrawScore() {
 }
 
 void GameScene::DrawLife() {
-	for (int i = 0; i < playerLife_; i++) {
+	for (int i = 0; i < simulation_.GetPlayerLife(); i++) {
 		spriteLife_[i]->Draw();
 	}
-}
\ No newline at end of file
+}
+
+//----------------------------------------------
+// 入力・音の窓口
+//----------------------------------------------
+
+void GameScene::ActionGameInput::Initialize(ActionMap* actionMap) {
+	actionMap_ = actionMap;
+	for (size_t i = 0; i < actions_.size(); i++) {
+		actions_[i] = static_cast<uint32_t>(actionMap_->AddAction(kButtonActionNames[i]));
+	}
+
+	// 既定の割り当て（キーコンフィグで差し替えたものは残す）
+	auto bindDefault = [this](GameButton button, std::initializer_list<InputBinding> bindings) {
+		uint32_t action = actions_[static_cast<size_t>(button)];
+		if (actionMap_->GetBindings(action).empty()) {
+			for (const InputBinding& binding : bindings) {
+				actionMap_->Bind(action, binding);
+			}
+		}
+	};
+	bindDefault(
+	    GameButton::Left,
+	    {InputBinding::Key(DIK_LEFT), InputBinding::Pad(GamepadButton::DpadLeft),
+	     InputBinding::Axis(GamepadAxis::LeftX, -1)});
+	bindDefault(
+	    GameButton::Right,
+	    {InputBinding::Key(DIK_RIGHT), InputBinding::Pad(GamepadButton::DpadRight),
+	     InputBinding::Axis(GamepadAxis::LeftX, 1)});
+	bindDefault(
+	    GameButton::Fire, {InputBinding::Key(DIK_SPACE), InputBinding::Pad(GamepadButton::A)});
+	bindDefault(
+	    GameButton::Decide,
+	    {InputBinding::Key(DIK_RETURN), InputBinding::Pad(GamepadButton::Start),
+	     InputBinding::Pad(GamepadButton::A)});
+}
+
+bool GameScene::ActionGameInput::IsPressed(GameButton button) const {
+	return actionMap_->IsPressed(actions_[static_cast<size_t>(button)]);
+}
+
+bool GameScene::ActionGameInput::IsTriggered(GameButton button) const {
+	return actionMap_->IsTriggered(actions_[static_cast<size_t>(button)]);
+}
@@ -1,15 +1,21 @@
 #pragma once
 
-#include "Audio.h"
+#include "ActionMap.h"
 #include "DebugText.h"
 #include "DirectXCommon.h"
-#include "Input.h"
+#include "GameServices.h"
+#include "GameSimulation.h"
+#include "InputEvents.h"
+#include "InputReplay.h"
+#include "MixerGameAudio.h"
+#include "SceneAssetLoader.h"
 #include "Model.h"
 #include "SafeDelete.h"
 #include "Sprite.h"
 #include "time.h"
 #include "ViewProjection.h"
 #include "WorldTransform.h"
+#include "XAudio2AudioOutput.h"
 
 /// <summary>
 /// ゲームシーン
@@ -43,19 +49,16 @@ public: // メンバ関数
 	//ステージ
 	uint32_t textureHandleStage_ = 0;
 	Model* modelStage_ = nullptr;
-	WorldTransform worldTransformStage_[20];
 
 	//プレイヤー
 	uint32_t textureHandlePlayer_ = 0;
 	Model* modelPlayer_ = nullptr;
-	WorldTransform worldTransformPlayer_;
-
-	void PlayerUpdate();	//プレイヤーの更新
+	WorldTransform worldTransformPlayer_;	//スケール・回転(座標は simulation_)
+	std::vector<WorldTransform> playerRenderTransforms_;	//描画用(フレームごと)
 
 	//ビーム
 	uint32_t textureHandleBeam_ = 0;
 	Model* modelBeam_ = nullptr;
-	WorldTransform worldTransformBeam_[10];
 
 	// スコア数値(スプライト)
 	uint32_t textureHandleNumber_ = 0;
@@ -68,63 +71,26 @@ public: // メンバ関数
 	uint32_t textureHandleLife_ = 0;
 	Sprite* spriteLife_[3] = {};
 
-	void BeamUpdate();		//ビーム更新
-
-	void BeamMove();		//ビーム移動
-
-	void BeamBorn();		//ビーム発生
-
-	int beamFlag_[10] = {}; // ビーム存在フラグ(0:存在しない 1:存在する)
-
 	//敵
 	uint32_t textureHandleEnemy_ = 0;
 	Model* modelEnemy_ = nullptr;
-	WorldTransform worldTransformEnemy_[10];
-
-	void EnemyUpdate();		//敵更新
-
-	void EnemyMove();		//敵移動
-
-	void EnemyBorn();		//敵発生
-
-	void EnemyJump();
 
-	int enemyFlag_[10] = {};
+	//ゲームの更新(ステージ・プレイヤー・ビーム・敵)
+	GameSimulation simulation_;
 
-	//衝突判定
-	void Collision();			//衝突判定
-	void CollisionPlayerEnemy();//衝突判定(プレイヤーと敵)
+	void UpdateRenderTransforms(float alpha);	//描画用のワールド変換を更新(直前の2ステップを補間)
 
-	void CollisionBeamEnemy();	//衝突判定(ビームと敵)
-
-	//サウンド
-	uint32_t soundDataHandleTitleBGM_ = 0;		// タイトルBGM
-	uint32_t soundDataHandleGamePlayBGM_ = 0;	// ゲームプレイBGM
-	uint32_t soundDataHandleGameOverBGM_ = 0;	// ゲームオーバーBGM
-	uint32_t soundDataHandleGameClearBGM_ = 0;   // ゲームクリアBGM
-	uint32_t soundDataHandleEnemyHitSE_ = 0;	// 敵ヒットSE
-	uint32_t soundDataHandlePlayerHitSE_ = 0;	//プレイヤーヒットSE
-	uint32_t voiceHandleBGM_ = 0;				//音声再生ハンドル
-	
-	//ステージ
-	void StageUpdate();
+	// 描画するアクター
+	struct DrawItem {
+		Model* model;
+		uint32_t textureHandle;
+	};
+	std::vector<DrawItem> drawItems_;
+	//drawItems_ と同じ順のワールド変換(GPUが前のフレームで読んでいる間に上書きしないようフレームごと)
+	std::vector<std::vector<WorldTransform>> renderTransforms_;
 
 	DebugText* debugText_ = nullptr;
 
-	int gameScore_ = 0;	//ゲームスコア
-
-	int playerLife_ = 3;// プレイヤーライフ
-
-	int gameTimer_ = 0;
-
-	int beamTimer_ = 0;
-
-	int playerTimer_ = 0;
-
-	float enemySpeed_[10] = {};	//スピード
-
-	float enemyJumpSpeed_[10] = {};	//敵ジャンプの移動速度
-
 	/// <summary>
 	/// デストラクタ
 	/// </summary>
@@ -133,43 +99,108 @@ public: // メンバ関数
 	/// <summary>
 	/// 初期化
 	/// </summary>
-	void Initialize();
+	/// <param name="inputState">ステップごとのキーボードの状態（入力イベントから作る）</param>
+	/// <param name="gamepad">ステップごとのパッド0の状態（呼び出し側が毎ステップ更新する）</param>
+	/// <param name="replayFileName">再生するリプレイ（空ならキーボードで遊び、入力を記録する）</param>
+	void Initialize(
+	    const InputEventState* inputState, const GamepadState* gamepad,
+	    const std::string& replayFileName = "");
+
+	/// <summary>
+	/// 記録した入力の保存（リプレイの再生中は何もしない）
+	/// </summary>
+	/// <returns>保存したか</returns>
+	bool SaveRecording(const std::string& fileName);
 
 	/// <summary>
-	/// 毎フレーム処理
+	/// 毎フレーム処理（固定の刻みで1ステップ進める）
 	/// </summary>
 	void Update();
 
+	/// <summary>
+	/// 描画用の補間（描画の直前に毎フレーム呼ぶ）
+	/// </summary>
+	/// <param name="alpha">補間係数（0で1つ前、1で最新のステップ）</param>
+	void Interpolate(float alpha);
+
 	/// <summary>
 	/// 描画
 	/// </summary>
 	void Draw();
 
+private: // サブクラス
+	// 描画の層
+	enum DrawLayer {
+		kDrawLayer2DBack, // 背景スプライト
+		kDrawLayer3D,     // 3Dオブジェクト
+		kDrawLayer2DNear, // 前景スプライト
+		kDrawLayerCount,
+	};
+
+	// 画面ごとの描画
+	struct SceneDraw {
+		GameSceneId under; // 下に重ねる画面（Count は無し）
+		void (GameScene::*layers[kDrawLayerCount])(); // 層ごとの描画（nullptr は無し）
+	};
+
+	// 画面ごとの描画（GameSceneId の順）
+	static const SceneDraw kSceneDraws[static_cast<size_t>(GameSceneId::Count)];
+
+	/// <summary>
+	/// キーボード・パッドによるゲームの入力（ボタンごとのアクションを読む）
+	/// </summary>
+	class ActionGameInput : public GameInput {
+	public:
+		/// <summary>
+		/// 初期化（ボタンのアクションを追加し、割り当てが無ければ既定の入力を割り当てる）
+		/// </summary>
+		void Initialize(ActionMap* actionMap);
+		bool IsPressed(GameButton button) const override;
+		bool IsTriggered(GameButton button) const override;
+
+	private:
+		ActionMap* actionMap_ = nullptr;
+		// ボタンごとのアクションの番号
+		std::array<uint32_t, static_cast<size_t>(GameButton::Count)> actions_ = {};
+	};
+
 private: // メンバ変数
 	DirectXCommon* dxCommon_ = nullptr;
-	Input* input_ = nullptr;
-	Audio* audio_ = nullptr;
+	const InputEventState* inputState_ = nullptr;
+	const GamepadState* gamepad_ = nullptr;
+
+	ActionMap actionMap_;               //アクションへの入力の割り当て
+	ActionGameInput actionInput_;       //ゲームの入力(キーボード・パッド)
+	MixerGameAudio sceneAudio_;         //ゲームの音(ミキサー)
+	XAudio2AudioOutput audioOutput_;    //ミキサーの出力先
+	InputRecording recording_;          //入力の記録(リプレイの再生中は再生する記録)
+	RecordingGameInput recordingInput_; //キーボード・パッドを記録しながらの入力
+	ScriptedGameInput replayInput_;     //リプレイの入力
+	bool isReplay_ = false;             //リプレイの再生中か
+	uint32_t replayStep_ = 0;           //再生したステップ数
+	bool isReplayMismatch_ = false;     //再生し終えた状態が記録とずれたか
+	SceneAssetLoader assetLoader_;      //画面ごとの素材の読み込み
 
 	/// <summary>
 	/// ゲームシーン用
 	/// </summary>
-	void GamePlayUpdate();		//ゲームプレイ更新
+	void LoadTitleAssets();     //タイトルの素材（読み込み後）
+	void LoadGamePlayAssets();  //ゲームプレイの素材（読み込み後）
+	void LoadGameOverAssets();  //ゲームオーバーの素材（読み込み後）
+	void LoadGameClearAssets(); //ゲームクリアの素材（読み込み後）
+
+	void DrawScene(GameSceneId scene, DrawLayer layer); //画面の1層分の描画
+
 	void GamePlayDraw3D();		//ゲームプレイ3D描画
 	void GamePlayDraw2DBack();	//ゲームプレイ2D背景描画
 	void GamePlayDraw2DNear();	//ゲームプレイ2D近景描画
-	void GamePlayStart();		//ゲームプレイ初期化
 
-	void TitleUpdate();		//タイトル更新
 	void TitleDraw2DNear();	//タイトル2D
 
-	void GameOverUpdate();
 	void GameOverDraw2DNear();
 
-	void GameClearUpdate();
 	void GameClearDraw2DNear();
 
 	void DrawScore();
 	void DrawLife();
-
-	int sceneMode_ = 1;
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "GameServices.h"
+#include <utility>
+
+bool ButtonMaskGameInput::IsPressed(GameButton button) const {
+	return (buttons_ & ToButtonMask(button)) != 0;
+}
+
+bool ButtonMaskGameInput::IsTriggered(GameButton button) const {
+	return (buttons_ & ~previousButtons_ & ToButtonMask(button)) != 0;
+}
+
+void ButtonMaskGameInput::SetButtons(GameButtonMask buttons) {
+	previousButtons_ = buttons_;
+	buttons_ = buttons;
+}
+
+void ButtonMaskGameInput::ResetButtons() {
+	buttons_ = 0;
+	previousButtons_ = 0;
+}
+
+void ScriptedGameInput::SetScript(Script script) {
+	script_ = std::move(script);
+	step_ = 0;
+	ResetButtons();
+}
+
+void ScriptedGameInput::Advance() {
+	SetButtons(script_ ? script_(step_) : 0);
+	step_++;
+}
+
+void NullGameAudio::PlayBGM(GameSound sound) { playCounts_[static_cast<uint32_t>(sound)]++; }
+
+void NullGameAudio::PlaySE(GameSound sound) { playCounts_[static_cast<uint32_t>(sound)]++; }
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+///
+/// ゲームの更新処理が使う入力・音・素材の窓口。
+/// 実機ではキーボード・XAudio2・テクスチャの読み込みに、ヘッドレスでは台本の入力・無音・素材なしにつなぐ。
+///
+
+/// <summary>
+/// ゲームのボタン
+/// </summary>
+enum class GameButton : uint8_t {
+	Left,   // 左移動
+	Right,  // 右移動
+	Fire,   // ビーム発射
+	Decide, // 決定（タイトル・リザルト画面を進める）
+	Count,
+};
+
+/// <summary>
+/// ボタンのビットマスク（1 << GameButton）
+/// </summary>
+using GameButtonMask = uint8_t;
+
+/// <summary>
+/// ボタンのビットの取得
+/// </summary>
+constexpr GameButtonMask ToButtonMask(GameButton button) {
+	return static_cast<GameButtonMask>(1u << static_cast<uint32_t>(button));
+}
+
+/// <summary>
+/// ゲームの入力
+/// </summary>
+class GameInput {
+public:
+	virtual ~GameInput() = default;
+
+	/// <summary>
+	/// 押しているか
+	/// </summary>
+	virtual bool IsPressed(GameButton button) const = 0;
+
+	/// <summary>
+	/// 押した瞬間か
+	/// </summary>
+	virtual bool IsTriggered(GameButton button) const = 0;
+};
+
+/// <summary>
+/// ゲームの音
+/// </summary>
+enum class GameSound : uint8_t {
+	TitleBGM,
+	GamePlayBGM,
+	GameOverBGM,
+	GameClearBGM,
+	EnemyHitSE,
+	PlayerHitSE,
+	Count,
+};
+
+/// <summary>
+/// ゲームの音の再生
+/// </summary>
+class GameAudio {
+public:
+	virtual ~GameAudio() = default;
+
+	/// <summary>
+	/// BGMの切り替え（再生中のBGMを止めてループ再生する）
+	/// </summary>
+	virtual void PlayBGM(GameSound sound) = 0;
+
+	/// <summary>
+	/// 効果音の再生
+	/// </summary>
+	virtual void PlaySE(GameSound sound) = 0;
+};
+
+/// <summary>
+/// ゲームの画面
+/// </summary>
+enum class GameSceneId : uint8_t {
+	GamePlay,  // ゲームプレイ
+	Title,     // タイトル
+	GameOver,  // ゲームオーバー
+	GameClear, // ゲームクリア
+	Count,
+};
+
+/// <summary>
+/// 画面ごとの素材の読み込み
+/// </summary>
+class GameAssets {
+public:
+	virtual ~GameAssets() = default;
+
+	/// <summary>
+	/// 先読みの開始（終わるのを待たない）
+	/// </summary>
+	virtual void Prefetch(GameSceneId scene) = 0;
+
+	/// <summary>
+	/// 読み込みが終わっているか（まだ始めていなければ始める）
+	/// </summary>
+	virtual bool IsReady(GameSceneId scene) = 0;
+
+	/// <summary>
+	/// 読み込み（終わるまで待つ）
+	/// </summary>
+	virtual void Load(GameSceneId scene) = 0;
+};
+
+/// <summary>
+/// ボタンのビットマスクで状態を持つ入力（押した瞬間は前のステップとの差分）
+/// </summary>
+class ButtonMaskGameInput : public GameInput {
+public:
+	/// <summary>
+	/// 現在押しているボタンの取得
+	/// </summary>
+	GameButtonMask GetButtons() const { return buttons_; }
+
+	bool IsPressed(GameButton button) const override;
+	bool IsTriggered(GameButton button) const override;
+
+protected:
+	/// <summary>
+	/// 次のステップのボタンの設定
+	/// </summary>
+	void SetButtons(GameButtonMask buttons);
+
+	/// <summary>
+	/// ボタンを離した状態に戻す
+	/// </summary>
+	void ResetButtons();
+
+private:
+	GameButtonMask buttons_ = 0;
+	GameButtonMask previousButtons_ = 0;
+};
+
+/// <summary>
+/// 台本による入力（ステップ番号から押しているボタンを決める）
+/// </summary>
+class ScriptedGameInput : public ButtonMaskGameInput {
+public:
+	using Script = std::function<GameButtonMask(uint32_t step)>;
+
+	/// <summary>
+	/// 台本の設定
+	/// </summary>
+	void SetScript(Script script);
+
+	/// <summary>
+	/// 次のステップへ進める（ゲームの更新の前に毎ステップ呼ぶ）
+	/// </summary>
+	void Advance();
+
+private:
+	Script script_;
+	uint32_t step_ = 0;
+};
+
+/// <summary>
+/// 無音（再生の回数だけ数える）
+/// </summary>
+class NullGameAudio : public GameAudio {
+public:
+	void PlayBGM(GameSound sound) override;
+	void PlaySE(GameSound sound) override;
+
+	/// <summary>
+	/// 再生された回数の取得
+	/// </summary>
+	uint32_t GetPlayCount(GameSound sound) const {
+		return playCounts_[static_cast<uint32_t>(sound)];
+	}
+
+private:
+	uint32_t playCounts_[static_cast<uint32_t>(GameSound::Count)] = {};
+};
+
+/// <summary>
+/// 素材なし（常に読み込み済み）
+/// </summary>
+class NullGameAssets : public GameAssets {
+public:
+	void Prefetch(GameSceneId) override {}
+	bool IsReady(GameSceneId) override { return true; }
+	void Load(GameSceneId) override {}
+};
@@ -0,0 +1,572 @@
+#include "GameSimulation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// プレイヤーの当たり判定の半径 (敵の0.5と合わせて、静止時は従来の abs(d) < 1 と一致)
+const float kPlayerRadius = 0.5f;
+
+// ビームが消える奥行き
+const float kBeamRangeZ = 40.0f;
+// ビームの速度
+const float kBeamSpeed = 0.3f;
+
+// 移動量
+Vector3 Movement(const Vector3& from, const Vector3& to) {
+	return {to.x - from.x, to.y - from.y, to.z - from.z};
+}
+
+// XZ方向の移動量の大きい方
+float MaxMovementXZ(const Vector3& move) { return std::max(std::abs(move.x), std::abs(move.z)); }
+
+// システムが触る ECS の外のデータ
+const uint64_t kResourcePlayer = 1 << 0;    // プレイヤーの座標・タイマー
+const uint64_t kResourceInput = 1 << 1;     // 入力
+const uint64_t kResourceGameState = 1 << 2; // スコア・ライフ・各タイマー
+
+// 乱数のストリーム番号
+const uint64_t kRandomStreamEnemyBorn = 1; // 敵発生
+
+// チェックサム (FNV-1a)
+const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * kFnvPrime;
+	}
+}
+
+} // namespace
+
+// 初期化
+void GameSimulation::Initialize(
+    GameInput* input, GameAudio* audio, GameAssets* assets, const Appearances& appearances,
+    unsigned int seed) {
+	assert(input);
+	assert(audio);
+	assert(assets);
+	input_ = input;
+	audio_ = audio;
+	assets_ = assets;
+	appearances_ = appearances;
+
+	// ステージ
+	for (int s = 0; s < 20; s++) {
+		// ステージの位置を変更
+		TransformComponent transform;
+		transform.translation = {0, -1.5f, 2.0f * s - 5};
+		transform.scale = {4.5f, 1, 1};
+		VelocityComponent velocity;
+		velocity.linear.z = -0.1f;
+		world_.Create(
+		    StageTag{}, transform, velocity,
+		    RenderableComponent{appearances_.stage.model, appearances_.stage.textureHandle});
+	}
+
+	// 乱数はシステムごとのストリームから取る
+	enemyRandom_.Seed(seed, kRandomStreamEnemyBorn);
+
+	// 衝突判定の空間ハッシュ (当たり判定の半径1に合わせたセル)
+	beamHash_.Initialize(1.0f);
+	enemyHash_.Initialize(1.0f);
+
+	// ゲームプレイ更新のシステム
+	InitializeSystems();
+
+	// タイトルから始める（タイトルの素材は呼び出し側で読み込んでおく）
+	ChangeScene(GameSceneId::Title);
+}
+
+// アクターの見た目の設定
+void GameSimulation::SetAppearances(const Appearances& appearances) {
+	appearances_ = appearances;
+	// 既にいるステージにも反映する（ビーム・敵は発生時に設定する）
+	world_.ForEach<StageTag, RenderableComponent>(
+	    [this](Entity, StageTag&, RenderableComponent& renderable) {
+		    renderable = {appearances_.stage.model, appearances_.stage.textureHandle};
+	    });
+}
+
+// 画面ごとの処理（GameSceneId の順）
+const GameSimulation::SceneState
+    GameSimulation::kSceneStates[static_cast<size_t>(GameSceneId::Count)] = {
+    {&GameSimulation::GamePlayEnter, &GameSimulation::GamePlayUpdate,
+     {GameSceneId::GameOver, GameSceneId::GameClear}},
+    {&GameSimulation::TitleEnter, &GameSimulation::TitleUpdate,
+     {GameSceneId::GamePlay, GameSceneId::Count}},
+    {&GameSimulation::GameOverEnter, &GameSimulation::ResultUpdate,
+     {GameSceneId::Title, GameSceneId::Count}},
+    {&GameSimulation::GameClearEnter, &GameSimulation::ResultUpdate,
+     {GameSceneId::Title, GameSceneId::Count}},
+};
+
+// 更新
+void GameSimulation::Update() {
+	// 決まったステップ数を待ったら画面を切り替える（読み込みが間に合っていなければ待つ）
+	if (pendingScene_ != GameSceneId::Count && --sceneChangeTimer_ <= 0) {
+		assets_->Load(pendingScene_);
+		ChangeScene(pendingScene_);
+	}
+
+	// ゲームプレイ以外と切り替えを待っている間はアクターが止まっているので、
+	// 補間しないよう移動前の座標を揃える
+	bool waiting = IsWaitingForAssets();
+	if (scene_ != GameSceneId::GamePlay || waiting) {
+		SavePreviousPositions();
+	}
+
+	// 現在の画面の更新（切り替えを待っている間は止める）
+	if (!waiting) {
+		(this->*kSceneStates[static_cast<size_t>(scene_)].update)();
+	}
+
+	// ゲームタイマー
+	gameTimer_++;
+}
+
+// 画面の切り替えの要求
+// 読み込みにかかる時間で切り替えのステップが変わるとリプレイがずれるので、
+// 読み込み済みでも kSceneChangeSteps だけ待ってから切り替える
+void GameSimulation::RequestScene(GameSceneId scene) {
+	pendingScene_ = scene;
+	sceneChangeTimer_ = kSceneChangeSteps;
+	assets_->Prefetch(scene);
+}
+
+// 画面の切り替え
+void GameSimulation::ChangeScene(GameSceneId scene) {
+	pendingScene_ = GameSceneId::Count;
+	scene_ = scene;
+	const SceneState& state = kSceneStates[static_cast<size_t>(scene)];
+	(this->*state.enter)();
+
+	// 次に進みうる画面の素材を先読みしておく
+	for (GameSceneId next : state.next) {
+		if (next != GameSceneId::Count) {
+			assets_->Prefetch(next);
+		}
+	}
+}
+
+// ゲームプレイ更新のシステムを登録
+void GameSimulation::InitializeSystems() {
+	ComponentMask transform = MakeComponentMask<TransformComponent>();
+	ComponentMask velocity = MakeComponentMask<VelocityComponent>();
+
+	// 移動前の座標を記録
+	SystemAccess savePrevious;
+	savePrevious.required = transform;
+	savePrevious.write = transform;
+	savePrevious.resourceWrite = kResourcePlayer;
+	scheduler_.AddSystem("SavePreviousPositions", savePrevious, [this] {
+		SavePreviousPositions();
+	});
+
+	// プレイヤー
+	SystemAccess player;
+	player.resourceRead = kResourceInput;
+	player.resourceWrite = kResourcePlayer;
+	scheduler_.AddSystem("Player", player, [this] { PlayerUpdate(); });
+
+	// ステージ
+	SystemAccess stage;
+	stage.required = MakeComponentMask<StageTag, TransformComponent, VelocityComponent>();
+	stage.read = velocity;
+	stage.write = transform;
+	scheduler_.AddSystem("StageScroll", stage, [this] { StageUpdate(); });
+
+	// ビーム移動
+	SystemAccess beamMove;
+	beamMove.required = MakeComponentMask<BeamTag, TransformComponent, VelocityComponent>();
+	beamMove.read = velocity;
+	beamMove.write = transform;
+	scheduler_.AddSystem("BeamMove", beamMove, [this] { BeamMoveSystem(world_); });
+
+	// 寿命（削除は予約だけなので構造は変えない）
+	SystemAccess lifetime;
+	lifetime.required = MakeComponentMask<LifetimeComponent>();
+	lifetime.write = lifetime.required;
+	scheduler_.AddSystem("Lifetime", lifetime, [this] { LifetimeSystem(world_); });
+
+	// 敵移動
+	SystemAccess enemyMove;
+	enemyMove.required = MakeComponentMask<EnemyTag, TransformComponent, VelocityComponent>();
+	enemyMove.exclude = MakeComponentMask<EnemyJumpComponent>();
+	enemyMove.write = transform | velocity;
+	enemyMove.resourceRead = kResourceGameState;
+	scheduler_.AddSystem("EnemyMove", enemyMove, [this] { EnemyMoveSystem(world_, gameTimer_); });
+
+	// 敵ジャンプ
+	SystemAccess enemyJump;
+	enemyJump.required = MakeComponentMask<EnemyTag, TransformComponent, EnemyJumpComponent>();
+	enemyJump.read = velocity;
+	enemyJump.write = transform | MakeComponentMask<EnemyJumpComponent>();
+	scheduler_.AddSystem("EnemyJump", enemyJump, [this] { EnemyJumpSystem(world_); });
+
+	// 予約した削除の実行とビーム・敵の発生
+	SystemAccess born;
+	born.structural = true;
+	scheduler_.AddSystem("Born", born, [this] {
+		world_.FlushDeferred();
+		BeamBorn();
+		EnemyBorn();
+	});
+
+	// 衝突判定
+	SystemAccess collision;
+	collision.structural = true;
+	scheduler_.AddSystem("Collision", collision, [this] { Collision(); });
+}
+
+void GameSimulation::GamePlayUpdate() {
+	// 触るデータが重ならないシステム同士は並列に実行する
+	scheduler_.Run(world_);
+
+	// プレイヤーライフが0以下になったとき
+	if (playerLife_ <= 0) {
+		RequestScene(GameSceneId::GameOver);
+	}
+
+	if (gameScore_ > 100) {
+		gameScore_ = 100;
+		RequestScene(GameSceneId::GameClear);
+	}
+}
+
+// ゲームプレイ開始
+void GameSimulation::GamePlayEnter() {
+	GamePlayStart();
+
+	// BGM切り替え
+	audio_->PlayBGM(GameSound::GamePlayBGM); // ゲームプレイBGMを再生
+}
+
+// ゲームプレイ初期化
+void GameSimulation::GamePlayStart() {
+	gameScore_ = 0;
+	playerLife_ = 3;
+	gameTimer_ = 0;
+	playerTimer_ = 0;
+	world_.DestroyAll<EnemyTag>();
+	world_.DestroyAll<BeamTag>();
+	playerPos_.x = 0;
+	PlayerUpdate();
+	SavePreviousPositions();
+}
+
+//----------------------------------------------
+// タイトル・リザルト
+//----------------------------------------------
+
+// タイトル開始
+void GameSimulation::TitleEnter() {
+	// BGM切り替え
+	audio_->PlayBGM(GameSound::TitleBGM); // タイトルBGMを再生
+}
+
+// タイトル更新
+void GameSimulation::TitleUpdate() {
+	// エンターキーを押した瞬間
+	if (input_->IsTriggered(GameButton::Decide)) {
+		// モードをゲームプレイへ変更
+		RequestScene(GameSceneId::GamePlay);
+	}
+}
+
+// ゲームオーバー開始
+void GameSimulation::GameOverEnter() {
+	// BGM切り替え
+	audio_->PlayBGM(GameSound::GameOverBGM); // ゲームオーバーBGMを再生
+}
+
+// ゲームクリア開始
+void GameSimulation::GameClearEnter() {
+	// BGM切り替え
+	audio_->PlayBGM(GameSound::GameClearBGM); // ゲームクリアBGMを再生
+}
+
+// リザルト（ゲームオーバー・ゲームクリア）更新
+void GameSimulation::ResultUpdate() {
+	// エンターキーを押した瞬間
+	if (input_->IsTriggered(GameButton::Decide)) {
+		// モードをタイトルへ変更
+		RequestScene(GameSceneId::Title);
+	}
+}
+
+//----------------------------------------------
+// ステージ
+//----------------------------------------------
+
+// ステージ更新
+void GameSimulation::StageUpdate() {
+	// 手前に移動し、端まで来たら奥へ戻る
+	StageScrollSystem(world_);
+}
+
+//----------------------------------------------
+// プレイヤー
+//----------------------------------------------
+
+// プレイヤー更新
+void GameSimulation::PlayerUpdate() {
+	// 移動
+
+	// 右へ移動
+	if (input_->IsPressed(GameButton::Right)) {
+		playerPos_.x += 0.1f;
+	}
+
+	// 左へ移動
+	if (input_->IsPressed(GameButton::Left)) {
+		playerPos_.x -= 0.1f;
+	}
+
+	// 右への移動制限
+	if (playerPos_.x > 4) {
+		playerPos_.x = 4;
+	}
+
+	// 左への移動制限
+	if (playerPos_.x < -4) {
+		playerPos_.x = -4;
+	}
+
+	if (playerTimer_ > 0) {
+		playerTimer_--;
+	}
+}
+
+//----------------------------------------------
+// ビーム
+//----------------------------------------------
+
+// ビーム発生 (発射)
+void GameSimulation::BeamBorn() {
+	if (beamTimer_ == 0) {
+		if (input_->IsPressed(GameButton::Fire)) {
+			TransformComponent transform;
+			transform.scale = {0.3f, 0.3f, 0.3f};
+			transform.translation = playerPos_;
+			transform.prevTranslation = transform.translation;
+			VelocityComponent velocity;
+			velocity.linear.z = kBeamSpeed;
+			velocity.angular.x = 0.1f;
+			// 奥まで飛ぶのにかかるフレーム数
+			LifetimeComponent lifetime = {(kBeamRangeZ - transform.translation.z) / kBeamSpeed};
+			world_.Create(
+			    BeamTag{}, transform, velocity, lifetime, ColliderComponent{0.5f},
+			    RenderableComponent{appearances_.beam.model, appearances_.beam.textureHandle});
+			beamTimer_ = 1;
+		}
+	} else {
+		// 発射タイマーが1以上
+		// 1フレームに10進み、100を超えると再び発射が可能
+		beamTimer_ += 10;
+		if (beamTimer_ > 100) {
+			beamTimer_ = 0;
+		}
+	}
+}
+
+//----------------------------------------------
+// 敵
+//----------------------------------------------
+
+// 敵発生
+void GameSimulation::EnemyBorn() {
+	// 乱数で発生
+	if (enemyRandom_.NextBelow(10) == 0) {
+		TransformComponent transform;
+		transform.scale = {0.5f, 0.5f, 0.5f};
+		transform.translation.z = 40;
+		transform.translation.y = 0;
+
+		// 乱数でX座標の指定
+		int x = static_cast<int>(enemyRandom_.NextBelow(80)); // 80は4の10倍の2倍
+		float x2 = (float)x / 10 - 4;                         // 10で割り、4を引く
+		transform.translation.x = x2;
+		transform.prevTranslation = transform.translation;
+
+		// 敵スピード
+		VelocityComponent velocity;
+		if (enemyRandom_.NextBelow(2) == 0) {
+			velocity.linear.x = 0.1f;
+		} else {
+			velocity.linear.x = -0.1f;
+		}
+		velocity.linear.z = -0.1f;
+		velocity.angular.x = -0.1f;
+
+		world_.Create(
+		    EnemyTag{}, transform, velocity, ColliderComponent{0.5f},
+		    RenderableComponent{appearances_.enemy.model, appearances_.enemy.textureHandle});
+	}
+}
+
+//----------------------------------------------
+// 衝突判定
+//----------------------------------------------
+
+// 衝突判定
+void GameSimulation::Collision() {
+	// 衝突判定(プレイヤーと敵)
+	CollisionPlayerEnemy();
+	CollisionBeamEnemy();
+}
+
+// 移動前の座標を記録
+void GameSimulation::SavePreviousPositions() {
+	playerPrevPos_ = playerPos_;
+	SavePreviousPositionSystem(world_);
+}
+
+// 衝突判定(プレイヤーと敵)
+void GameSimulation::CollisionPlayerEnemy() {
+	// 存在する敵を空間ハッシュに登録（IDは登録順）
+	enemyHash_.Clear();
+	enemyEntities_.clear();
+	float maxEnemyMove = 0.0f;
+	float maxEnemyRadius = 0.0f;
+	world_.ForEach<EnemyTag, TransformComponent, ColliderComponent>(
+	    [&](Entity entity, EnemyTag&, const TransformComponent& transform,
+	        const ColliderComponent& collider) {
+		    enemyHash_.Insert(
+		        static_cast<uint32_t>(enemyEntities_.size()), transform.translation.x,
+		        transform.translation.z);
+		    enemyEntities_.push_back(entity);
+		    maxEnemyMove = std::max(
+		        maxEnemyMove,
+		        MaxMovementXZ(Movement(transform.prevTranslation, transform.translation)));
+		    maxEnemyRadius = std::max(maxEnemyRadius, collider.radius);
+	    },
+	    MakeComponentMask<EnemyJumpComponent>());
+	enemyHash_.Build();
+
+	// プレイヤーの移動範囲の近くの敵だけ調べる
+	float hitRadius = kPlayerRadius + maxEnemyRadius;
+	Vector3 playerMove = Movement(playerPrevPos_, playerPos_);
+	enemyHash_.Query(
+	    playerPrevPos_.x + playerMove.x * 0.5f, playerPrevPos_.z + playerMove.z * 0.5f,
+	    hitRadius + MaxMovementXZ(playerMove) * 0.5f + maxEnemyMove, collisionCandidates_);
+
+	// 候補をまとめてフレーム中の移動を考慮して判定
+	collisionBatch_.Clear();
+	for (uint32_t id : collisionCandidates_) {
+		const TransformComponent& transform = *world_.Get<TransformComponent>(enemyEntities_[id]);
+		collisionBatch_.Add(
+		    id, transform.prevTranslation,
+		    Movement(transform.prevTranslation, transform.translation));
+	}
+	CollisionQuery query = {
+	    playerPrevPos_.x, playerPrevPos_.z, playerMove.x, playerMove.z, hitRadius};
+	TestSweepXZ(query, collisionBatch_, collisionHitMask_);
+
+	for (uint32_t i = 0; i < collisionBatch_.Size(); i++) {
+		// 衝突したら
+		if (collisionHitMask_[i / 32] >> (i % 32) & 1) {
+			// 存在しない
+			world_.Destroy(enemyEntities_[collisionBatch_.ids[i]]);
+
+			// ライフ減算
+			playerLife_ -= 1;
+
+			playerTimer_ = 60;
+
+			// プレイヤーヒットSE
+			audio_->PlaySE(GameSound::PlayerHitSE);
+		}
+	}
+}
+
+// 衝突判定(ビームと敵)
+void GameSimulation::CollisionBeamEnemy() {
+	// 存在するビームを空間ハッシュに登録
+	beamHash_.Clear();
+	beamEntities_.clear();
+	float maxBeamMove = 0.0f;
+	float maxBeamRadius = 0.0f;
+	world_.ForEach<BeamTag, TransformComponent, ColliderComponent>(
+	    [&](Entity entity, BeamTag&, const TransformComponent& transform,
+	        const ColliderComponent& collider) {
+		    beamHash_.Insert(
+		        static_cast<uint32_t>(beamEntities_.size()), transform.translation.x,
+		        transform.translation.z);
+		    beamEntities_.push_back(entity);
+		    maxBeamMove = std::max(
+		        maxBeamMove,
+		        MaxMovementXZ(Movement(transform.prevTranslation, transform.translation)));
+		    maxBeamRadius = std::max(maxBeamRadius, collider.radius);
+	    });
+	beamHash_.Build();
+
+	// 存在する敵（判定中に消滅演出へ移るので先に集める）
+	enemyEntities_.clear();
+	world_.ForEach<EnemyTag>(
+	    [this](Entity entity, EnemyTag&) { enemyEntities_.push_back(entity); },
+	    MakeComponentMask<EnemyJumpComponent>());
+
+	for (Entity enemy : enemyEntities_) {
+		const TransformComponent& transform = *world_.Get<TransformComponent>(enemy);
+		float hitRadius = world_.Get<ColliderComponent>(enemy)->radius + maxBeamRadius;
+
+		// 移動範囲の近くのビームだけ調べる
+		Vector3 enemyMove = Movement(transform.prevTranslation, transform.translation);
+		beamHash_.Query(
+		    transform.prevTranslation.x + enemyMove.x * 0.5f,
+		    transform.prevTranslation.z + enemyMove.z * 0.5f,
+		    hitRadius + MaxMovementXZ(enemyMove) * 0.5f + maxBeamMove, collisionCandidates_);
+
+		// まだ存在するビームをまとめて判定
+		collisionBatch_.Clear();
+		for (uint32_t id : collisionCandidates_) {
+			Entity beamEntity = beamEntities_[id];
+			if (const TransformComponent* beam = world_.Get<TransformComponent>(beamEntity)) {
+				Vector3 beamMove = Movement(beam->prevTranslation, beam->translation);
+				collisionBatch_.Add(id, beam->prevTranslation, beamMove);
+			}
+		}
+		CollisionQuery query = {
+		    transform.prevTranslation.x, transform.prevTranslation.z, enemyMove.x, enemyMove.z,
+		    hitRadius};
+		TestSweepXZ(query, collisionBatch_, collisionHitMask_);
+
+		for (uint32_t i = 0; i < collisionBatch_.Size(); i++) {
+			// 衝突したら
+			if (collisionHitMask_[i / 32] >> (i % 32) & 1) {
+				// 存在しない
+				world_.Destroy(beamEntities_[collisionBatch_.ids[i]]);
+				world_.Add(enemy, EnemyJumpComponent{1});
+				gameScore_ += 1;
+
+				// バレットヒットSE
+				audio_->PlaySE(GameSound::EnemyHitSE);
+			}
+		}
+	}
+}
+
+//----------------------------------------------
+// チェックサム
+//----------------------------------------------
+
+// 状態のチェックサム
+uint64_t GameSimulation::ComputeChecksum() {
+	uint64_t hash = kFnvOffsetBasis;
+	int state[] = {
+	    static_cast<int>(scene_), static_cast<int>(pendingScene_), sceneChangeTimer_, gameScore_,
+	    playerLife_, gameTimer_, beamTimer_, playerTimer_};
+	HashBytes(hash, state, sizeof(state));
+	HashBytes(hash, &playerPos_, sizeof(playerPos_));
+
+	// アクターは生成順に並ぶので、同じ入力なら同じ順に反復する
+	world_.ForEach<TransformComponent>([&hash](Entity, const TransformComponent& transform) {
+		HashBytes(hash, &transform.translation, sizeof(transform.translation));
+		HashBytes(hash, &transform.rotation, sizeof(transform.rotation));
+	});
+	return hash;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "ActorSystems.h"
+#include "CollisionKernel.h"
+#include "GameServices.h"
+#include "Random.h"
+#include "SpatialHash.h"
+#include "SystemScheduler.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// アクターの見た目（ヘッドレスでは空のまま）
+/// </summary>
+struct ActorAppearance {
+	Model* model = nullptr;
+	uint32_t textureHandle = 0;
+};
+
+/// <summary>
+/// ゲームの更新処理
+/// 描画・入力・音の実装に依存せず、固定の刻みで1ステップずつ進める。
+/// 乱数の種と入力が同じなら、同じ結果になる。
+/// </summary>
+class GameSimulation {
+public: // サブクラス
+	// アクターの見た目
+	struct Appearances {
+		ActorAppearance stage;
+		ActorAppearance beam;
+		ActorAppearance enemy;
+	};
+
+public: // 定数
+	// 画面の切り替えを頼んでから切り替えるまでのステップ数（この間に素材を読み込む）
+	static const int kSceneChangeSteps = 10;
+
+public: // メンバ関数
+	GameSimulation() = default;
+	GameSimulation(const GameSimulation&) = delete;
+	GameSimulation& operator=(const GameSimulation&) = delete;
+
+	/// <summary>
+	/// 初期化（タイトル画面から始まる）
+	/// </summary>
+	/// <param name="input">入力（所有しない）</param>
+	/// <param name="audio">音（所有しない）</param>
+	/// <param name="assets">画面ごとの素材（所有しない。タイトルは読み込み済みにしておく）</param>
+	/// <param name="appearances">アクターの見た目</param>
+	/// <param name="seed">乱数の種</param>
+	void Initialize(
+	    GameInput* input, GameAudio* audio, GameAssets* assets, const Appearances& appearances,
+	    unsigned int seed);
+
+	/// <summary>
+	/// アクターの見た目の設定（ゲームプレイの素材を読み込んだとき）
+	/// </summary>
+	void SetAppearances(const Appearances& appearances);
+
+	/// <summary>
+	/// 1ステップ進める
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 状態のチェックサム（決定性の確認用）
+	/// </summary>
+	uint64_t ComputeChecksum();
+
+	// アクター（ステージ・ビーム・敵。描画は読むだけ）
+	EcsWorld& GetWorld() { return world_; }
+	// プレイヤーの座標
+	const Vector3& GetPlayerPosition() const { return playerPos_; }
+	const Vector3& GetPlayerPreviousPosition() const { return playerPrevPos_; }
+	// 画面
+	GameSceneId GetScene() const { return scene_; }
+	// 画面の切り替えを待って更新を止めているか
+	bool IsWaitingForAssets() const { return pendingScene_ != GameSceneId::Count; }
+	int GetGameScore() const { return gameScore_; }
+	int GetPlayerLife() const { return playerLife_; }
+	int GetGameTimer() const { return gameTimer_; }
+	int GetPlayerTimer() const { return playerTimer_; }
+
+private: // サブクラス
+	// 画面ごとの処理
+	struct SceneState {
+		void (GameSimulation::*enter)();  //画面に入ったとき
+		void (GameSimulation::*update)(); //毎ステップ
+		GameSceneId next[2];              //次に進みうる画面（先読みする。Count は無し）
+	};
+
+	// 画面ごとの処理（GameSceneId の順）
+	static const SceneState kSceneStates[static_cast<size_t>(GameSceneId::Count)];
+
+private: // メンバ関数
+	void InitializeSystems(); //システムの登録
+
+	void RequestScene(GameSceneId scene); //画面の切り替えの要求
+	void ChangeScene(GameSceneId scene);  //画面の切り替え
+
+	void GamePlayEnter();  //ゲームプレイ開始
+	void GamePlayUpdate(); //ゲームプレイ更新
+	void GamePlayStart();  //ゲームプレイ初期化
+	void TitleEnter();     //タイトル開始
+	void TitleUpdate();    //タイトル更新
+	void GameOverEnter();  //ゲームオーバー開始
+	void GameClearEnter(); //ゲームクリア開始
+	void ResultUpdate();   //リザルト(ゲームオーバー・ゲームクリア)更新
+
+	void PlayerUpdate(); //プレイヤーの更新
+	void StageUpdate();  //ステージの更新
+	void BeamBorn();     //ビーム発生
+	void EnemyBorn();    //敵発生
+
+	void SavePreviousPositions(); //移動前の座標を記録(連続衝突判定・描画の補間用)
+	void Collision();             //衝突判定
+	void CollisionPlayerEnemy();  //衝突判定(プレイヤーと敵)
+	void CollisionBeamEnemy();    //衝突判定(ビームと敵)
+
+private: // メンバ変数
+	GameInput* input_ = nullptr;
+	GameAudio* audio_ = nullptr;
+	GameAssets* assets_ = nullptr;
+	Appearances appearances_;
+
+	//アクター(ステージ・ビーム・敵)
+	EcsWorld world_;
+	SystemScheduler scheduler_; //ゲームプレイ更新のシステム
+
+	//プレイヤー
+	Vector3 playerPos_ = {};     //プレイヤーの座標
+	Vector3 playerPrevPos_ = {}; //プレイヤーの移動前の座標
+
+	//衝突判定
+	SpatialHash beamHash_;                     //ビームの空間ハッシュ
+	SpatialHash enemyHash_;                    //敵の空間ハッシュ
+	std::vector<Entity> beamEntities_;         //空間ハッシュのID → ビーム
+	std::vector<Entity> enemyEntities_;        //空間ハッシュのID → 敵
+	std::vector<uint32_t> collisionCandidates_; //衝突候補
+	CollisionBatch collisionBatch_;            //ナローフェーズのSoA配列
+	std::vector<uint32_t> collisionHitMask_;   //ナローフェーズの結果
+
+	int gameScore_ = 0;  //ゲームスコア
+	int playerLife_ = 3; // プレイヤーライフ
+	int gameTimer_ = 0;
+	int beamTimer_ = 0;
+	int playerTimer_ = 0;
+	GameSceneId scene_ = GameSceneId::Title;        //現在の画面
+	GameSceneId pendingScene_ = GameSceneId::Count; //切り替えを待っている画面
+	int sceneChangeTimer_ = 0;                      //画面を切り替えるまでのステップ数
+
+	Random enemyRandom_; //敵発生の乱数
+};
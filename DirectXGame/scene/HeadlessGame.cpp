@@ -0,0 +1,97 @@
+#include "HeadlessGame.h"
+#include <cassert>
+#include <chrono>
+#include <utility>
+
+bool HeadlessGame::InitializeAudio(const std::string& directoryPath) {
+	mixerAudio_.Initialize(directoryPath, kAudioSampleRate);
+	audioOutput_.Start(&mixerAudio_.GetMixer());
+	isAudioEnabled_ = true;
+	return mixerAudio_.LoadAllSounds();
+}
+
+void HeadlessGame::Initialize(unsigned int seed, ScriptedGameInput::Script script) {
+	replay_ = nullptr;
+	recording_ = nullptr;
+	input_.SetScript(script ? std::move(script) : AutoPlay);
+	// 描画しないので見た目は空のまま、素材は常に読み込み済み
+	GameAudio* audio = isAudioEnabled_ ? static_cast<GameAudio*>(&mixerAudio_) : &audio_;
+	simulation_.Initialize(&input_, audio, &assets_, GameSimulation::Appearances{}, seed);
+}
+
+void HeadlessGame::InitializeReplay(const InputRecording* recording) {
+	assert(recording);
+	Initialize(recording->GetSeed(), [recording](uint32_t step) {
+		return recording->GetButtons(step);
+	});
+	replay_ = recording;
+}
+
+void HeadlessGame::InitializeRecording(
+    unsigned int seed, InputRecording* recording, ScriptedGameInput::Script script) {
+	assert(recording);
+	recording->Reset(seed);
+	if (!script) {
+		script = AutoPlay;
+	}
+	// 台本は1ステップに1回だけ呼ばれるので、そのまま記録する
+	Initialize(seed, [recording, script = std::move(script)](uint32_t step) {
+		GameButtonMask buttons = script(step);
+		recording->Append(buttons);
+		return buttons;
+	});
+	recording_ = recording;
+}
+
+HeadlessGame::Result HeadlessGame::Run(uint32_t steps) {
+	Result result;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < steps; i++) {
+		GameSceneId previousScene = simulation_.GetScene();
+		input_.Advance();
+		simulation_.Update();
+		if (isAudioEnabled_) {
+			audioOutput_.Render(kAudioFramesPerStep);
+		}
+
+		// ゲームプレイから抜けたらゲームの終わり
+		GameSceneId scene = simulation_.GetScene();
+		if (previousScene == GameSceneId::GamePlay && scene != GameSceneId::GamePlay) {
+			result.games++;
+			result.clears += scene == GameSceneId::GameClear ? 1 : 0;
+			result.totalScore += simulation_.GetGameScore();
+		}
+	}
+	result.steps = steps;
+	result.seconds =
+	    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.checksum = simulation_.ComputeChecksum();
+	if (isAudioEnabled_) {
+		result.audioChecksum = audioOutput_.GetChecksum();
+		result.audioPeak = audioOutput_.GetPeak();
+	}
+	if (recording_) {
+		recording_->SetChecksum(result.checksum);
+	}
+	return result;
+}
+
+HeadlessGame::Result HeadlessGame::RunReplay() {
+	assert(replay_);
+	Result result = Run(replay_->GetStepCount());
+	result.isReplayMismatch = !replay_->MatchesChecksum(result.checksum);
+	return result;
+}
+
+GameButtonMask HeadlessGame::AutoPlay(uint32_t step) {
+	GameButtonMask buttons = ToButtonMask(GameButton::Fire);
+
+	// 左右に2秒ずつ動く
+	buttons |= ToButtonMask((step / 120) % 2 == 0 ? GameButton::Left : GameButton::Right);
+
+	// タイトル・リザルト画面は1秒ごとに決定を押して進める
+	if (step % 60 == 0) {
+		buttons |= ToButtonMask(GameButton::Decide);
+	}
+	return buttons;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "AudioOutput.h"
+#include "GameServices.h"
+#include "GameSimulation.h"
+#include "InputReplay.h"
+#include "MixerGameAudio.h"
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// ヘッドレス実行（描画なし・台本の入力・無音）
+/// ウィンドウやGPUの無い環境で、ゲームの更新だけを高速に回す。
+/// 乱数の種と台本が同じなら、同じチェックサムになる。
+/// 音を有効にするとミキサーで実際に混ぜ（出力は捨てる）、音のチェックサムも同じになる。
+/// </summary>
+class HeadlessGame {
+public: // サブクラス
+	// 実行結果
+	struct Result {
+		uint32_t steps = 0;     // 進めたステップ数
+		uint32_t games = 0;     // 終わったゲームの数（ゲームオーバー・ゲームクリア）
+		uint32_t clears = 0;    // そのうちゲームクリアの数
+		int64_t totalScore = 0; // 終わったゲームのスコアの合計
+		uint64_t checksum = 0;  // 最後の状態のチェックサム
+		double seconds = 0.0;   // かかった時間
+		uint64_t audioChecksum = 0; // 混ぜた音のチェックサム（音が有効なとき）
+		float audioPeak = 0.0f;     // 混ぜた音の大きさの最大（音が有効なとき）
+		bool isReplayMismatch = false; // リプレイの最後の状態が記録のチェックサムと違ったか
+	};
+
+	// 1ステップで混ぜるフレーム数（48kHz・60fps）
+	static const uint32_t kAudioSampleRate = 48000;
+	static const uint32_t kAudioFramesPerStep = kAudioSampleRate / 60;
+
+public: // メンバ関数
+	/// <summary>
+	/// 音を有効にする（Initialize の前に呼ぶ）
+	/// </summary>
+	/// <param name="directoryPath">サウンド格納ディレクトリ</param>
+	/// <returns>全ての音を読み込めたか</returns>
+	bool InitializeAudio(const std::string& directoryPath);
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="seed">乱数の種</param>
+	/// <param name="script">入力の台本（空なら AutoPlay）</param>
+	void Initialize(unsigned int seed, ScriptedGameInput::Script script = nullptr);
+
+	/// <summary>
+	/// リプレイで初期化（記録の乱数の種と入力で進める）
+	/// </summary>
+	/// <param name="recording">入力の記録（実行が終わるまで保持しておく）</param>
+	void InitializeReplay(const InputRecording* recording);
+
+	/// <summary>
+	/// 入力を記録しながら初期化（Run の終わりに最後の状態のチェックサムも記録する）
+	/// </summary>
+	/// <param name="seed">乱数の種</param>
+	/// <param name="recording">記録先（実行が終わるまで保持しておく）</param>
+	/// <param name="script">入力の台本（空なら AutoPlay）</param>
+	void InitializeRecording(
+	    unsigned int seed, InputRecording* recording, ScriptedGameInput::Script script = nullptr);
+
+	/// <summary>
+	/// ステップを進める
+	/// </summary>
+	/// <param name="steps">進めるステップ数</param>
+	Result Run(uint32_t steps);
+
+	/// <summary>
+	/// リプレイを記録の最後まで進め、最後の状態を記録のチェックサムと比べる
+	/// （InitializeReplay の後に呼ぶ）
+	/// </summary>
+	Result RunReplay();
+
+	/// <summary>
+	/// 自動プレイの台本（左右に往復しながら撃ち続け、画面を進める）
+	/// </summary>
+	static GameButtonMask AutoPlay(uint32_t step);
+
+	GameSimulation& GetSimulation() { return simulation_; }
+	// 無音のときの再生回数
+	const NullGameAudio& GetAudio() const { return audio_; }
+
+private: // メンバ変数
+	ScriptedGameInput input_;
+	NullGameAudio audio_;
+	MixerGameAudio mixerAudio_;     // 音が有効なときの音
+	NullAudioOutput audioOutput_;   // mixerAudio_ の出力先
+	bool isAudioEnabled_ = false;
+	NullGameAssets assets_;
+	GameSimulation simulation_;
+	const InputRecording* replay_ = nullptr; // 再生中の記録
+	InputRecording* recording_ = nullptr;    // 記録先
+};
@@ -0,0 +1,180 @@
+#include "InputReplay.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+// ファイルの先頭の識別子
+const uint8_t kMagic[4] = {'A', 'L', '3', 'R'};
+
+// リトルエンディアンで書き込む
+template<class T> void WriteValue(std::vector<uint8_t>& out, T value) {
+	for (size_t i = 0; i < sizeof(T); i++) {
+		out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8)));
+	}
+}
+
+// 可変長で書き込む（7ビットずつ、続きがあれば最上位ビットを立てる）
+void WriteVarint(std::vector<uint8_t>& out, uint32_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+// 読み込み位置
+struct ByteReader {
+	const std::vector<uint8_t>& data;
+	size_t offset = 0;
+	bool failed = false;
+
+	template<class T> T ReadValue() {
+		if (data.size() - offset < sizeof(T)) {
+			failed = true;
+			return 0;
+		}
+		uint64_t value = 0;
+		for (size_t i = 0; i < sizeof(T); i++) {
+			value |= static_cast<uint64_t>(data[offset++]) << (i * 8);
+		}
+		return static_cast<T>(value);
+	}
+
+	uint32_t ReadVarint() {
+		uint32_t value = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7) {
+			uint8_t byte = ReadValue<uint8_t>();
+			if (failed) {
+				return 0;
+			}
+			value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		failed = true;
+		return 0;
+	}
+};
+
+} // namespace
+
+void InputRecording::Reset(uint32_t seed) {
+	runs_.clear();
+	seed_ = seed;
+	stepCount_ = 0;
+	checksum_ = 0;
+}
+
+void InputRecording::Append(GameButtonMask buttons) {
+	if (!runs_.empty() && runs_.back().buttons == buttons) {
+		runs_.back().count++;
+	} else {
+		runs_.push_back({buttons, stepCount_, 1});
+	}
+	stepCount_++;
+}
+
+GameButtonMask InputRecording::GetButtons(uint32_t step) const {
+	if (step >= stepCount_) {
+		return 0;
+	}
+	// step を含む区間（開始が step 以下で最後のもの）
+	auto it = std::upper_bound(
+	    runs_.begin(), runs_.end(), step, [](uint32_t s, const Run& run) { return s < run.start; });
+	return std::prev(it)->buttons;
+}
+
+std::vector<uint8_t> InputRecording::Serialize() const {
+	std::vector<uint8_t> out;
+	for (uint8_t byte : kMagic) {
+		out.push_back(byte);
+	}
+	WriteValue<uint16_t>(out, kVersion);
+	WriteValue<uint16_t>(out, 0); // 予約
+	WriteValue<uint32_t>(out, seed_);
+	WriteValue<uint32_t>(out, stepCount_);
+	WriteValue<uint64_t>(out, checksum_);
+	WriteValue<uint32_t>(out, static_cast<uint32_t>(runs_.size()));
+	for (const Run& run : runs_) {
+		out.push_back(run.buttons);
+		WriteVarint(out, run.count);
+	}
+	return out;
+}
+
+bool InputRecording::Deserialize(const std::vector<uint8_t>& data) {
+	Reset(0);
+	if (data.size() < sizeof(kMagic) ||
+	    !std::equal(std::begin(kMagic), std::end(kMagic), data.begin())) {
+		return false;
+	}
+	ByteReader reader = {data, sizeof(kMagic)};
+	uint16_t version = reader.ReadValue<uint16_t>();
+	reader.ReadValue<uint16_t>();
+	uint32_t seed = reader.ReadValue<uint32_t>();
+	uint32_t stepCount = reader.ReadValue<uint32_t>();
+	uint64_t checksum = reader.ReadValue<uint64_t>();
+	uint32_t runCount = reader.ReadValue<uint32_t>();
+	if (reader.failed || version != kVersion) {
+		return false;
+	}
+
+	seed_ = seed;
+	for (uint32_t i = 0; i < runCount; i++) {
+		GameButtonMask buttons = reader.ReadValue<uint8_t>();
+		uint32_t count = reader.ReadVarint();
+		if (reader.failed || count == 0) {
+			Reset(0);
+			return false;
+		}
+		runs_.push_back({buttons, stepCount_, count});
+		stepCount_ += count;
+	}
+	if (stepCount_ != stepCount) {
+		Reset(0);
+		return false;
+	}
+	checksum_ = checksum;
+	return true;
+}
+
+bool InputRecording::SaveFile(const std::string& fileName) const {
+	std::vector<uint8_t> data = Serialize();
+	std::ofstream file(fileName, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return file.good();
+}
+
+bool InputRecording::LoadFile(const std::string& fileName) {
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file) {
+		Reset(0);
+		return false;
+	}
+	std::vector<uint8_t> data(
+	    (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return Deserialize(data);
+}
+
+void RecordingGameInput::Initialize(GameInput* source, InputRecording* recording) {
+	assert(source);
+	assert(recording);
+	source_ = source;
+	recording_ = recording;
+	ResetButtons();
+}
+
+void RecordingGameInput::Advance() {
+	GameButtonMask buttons = 0;
+	for (uint32_t i = 0; i < static_cast<uint32_t>(GameButton::Count); i++) {
+		if (source_->IsPressed(static_cast<GameButton>(i))) {
+			buttons |= ToButtonMask(static_cast<GameButton>(i));
+		}
+	}
+	recording_->Append(buttons);
+	SetButtons(buttons);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "GameServices.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 入力の記録（リプレイ）
+/// ステップごとのボタンを、同じ値が続く区間ごとにまとめて（ランレングス）持つ。
+/// 乱数の種も一緒に持つので、同じ記録を流せば同じプレイになる。
+/// </summary>
+class InputRecording {
+public: // 定数
+	// ファイルの版（乱数の生成器や画面の切り替えのタイミングが変わると
+	// 同じ入力でも別のプレイになるので上げる）
+	static const uint16_t kVersion = 3;
+
+public: // メンバ関数
+	/// <summary>
+	/// 記録を空にする
+	/// </summary>
+	/// <param name="seed">乱数の種</param>
+	void Reset(uint32_t seed);
+
+	/// <summary>
+	/// 1ステップ分のボタンを追加
+	/// </summary>
+	void Append(GameButtonMask buttons);
+
+	/// <summary>
+	/// ステップのボタンの取得（記録より先は何も押していない）
+	/// </summary>
+	GameButtonMask GetButtons(uint32_t step) const;
+
+	/// <summary>
+	/// 最後の状態のチェックサムの設定（再生したときの確認用。0は未設定）
+	/// </summary>
+	void SetChecksum(uint64_t checksum) { checksum_ = checksum; }
+
+	uint32_t GetSeed() const { return seed_; }
+	uint32_t GetStepCount() const { return stepCount_; }
+	uint64_t GetChecksum() const { return checksum_; }
+
+	/// <summary>
+	/// 最後まで再生した状態が記録と同じか（チェックサムが未設定なら確かめられないので true）
+	/// </summary>
+	bool MatchesChecksum(uint64_t checksum) const {
+		return checksum_ == 0 || checksum_ == checksum;
+	}
+	size_t GetRunCount() const { return runs_.size(); }
+
+	/// <summary>
+	/// バイト列への変換
+	/// </summary>
+	std::vector<uint8_t> Serialize() const;
+
+	/// <summary>
+	/// バイト列からの復元
+	/// </summary>
+	/// <returns>壊れていたら false（記録は空になる）</returns>
+	bool Deserialize(const std::vector<uint8_t>& data);
+
+	/// <summary>
+	/// ファイルへの保存
+	/// </summary>
+	bool SaveFile(const std::string& fileName) const;
+
+	/// <summary>
+	/// ファイルからの読み込み
+	/// </summary>
+	bool LoadFile(const std::string& fileName);
+
+private: // サブクラス
+	// 同じボタンが続く区間
+	struct Run {
+		GameButtonMask buttons;
+		uint32_t start; // 最初のステップ
+		uint32_t count; // ステップ数
+	};
+
+private: // メンバ変数
+	std::vector<Run> runs_;
+	uint32_t seed_ = 0;
+	uint32_t stepCount_ = 0;
+	uint64_t checksum_ = 0;
+};
+
+/// <summary>
+/// 記録しながらの入力（元の入力をボタンのビットマスクに変えて記録する）
+/// </summary>
+class RecordingGameInput : public ButtonMaskGameInput {
+public:
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="source">元の入力（所有しない）</param>
+	/// <param name="recording">記録先（所有しない）</param>
+	void Initialize(GameInput* source, InputRecording* recording);
+
+	/// <summary>
+	/// 次のステップへ進める（ゲームの更新の前に毎ステップ呼ぶ）
+	/// </summary>
+	void Advance();
+
+private:
+	GameInput* source_ = nullptr;
+	InputRecording* recording_ = nullptr;
+};
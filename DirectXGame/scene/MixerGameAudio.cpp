@@ -0,0 +1,113 @@
+#include "MixerGameAudio.h"
+#include <algorithm>
+
+const MixerGameAudio::SoundFile
+    MixerGameAudio::kSoundFiles[static_cast<size_t>(GameSound::Count)] = {
+        {"Audio/Ring05.wav", true, 3, 1},  // TitleBGM
+        {"Audio/Ring08.wav", true, 3, 1},  // GamePlayBGM
+        {"Audio/Ring09.wav", true, 3, 1},  // GameOverBGM
+        {"Audio/fanfare.wav", true, 3, 1}, // GameClearBGM
+        {"Audio/chord.wav", false, 1, 4},  // EnemyHitSE
+        {"Audio/tada.wav", false, 2, 2},   // PlayerHitSE
+};
+
+const float MixerGameAudio::kBGMCrossfadeSeconds = 1.0f;
+const float MixerGameAudio::kDuckGain = 0.5f;
+const float MixerGameAudio::kDuckAttackSeconds = 0.05f;
+const float MixerGameAudio::kDuckReleaseSeconds = 0.4f;
+
+void MixerGameAudio::Initialize(const std::string& directoryPath, uint32_t sampleRate) {
+	mixer_.Initialize(sampleRate);
+	soundFormat_.formatTag = kWaveFormatFloat;
+	soundFormat_.channels = AudioMixer::kChannels;
+	soundFormat_.samplesPerSec = sampleRate;
+	soundFormat_.blockAlign = static_cast<uint16_t>(sizeof(float) * AudioMixer::kChannels);
+	soundFormat_.avgBytesPerSec = sampleRate * soundFormat_.blockAlign;
+	soundFormat_.bitsPerSample = sizeof(float) * 8;
+	mixer_.SetDucking(
+	    AudioBus::BGM, AudioBus::SE, kDuckGain, kDuckAttackSeconds, kDuckReleaseSeconds);
+	directoryPath_ = directoryPath;
+	for (uint32_t& handle : bgmVoiceHandles_) {
+		handle = 0;
+	}
+	for (size_t i = 0; i < static_cast<size_t>(GameSound::Count); i++) {
+		std::fill_n(instanceHandles_[i], kMaxInstances, 0u);
+		nextInstances_[i] = 0;
+	}
+	voiceHandleBGM_ = 0;
+}
+
+bool MixerGameAudio::LoadSound(GameSound sound) {
+	size_t index = static_cast<size_t>(sound);
+	if (isLoaded_[index]) {
+		return true;
+	}
+	const SoundFile& file = kSoundFiles[index];
+	if (file.isStream) {
+		// 開けることだけ確かめる（ヘッダを読むだけ）
+		WaveStream stream;
+		isLoaded_[index] = stream.Open(directoryPath_ + file.fileName, true);
+	} else {
+		// 鳴らすたびに変換しないように、出力の形式に揃えておく（ファイルはすぐ閉じる）
+		WaveFile wave;
+		isLoaded_[index] = wave.Open(directoryPath_ + file.fileName) &&
+		                   ConvertSound(
+		                       {wave.GetFormat(), wave.GetData()}, mixer_.GetSampleRate(),
+		                       ResampleQuality::Sinc, sounds_[index]);
+	}
+	return isLoaded_[index];
+}
+
+bool MixerGameAudio::LoadAllSounds() {
+	bool loaded = true;
+	for (size_t i = 0; i < static_cast<size_t>(GameSound::Count); i++) {
+		loaded = LoadSound(static_cast<GameSound>(i)) && loaded;
+	}
+	return loaded;
+}
+
+void MixerGameAudio::PlayBGM(GameSound sound) {
+	// 現在のBGMを絞ってから止める（鳴り終わるまでストリームはミキサーが読んでいる）
+	bool isCrossfade = mixer_.IsPlaying(voiceHandleBGM_);
+	mixer_.FadeOutAndStop(voiceHandleBGM_, kBGMCrossfadeSeconds);
+	voiceHandleBGM_ = 0;
+	size_t index = static_cast<size_t>(sound);
+	if (!isLoaded_[index]) {
+		return;
+	}
+	// ミキサーが参照していないストリームで開き直す
+	for (uint32_t i = 0; i < kBGMStreamCount; i++) {
+		if (mixer_.IsPlaying(bgmVoiceHandles_[i])) {
+			continue;
+		}
+		bgmVoiceHandles_[i] = 0;
+		if (bgmStreams_[i].Open(directoryPath_ + kSoundFiles[index].fileName, true)) {
+			// 前のBGMが鳴っていたら、無音から上げる
+			voiceHandleBGM_ = mixer_.PlayStream(
+			    &bgmStreams_[i], isCrossfade ? 0.0f : 1.0f, 0.0f, kSoundFiles[index].priority,
+			    AudioBus::BGM);
+			if (isCrossfade) {
+				mixer_.FadeVolume(voiceHandleBGM_, 1.0f, kBGMCrossfadeSeconds);
+			}
+			bgmVoiceHandles_[i] = voiceHandleBGM_;
+		}
+		return;
+	}
+}
+
+void MixerGameAudio::PlaySE(GameSound sound) {
+	size_t index = static_cast<size_t>(sound);
+	if (!isLoaded_[index]) {
+		return;
+	}
+	// 上限まで鳴っていたら一番古いものを止める
+	const SoundFile& file = kSoundFiles[index];
+	uint32_t& next = nextInstances_[index];
+	mixer_.Stop(instanceHandles_[index][next]);
+	const std::vector<float>& samples = sounds_[index];
+	std::span<const uint8_t> data(
+	    reinterpret_cast<const uint8_t*>(samples.data()), samples.size() * sizeof(float));
+	instanceHandles_[index][next] =
+	    mixer_.Play({soundFormat_, data}, false, 1.0f, 0.0f, file.priority, AudioBus::SE);
+	next = (next + 1) % file.maxInstances;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "AudioMixer.h"
+#include "GameServices.h"
+#include "WaveFile.h"
+#include "WaveStream.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// ソフトウェアミキサーによるゲームの音
+/// 効果音は読み込み時に出力の形式（ステレオの float）へ変換しておき、BGMはストリーミングで
+/// 鳴らしながら変換する。
+/// 同じ効果音を重ねて鳴らせる数には音ごとに上限があり、超えたら一番古いものを止める。
+/// BGMは BGM、効果音は SE のバスで鳴らし、効果音が鳴っている間はBGMを絞る。
+/// BGMの切り替えは、前のBGMを絞りながら次のBGMを上げる（クロスフェード）。
+/// 出力先（XAudio2・無音・ファイル）は GetMixer を AudioOutput につないで決める。
+/// </summary>
+class MixerGameAudio : public GameAudio {
+public: // 定数
+	// BGMのストリームの数（止めたBGMが鳴り終わるまで、次のBGMは別のストリームで鳴らす）
+	static const uint32_t kBGMStreamCount = 3;
+	// 同じ効果音を重ねて鳴らせる数の最大
+	static const uint32_t kMaxInstances = 8;
+	// BGMを切り替えるときのクロスフェードの秒数
+	static const float kBGMCrossfadeSeconds;
+	// 効果音が鳴っている間のBGMの倍率と、絞る・戻す秒数
+	static const float kDuckGain;
+	static const float kDuckAttackSeconds;
+	static const float kDuckReleaseSeconds;
+
+public: // メンバ関数
+	MixerGameAudio() = default;
+	MixerGameAudio(const MixerGameAudio&) = delete;
+	MixerGameAudio& operator=(const MixerGameAudio&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="directoryPath">サウンド格納ディレクトリ</param>
+	/// <param name="sampleRate">出力の周波数</param>
+	void Initialize(const std::string& directoryPath = "Resources/", uint32_t sampleRate = 48000);
+
+	/// <summary>
+	/// 音の読み込み（BGMはファイルを確かめるだけで、再生するまで読まない）
+	/// </summary>
+	/// <returns>読み込めたか</returns>
+	bool LoadSound(GameSound sound);
+
+	/// <summary>
+	/// 全ての音の読み込み
+	/// </summary>
+	/// <returns>全て読み込めたか</returns>
+	bool LoadAllSounds();
+
+	void PlayBGM(GameSound sound) override;
+	void PlaySE(GameSound sound) override;
+
+	AudioMixer& GetMixer() { return mixer_; }
+
+private: // サブクラス
+	// 音のファイル
+	struct SoundFile {
+		const char* fileName;
+		bool isStream;          // ストリーミングで鳴らすか
+		uint32_t priority;      // ミキサーでの優先度
+		uint32_t maxInstances;  // 重ねて鳴らせる数（kMaxInstances 以下）
+	};
+
+	// 音のファイル（GameSound の順）
+	static const SoundFile kSoundFiles[static_cast<size_t>(GameSound::Count)];
+
+private: // メンバ変数
+	AudioMixer mixer_;
+	std::string directoryPath_;
+	// 効果音（出力の周波数のステレオの float）
+	std::vector<float> sounds_[static_cast<size_t>(GameSound::Count)];
+	WaveFormat soundFormat_;
+	bool isLoaded_[static_cast<size_t>(GameSound::Count)] = {};
+	WaveStream bgmStreams_[kBGMStreamCount];
+	uint32_t bgmVoiceHandles_[kBGMStreamCount] = {}; // ストリームごとの再生ハンドル
+	uint32_t voiceHandleBGM_ = 0; //音声再生ハンドル
+	// 効果音ごとの最近の再生ハンドル（nextInstances_ が一番古い）
+	uint32_t instanceHandles_[static_cast<size_t>(GameSound::Count)][kMaxInstances] = {};
+	uint32_t nextInstances_[static_cast<size_t>(GameSound::Count)] = {};
+};
@@ -0,0 +1,77 @@
+#include "SceneAssetLoader.h"
+#include <utility>
+
+void SceneAssetLoader::SetManifest(GameSceneId scene, Manifest manifest) {
+	Entry& entry = entries_[static_cast<size_t>(scene)];
+	entry.manifest = std::move(manifest);
+	entry.state = State::Unloaded;
+}
+
+void SceneAssetLoader::Load(GameSceneId scene) {
+	Prefetch(scene);
+	Entry& entry = entries_[static_cast<size_t>(scene)];
+	if (entry.state == State::Loading) {
+		BackgroundLoader::GetInstance()->Wait(entry.ticket);
+		Complete(entry);
+	}
+}
+
+void SceneAssetLoader::Prefetch(GameSceneId scene) {
+	Entry& entry = entries_[static_cast<size_t>(scene)];
+	if (entry.state != State::Unloaded) {
+		return;
+	}
+
+	// 読み込み済みのテクスチャは展開しない（テクスチャの一覧はメインスレッドでしか触らない）
+	std::vector<std::string> fileNames;
+	for (const std::string& fileName : entry.manifest.textures) {
+		if (!TextureManager::IsLoaded(fileName)) {
+			fileNames.push_back(fileName);
+		}
+	}
+
+	entry.decoded = std::make_shared<std::vector<TextureManager::DecodedTexture>>();
+	if (fileNames.empty()) {
+		// 展開するものが無ければすぐ読み込み済みにする
+		Complete(entry);
+		return;
+	}
+	entry.state = State::Loading;
+	entry.ticket = BackgroundLoader::GetInstance()->Submit(
+	    [decoded = entry.decoded, fileNames = std::move(fileNames)] {
+		    for (const std::string& fileName : fileNames) {
+			    decoded->push_back(TextureManager::Decode(fileName));
+		    }
+	    });
+}
+
+bool SceneAssetLoader::IsReady(GameSceneId scene) {
+	Entry& entry = entries_[static_cast<size_t>(scene)];
+	switch (entry.state) {
+	case State::Unloaded:
+		Prefetch(scene);
+		return false;
+	case State::Loading:
+		if (!BackgroundLoader::GetInstance()->IsDone(entry.ticket)) {
+			return false;
+		}
+		Complete(entry);
+		return true;
+	case State::Ready:
+	default:
+		return true;
+	}
+}
+
+void SceneAssetLoader::Complete(Entry& entry) {
+	// デバイスとデスクリプタヒープを触るのでメインスレッドで行う
+	for (const TextureManager::DecodedTexture& decoded : *entry.decoded) {
+		TextureManager::LoadDecoded(decoded);
+	}
+	entry.decoded.reset();
+	entry.state = State::Ready;
+
+	if (entry.manifest.onLoaded) {
+		entry.manifest.onLoaded();
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "BackgroundLoader.h"
+#include "GameServices.h"
+#include "TextureManager.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 画面ごとの素材の読み込み
+/// 画面ごとに素材の一覧を持ち、先読みを頼まれたらテクスチャの展開を読み込み用のスレッドで行う。
+/// 展開が終わったら、テクスチャの生成と一覧の後処理をメインスレッドで行って読み込み済みにする。
+/// 読み込んだ素材は解放しない。
+/// </summary>
+class SceneAssetLoader : public GameAssets {
+public: // サブクラス
+	// 素材の一覧
+	struct Manifest {
+		std::vector<std::string> textures; // テクスチャ（読み込み用のスレッドで展開する）
+		std::function<void()> onLoaded; // 読み込み後にメインスレッドで行う処理（スプライト・音など）
+	};
+
+public: // メンバ関数
+	/// <summary>
+	/// 素材の一覧の設定
+	/// </summary>
+	void SetManifest(GameSceneId scene, Manifest manifest);
+
+	void Prefetch(GameSceneId scene) override;
+	bool IsReady(GameSceneId scene) override;
+	void Load(GameSceneId scene) override;
+
+private: // サブクラス
+	// 読み込みの状態
+	enum class State {
+		Unloaded, // 未読み込み
+		Loading,  // 展開中
+		Ready,    // 読み込み済み
+	};
+
+	// 画面ごとの素材
+	struct Entry {
+		Manifest manifest;
+		State state = State::Unloaded;
+		BackgroundLoader::Ticket ticket = 0;
+		// 展開した画像（読み込み用のスレッドが書き、終わってからメインスレッドが読む）
+		std::shared_ptr<std::vector<TextureManager::DecodedTexture>> decoded;
+	};
+
+private: // メンバ関数
+	/// <summary>
+	/// 展開済みの画像からテクスチャを生成して読み込み済みにする
+	/// </summary>
+	void Complete(Entry& entry);
+
+private: // メンバ変数
+	std::array<Entry, static_cast<size_t>(GameSceneId::Count)> entries_;
+};
@@ -0,0 +1,136 @@
+#include "ActionMap.h"
+#include "InputReplay.h"
+#include "Random.h"
+#include "TestUtility.h"
+
+// アクションの押した・離したが、記録したボタンから作り直したものと同じになるかの確認
+// （リプレイは押下だけを記録して、押した瞬間をその差から作る）
+
+namespace {
+
+// キー番号（DIK_LEFT・DIK_SPACE と同じ）
+const uint8_t kKeyLeft = 0xCB;
+const uint8_t kKeySpace = 0x39;
+
+// アクションをそのままゲームのボタンにする入力（GameScene と同じ）
+class ActionInput : public GameInput {
+public:
+	explicit ActionInput(const ActionMap* actionMap) : actionMap_(actionMap) {}
+
+	bool IsPressed(GameButton button) const override {
+		return actionMap_->IsPressed(static_cast<uint32_t>(button));
+	}
+	bool IsTriggered(GameButton button) const override {
+		return actionMap_->IsTriggered(static_cast<uint32_t>(button));
+	}
+
+private:
+	const ActionMap* actionMap_;
+};
+
+// 1ステップ分の入力
+struct Step {
+	InputEventQueue queue;
+	InputEventState keyboard;
+	GamepadState pad;
+	InputClock::time_point time = InputClock::now();
+
+	void Key(InputEventType type, uint8_t key) {
+		InputEvent event;
+		event.time = time;
+		event.type = type;
+		event.code = key;
+		queue.Push(event);
+	}
+
+	void Advance() {
+		keyboard.Advance(queue, time);
+		time += std::chrono::milliseconds(16);
+	}
+};
+
+void SetupActions(ActionMap& actionMap) {
+	TEST_CHECK(actionMap.AddAction("Left") == static_cast<int32_t>(GameButton::Left));
+	TEST_CHECK(actionMap.AddAction("Right") == static_cast<int32_t>(GameButton::Right));
+	TEST_CHECK(actionMap.AddAction("Fire") == static_cast<int32_t>(GameButton::Fire));
+	actionMap.Bind(uint32_t(GameButton::Left), InputBinding::Key(kKeyLeft));
+	actionMap.Bind(uint32_t(GameButton::Left), InputBinding::Pad(GamepadButton::DpadLeft));
+	actionMap.Bind(uint32_t(GameButton::Left), InputBinding::Axis(GamepadAxis::LeftX, -1));
+	actionMap.Bind(uint32_t(GameButton::Fire), InputBinding::Key(kKeySpace));
+	actionMap.Bind(uint32_t(GameButton::Fire), InputBinding::Pad(GamepadButton::A));
+}
+
+void TestTaps() {
+	ActionMap actionMap;
+	SetupActions(actionMap);
+	Step step;
+	const uint32_t fire = uint32_t(GameButton::Fire);
+
+	// 1ステップの間に押して離したキーも、そのステップは押したことになる
+	step.Key(InputEventType::KeyDown, kKeySpace);
+	step.Key(InputEventType::KeyUp, kKeySpace);
+	step.Advance();
+	actionMap.Update(step.keyboard, step.pad);
+	TEST_CHECK(actionMap.IsTriggered(fire) && actionMap.IsPressed(fire));
+	step.Advance();
+	actionMap.Update(step.keyboard, step.pad);
+	TEST_CHECK(actionMap.IsReleased(fire) && !actionMap.IsPressed(fire));
+
+	// パッドで押したまま、キーで押し直しても押したことにはならない（記録と同じ）
+	step.pad.buttons = 1u << uint32_t(GamepadButton::A);
+	step.Advance();
+	actionMap.Update(step.keyboard, step.pad);
+	TEST_CHECK(actionMap.IsTriggered(fire));
+	step.Key(InputEventType::KeyDown, kKeySpace);
+	step.Key(InputEventType::KeyUp, kKeySpace);
+	step.Advance();
+	actionMap.Update(step.keyboard, step.pad);
+	TEST_CHECK(actionMap.IsPressed(fire) && !actionMap.IsTriggered(fire));
+}
+
+void TestMatchesRecording() {
+	// でたらめな入力で、アクションと記録から作り直したボタンを比べる
+	ActionMap actionMap;
+	SetupActions(actionMap);
+	ActionInput actionInput(&actionMap);
+	InputRecording recording;
+	recording.Reset(1);
+	RecordingGameInput recordingInput;
+	recordingInput.Initialize(&actionInput, &recording);
+
+	Random random(7);
+	Step step;
+	const uint8_t keys[] = {kKeyLeft, kKeySpace};
+	for (int i = 0; i < 5000; i++) {
+		// 1ステップの間にキーを0~3回押したり離したりする
+		for (uint32_t n = random.NextBelow(4); n > 0; n--) {
+			uint8_t key = keys[random.NextBelow(2)];
+			bool down = random.NextBelow(2) == 0;
+			step.Key(down ? InputEventType::KeyDown : InputEventType::KeyUp, key);
+		}
+		if (random.NextBelow(8) == 0) {
+			GamepadButton button = random.NextBelow(2) ? GamepadButton::A : GamepadButton::DpadLeft;
+			step.pad.buttons ^= 1u << uint32_t(button);
+		}
+		if (random.NextBelow(8) == 0) {
+			step.pad.axes[size_t(GamepadAxis::LeftX)] = int16_t(random.NextInt(-32768, 32767));
+		}
+		step.Advance();
+		actionMap.Update(step.keyboard, step.pad);
+		recordingInput.Advance();
+
+		for (uint32_t b = 0; b < static_cast<uint32_t>(GameButton::Count); b++) {
+			GameButton button = static_cast<GameButton>(b);
+			TEST_CHECK(recordingInput.IsPressed(button) == actionInput.IsPressed(button));
+			TEST_CHECK(recordingInput.IsTriggered(button) == actionInput.IsTriggered(button));
+		}
+	}
+}
+
+} // namespace
+
+int main() {
+	TestTaps();
+	TestMatchesRecording();
+	return TestExitCode();
+}
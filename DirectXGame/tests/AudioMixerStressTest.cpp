@@ -0,0 +1,316 @@
+#include "AudioMixer.h"
+#include "Random.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+// 出力先のスレッドで Render を回しながら、ゲームのスレッドから効果音を連打する
+// （ThreadSanitizer でも動かせるよう、速さの確認はしない）
+// 例: cmake -DCMAKE_CXX_FLAGS=-fsanitize=thread -DCMAKE_BUILD_TYPE=RelWithDebInfo
+
+namespace {
+
+// 出力の周波数
+const uint32_t kSampleRate = 48000;
+// ゲームの1フレームで進める出力のフレーム数（60fps）
+const uint32_t kFramesPerUpdate = kSampleRate / 60;
+// ゲームの1フレームで鳴らす数（60fps で毎秒 6000 回）
+const int kPlaysPerUpdate = 100;
+// ゲームのフレーム数（出力の時間で10秒）
+const int kUpdateCount = 600;
+
+// 連打している間の確保の回数（Play・Render が確保しないことの確認）
+std::atomic<bool> isCountingAllocations{false};
+std::atomic<int> allocationCount{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+	if (isCountingAllocations.load(std::memory_order_relaxed)) {
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (void* pointer = std::malloc(size ? size : 1)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+namespace {
+
+// 正弦波の音（16ビットか float）
+struct TestSound {
+	std::vector<uint8_t> bytes;
+	WaveView view;
+};
+
+TestSound MakeSound(uint16_t formatTag, uint16_t channels, uint32_t sampleRate, uint32_t frames) {
+	TestSound sound;
+	uint16_t bytesPerSample = formatTag == kWaveFormatFloat ? 4 : 2;
+	WaveFormat& format = sound.view.format;
+	format.formatTag = formatTag;
+	format.channels = channels;
+	format.samplesPerSec = sampleRate;
+	format.blockAlign = static_cast<uint16_t>(channels * bytesPerSample);
+	format.avgBytesPerSec = sampleRate * format.blockAlign;
+	format.bitsPerSample = static_cast<uint16_t>(bytesPerSample * 8);
+
+	sound.bytes.resize(static_cast<size_t>(frames) * format.blockAlign);
+	for (uint32_t i = 0; i < frames * channels; i++) {
+		float value = 0.5f * std::sin(static_cast<float>(i) * 0.05f);
+		if (formatTag == kWaveFormatFloat) {
+			reinterpret_cast<float*>(sound.bytes.data())[i] = value;
+		} else {
+			reinterpret_cast<int16_t*>(sound.bytes.data())[i] =
+			    static_cast<int16_t>(value * 32767.0f);
+		}
+	}
+	sound.view.data = sound.bytes;
+	return sound;
+}
+
+// 出力先のスレッド（実際の出力と同じく、ゲームの進みに合わせた分だけ引き出す）
+class RenderThread {
+public:
+	explicit RenderThread(AudioMixer* mixer) : mixer_(mixer) {
+		thread_ = std::thread([this] { Run(); });
+	}
+
+	~RenderThread() {
+		isRunning_ = false;
+		thread_.join();
+	}
+
+	// 出力したフレーム数
+	uint64_t GetRenderedFrames() const { return renderedFrames_.load(); }
+	// [-1, 1] の外や NaN を出したか
+	bool IsOutOfRange() const { return isOutOfRange_.load(); }
+
+	// 出力を frames まで進めて、届くまで待つ
+	void RenderUntil(uint64_t frames) {
+		targetFrames_ = frames;
+		while (GetRenderedFrames() < frames) {
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	void Run() {
+		float buffer[AudioMixer::kMaxRenderFrames * AudioMixer::kChannels];
+		while (isRunning_) {
+			if (renderedFrames_.load() >= targetFrames_.load()) {
+				std::this_thread::yield();
+				continue;
+			}
+			mixer_->Render(buffer, AudioMixer::kMaxRenderFrames);
+			for (float sample : buffer) {
+				if (!(sample >= -1.0f && sample <= 1.0f)) {
+					isOutOfRange_ = true;
+				}
+			}
+			renderedFrames_ += AudioMixer::kMaxRenderFrames;
+		}
+	}
+
+	AudioMixer* mixer_;
+	std::thread thread_;
+	std::atomic<bool> isRunning_{true};
+	std::atomic<uint64_t> renderedFrames_{0};
+	std::atomic<uint64_t> targetFrames_{0};
+	std::atomic<bool> isOutOfRange_{false};
+};
+
+void TestRapidFire(ResampleQuality quality) {
+	// 周波数の変換あり・なし、モノラル・ステレオを混ぜる（20~50ms の短い効果音）
+	std::vector<TestSound> sounds;
+	sounds.push_back(MakeSound(kWaveFormatPCM, 1, 44100, 1500));
+	sounds.push_back(MakeSound(kWaveFormatPCM, 2, 48000, 2400));
+	sounds.push_back(MakeSound(kWaveFormatFloat, 2, 22050, 500));
+	sounds.push_back(MakeSound(kWaveFormatPCM, 1, 96000, 3000));
+
+	AudioMixer mixer;
+	mixer.Initialize(kSampleRate);
+	mixer.SetResampleQuality(quality);
+	mixer.SetDucking(AudioBus::BGM, AudioBus::SE, 0.5f, 0.01f, 0.1f);
+	RenderThread renderThread(&mixer);
+	// 周波数変換のフィルターは初めての周波数で作るので、先に1回ずつ鳴らして止めておく
+	for (const TestSound& sound : sounds) {
+		mixer.Stop(mixer.Play(sound.view));
+	}
+	renderThread.RenderUntil(kFramesPerUpdate);
+	TEST_CHECK(mixer.GetPlayingVoiceCount() == 0);
+
+	Random random(12345);
+	std::vector<uint32_t> handles;
+	handles.reserve(kPlaysPerUpdate * kUpdateCount);
+	int rejectedCount = 0;
+
+	isCountingAllocations = true;
+	for (int update = 0; update < kUpdateCount; update++) {
+		for (int i = 0; i < kPlaysPerUpdate; i++) {
+			const TestSound& sound = sounds[random.NextBelow(uint32_t(sounds.size()))];
+			uint32_t priority = random.NextBelow(4);
+			AudioBus bus = random.NextBelow(8) == 0 ? AudioBus::UI : AudioBus::SE;
+			uint32_t handle = mixer.Play(
+			    sound.view, false, random.NextFloat(0.1f, 1.0f), random.NextFloat(-1.0f, 1.0f),
+			    priority, bus);
+			if (handle == 0) {
+				rejectedCount++;
+				continue;
+			}
+			handles.push_back(handle);
+
+			// 少し前に鳴らした音を触る（鳴り終わっていたり奪われていたりするハンドルも混ぜる）
+			uint32_t earlier = handles[random.NextBelow(uint32_t(handles.size()))];
+			switch (random.NextBelow(8)) {
+			case 0:
+				mixer.Stop(earlier);
+				break;
+			case 1:
+				mixer.SetVolume(earlier, random.NextFloat());
+				break;
+			case 2:
+				mixer.FadeOutAndStop(earlier, 0.02f);
+				break;
+			case 3:
+				mixer.SetPan(earlier, random.NextFloat(-1.0f, 1.0f));
+				break;
+			default:
+				break;
+			}
+		}
+		// 再生中と答えるハンドルは枠の数を超えない（奪われた・鳴り終わった音のハンドルは
+		// 再生中でなくなる）。数えている間も鳴り終わりは返ってくるので、前後の数で挟む
+		if (update % 60 == 0) {
+			uint32_t before = mixer.GetPlayingVoiceCount();
+			uint32_t playing = 0;
+			for (uint32_t handle : handles) {
+				playing += mixer.IsPlaying(handle) ? 1 : 0;
+			}
+			uint32_t after = mixer.GetPlayingVoiceCount();
+			TEST_CHECK(after <= playing && playing <= before);
+		}
+		TEST_CHECK(mixer.GetPlayingVoiceCount() <= AudioMixer::kMaxVoices);
+
+		// 出力を1フレーム分進める（Render が命令を受け取る）
+		renderThread.RenderUntil(static_cast<uint64_t>(update + 2) * kFramesPerUpdate);
+	}
+	isCountingAllocations = false;
+
+	// 同じハンドルを2つの音に渡していない（枠ごとに使った回数で区別する）
+	std::vector<uint32_t> sorted = handles;
+	std::sort(sorted.begin(), sorted.end());
+	TEST_CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+	// 全て止めたら、鳴り終わりが返ってきて枠が全て空く
+	mixer.StopAll();
+	uint64_t stopFrame = renderThread.GetRenderedFrames();
+	renderThread.RenderUntil(stopFrame + kFramesPerUpdate);
+	TEST_CHECK(mixer.GetPlayingVoiceCount() == 0);
+	for (uint32_t handle : handles) {
+		TEST_CHECK(!mixer.IsPlaying(handle));
+	}
+
+	printf(
+	    "%s: %zu plays, %d rejected, %u stolen, %u dropped commands\n",
+	    quality == ResampleQuality::Sinc ? "sinc" : "linear", handles.size(), rejectedCount,
+	    mixer.GetStolenVoiceCount(), mixer.GetDroppedCommandCount());
+	TEST_CHECK(allocationCount == 0);
+	TEST_CHECK(!renderThread.IsOutOfRange());
+	// 1フレームで出す命令は溜めておける数より少ないので、捨てることはない
+	TEST_CHECK(mixer.GetDroppedCommandCount() == 0);
+	// 枠より多く鳴らしているので、奪うことが起きている
+	TEST_CHECK(mixer.GetStolenVoiceCount() > 0);
+	TEST_CHECK(handles.size() + rejectedCount == size_t(kPlaysPerUpdate) * kUpdateCount);
+}
+
+void TestFinishedBurst() {
+	// ゲームのスレッドが受け取らないまま、1回の Render で鳴り終わりが最も多く積まれる並び
+	// （全ての枠を止めて、全ての枠を奪って鳴らし直す、を溜めておける命令の数まで）でも、
+	// 知らせを落とさず全ての枠が空きに戻る
+	TestSound sound = MakeSound(kWaveFormatPCM, 2, kSampleRate, 4800);
+	AudioMixer mixer;
+	mixer.Initialize(kSampleRate);
+	float buffer[AudioMixer::kMaxRenderFrames * AudioMixer::kChannels];
+	for (uint32_t i = 0; i < AudioMixer::kMaxVoices; i++) {
+		TEST_CHECK(mixer.Play(sound.view, true) != 0);
+	}
+	mixer.Render(buffer, AudioMixer::kMaxRenderFrames);
+
+	const uint32_t kRounds = (AudioMixer::kMaxCommands - 1) / (AudioMixer::kMaxVoices + 1);
+	std::vector<uint32_t> handles;
+	for (uint32_t round = 0; round < kRounds; round++) {
+		mixer.StopAll();
+		for (uint32_t i = 0; i < AudioMixer::kMaxVoices; i++) {
+			// Render の前なので枠は埋まったままに見え、同じ優先度・音量の音から奪う
+			uint32_t handle = mixer.Play(sound.view, true);
+			TEST_CHECK(handle != 0);
+			handles.push_back(handle);
+		}
+	}
+	mixer.StopAll();
+	TEST_CHECK(mixer.GetDroppedCommandCount() == 0);
+	TEST_CHECK(mixer.GetPlayingVoiceCount() == AudioMixer::kMaxVoices);
+
+	mixer.Render(buffer, AudioMixer::kMaxRenderFrames);
+	TEST_CHECK(mixer.GetPlayingVoiceCount() == 0);
+	for (uint32_t handle : handles) {
+		TEST_CHECK(!mixer.IsPlaying(handle));
+	}
+	// 空いた枠は奪わずに使える
+	uint32_t stolenCount = mixer.GetStolenVoiceCount();
+	for (uint32_t i = 0; i < AudioMixer::kMaxVoices; i++) {
+		TEST_CHECK(mixer.Play(sound.view, true) != 0);
+	}
+	TEST_CHECK(mixer.GetStolenVoiceCount() == stolenCount);
+}
+
+void TestBusMute() {
+	// 消したバスは音量を保ったまま無音になり、戻すと元の音量で鳴る
+	TestSound sound = MakeSound(kWaveFormatPCM, 2, kSampleRate, 4800);
+	AudioMixer mixer;
+	mixer.Initialize(kSampleRate);
+	float buffer[AudioMixer::kMaxRenderFrames * AudioMixer::kChannels];
+	auto renderPeak = [&]() {
+		mixer.Render(buffer, AudioMixer::kMaxRenderFrames);
+		float peak = 0.0f;
+		for (float sample : buffer) {
+			peak = std::max(peak, std::abs(sample));
+		}
+		return peak;
+	};
+	mixer.Play(sound.view, true, 1.0f, 0.0f, 0, AudioBus::SE);
+	mixer.SetBusVolume(AudioBus::SE, 0.5f);
+	renderPeak();
+	float audible = renderPeak();
+	TEST_CHECK(audible > 0.0f);
+
+	mixer.SetBusMute(AudioBus::SE, true);
+	renderPeak();
+	TEST_CHECK(renderPeak() == 0.0f);
+	// 消している間に音量を変えても鳴らない
+	mixer.SetBusVolume(AudioBus::SE, 0.5f);
+	TEST_CHECK(renderPeak() == 0.0f);
+	// 別のバスを消しても影響しない
+	mixer.SetBusMute(AudioBus::SE, false);
+	mixer.SetBusMute(AudioBus::BGM, true);
+	renderPeak();
+	TEST_CHECK(std::abs(renderPeak() - audible) < audible * 0.1f);
+}
+
+} // namespace
+
+int main() {
+	TestRapidFire(ResampleQuality::Sinc);
+	TestRapidFire(ResampleQuality::Linear);
+	TestFinishedBurst();
+	TestBusMute();
+	return TestExitCode();
+}
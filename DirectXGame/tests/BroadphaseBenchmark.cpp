@@ -0,0 +1,140 @@
+#include "SpatialHash.h"
+#include "TestUtility.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// ビームと敵の数
+const uint32_t kBeamCount = 10000;
+const uint32_t kEnemyCount = 10000;
+// 配置する範囲（XZ、一辺の長さ）
+const float kFieldSize = 400.0f;
+// 計測するフレーム数
+const uint32_t kFrameCount = 100;
+
+// ビームか敵の配置
+struct Actors {
+	std::vector<float> x;
+	std::vector<float> z;
+	std::vector<int> flag; // 1:生きている
+};
+
+Actors MakeActors(uint32_t count, std::mt19937& random) {
+	std::uniform_real_distribution<float> position(-kFieldSize * 0.5f, kFieldSize * 0.5f);
+	Actors actors;
+	for (uint32_t i = 0; i < count; i++) {
+		actors.x.push_back(position(random));
+		actors.z.push_back(position(random));
+		actors.flag.push_back(1);
+	}
+	return actors;
+}
+
+bool IsHit(const Actors& beams, uint32_t beam, const Actors& enemies, uint32_t enemy) {
+	return std::abs(beams.x[beam] - enemies.x[enemy]) < 1.0f &&
+	       std::abs(beams.z[beam] - enemies.z[enemy]) < 1.0f;
+}
+
+// 元の GameScene::CollisionBeamEnemy と同じ総当たり（敵ごとに全ビームを調べる）
+uint32_t CollideBruteForce(Actors& beams, Actors& enemies) {
+	uint32_t hitCount = 0;
+	for (uint32_t e = 0; e < kEnemyCount; e++) {
+		if (enemies.flag[e] != 1) {
+			continue;
+		}
+		for (uint32_t b = 0; b < kBeamCount; b++) {
+			if (beams.flag[b] == 1 && IsHit(beams, b, enemies, e)) {
+				beams.flag[b] = 0;
+				enemies.flag[e] = 2;
+				hitCount++;
+			}
+		}
+	}
+	return hitCount;
+}
+
+// 空間ハッシュで候補を絞ってから同じ順で調べる
+uint32_t CollideSpatialHash(
+    Actors& beams, Actors& enemies, SpatialHash& hash, std::vector<uint32_t>& candidates,
+    uint64_t& candidateCount) {
+	hash.Clear();
+	for (uint32_t b = 0; b < kBeamCount; b++) {
+		if (beams.flag[b] == 1) {
+			hash.Insert(b, beams.x[b], beams.z[b]);
+		}
+	}
+	hash.Build();
+
+	uint32_t hitCount = 0;
+	for (uint32_t e = 0; e < kEnemyCount; e++) {
+		if (enemies.flag[e] != 1) {
+			continue;
+		}
+		hash.Query(enemies.x[e], enemies.z[e], 1.0f, candidates);
+		candidateCount += candidates.size();
+		for (uint32_t b : candidates) {
+			if (beams.flag[b] == 1 && IsHit(beams, b, enemies, e)) {
+				beams.flag[b] = 0;
+				enemies.flag[e] = 2;
+				hitCount++;
+			}
+		}
+	}
+	return hitCount;
+}
+
+} // namespace
+
+int main() {
+	std::mt19937 random(5);
+	Actors beams = MakeActors(kBeamCount, random);
+	Actors enemies = MakeActors(kEnemyCount, random);
+	SpatialHash hash;
+	hash.Initialize(1.0f);
+	std::vector<uint32_t> candidates;
+
+	// 同じ配置なら総当たりと同じ当たりになる
+	Actors bruteBeams = beams;
+	Actors bruteEnemies = enemies;
+	uint32_t bruteHits = 0;
+	double bruteSeconds =
+	    MeasureSeconds([&] { bruteHits = CollideBruteForce(bruteBeams, bruteEnemies); });
+	Actors hashBeams = beams;
+	Actors hashEnemies = enemies;
+	uint64_t candidateCount = 0;
+	uint32_t hashHits =
+	    CollideSpatialHash(hashBeams, hashEnemies, hash, candidates, candidateCount);
+	bool isSame = bruteHits == hashHits && bruteBeams.flag == hashBeams.flag &&
+	              bruteEnemies.flag == hashEnemies.flag;
+	std::printf(
+	    "brute force:  1 frame %.1f ms, %u hits (%s the spatial hash)\n", bruteSeconds * 1000.0,
+	    bruteHits, isSame ? "same as" : "DIFFERENT from");
+
+	// 毎フレーム全員を少しずつ動かして、登録からやり直す
+	std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+	uint64_t totalHits = 0;
+	candidateCount = 0;
+	double seconds = 0.0;
+	for (uint32_t frame = 0; frame < kFrameCount; frame++) {
+		Actors frameBeams = beams;
+		Actors frameEnemies = enemies;
+		seconds += MeasureSeconds([&] {
+			totalHits +=
+			    CollideSpatialHash(frameBeams, frameEnemies, hash, candidates, candidateCount);
+		});
+		for (uint32_t i = 0; i < kBeamCount; i++) {
+			beams.x[i] += step(random);
+			beams.z[i] += step(random);
+			enemies.x[i] += step(random);
+			enemies.z[i] += step(random);
+		}
+	}
+	std::printf(
+	    "spatial hash: %u frames %.3f ms/frame, %.1f candidates/enemy, %.1f hits/frame\n",
+	    kFrameCount, seconds * 1000.0 / kFrameCount,
+	    double(candidateCount) / (double(kEnemyCount) * kFrameCount),
+	    double(totalHits) / kFrameCount);
+	return isSame ? 0 : 1;
+}
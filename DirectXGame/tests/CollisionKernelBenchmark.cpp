@@ -0,0 +1,137 @@
+#include "CollisionKernel.h"
+#include "SweptCollision.h"
+#include "TestUtility.h"
+#include <bit>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 1回の判定のバッチの件数と、問い合わせの回数
+const uint32_t kBatchSize = 4096;
+const uint32_t kQueryCount = 20000;
+// SweepAABB と比べる回数
+const uint32_t kVerifyCount = 2000;
+const uint32_t kVerifyBatchSize = 13; // 8件と端数が混ざる数
+
+std::mt19937 random(5);
+std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+std::uniform_real_distribution<float> move(-1.5f, 1.5f);
+
+CollisionBatch MakeBatch(uint32_t count, bool isMoving) {
+	CollisionBatch batch;
+	for (uint32_t i = 0; i < count; i++) {
+		Vector3 velocity = isMoving ? Vector3{move(random), 0.0f, move(random)} : Vector3{};
+		batch.Add(i, {position(random), 0.0f, position(random)}, velocity);
+	}
+	return batch;
+}
+
+std::vector<CollisionQuery> MakeQueries(uint32_t count, bool isMoving) {
+	std::vector<CollisionQuery> queries(count);
+	for (CollisionQuery& query : queries) {
+		query = {position(random), position(random), 0.0f, 0.0f, 1.0f};
+		if (isMoving) {
+			query.moveX = move(random);
+			query.moveZ = move(random);
+		}
+	}
+	return queries;
+}
+
+// 元の GameScene と同じ1組ずつの判定（静止時）
+uint32_t CountHitsScalar(const CollisionQuery& query, const CollisionBatch& batch) {
+	uint32_t hitCount = 0;
+	for (uint32_t i = 0; i < batch.Size(); i++) {
+		if (std::abs(query.x - batch.x[i]) < query.radius &&
+		    std::abs(query.z - batch.z[i]) < query.radius) {
+			hitCount++;
+		}
+	}
+	return hitCount;
+}
+
+uint32_t CountHitsKernel(
+    const CollisionQuery& query, const CollisionBatch& batch, std::vector<uint32_t>& hitMask) {
+	TestSweepXZ(query, batch, hitMask);
+	uint32_t hitCount = 0;
+	for (uint32_t mask : hitMask) {
+		hitCount += std::popcount(mask);
+	}
+	return hitCount;
+}
+
+// カーネルの結果が SweepAABB のXZ成分と一致するか
+uint32_t CountMismatches() {
+	uint32_t mismatchCount = 0;
+	std::vector<uint32_t> hitMask;
+	for (uint32_t n = 0; n < kVerifyCount; n++) {
+		bool isMoving = n % 2 == 1;
+		CollisionBatch batch = MakeBatch(kVerifyBatchSize, isMoving);
+		CollisionQuery query = MakeQueries(1, isMoving)[0];
+		// 当たりが混ざるよう近くに寄せる
+		query.x *= 0.1f;
+		query.z *= 0.1f;
+		for (uint32_t i = 0; i < batch.Size(); i++) {
+			batch.x[i] *= 0.1f;
+			batch.z[i] *= 0.1f;
+		}
+		TestSweepXZ(query, batch, hitMask);
+		Vector3 half = {query.radius * 0.5f, query.radius * 0.5f, query.radius * 0.5f};
+		for (uint32_t i = 0; i < batch.Size(); i++) {
+			float t = 0.0f;
+			bool expected = SweepAABB(
+			    MakeAABB({query.x, 0.0f, query.z}, half), {query.moveX, 0.0f, query.moveZ},
+			    MakeAABB({batch.x[i], 0.0f, batch.z[i]}, half),
+			    {batch.moveX[i], 0.0f, batch.moveZ[i]}, t);
+			if (expected != ((hitMask[i / 32] >> (i % 32) & 1) != 0)) {
+				mismatchCount++;
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+} // namespace
+
+int main() {
+	uint32_t mismatchCount = CountMismatches();
+	std::printf(
+	    "kernel: %s, mismatches against SweepAABB %u\n", GetCollisionKernelName(),
+	    mismatchCount);
+
+	std::vector<uint32_t> hitMask;
+	const double kPairs = double(kBatchSize) * kQueryCount;
+	for (bool isMoving : {false, true}) {
+		CollisionBatch batch = MakeBatch(kBatchSize, isMoving);
+		std::vector<CollisionQuery> queries = MakeQueries(kQueryCount, isMoving);
+
+		uint64_t kernelHits = 0;
+		double kernelSeconds = MeasureSeconds([&] {
+			for (const CollisionQuery& query : queries) {
+				kernelHits += CountHitsKernel(query, batch, hitMask);
+			}
+		});
+		std::printf(
+		    "%-7s kernel: %.1f Mpairs/s (%llu hits)\n", isMoving ? "moving" : "static",
+		    kPairs / kernelSeconds / 1.0e6, static_cast<unsigned long long>(kernelHits));
+
+		// 1組ずつの判定は静止時だけ（元のコードと同じ判定）
+		if (!isMoving) {
+			uint64_t scalarHits = 0;
+			double scalarSeconds = MeasureSeconds([&] {
+				for (const CollisionQuery& query : queries) {
+					scalarHits += CountHitsScalar(query, batch);
+				}
+			});
+			std::printf(
+			    "static  scalar: %.1f Mpairs/s (%llu hits)\n", kPairs / scalarSeconds / 1.0e6,
+			    static_cast<unsigned long long>(scalarHits));
+			if (scalarHits != kernelHits) {
+				mismatchCount++;
+			}
+		}
+	}
+	return mismatchCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include "ActorComponents.h"
+#include "ActorSystems.h"
+#include "EcsWorld.h"
+#include "TestUtility.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+// エンティティの数（敵・ビーム・ステージの合計）
+const uint32_t kEntityCount = 100000;
+// 計測するフレーム数
+const uint32_t kFrameCount = 200;
+// 毎フレーム消して作り直す割合
+const uint32_t kChurnPerFrame = kEntityCount / 100;
+
+std::mt19937 randomEngine(1);
+std::uniform_real_distribution<float> positionX(-4.0f, 4.0f);
+std::uniform_real_distribution<float> positionZ(0.0f, 1000.0f);
+
+// ゲームと同じ組み合わせのコンポーネントで作る（半分が敵、4割がビーム、残りがステージ）
+Entity CreateActor(EcsWorld& world, uint32_t index) {
+	TransformComponent transform;
+	transform.translation = {positionX(randomEngine), 0.0f, positionZ(randomEngine)};
+	VelocityComponent velocity;
+	uint32_t kind = index % 10;
+	if (kind < 5) {
+		velocity.linear = {0.1f, 0.0f, -0.1f};
+		velocity.angular.x = -0.1f;
+		return world.Create(
+		    EnemyTag{}, transform, velocity, ColliderComponent{}, RenderableComponent{});
+	}
+	if (kind < 9) {
+		velocity.linear.z = 0.3f;
+		velocity.angular.x = 0.1f;
+		return world.Create(
+		    BeamTag{}, transform, velocity, LifetimeComponent{1.0e9f}, ColliderComponent{},
+		    RenderableComponent{});
+	}
+	velocity.linear.z = -0.1f;
+	return world.Create(StageTag{}, transform, velocity, RenderableComponent{});
+}
+
+// GameSimulation のゲームプレイ中と同じシステムの並び
+void UpdateSystems(EcsWorld& world) {
+	SavePreviousPositionSystem(world);
+	StageScrollSystem(world);
+	BeamMoveSystem(world);
+	LifetimeSystem(world);
+	EnemyMoveSystem(world, 0);
+	EnemyJumpSystem(world);
+	world.FlushDeferred();
+}
+
+} // namespace
+
+int main() {
+	EcsWorld world;
+	std::vector<Entity> entities;
+	entities.reserve(kEntityCount);
+	double createSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kEntityCount; i++) {
+			entities.push_back(CreateActor(world, i));
+		}
+	});
+	std::printf(
+	    "create:  %u entities %.1f ms (%.1f M/s), %zu archetypes\n", kEntityCount,
+	    createSeconds * 1000.0, kEntityCount / createSeconds / 1.0e6, world.GetArchetypeCount());
+
+	double updateSeconds = MeasureSeconds([&] {
+		for (uint32_t frame = 0; frame < kFrameCount; frame++) {
+			UpdateSystems(world);
+		}
+	});
+	std::printf(
+	    "systems: %.3f ms/frame (%.1f M entity updates/s), %zu alive\n",
+	    updateSeconds * 1000.0 / kFrameCount,
+	    double(kEntityCount) * kFrameCount / updateSeconds / 1.0e6, world.Size());
+
+	// 生き残りを集め直し、毎フレーム一部を消して作り直す（ビームの発射と消滅）
+	entities.clear();
+	world.ForEach<TransformComponent>(
+	    [&entities](Entity entity, TransformComponent&) { entities.push_back(entity); });
+	uint32_t next = 0;
+	double churnSeconds = MeasureSeconds([&] {
+		for (uint32_t frame = 0; frame < kFrameCount; frame++) {
+			for (uint32_t i = 0; i < kChurnPerFrame; i++) {
+				size_t slot = randomEngine() % entities.size();
+				if (world.IsAlive(entities[slot])) {
+					world.Destroy(entities[slot]);
+				}
+				entities[slot] = CreateActor(world, next++);
+			}
+			UpdateSystems(world);
+		}
+	});
+	std::printf(
+	    "churn:   %u destroy+create per frame, %.3f ms/frame\n", kChurnPerFrame,
+	    churnSeconds * 1000.0 / kFrameCount);
+
+	// 反復で数えた数と生きている数が合う
+	size_t iterated = 0;
+	world.ForEach<TransformComponent>([&iterated](Entity, TransformComponent&) { iterated++; });
+	return iterated == world.Size() ? 0 : 1;
+}
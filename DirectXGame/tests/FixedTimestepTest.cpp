@@ -0,0 +1,114 @@
+#include "FixedTimestep.h"
+#include "Random.h"
+#include "TestUtility.h"
+#include <cmath>
+
+// 時計を使わない Advance(double) で、ステップ数・処理落ちの切り捨て・補間係数・
+// ステップの終わりの時刻を確かめる（刻み幅は誤差の出ない 2 の累乗分の1秒）
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 1ステップの秒数
+const double kStep = 1.0 / 64.0;
+
+Clock::duration ToDuration(double seconds) {
+	return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+void TestStepCount() {
+	FixedTimestep timestep(kStep, 10);
+	TEST_CHECK(timestep.Advance(0.0) == 0);
+	TEST_CHECK(timestep.Advance(-1.0) == 0);
+	// 1ステップ未満は貯めておき、足りたところで進める
+	TEST_CHECK(timestep.Advance(kStep * 0.75) == 0);
+	TEST_CHECK(timestep.GetAlpha() == 0.75f);
+	TEST_CHECK(timestep.Advance(kStep * 0.5) == 1);
+	TEST_CHECK(timestep.GetAlpha() == 0.25f);
+	TEST_CHECK(timestep.Advance(kStep * 6.75) == 7);
+	TEST_CHECK(timestep.GetAlpha() == 0.0f);
+	TEST_CHECK(timestep.GetDroppedSeconds() == 0.0);
+}
+
+void TestClamp() {
+	// 1フレームで進めるのは4ステップまでで、超えた分は捨てる（端数は補間用に残す）
+	FixedTimestep timestep(kStep, 4);
+	TEST_CHECK(timestep.Advance(kStep * 10.5) == 4);
+	TEST_CHECK(timestep.GetDroppedSeconds() == kStep * 6);
+	TEST_CHECK(timestep.GetAlpha() == 0.5f);
+	// 捨てた後は貯まった分が無いので、次のフレームは普通に進む
+	TEST_CHECK(timestep.Advance(kStep * 1.5) == 2);
+	TEST_CHECK(timestep.GetAlpha() == 0.0f);
+	TEST_CHECK(timestep.Advance(kStep * 4) == 4);
+	TEST_CHECK(timestep.GetDroppedSeconds() == kStep * 6);
+	TEST_CHECK(timestep.Advance(kStep * 100) == 4);
+	TEST_CHECK(timestep.GetDroppedSeconds() == kStep * 102);
+}
+
+void TestAccounting() {
+	// でたらめなフレーム時間でも、進めた時間・捨てた時間・余りの合計は経過時間に等しく、
+	// 余りは常に1ステップ未満
+	FixedTimestep timestep(kStep, 5);
+	Random random(11);
+	double total = 0.0;
+	uint64_t steps = 0;
+	for (int frame = 0; frame < 10000; frame++) {
+		// たまに長く止まる（処理落ち）
+		double elapsed = random.NextBelow(50) == 0 ? random.NextFloat(0.1f, 0.5f)
+		                                           : random.NextFloat(0.0f, 0.04f);
+		total += elapsed;
+		uint32_t frameSteps = timestep.Advance(elapsed);
+		TEST_CHECK(frameSteps <= 5);
+		steps += frameSteps;
+		TEST_CHECK(0.0f <= timestep.GetAlpha() && timestep.GetAlpha() < 1.0f);
+	}
+	double accounted =
+	    steps * kStep + timestep.GetDroppedSeconds() + timestep.GetAlpha() * kStep;
+	TEST_CHECK(std::abs(accounted - total) < 1e-6);
+	TEST_CHECK(timestep.GetDroppedSeconds() > 0.0);
+}
+
+void TestStepEndTimes() {
+	FixedTimestep timestep(kStep, 10);
+	// 最初のステップの終わりを基準に、以降のステップは刻み幅ずつ後で終わる
+	TEST_CHECK(timestep.Advance(kStep * 1.25) == 1);
+	Clock::time_point first = timestep.GetStepEndTime(0);
+	uint32_t stepIndex = 1;
+	Clock::time_point last = first;
+	const double kElapsedSteps[] = {0.5, 3.25, 0.125, 2.0, 7.875};
+	for (double elapsedSteps : kElapsedSteps) {
+		uint32_t steps = timestep.Advance(kStep * elapsedSteps);
+		for (uint32_t i = 0; i < steps; i++, stepIndex++) {
+			Clock::time_point end = timestep.GetStepEndTime(i);
+			// 前のステップより後（前のフレームの最後のステップより後も含む）
+			TEST_CHECK(end > last);
+			// Advance(double) の経過秒数で基準が進むので、刻み幅の格子に乗ったまま
+			Clock::duration offset = end - (first + ToDuration(kStep * stepIndex));
+			TEST_CHECK(std::chrono::abs(offset) < std::chrono::microseconds(1));
+			last = end;
+		}
+	}
+	TEST_CHECK(stepIndex == 15);
+
+	// 捨てたときは、最後のステップが「今 - 余り」で終わり、その前は刻み幅ずつ前
+	TEST_CHECK(timestep.Advance(kStep * 20.5) == 10);
+	// 最初のステップの終わりから、経過秒数の合計（35.5 ステップ） - 1 ステップ後が今
+	Clock::time_point now = first + ToDuration(kStep * 34.5);
+	Clock::duration lastOffset = timestep.GetStepEndTime(9) - (now - ToDuration(kStep * 0.5));
+	TEST_CHECK(std::chrono::abs(lastOffset) < std::chrono::microseconds(1));
+	for (uint32_t i = 1; i < 10; i++) {
+		Clock::duration gap = timestep.GetStepEndTime(i) - timestep.GetStepEndTime(i - 1);
+		TEST_CHECK(std::chrono::abs(gap - ToDuration(kStep)) < std::chrono::microseconds(1));
+	}
+}
+
+} // namespace
+
+int main() {
+	TestStepCount();
+	TestClamp();
+	TestAccounting();
+	TestStepEndTimes();
+	return TestExitCode();
+}
@@ -0,0 +1,38 @@
+#include "FramePacer.h"
+#include "TestUtility.h"
+#include <thread>
+
+// 実際の時計で数秒ずつフレームレートを制限して、フレーム時間のばらつきを出す
+// （OSの眠りの精度や負荷で変わるので、目安として手で実行する）
+
+namespace {
+
+// 1つの目標で回すフレーム数（統計に使う直近のフレーム数と同じ）
+const uint32_t kFrameCount = FramePacer::kHistorySize;
+
+void Measure(double targetRate, std::chrono::microseconds work) {
+	FramePacer pacer(targetRate);
+	for (uint32_t frame = 0; frame <= kFrameCount; frame++) {
+		// フレームの処理の代わりに空回りする
+		auto end = FramePacer::Clock::now() + work;
+		while (FramePacer::Clock::now() < end) {
+		}
+		pacer.Wait();
+	}
+	FramePacer::Stats stats = pacer.GetStats();
+	std::printf(
+	    "%5.0f fps, work %5.2f ms: mean %7.3f ms, stddev %6.3f ms, p99 %7.3f ms, "
+	    "min %7.3f ms, max %7.3f ms, missed %u, oversleep %.3f ms\n",
+	    targetRate, work.count() / 1000.0, stats.meanMs, stats.stdDevMs, stats.p99Ms, stats.minMs,
+	    stats.maxMs, stats.missedDeadlines, stats.oversleepMs);
+}
+
+} // namespace
+
+int main() {
+	for (double targetRate : {60.0, 144.0}) {
+		Measure(targetRate, std::chrono::microseconds(1000));
+		Measure(targetRate, std::chrono::microseconds(5000));
+	}
+	return 0;
+}
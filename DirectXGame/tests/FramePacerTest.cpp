@@ -0,0 +1,152 @@
+#include "FramePacer.h"
+#include "TestUtility.h"
+#include <cmath>
+
+// 決まった時間だけ眠りすぎる仮想の時計で、締め切りの守り方と見積もりを確かめる
+
+namespace {
+
+using Clock = FramePacer::Clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// 目標のフレームレート
+const double kTargetRate = 60.0;
+// 眠ると毎回この分だけ長く眠る
+const Clock::duration kOversleep = milliseconds(2);
+// 空回り1回で進む時間
+const Clock::duration kSpinStep = microseconds(1);
+
+// 仮想の時計（眠る・空回りする・処理するときだけ進む）
+class TestTimer : public FramePacer::Timer {
+public:
+	Clock::time_point Now() override { return now_; }
+	void SleepFor(Clock::duration duration) override {
+		now_ += duration + kOversleep;
+		sleepCount_++;
+	}
+	void Spin() override { now_ += kSpinStep; }
+
+	// フレームの処理に duration かかったことにする
+	void Work(Clock::duration duration) { now_ += duration; }
+
+	uint32_t GetSleepCount() const { return sleepCount_; }
+
+private:
+	Clock::time_point now_ = Clock::time_point() + std::chrono::hours(1);
+	uint32_t sleepCount_ = 0;
+};
+
+// FramePacer と同じ丸め方の1フレームの時間
+Clock::duration Period() {
+	return std::chrono::duration_cast<Clock::duration>(
+	    std::chrono::duration<double>(1.0 / kTargetRate));
+}
+
+void TestNoDrift() {
+	TestTimer timer;
+	FramePacer pacer(kTargetRate, &timer);
+	pacer.Wait();
+	Clock::time_point start = timer.Now();
+
+	// 処理の時間がばらついても、抜ける時刻は最初の時刻から period の倍数に揃う
+	const int kFrameCount = 3000;
+	for (int frame = 1; frame <= kFrameCount; frame++) {
+		timer.Work(microseconds(500 + (frame * 7919) % 9000));
+		pacer.Wait();
+		Clock::time_point deadline = start + Period() * frame;
+		// 見積もりが合うまでの最初の数フレームは眠りすぎて締め切りを過ぎることがある
+		if (frame > 10) {
+			TEST_CHECK(deadline <= timer.Now() && timer.Now() < deadline + kSpinStep);
+		}
+	}
+	TEST_CHECK(timer.GetSleepCount() >= kFrameCount);
+
+	FramePacer::Stats stats = pacer.GetStats();
+	TEST_CHECK(stats.frameCount == FramePacer::kHistorySize);
+	TEST_CHECK(stats.missedDeadlines == 0);
+	TEST_CHECK(std::abs(stats.meanMs - 1000.0 / kTargetRate) < 0.001);
+	TEST_CHECK(stats.stdDevMs < 0.001);
+	TEST_CHECK(stats.p99Ms <= stats.maxMs && stats.minMs <= stats.meanMs);
+}
+
+void TestOversleepConverges() {
+	// 見積もりは初期値（1ms）から眠りすぎの時間へ近づき、そこに留まる
+	TestTimer timer;
+	FramePacer pacer(kTargetRate, &timer);
+	double oversleepMs = std::chrono::duration<double, std::milli>(kOversleep).count();
+	double lastError = std::abs(pacer.GetStats().oversleepMs - oversleepMs);
+	for (int frame = 0; frame < 60; frame++) {
+		timer.Work(milliseconds(1));
+		pacer.Wait();
+		double error = std::abs(pacer.GetStats().oversleepMs - oversleepMs);
+		TEST_CHECK(error <= lastError);
+		lastError = error;
+	}
+	TEST_CHECK(lastError < 0.001);
+}
+
+void TestMissedDeadlines() {
+	TestTimer timer;
+	FramePacer pacer(kTargetRate, &timer);
+	pacer.Wait();
+	for (int frame = 0; frame < 30; frame++) {
+		timer.Work(milliseconds(1));
+		pacer.Wait();
+	}
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 0);
+	Clock::time_point onTime = timer.Now();
+
+	// 1フレーム未満の遅れは、締め切りを前の締め切りから数えたまま取り戻す
+	timer.Work(Period() * 3 / 2);
+	pacer.Wait();
+	TEST_CHECK(timer.Now() == onTime + Period() * 3 / 2);
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 1);
+	timer.Work(milliseconds(1));
+	pacer.Wait();
+	TEST_CHECK(timer.Now() >= onTime + Period() * 2);
+	TEST_CHECK(timer.Now() < onTime + Period() * 2 + kSpinStep);
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 1);
+
+	// 1フレーム以上の遅れは、抜けた時刻から数え直す（遅れを取り戻そうと急がない）
+	Clock::time_point late = timer.Now() + Period() * 5 / 2;
+	timer.Work(Period() * 5 / 2);
+	pacer.Wait();
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 2);
+	timer.Work(milliseconds(1));
+	pacer.Wait();
+	TEST_CHECK(timer.Now() >= late + Period() && timer.Now() < late + Period() + kSpinStep);
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 2);
+
+	// 数え直した後の締め切りも遅れない
+	for (int frame = 2; frame <= 10; frame++) {
+		timer.Work(milliseconds(1));
+		pacer.Wait();
+		TEST_CHECK(timer.Now() >= late + Period() * frame);
+		TEST_CHECK(timer.Now() < late + Period() * frame + kSpinStep);
+	}
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 2);
+}
+
+void TestUnlimited() {
+	// 目標が 0 なら待たない
+	TestTimer timer;
+	FramePacer pacer(0.0, &timer);
+	for (int frame = 0; frame < 10; frame++) {
+		timer.Work(milliseconds(1));
+		pacer.Wait();
+	}
+	TEST_CHECK(timer.GetSleepCount() == 0);
+	TEST_CHECK(pacer.GetStats().missedDeadlines == 0);
+	TEST_CHECK(std::abs(pacer.GetStats().meanMs - 1.0) < 0.001);
+}
+
+} // namespace
+
+int main() {
+	TestNoDrift();
+	TestOversleepConverges();
+	TestMissedDeadlines();
+	TestUnlimited();
+	return TestExitCode();
+}
@@ -0,0 +1,133 @@
+#include "FrameResourceRing.h"
+#include "TestUtility.h"
+#include <cstdint>
+#include <vector>
+
+// 仮想のGPUのタイムラインで、フレームの切り替えとアップロード領域の割り当てを確かめる
+
+namespace {
+
+// 完了値をテストが決める仮想のGPU
+class TestTimeline : public FrameResourceRing::Timeline {
+public:
+	void Signal(uint64_t value) override { signaledValue_ = value; }
+	uint64_t GetCompletedValue() override { return completedValue_; }
+	void WaitForValue(uint64_t value) override {
+		// 待つのは積んだ値までで、既に終わった値を待つことはない
+		TEST_CHECK(value <= signaledValue_);
+		TEST_CHECK(completedValue_ < value);
+		waitedValues_.push_back(value);
+		completedValue_ = value;
+	}
+
+	// GPUが value まで終えたことにする
+	void Complete(uint64_t value) { completedValue_ = value; }
+
+	uint64_t GetSignaledValue() const { return signaledValue_; }
+	const std::vector<uint64_t>& GetWaitedValues() const { return waitedValues_; }
+
+private:
+	uint64_t signaledValue_ = 0;
+	uint64_t completedValue_ = 0;
+	std::vector<uint64_t> waitedValues_;
+};
+
+void TestRotation(uint32_t frameCount) {
+	// 番号はフレーム数で回り、積む値は1ずつ増える
+	TestTimeline timeline;
+	FrameResourceRing ring;
+	ring.Initialize(&timeline, frameCount);
+	TEST_CHECK(ring.GetFrameIndex() == 0);
+	for (uint32_t frame = 1; frame <= 20; frame++) {
+		// GPUが前のフレームまで追いついていれば待たない
+		timeline.Complete(timeline.GetSignaledValue());
+		TEST_CHECK(ring.Advance() == frame % frameCount);
+		TEST_CHECK(ring.GetFrameIndex() == frame % frameCount);
+		TEST_CHECK(ring.GetLastSignaledValue() == frame);
+		TEST_CHECK(timeline.GetSignaledValue() == frame);
+	}
+	// 1フレームだけなら毎フレームそのフレームの完了を待つ（先行しない）
+	TEST_CHECK(ring.GetWaitCount() == (frameCount == 1 ? 20u : 0u));
+	TEST_CHECK(timeline.GetWaitedValues().size() == ring.GetWaitCount());
+}
+
+void TestWaitOnlyForReusedSlot(uint32_t frameCount) {
+	// GPUが全く進まなくても、最初のフレーム数ぶんは待たずに先行する
+	TestTimeline timeline;
+	FrameResourceRing ring;
+	ring.Initialize(&timeline, frameCount);
+	for (uint32_t frame = 1; frame < frameCount; frame++) {
+		ring.Advance();
+	}
+	TEST_CHECK(ring.GetWaitCount() == 0);
+
+	// 次は最初の枠を使い回すので、その枠を使ったフレーム（値 1）だけを待つ
+	ring.Advance();
+	TEST_CHECK(ring.GetFrameIndex() == 0);
+	TEST_CHECK(ring.GetWaitCount() == 1);
+	TEST_CHECK(timeline.GetWaitedValues().back() == 1);
+
+	// 使い回す枠のフレームが終わっていれば、後ろのフレームが終わっていなくても待たない
+	if (frameCount >= 2) {
+		timeline.Complete(2);
+		ring.Advance();
+		TEST_CHECK(ring.GetWaitCount() == 1);
+	}
+
+	// GPUが遅れ続けると、毎フレーム frameCount 前のフレームを待つ
+	for (int i = 0; i < 10; i++) {
+		uint64_t before = ring.GetWaitCount();
+		ring.Advance();
+		uint64_t reused = ring.GetLastSignaledValue() - frameCount + 1;
+		TEST_CHECK(ring.GetWaitCount() == before + 1);
+		TEST_CHECK(timeline.GetWaitedValues().back() == reused);
+		// 待った後も、まだ後ろのフレームはGPUに残っている
+		TEST_CHECK(timeline.GetCompletedValue() + frameCount - 1 == ring.GetLastSignaledValue());
+	}
+
+	ring.WaitIdle();
+	TEST_CHECK(timeline.GetCompletedValue() == ring.GetLastSignaledValue());
+}
+
+void TestUpload() {
+	const size_t kRegionSize = 1024;
+	TestTimeline timeline;
+	FrameResourceRing ring;
+	ring.Initialize(&timeline, 3, kRegionSize);
+
+	for (uint32_t frame = 0; frame < 6; frame++) {
+		size_t base = ring.GetFrameIndex() * kRegionSize;
+		// フレームの最初は領域の先頭から
+		TEST_CHECK(ring.AllocateUpload(100, 16) == base);
+		// アライメントに合わせて詰める
+		TEST_CHECK(ring.AllocateUpload(8, 256) == base + 256);
+		TEST_CHECK(ring.AllocateUpload(1, 1) == base + 264);
+		// 残りに収まらなければ失敗し、使った量は変えない
+		TEST_CHECK(ring.AllocateUpload(kRegionSize, 1) == FrameResourceRing::kInvalidOffset);
+		TEST_CHECK(ring.AllocateUpload(SIZE_MAX, 1) == FrameResourceRing::kInvalidOffset);
+		TEST_CHECK(ring.AllocateUpload(16, 2048) == FrameResourceRing::kInvalidOffset);
+		TEST_CHECK(ring.AllocateUpload(16, 16) == base + 272);
+		// ちょうど使い切るのは成功する
+		TEST_CHECK(ring.AllocateUpload(kRegionSize - 288, 1) == base + 288);
+		TEST_CHECK(ring.AllocateUpload(1, 1) == FrameResourceRing::kInvalidOffset);
+
+		timeline.Complete(timeline.GetSignaledValue());
+		ring.Advance();
+	}
+
+	// アップロード領域が無ければ全て失敗する
+	FrameResourceRing empty;
+	empty.Initialize(&timeline, 2);
+	TEST_CHECK(empty.AllocateUpload(1, 1) == FrameResourceRing::kInvalidOffset);
+}
+
+} // namespace
+
+int main() {
+	for (uint32_t frameCount = 1; frameCount <= FrameResourceRing::kMaxFrameCount; frameCount++) {
+		TestRotation(frameCount);
+		TestWaitOnlyForReusedSlot(frameCount);
+	}
+	TestUpload();
+	return TestExitCode();
+}
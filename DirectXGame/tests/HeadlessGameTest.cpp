@@ -0,0 +1,41 @@
+#include "HeadlessGame.h"
+#include "JobSystem.h"
+#include "TestUtility.h"
+
+namespace {
+
+// ソークテストのステップ数（約10分のプレイ）
+const uint32_t kSoakSteps = 36000;
+
+HeadlessGame::Result RunGame(uint32_t seed, uint32_t steps) {
+	HeadlessGame game;
+	game.Initialize(seed);
+	return game.Run(steps);
+}
+
+} // namespace
+
+int main() {
+	// 同じ種なら同じ結果
+	HeadlessGame::Result first = RunGame(1, kSoakSteps);
+	HeadlessGame::Result second = RunGame(1, kSoakSteps);
+	TEST_CHECK(first.checksum == second.checksum);
+	TEST_CHECK(first.totalScore == second.totalScore);
+	TEST_CHECK(first.games == second.games);
+	// 自動プレイで何ゲームか終わる
+	TEST_CHECK(first.games > 0);
+
+	// 違う種なら違うプレイ
+	TEST_CHECK(RunGame(2, kSoakSteps).checksum != first.checksum);
+
+	// ジョブシステムで更新しても同じ結果
+	JobSystem::GetInstance()->Initialize(3);
+	HeadlessGame::Result parallel = RunGame(1, kSoakSteps);
+	JobSystem::GetInstance()->Finalize();
+	TEST_CHECK(parallel.checksum == first.checksum);
+
+	std::printf(
+	    "%u steps %u games %.0f steps/s\n", first.steps, first.games,
+	    first.steps / first.seconds);
+	return TestExitCode();
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "ImaAdpcm.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// テスト・ベンチマーク用の IMA ADPCM の符号化（ゲームは展開しかしないので、ここだけに置く）
+
+/// <summary>
+/// 符号化した IMA ADPCM
+/// </summary>
+struct ImaAdpcmEncoded {
+	WaveFormat format;
+	std::vector<uint8_t> data;    // data チャンク
+	std::vector<int16_t> decoded; // 符号化したときの復元値（展開の結果と一致するはず）
+};
+
+namespace ImaAdpcmEncoder {
+
+// ステップの大きさ（ImaAdpcm.cpp と同じ規格の表）
+inline const int32_t kStepTable[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+inline const int32_t kIndexTable[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+// 1チャンネルの符号化の途中の状態
+struct ChannelState {
+	int32_t predictor = 0;
+	int32_t index = 0;
+};
+
+// 1サンプルを4ビットに（状態は展開と同じ計算で進める）
+inline uint8_t EncodeSample(ChannelState& state, int32_t sample) {
+	int32_t step = kStepTable[state.index];
+	int32_t diff = sample - state.predictor;
+	uint8_t nibble = 0;
+	if (diff < 0) {
+		nibble = 8;
+		diff = -diff;
+	}
+	if (diff >= step) {
+		nibble |= 4;
+		diff -= step;
+	}
+	if (diff >= step >> 1) {
+		nibble |= 2;
+		diff -= step >> 1;
+	}
+	if (diff >= step >> 2) {
+		nibble |= 1;
+	}
+	int32_t quantized = step >> 3;
+	if (nibble & 1) {
+		quantized += step >> 2;
+	}
+	if (nibble & 2) {
+		quantized += step >> 1;
+	}
+	if (nibble & 4) {
+		quantized += step;
+	}
+	state.predictor =
+	    std::clamp(state.predictor + (nibble & 8 ? -quantized : quantized), -32768, 32767);
+	state.index = std::clamp(state.index + kIndexTable[nibble], 0, 88);
+	return nibble;
+}
+
+} // namespace ImaAdpcmEncoder
+
+/// <summary>
+/// 16ビットのPCMを IMA ADPCM に符号化
+/// 最後のブロックは、残りのフレームをヘッダと8サンプルのグループに収まる分だけの短いブロックにする
+/// （グループに足りない分は最後のサンプルを繰り返して埋めるので、復元値はその分長くなる）。
+/// </summary>
+/// <param name="samples">チャンネル交互の16ビット</param>
+/// <param name="channels">チャンネル数</param>
+/// <param name="sampleRate">周波数</param>
+/// <param name="blockAlign">ブロックのバイト数（チャンネル数 × 4 の倍数）</param>
+inline ImaAdpcmEncoded EncodeImaAdpcm(
+    const std::vector<int16_t>& samples, uint16_t channels, uint32_t sampleRate,
+    uint16_t blockAlign) {
+	using namespace ImaAdpcmEncoder;
+	ImaAdpcmEncoded encoded;
+	WaveFormat& format = encoded.format;
+	format.formatTag = kWaveFormatImaAdpcm;
+	format.channels = channels;
+	format.samplesPerSec = sampleRate;
+	format.blockAlign = blockAlign;
+	format.bitsPerSample = 4;
+	uint32_t blockFrames = GetImaAdpcmBlockFrames(format, blockAlign);
+	format.avgBytesPerSec =
+	    static_cast<uint32_t>(static_cast<uint64_t>(sampleRate) * blockAlign / blockFrames);
+
+	size_t frames = samples.size() / channels;
+	auto sampleAt = [&](size_t frame, uint32_t c) {
+		return samples[std::min(frame, frames - 1) * channels + c];
+	};
+	std::vector<ChannelState> states(channels);
+	for (size_t first = 0; first < frames; first += blockFrames) {
+		// 最後のブロックは必要なグループの数だけ
+		size_t rest = std::min<size_t>(blockFrames, frames - first);
+		size_t groups = (rest - 1 + 7) / 8;
+		size_t blockFramesHere = 1 + groups * 8;
+
+		// ヘッダ：最初のサンプルはそのまま入れる
+		for (uint32_t c = 0; c < channels; c++) {
+			int16_t sample = sampleAt(first, c);
+			states[c].predictor = sample;
+			encoded.data.push_back(static_cast<uint8_t>(sample));
+			encoded.data.push_back(static_cast<uint8_t>(static_cast<uint16_t>(sample) >> 8));
+			encoded.data.push_back(static_cast<uint8_t>(states[c].index));
+			encoded.data.push_back(0);
+		}
+		size_t decodedBase = encoded.decoded.size();
+		encoded.decoded.resize(decodedBase + blockFramesHere * channels);
+		for (uint32_t c = 0; c < channels; c++) {
+			encoded.decoded[decodedBase + c] = sampleAt(first, c);
+		}
+		// 8サンプルのグループをチャンネルごとに交互に
+		for (size_t g = 0; g < groups; g++) {
+			for (uint32_t c = 0; c < channels; c++) {
+				for (uint32_t i = 0; i < 8; i += 2) {
+					size_t frame = 1 + g * 8 + i;
+					uint8_t low = EncodeSample(states[c], sampleAt(first + frame, c));
+					encoded.decoded[decodedBase + frame * channels + c] =
+					    static_cast<int16_t>(states[c].predictor);
+					uint8_t high = EncodeSample(states[c], sampleAt(first + frame + 1, c));
+					encoded.decoded[decodedBase + (frame + 1) * channels + c] =
+					    static_cast<int16_t>(states[c].predictor);
+					encoded.data.push_back(static_cast<uint8_t>(low | high << 4));
+				}
+			}
+		}
+	}
+	return encoded;
+}
+
+/// <summary>
+/// 符号化した IMA ADPCM の WAV ファイルの中身
+/// </summary>
+inline std::vector<uint8_t> MakeImaAdpcmWave(const ImaAdpcmEncoded& encoded) {
+	std::vector<uint8_t> bytes;
+	auto append = [&bytes](uint32_t value, int size) {
+		for (int i = 0; i < size; i++) {
+			bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	};
+	auto appendId = [&bytes](const char* id) {
+		for (int i = 0; i < 4; i++) {
+			bytes.push_back(static_cast<uint8_t>(id[i]));
+		}
+	};
+	const WaveFormat& format = encoded.format;
+	uint32_t dataSize = static_cast<uint32_t>(encoded.data.size());
+	appendId("RIFF");
+	append(4 + 28 + 8 + dataSize + (dataSize & 1), 4);
+	appendId("WAVE");
+	appendId("fmt ");
+	append(20, 4);
+	append(format.formatTag, 2);
+	append(format.channels, 2);
+	append(format.samplesPerSec, 4);
+	append(format.avgBytesPerSec, 4);
+	append(format.blockAlign, 2);
+	append(format.bitsPerSample, 2);
+	append(2, 2); // cbSize
+	append(GetImaAdpcmBlockFrames(format, format.blockAlign), 2);
+	appendId("data");
+	append(dataSize, 4);
+	bytes.insert(bytes.end(), encoded.data.begin(), encoded.data.end());
+	if (dataSize & 1) {
+		bytes.push_back(0);
+	}
+	return bytes;
+}
@@ -0,0 +1,165 @@
+#include "ImaAdpcm.h"
+#include "ImaAdpcmEncoder.h"
+#include "TestUtility.h"
+#include "WaveFile.h"
+#include "WaveStream.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 既知の音を符号化して展開し、誤差とフレーム数を確かめる
+// （最後のブロックが短いファイル、ファイルからの読み込み・ストリーミングも）
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// 周波数が 200Hz から 2000Hz へ上がっていく正弦波（チャンネルごとに位相をずらす）
+std::vector<int16_t> MakeChirp(uint16_t channels, uint32_t sampleRate, uint32_t frames) {
+	std::vector<int16_t> samples(static_cast<size_t>(frames) * channels);
+	double duration = static_cast<double>(frames) / sampleRate;
+	for (uint32_t i = 0; i < frames; i++) {
+		double t = static_cast<double>(i) / sampleRate;
+		// 周波数を時間で積分した位相
+		double cycles = 200.0 * t + 1800.0 / duration * t * t / 2.0;
+		for (uint32_t c = 0; c < channels; c++) {
+			double phase = 2.0 * kPi * cycles + c * 0.7;
+			samples[i * channels + c] =
+			    static_cast<int16_t>(std::lround(12000.0 * std::sin(phase)));
+		}
+	}
+	return samples;
+}
+
+// 元の音と展開した音の信号と誤差の比（dB。first 番目のサンプルから）
+double MeasureSnr(const std::vector<int16_t>& original, const int16_t* decoded, size_t first) {
+	double signal = 0.0;
+	double noise = 0.0;
+	for (size_t i = first; i < original.size(); i++) {
+		double error = static_cast<double>(decoded[i]) - original[i];
+		signal += static_cast<double>(original[i]) * original[i];
+		noise += error * error;
+	}
+	return 10.0 * std::log10(signal / std::max(noise, 1.0));
+}
+
+// ブロックごとに展開する（WaveFile::Open と同じ）
+std::vector<int16_t> Decode(const ImaAdpcmEncoded& encoded) {
+	const WaveFormat& format = encoded.format;
+	uint32_t dataSize = static_cast<uint32_t>(encoded.data.size());
+	std::vector<int16_t> output(
+	    static_cast<size_t>(GetImaAdpcmFrameCount(format, dataSize)) * format.channels);
+	size_t written = 0;
+	for (uint32_t position = 0; position < dataSize; position += format.blockAlign) {
+		uint32_t blockSize = std::min<uint32_t>(format.blockAlign, dataSize - position);
+		TEST_CHECK(written + GetImaAdpcmBlockFrames(format, blockSize) * format.channels <=
+		           output.size());
+		written += DecodeImaAdpcmBlock(
+		               encoded.data.data() + position, blockSize, format, output.data() + written) *
+		           format.channels;
+	}
+	TEST_CHECK(written == output.size());
+	return output;
+}
+
+void TestDecode(uint16_t channels, uint16_t blockAlign, uint32_t shortGroups) {
+	// 最後のブロックがヘッダと shortGroups 個のグループだけになる長さにする
+	WaveFormat format;
+	format.formatTag = kWaveFormatImaAdpcm;
+	format.channels = channels;
+	format.bitsPerSample = 4;
+	format.blockAlign = blockAlign;
+	uint32_t blockFrames = GetImaAdpcmBlockFrames(format, blockAlign);
+	TEST_CHECK(blockFrames == 1 + (blockAlign / (4u * channels) - 1) * 8);
+	const uint32_t kBlocks = 40;
+	uint32_t frames = kBlocks * blockFrames + 1 + shortGroups * 8;
+
+	std::vector<int16_t> original = MakeChirp(channels, 22050, frames);
+	ImaAdpcmEncoded encoded = EncodeImaAdpcm(original, channels, 22050, blockAlign);
+	uint32_t dataSize = static_cast<uint32_t>(encoded.data.size());
+	TEST_CHECK(dataSize == kBlocks * blockAlign + 4u * channels * (1 + shortGroups));
+	TEST_CHECK(GetImaAdpcmFrameCount(encoded.format, dataSize) == frames);
+	TEST_CHECK(
+	    GetImaAdpcmBlockFrames(encoded.format, dataSize % blockAlign) == 1 + shortGroups * 8);
+
+	// 展開は符号化したときの復元値とビット単位で同じ
+	std::vector<int16_t> decoded = Decode(encoded);
+	TEST_CHECK(decoded.size() == original.size());
+	TEST_CHECK(decoded == encoded.decoded);
+
+	// 元の音との差はステップの大きさ程度。最初はステップが最小から始まって音に追いつくまで
+	// 大きくずれるので、その分（kSettleFrames）は除く
+	const size_t kSettleFrames = 64;
+	size_t first = kSettleFrames * channels;
+	double snr = MeasureSnr(original, decoded.data(), first);
+	int32_t maxError = 0;
+	for (size_t i = first; i < original.size(); i++) {
+		maxError = std::max(maxError, std::abs(decoded[i] - original[i]));
+	}
+	std::printf(
+	    "%u ch, block %u, last block %u frames: SNR %.1f dB, max error %d\n", channels,
+	    blockAlign, 1 + shortGroups * 8, snr, maxError);
+	TEST_CHECK(snr > 25.0);
+	// 振幅（12000）の 1/8 より小さい
+	TEST_CHECK(maxError < 1500);
+	// 各ブロックの最初のサンプルはヘッダにそのまま入っている
+	for (uint32_t block = 0; block <= kBlocks; block++) {
+		for (uint32_t c = 0; c < channels; c++) {
+			size_t i = static_cast<size_t>(block) * blockFrames * channels + c;
+			TEST_CHECK(decoded[i] == original[i]);
+		}
+	}
+}
+
+void TestFile() {
+	// ファイルから開くと、展開した16ビットのPCMになる。ストリーミングでも同じ
+	const uint16_t kChannels = 2;
+	const uint16_t kBlockAlign = 1024;
+	std::vector<int16_t> original = MakeChirp(kChannels, 44100, 44100 * 3 + 1 + 8 * 3);
+	ImaAdpcmEncoded encoded = EncodeImaAdpcm(original, kChannels, 44100, kBlockAlign);
+	std::vector<uint8_t> bytes = MakeImaAdpcmWave(encoded);
+	std::string fileName =
+	    (std::filesystem::temp_directory_path() / "ImaAdpcmTest.wav").string();
+	std::ofstream(fileName, std::ios::binary)
+	    .write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+	WaveFile file;
+	TEST_CHECK(file.Open(fileName));
+	TEST_CHECK(file.GetFormat().formatTag == kWaveFormatPCM);
+	TEST_CHECK(file.GetFormat().bitsPerSample == 16);
+	TEST_CHECK(file.GetFormat().channels == kChannels);
+	TEST_CHECK(file.GetData().size() == encoded.decoded.size() * sizeof(int16_t));
+	TEST_CHECK(std::memcmp(
+	               file.GetData().data(), encoded.decoded.data(), file.GetData().size()) == 0);
+
+	WaveStream stream;
+	TEST_CHECK(stream.Open(fileName, false));
+	TEST_CHECK(stream.GetFormat().blockAlign == kChannels * sizeof(int16_t));
+	std::vector<uint8_t> streamed;
+	while (true) {
+		WaveStream::Block block = stream.ReadBlock();
+		streamed.insert(streamed.end(), block.data, block.data + block.size);
+		if (block.endOfStream) {
+			break;
+		}
+	}
+	TEST_CHECK(
+	    streamed == std::vector<uint8_t>(file.GetData().begin(), file.GetData().end()));
+	stream.Close();
+	file.Close();
+	std::filesystem::remove(fileName);
+}
+
+} // namespace
+
+int main() {
+	TestDecode(1, 256, 0);
+	TestDecode(1, 512, 5);
+	TestDecode(2, 1024, 3);
+	TestDecode(6, 24 * 16, 1);
+	TestFile();
+	return TestExitCode();
+}
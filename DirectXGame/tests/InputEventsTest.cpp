@@ -0,0 +1,172 @@
+#include "InputEvents.h"
+#include "TestUtility.h"
+
+// 入力イベントのキューが溢れそうなときに、キー・フォーカスのイベントを失わないかの確認
+
+namespace {
+
+// キー番号（DIK_A・DIK_B と同じ）
+const uint8_t kKeyA = 0x1E;
+const uint8_t kKeyB = 0x30;
+
+InputClock::time_point startTime = InputClock::now();
+
+InputEvent MakeEvent(
+    InputEventType type, int tick, uint8_t code = 0, int32_t x = 0, int32_t y = 0) {
+	InputEvent event;
+	event.time = startTime + std::chrono::microseconds(tick);
+	event.type = type;
+	event.code = code;
+	event.x = x;
+	event.y = y;
+	return event;
+}
+
+// 取り出したイベントの集計
+struct PoppedEvents {
+	int keyDownCount = 0;
+	int keyUpCount = 0;
+	int focusLostCount = 0;
+	int64_t moveX = 0;
+	int64_t moveY = 0;
+	int64_t wheel = 0;
+	bool isTimeOrdered = true;
+};
+
+PoppedEvents PopAll(InputEventQueue& queue) {
+	PoppedEvents popped;
+	InputEvent event;
+	InputClock::time_point lastTime = startTime;
+	while (queue.Pop(InputClock::time_point::max(), event)) {
+		popped.isTimeOrdered = popped.isTimeOrdered && event.time >= lastTime;
+		lastTime = event.time;
+		switch (event.type) {
+		case InputEventType::KeyDown:
+			popped.keyDownCount++;
+			break;
+		case InputEventType::KeyUp:
+			popped.keyUpCount++;
+			break;
+		case InputEventType::FocusLost:
+			popped.focusLostCount++;
+			break;
+		case InputEventType::MouseMove:
+			popped.moveX += event.x;
+			popped.moveY += event.y;
+			break;
+		case InputEventType::MouseWheel:
+			popped.wheel += event.x;
+			break;
+		default:
+			break;
+		}
+	}
+	return popped;
+}
+
+void TestMergeMouseMoves() {
+	// 1ステップの間の速いマウスの動きは1つにまとまる
+	InputEventQueue queue;
+	for (int i = 0; i < 10000; i++) {
+		TEST_CHECK(queue.Push(MakeEvent(InputEventType::MouseMove, i, 0, 3, -1)));
+	}
+	TEST_CHECK(queue.GetSize() == 1);
+	TEST_CHECK(queue.GetDroppedCount() == 0);
+
+	// まとめたイベントは最後の時刻になる（途中の時刻までではまだ取り出さない）
+	InputEvent event;
+	TEST_CHECK(!queue.Pop(startTime + std::chrono::microseconds(5000), event));
+	TEST_CHECK(queue.Pop(startTime + std::chrono::microseconds(9999), event));
+	TEST_CHECK(event.x == 30000 && event.y == -10000);
+}
+
+void TestKeyUpAfterMouseFlood() {
+	// 押した後に移動とホイールが交互に溢れるほど来ても、離したことは失わない
+	InputEventQueue queue;
+	int tick = 0;
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyDown, tick++, kKeyA)));
+	for (int i = 0; i < 5000; i++) {
+		TEST_CHECK(queue.Push(MakeEvent(InputEventType::MouseMove, tick++, 0, 1, 2)));
+		TEST_CHECK(queue.Push(MakeEvent(InputEventType::MouseWheel, tick++, 0, 120)));
+	}
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyUp, tick++, kKeyA)));
+	TEST_CHECK(queue.GetDroppedCount() == 0);
+
+	InputEventState state;
+	state.Advance(queue, startTime + std::chrono::microseconds(tick));
+	TEST_CHECK(!state.PushKey(kKeyA));
+	TEST_CHECK(state.TriggerKey(kKeyA) && state.ReleaseKey(kKeyA));
+	// 移動量は足してまとめるので、捨てた分は無い
+	TEST_CHECK(state.GetMouseMoveX() == 5000 && state.GetMouseMoveY() == 10000);
+	TEST_CHECK(state.GetWheel() == 5000 * 120);
+	TEST_CHECK(queue.GetSize() == 0);
+}
+
+void TestKeysBetweenMouseMoves() {
+	// キーとマウスが交互に容量を超えて来ると、マウスの移動を減らしてキーを積む
+	// （キー・フォーカスのイベントは容量に収まる数）
+	InputEventQueue queue;
+	int tick = 0;
+	const int kRepeat = 120;
+	for (int i = 0; i < kRepeat; i++) {
+		uint8_t key = i % 2 == 0 ? kKeyA : kKeyB;
+		queue.Push(MakeEvent(InputEventType::MouseMove, tick++, 0, 1, -1));
+		TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyDown, tick++, key)));
+		queue.Push(MakeEvent(InputEventType::MouseMove, tick++, 0, 1, -1));
+		TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyUp, tick++, key)));
+	}
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::FocusLost, tick++)));
+	TEST_CHECK(queue.GetSize() <= InputEventQueue::kCapacity);
+
+	PoppedEvents popped = PopAll(queue);
+	TEST_CHECK(popped.keyDownCount == kRepeat && popped.keyUpCount == kRepeat);
+	TEST_CHECK(popped.focusLostCount == 1);
+	TEST_CHECK(popped.moveX == 2 * kRepeat && popped.moveY == -2 * kRepeat);
+	TEST_CHECK(popped.isTimeOrdered);
+	TEST_CHECK(queue.GetDroppedCount() == 0);
+}
+
+void TestFocusLostWhenFullOfKeys() {
+	// キーのイベントだけで満杯なら新しいキーは捨てるが、フォーカスを失ったことは
+	// 最後のイベントの代わりに積む（離したことを捨てた A も、押したままにならない）
+	InputEventQueue queue;
+	int tick = 0;
+	for (uint32_t i = 0; i < InputEventQueue::kCapacity / 2 - 1; i++) {
+		queue.Push(MakeEvent(InputEventType::KeyDown, tick++, kKeyA));
+		queue.Push(MakeEvent(InputEventType::KeyUp, tick++, kKeyA));
+	}
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyDown, tick++, kKeyB)));
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::KeyDown, tick++, kKeyA)));
+	TEST_CHECK(!queue.Push(MakeEvent(InputEventType::KeyUp, tick++, kKeyA)));
+	// 満杯でもマウスの移動は捨てるだけで、キーを押し出さない
+	TEST_CHECK(!queue.Push(MakeEvent(InputEventType::MouseMove, tick++, 0, 1, 1)));
+	TEST_CHECK(queue.Push(MakeEvent(InputEventType::FocusLost, tick++)));
+	TEST_CHECK(queue.GetSize() == InputEventQueue::kCapacity);
+
+	InputEventState state;
+	state.Advance(queue, startTime + std::chrono::microseconds(tick));
+	TEST_CHECK(!state.PushKey(kKeyA) && !state.PushKey(kKeyB));
+	TEST_CHECK(queue.GetDroppedCount() == 3);
+}
+
+void TestTimeOrder() {
+	// 時刻が戻るイベントは前のイベントと同時に起きたことにする
+	InputEventQueue queue;
+	queue.Push(MakeEvent(InputEventType::KeyDown, 100, kKeyA));
+	queue.Push(MakeEvent(InputEventType::KeyUp, 50, kKeyA));
+	InputEvent event;
+	TEST_CHECK(queue.Pop(startTime + std::chrono::microseconds(100), event));
+	TEST_CHECK(queue.Pop(startTime + std::chrono::microseconds(100), event));
+	TEST_CHECK(event.type == InputEventType::KeyUp);
+}
+
+} // namespace
+
+int main() {
+	TestMergeMouseMoves();
+	TestKeyUpAfterMouseFlood();
+	TestKeysBetweenMouseMoves();
+	TestFocusLostWhenFullOfKeys();
+	TestTimeOrder();
+	return TestExitCode();
+}
@@ -0,0 +1,74 @@
+#include "JobSystem.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 空のジョブの数（1つの親に kJobsPerRoot ずつぶら下げる）
+const uint32_t kEmptyJobCount = 200000;
+const uint32_t kJobsPerRoot = 1000;
+// ParallelFor の要素数と繰り返し回数
+const uint32_t kElementCount = 1 << 22;
+const uint32_t kParallelForRepeat = 20;
+
+void Transform(std::vector<float>& data, uint32_t begin, uint32_t end) {
+	for (uint32_t i = begin; i < end; i++) {
+		data[i] = std::sqrt(data[i] * 1.5f + 0.25f);
+	}
+}
+
+} // namespace
+
+int main() {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	std::vector<float> data(kElementCount, 1.0f);
+
+	// 分割しない場合
+	double serialSeconds = MeasureSeconds([&data] {
+		for (uint32_t repeat = 0; repeat < kParallelForRepeat; repeat++) {
+			Transform(data, 0, kElementCount);
+		}
+	});
+	std::printf(
+	    "serial:             parallel_for %.2f ms\n", serialSeconds * 1000.0 / kParallelForRepeat);
+
+	// 2スレッド（メイン＋ワーカー1つ）から、ハードウェアのスレッド数まで倍々に増やす
+	uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (uint32_t threads = 2; threads <= std::max(hardware, 2u); threads *= 2) {
+		jobSystem->Initialize(threads - 1);
+
+		double parallelSeconds = MeasureSeconds([&] {
+			for (uint32_t repeat = 0; repeat < kParallelForRepeat; repeat++) {
+				jobSystem->ParallelFor(0, kElementCount, [&data](uint32_t begin, uint32_t end) {
+					Transform(data, begin, end);
+				});
+			}
+		});
+
+		std::atomic<uint32_t> counter{0};
+		double jobSeconds = MeasureSeconds([&] {
+			for (uint32_t n = 0; n < kEmptyJobCount / kJobsPerRoot; n++) {
+				JobSystem::Job* root = jobSystem->CreateJob([] {});
+				for (uint32_t i = 0; i < kJobsPerRoot; i++) {
+					jobSystem->Run(jobSystem->CreateJob([&counter] { counter++; }, root));
+				}
+				jobSystem->Run(root);
+				jobSystem->Wait(root);
+			}
+		});
+		jobSystem->Finalize();
+
+		std::printf(
+		    "%2u threads:         parallel_for %.2f ms (%.2fx), empty job %.0f ns/job\n", threads,
+		    parallelSeconds * 1000.0 / kParallelForRepeat, serialSeconds / parallelSeconds,
+		    jobSeconds * 1.0e9 / kEmptyJobCount);
+		if (counter != kEmptyJobCount) {
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,191 @@
+#include "JobSystem.h"
+#include "TestUtility.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 競合のある状態で正しく動くかの確認（ThreadSanitizer でも動かせるよう、計測はしない）
+// 例: cmake -DCMAKE_CXX_FLAGS=-fsanitize=thread -DCMAKE_BUILD_TYPE=RelWithDebInfo
+
+namespace {
+
+// 入れ子のジョブの木（3分木、深さ6で 1093 個）
+const int kTreeDepth = 6;
+const int kTreeJobCount = 1093;
+// 繰り返しの回数
+const int kRepeatCount = 50;
+// ParallelFor の範囲
+const uint32_t kRangeSize = 100000;
+// 同時に生きているジョブの数（スレッドごとのジョブの数の3倍）
+const uint32_t kManyJobCount = JobSystem::kMaxJobsPerThread * 3;
+
+std::atomic<int> jobCounter{0};
+
+// 親の子として3つずつ子を投入していく
+void SpawnTree(JobSystem* jobSystem, JobSystem::Job* parent, int depth) {
+	jobCounter++;
+	if (depth == 0) {
+		return;
+	}
+	for (int i = 0; i < 3; i++) {
+		jobSystem->Run(jobSystem->CreateJob(
+		    [jobSystem, parent, depth] { SpawnTree(jobSystem, parent, depth - 1); }, parent));
+	}
+}
+
+// 子の完了をジョブの中で待つ木（待つ間に他のジョブを実行する）
+void WaitTree(JobSystem* jobSystem, int depth) {
+	jobCounter++;
+	if (depth == 0) {
+		return;
+	}
+	JobSystem::Job* root = jobSystem->CreateJob([] {});
+	for (int i = 0; i < 3; i++) {
+		jobSystem->Run(
+		    jobSystem->CreateJob([jobSystem, depth] { WaitTree(jobSystem, depth - 1); }, root));
+	}
+	jobSystem->Run(root);
+	jobSystem->Wait(root);
+}
+
+// 全ての番号がちょうど1回ずつ処理されたか
+bool IsEachOnce(const std::vector<std::atomic<int>>& hits) {
+	for (const std::atomic<int>& hit : hits) {
+		if (hit.load() != 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// root の子として、スレッドごとのジョブの数より多くのジョブを投入する
+// （root も子も終わるまで生きているので、確保は一周したところで生きているジョブを飛ばし、
+// 空きが無くなれば実行待ちのジョブを実行して空くのを待つ）
+void SpawnMany(JobSystem* jobSystem, JobSystem::Job* root, std::atomic<int>& count) {
+	for (uint32_t i = 0; i < kManyJobCount; i++) {
+		jobSystem->Run(jobSystem->CreateJob([&count] { count++; }, root));
+	}
+}
+
+void TestManyLiveJobs(JobSystem* jobSystem) {
+	// メインスレッドから
+	std::atomic<int> count{0};
+	JobSystem::Job* root = jobSystem->CreateJob([] {});
+	SpawnMany(jobSystem, root, count);
+	jobSystem->Run(root);
+	jobSystem->Wait(root);
+	TEST_CHECK(count == int(kManyJobCount));
+
+	// ワーカーで動くジョブの中から（ワーカーのジョブの領域を使う）
+	count = 0;
+	root = jobSystem->CreateJob([] {});
+	for (int i = 0; i < 2; i++) {
+		JobSystem::Job* spawner = jobSystem->CreateJob(
+		    [jobSystem, root, &count] { SpawnMany(jobSystem, root, count); }, root);
+		jobSystem->Run(spawner);
+	}
+	jobSystem->Run(root);
+	jobSystem->Wait(root);
+	TEST_CHECK(count == int(kManyJobCount * 2));
+
+	// ジョブシステムの外のスレッドから（共有の領域を使う）
+	count = 0;
+	std::thread external([jobSystem, &count] {
+		JobSystem::Job* externalRoot = jobSystem->CreateJob([] {});
+		SpawnMany(jobSystem, externalRoot, count);
+		jobSystem->Run(externalRoot);
+		jobSystem->Wait(externalRoot);
+	});
+	external.join();
+	TEST_CHECK(count == int(kManyJobCount));
+}
+
+void TestUninitialized() {
+	// 初期化前はその場で実行する
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	uint64_t sum = 0;
+	jobSystem->ParallelFor(0, 1000, [&sum](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; i++) {
+			sum += i;
+		}
+	});
+	JobSystem::Job* job = jobSystem->CreateJob([&sum] { sum++; });
+	jobSystem->Run(job);
+	jobSystem->Wait(job);
+	TEST_CHECK(sum == 499501);
+}
+
+void TestWorkers(uint32_t workerCount) {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(workerCount);
+
+	for (int repeat = 0; repeat < kRepeatCount; repeat++) {
+		// 親子の数え上げ：root は全ての子孫が終わるまで完了しない
+		jobCounter = 0;
+		JobSystem::Job* root = jobSystem->CreateJob([] {});
+		SpawnTree(jobSystem, root, kTreeDepth);
+		jobSystem->Run(root);
+		jobSystem->Wait(root);
+		TEST_CHECK(jobCounter == kTreeJobCount);
+
+		// ジョブの中での待ち
+		jobCounter = 0;
+		WaitTree(jobSystem, kTreeDepth);
+		TEST_CHECK(jobCounter == kTreeJobCount);
+
+		// 細かい粒度で盗み合う ParallelFor（全ての番号が1回ずつ）
+		std::vector<std::atomic<int>> hits(kRangeSize);
+		jobSystem->ParallelFor(
+		    0, kRangeSize,
+		    [&hits](uint32_t begin, uint32_t end) {
+			    for (uint32_t i = begin; i < end; i++) {
+				    hits[i]++;
+			    }
+		    },
+		    7);
+		TEST_CHECK(IsEachOnce(hits));
+	}
+
+	// ジョブの中の ParallelFor（入れ子）
+	std::vector<std::atomic<int>> nestedHits(kRangeSize);
+	jobSystem->ParallelFor(0, 100, [jobSystem, &nestedHits](uint32_t begin, uint32_t end) {
+		for (uint32_t block = begin; block < end; block++) {
+			uint32_t blockSize = kRangeSize / 100;
+			jobSystem->ParallelFor(
+			    block * blockSize, (block + 1) * blockSize,
+			    [&nestedHits](uint32_t first, uint32_t last) {
+				    for (uint32_t i = first; i < last; i++) {
+					    nestedHits[i]++;
+				    }
+			    });
+		}
+	});
+	TEST_CHECK(IsEachOnce(nestedHits));
+
+	// ジョブシステムの外のスレッドからの投入と待ち
+	std::atomic<int> externalCount{0};
+	std::thread external([jobSystem, &externalCount] {
+		for (int i = 0; i < 2000; i++) {
+			JobSystem::Job* job = jobSystem->CreateJob([&externalCount] { externalCount++; });
+			jobSystem->Run(job);
+			jobSystem->Wait(job);
+		}
+	});
+	external.join();
+	TEST_CHECK(externalCount == 2000);
+
+	TestManyLiveJobs(jobSystem);
+
+	jobSystem->Finalize();
+}
+
+} // namespace
+
+int main() {
+	TestUninitialized();
+	// ハードウェアのスレッド数に関わらず、ワーカーが多い状態も試す
+	for (uint32_t workerCount : {1u, 3u, 7u}) {
+		TestWorkers(workerCount);
+	}
+	return TestExitCode();
+}
@@ -0,0 +1,161 @@
+#include "ObjectPool.h"
+#include "Random.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <vector>
+
+// 世代付きハンドルのプールの確認
+// （削除後の古いハンドル、空きスロットの再利用、世代の一周、生存中のオブジェクトの走査）
+
+namespace {
+
+// 作られた回数を数えるオブジェクト
+struct Counted {
+	static inline int constructCount = 0;
+	int value = 0;
+	Counted() { constructCount++; }
+};
+
+using Pool = ObjectPool<Counted>;
+
+void TestStaleHandles() {
+	Pool pool;
+	Pool::Handle a = pool.Spawn();
+	Pool::Handle b = pool.Spawn();
+	Pool::Handle c = pool.Spawn();
+	pool.Get(a)->value = 1;
+	pool.Get(b)->value = 2;
+	pool.Get(c)->value = 3;
+	TEST_CHECK(pool.Size() == 3);
+
+	// 削除したハンドルは無効になり、2回目の削除は失敗する
+	TEST_CHECK(pool.Despawn(a));
+	TEST_CHECK(!pool.IsAlive(a));
+	TEST_CHECK(pool.Get(a) == nullptr);
+	TEST_CHECK(!pool.Despawn(a));
+	TEST_CHECK(pool.Size() == 2);
+	// 末尾と入れ替えても、残りのハンドルは同じオブジェクトを指す
+	TEST_CHECK(pool.Get(b)->value == 2 && pool.Get(c)->value == 3);
+
+	// 同じスロットを再利用しても、前の世代のハンドルは無効のまま
+	Pool::Handle d = pool.Spawn();
+	TEST_CHECK(d.index == a.index && d.generation == a.generation + 1);
+	TEST_CHECK(!pool.IsAlive(a) && pool.IsAlive(d));
+	TEST_CHECK(!pool.Despawn(a));
+	TEST_CHECK(pool.IsAlive(d));
+
+	// 範囲外・既定のハンドルも無効
+	TEST_CHECK(!pool.IsAlive(Pool::Handle{}));
+	TEST_CHECK(!pool.IsAlive({100, 0}));
+	TEST_CHECK(pool.Get({100, 0}) == nullptr);
+}
+
+void TestFreeListReuse() {
+	Pool pool;
+	std::vector<Pool::Handle> handles;
+	for (int i = 0; i < 8; i++) {
+		handles.push_back(pool.Spawn());
+	}
+	int constructed = Counted::constructCount;
+
+	// 空きスロットは最後に空いたものから使い、スロットも詰めた配列も増やさない
+	pool.Despawn(handles[2]);
+	pool.Despawn(handles[5]);
+	pool.Despawn(handles[0]);
+	TEST_CHECK(pool.Spawn().index == handles[0].index);
+	TEST_CHECK(pool.Spawn().index == handles[5].index);
+	TEST_CHECK(pool.Spawn().index == handles[2].index);
+	TEST_CHECK(pool.Spawn().index == 8);
+	// 削除済みの領域は作り直さずに再利用する（9個目の分だけ作る）
+	TEST_CHECK(Counted::constructCount <= constructed + 2);
+	TEST_CHECK(pool.Size() == 9);
+}
+
+void TestGenerationWrap() {
+	// 世代が一周したスロットは使わなくするので、一周前のハンドルは有効に戻らない
+	ObjectPool<int, uint8_t> pool;
+	using Handle = ObjectPool<int, uint8_t>::Handle;
+	Handle first = pool.Spawn();
+	Handle handle = first;
+	for (int i = 0; i < 255; i++) {
+		TEST_CHECK(pool.Despawn(handle));
+		handle = pool.Spawn();
+		TEST_CHECK(handle.index == first.index);
+	}
+	TEST_CHECK(handle.generation == 255);
+	TEST_CHECK(pool.GetRetiredCount() == 0);
+
+	TEST_CHECK(pool.Despawn(handle));
+	TEST_CHECK(pool.GetRetiredCount() == 1);
+	TEST_CHECK(!pool.IsAlive(first) && !pool.IsAlive(handle));
+	Handle next = pool.Spawn();
+	TEST_CHECK(next.index != first.index);
+	TEST_CHECK(!pool.IsAlive(first));
+	TEST_CHECK(!pool.Despawn(first));
+	TEST_CHECK(pool.IsAlive(next) && pool.Size() == 1);
+}
+
+void TestIteration() {
+	// でたらめな生成・削除を、生存中のハンドルの一覧と比べる
+	Pool pool;
+	Random random(5);
+	std::vector<Pool::Handle> alive;
+	std::vector<Pool::Handle> dead;
+	int nextValue = 0;
+	for (int i = 0; i < 20000; i++) {
+		if (alive.empty() || random.NextBelow(5) < 3) {
+			Pool::Handle handle = pool.Spawn();
+			TEST_CHECK(pool.IsAlive(handle));
+			pool.Get(handle)->value = nextValue++;
+			alive.push_back(handle);
+		} else {
+			size_t victim = random.NextBelow(static_cast<uint32_t>(alive.size()));
+			TEST_CHECK(pool.Despawn(alive[victim]));
+			dead.push_back(alive[victim]);
+			alive[victim] = alive.back();
+			alive.pop_back();
+		}
+		if (i % 1000 != 0) {
+			continue;
+		}
+
+		// 範囲forは生存中のものだけをちょうど1回ずつ回る
+		TEST_CHECK(pool.Size() == alive.size());
+		std::vector<int> expected;
+		for (const Pool::Handle& handle : alive) {
+			expected.push_back(pool.Get(handle)->value);
+		}
+		std::vector<int> visited;
+		for (const Counted& object : pool) {
+			visited.push_back(object.value);
+		}
+		std::sort(expected.begin(), expected.end());
+		std::sort(visited.begin(), visited.end());
+		TEST_CHECK(visited == expected);
+
+		// 詰めた配列の番号からのハンドルは同じオブジェクトを指す
+		for (size_t dense = 0; dense < pool.Size(); dense++) {
+			TEST_CHECK(pool.Get(pool.GetHandle(dense)) == &pool[dense]);
+		}
+		for (const Pool::Handle& handle : dead) {
+			TEST_CHECK(!pool.IsAlive(handle));
+		}
+	}
+
+	pool.Clear();
+	TEST_CHECK(pool.Size() == 0);
+	TEST_CHECK(pool.begin() == pool.end());
+	for (const Pool::Handle& handle : alive) {
+		TEST_CHECK(!pool.IsAlive(handle));
+	}
+}
+
+} // namespace
+
+int main() {
+	TestStaleHandles();
+	TestFreeListReuse();
+	TestGenerationWrap();
+	TestIteration();
+	return TestExitCode();
+}
@@ -0,0 +1,63 @@
+#include "Random.h"
+#include "TestUtility.h"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// 生成する個数
+const uint32_t kValueCount = 50000000;
+// まとめて生成するときの1回の個数
+const uint32_t kFillSize = 4096;
+
+void Print(const char* name, double seconds) {
+	std::printf("%-16s %.2f ns/value\n", name, seconds / kValueCount * 1.0e9);
+}
+
+} // namespace
+
+int main() {
+	// 最適化で消されないよう全て足し込む
+	uint32_t sum = 0;
+	srand(1);
+	double randSeconds = MeasureSeconds([&sum] {
+		for (uint32_t i = 0; i < kValueCount; i++) {
+			sum += static_cast<uint32_t>(rand());
+		}
+	});
+	Print("rand()", randSeconds);
+
+	Random random(1);
+	double nextSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kValueCount; i++) {
+			sum += random.NextU32();
+		}
+	});
+	Print("NextU32", nextSeconds);
+
+	double belowSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kValueCount; i++) {
+			sum += random.NextBelow(80);
+		}
+	});
+	Print("NextBelow(80)", belowSeconds);
+
+	double floatSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kValueCount; i++) {
+			sum += random.NextFloat() < 0.5f ? 1 : 0;
+		}
+	});
+	Print("NextFloat", floatSeconds);
+
+	std::vector<uint32_t> buffer(kFillSize);
+	double fillSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kValueCount / kFillSize; i++) {
+			random.Fill(buffer.data(), kFillSize);
+			sum += buffer[i % kFillSize];
+		}
+	});
+	Print("Fill", fillSeconds);
+
+	std::printf("kernel %s (checksum %08x)\n", GetRandomKernelName(), sum);
+	return 0;
+}
@@ -0,0 +1,143 @@
+#include "Random.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+// 統計的な確認は種を固定しているので、結果は毎回同じ（たまたま落ちることはない）
+
+namespace {
+
+const int kSampleCount = 1000000;
+
+// 一様な分布からのカイ二乗値
+double ChiSquare(Random& random, uint32_t bound) {
+	std::vector<long> counts(bound);
+	for (int i = 0; i < kSampleCount; i++) {
+		counts[random.NextBelow(bound)]++;
+	}
+	double expected = double(kSampleCount) / bound;
+	double chi = 0.0;
+	for (long count : counts) {
+		chi += (count - expected) * (count - expected) / expected;
+	}
+	return chi;
+}
+
+void TestDeterminism() {
+	// 種とストリームが同じなら同じ列、ストリームが違えば別の列
+	TEST_CHECK(Random(5, 1) == Random(5, 1));
+	TEST_CHECK(!(Random(5, 1) == Random(5, 2)));
+	TEST_CHECK(!(Random(5, 1) == Random(6, 1)));
+
+	// Split は元の列を返し、自身は Jump した列になる
+	Random random(3);
+	Random jumped = random;
+	jumped.Jump();
+	Random split = random.Split();
+	TEST_CHECK(split == Random(3));
+	TEST_CHECK(random == jumped);
+}
+
+void TestFill() {
+	// out[4 * i + j] は j 回 Jump した列の i 番目（端数も含め、SIMD の有無で変わらない）
+	for (size_t count : {0, 1, 3, 4, 7, 1000, 1001}) {
+		Random random(7, 3);
+		Random lanes[4];
+		lanes[0] = random;
+		for (int j = 1; j < 4; j++) {
+			lanes[j] = lanes[j - 1];
+			lanes[j].Jump();
+		}
+		const uint32_t kGuard = 0xdeadbeef;
+		std::vector<uint32_t> out(count + 1, kGuard);
+		random.Fill(out.data(), count);
+		TEST_CHECK(out[count] == kGuard);
+		bool isSame = true;
+		for (size_t i = 0; i < (count + 3) / 4 * 4; i += 4) {
+			for (size_t j = 0; j < 4; j++) {
+				uint32_t value = lanes[j].NextU32();
+				if (i + j < count && out[i + j] != value) {
+					isSame = false;
+				}
+			}
+		}
+		TEST_CHECK(isSame);
+		TEST_CHECK(random == lanes[0]);
+	}
+}
+
+void TestDistribution() {
+	// カイ二乗（有意水準 0.001 の棄却域: 自由度9で 27.88、自由度79で 124.8）
+	Random random10(1);
+	TEST_CHECK(ChiSquare(random10, 10) < 27.88);
+	Random random80(2);
+	TEST_CHECK(ChiSquare(random80, 80) < 124.8);
+
+	// 各ビットの 0 と 1 の偏り（標準正規の z が 5 未満）
+	Random bitRandom(3);
+	long bits[32] = {};
+	for (int i = 0; i < kSampleCount; i++) {
+		uint32_t value = bitRandom.NextU32();
+		for (int b = 0; b < 32; b++) {
+			bits[b] += value >> b & 1;
+		}
+	}
+	double worst = 0.0;
+	for (long count : bits) {
+		double z = std::abs(count - kSampleCount / 2.0) / std::sqrt(kSampleCount / 4.0);
+		worst = std::max(worst, z);
+	}
+	TEST_CHECK(worst < 5.0);
+
+	// [0, 1) の実数の範囲・平均・分散
+	Random floatRandom(4);
+	double sum = 0.0;
+	double sumSquares = 0.0;
+	bool isInRange = true;
+	for (int i = 0; i < kSampleCount; i++) {
+		float value = floatRandom.NextFloat();
+		isInRange = isInRange && value >= 0.0f && value < 1.0f;
+		sum += value;
+		sumSquares += value * value;
+	}
+	double mean = sum / kSampleCount;
+	double variance = sumSquares / kSampleCount - mean * mean;
+	TEST_CHECK(isInRange);
+	TEST_CHECK(std::abs(mean - 0.5) < 0.002);
+	TEST_CHECK(std::abs(variance - 1.0 / 12.0) < 0.001);
+
+	// [min, max] の整数（両端を含み、範囲の全体も扱える）
+	Random intRandom(5);
+	bool isIntInRange = true;
+	bool hasMin = false;
+	bool hasMax = false;
+	for (int i = 0; i < 100000; i++) {
+		int value = intRandom.NextInt(-3, 3);
+		isIntInRange = isIntInRange && value >= -3 && value <= 3;
+		hasMin = hasMin || value == -3;
+		hasMax = hasMax || value == 3;
+	}
+	TEST_CHECK(isIntInRange && hasMin && hasMax);
+	intRandom.NextInt(INT_MIN, INT_MAX);
+
+	// Jump した列と元の列が同じ値を出す回数は偶然程度（100万回で期待値は 0.0002）
+	Random original(9);
+	Random jumped = original;
+	jumped.Jump();
+	int equalCount = 0;
+	for (int i = 0; i < kSampleCount; i++) {
+		equalCount += original.NextU32() == jumped.NextU32() ? 1 : 0;
+	}
+	TEST_CHECK(equalCount <= 2);
+}
+
+} // namespace
+
+int main() {
+	TestDeterminism();
+	TestFill();
+	TestDistribution();
+	return TestExitCode();
+}
@@ -0,0 +1,56 @@
+#include "HeadlessGame.h"
+#include "TestUtility.h"
+
+namespace {
+
+// 記録するステップ数（約3分のプレイ）
+const uint32_t kRecordSteps = 10800;
+
+HeadlessGame::Result Replay(const InputRecording& recording) {
+	HeadlessGame game;
+	game.InitializeReplay(&recording);
+	return game.RunReplay();
+}
+
+} // namespace
+
+int main() {
+	// 自動プレイを記録する
+	InputRecording recording;
+	HeadlessGame::Result recorded;
+	{
+		HeadlessGame game;
+		game.InitializeRecording(7, &recording);
+		recorded = game.Run(kRecordSteps);
+	}
+	TEST_CHECK(recording.GetStepCount() == kRecordSteps);
+	TEST_CHECK(recording.GetChecksum() == recorded.checksum);
+
+	// 保存して読み直した記録を再生すると、同じ最後の状態になる
+	InputRecording loaded;
+	TEST_CHECK(loaded.Deserialize(recording.Serialize()));
+	HeadlessGame::Result replayed = Replay(loaded);
+	TEST_CHECK(!replayed.isReplayMismatch);
+	TEST_CHECK(replayed.steps == kRecordSteps);
+	TEST_CHECK(replayed.checksum == recorded.checksum);
+	TEST_CHECK(replayed.totalScore == recorded.totalScore);
+
+	// 途中で1秒だけ何も押さなかった記録は、チェックサムが合わずにずれが分かる
+	InputRecording changed;
+	changed.Reset(recording.GetSeed());
+	for (uint32_t step = 0; step < kRecordSteps; step++) {
+		GameButtonMask buttons = recording.GetButtons(step);
+		if (step >= kRecordSteps / 2 && step < kRecordSteps / 2 + 60) {
+			buttons = 0;
+		}
+		changed.Append(buttons);
+	}
+	changed.SetChecksum(recording.GetChecksum());
+	TEST_CHECK(Replay(changed).isReplayMismatch);
+
+	// チェックサムの無い記録は確かめられないので、ずれとは言わない
+	changed.SetChecksum(0);
+	TEST_CHECK(!Replay(changed).isReplayMismatch);
+
+	return TestExitCode();
+}
@@ -0,0 +1,187 @@
+#include "AudioMixer.h"
+#include "Resampler.h"
+#include "TestUtility.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// 窓付き sinc の周波数変換を、同じフィルターを double で直接計算した結果と比べる
+// （ミキサーで使う 44.1k → 48k と 48k → 22.05k）
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+// フィルターの形（Resampler.cpp と同じ）
+const double kCutoff = 0.9;
+const double kKaiserBeta = 8.0;
+// 正弦波の振幅
+const double kAmplitude = 0.5;
+// 音源のフレーム数
+const uint32_t kSourceFrames = 8192;
+
+// float のモノラルの正弦波
+struct TestSound {
+	std::vector<float> samples;
+	WaveView view;
+};
+
+TestSound MakeSine(uint32_t sampleRate, double frequency, uint32_t frames) {
+	TestSound sound;
+	sound.samples.resize(frames);
+	for (uint32_t i = 0; i < frames; i++) {
+		sound.samples[i] =
+		    static_cast<float>(kAmplitude * std::sin(2.0 * kPi * frequency * i / sampleRate));
+	}
+	WaveFormat& format = sound.view.format;
+	format.formatTag = kWaveFormatFloat;
+	format.channels = 1;
+	format.samplesPerSec = sampleRate;
+	format.blockAlign = sizeof(float);
+	format.avgBytesPerSec = sampleRate * format.blockAlign;
+	format.bitsPerSample = 32;
+	sound.view.data = std::span<const uint8_t>(
+	    reinterpret_cast<const uint8_t*>(sound.samples.data()), frames * sizeof(float));
+	return sound;
+}
+
+double Sinc(double x) { return std::abs(x) < 1e-12 ? 1.0 : std::sin(kPi * x) / (kPi * x); }
+
+double BesselI0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 64; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+double Kaiser(double x) {
+	return std::abs(x) >= 1.0 ? 0.0
+	                          : BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) /
+	                                BesselI0(kKaiserBeta);
+}
+
+// 位相を丸めず、位置ごとに係数を double で計算する変換
+std::vector<double> ReferenceResample(
+    const std::vector<float>& source, uint32_t sourceRate, uint32_t outputRate, uint32_t taps,
+    uint32_t outputFrames) {
+	double scale = std::min(1.0, static_cast<double>(outputRate) / sourceRate);
+	double cutoff = kCutoff * scale;
+	int64_t center = taps / 2 - 1;
+	std::vector<double> output(outputFrames);
+	for (uint32_t i = 0; i < outputFrames; i++) {
+		double position = static_cast<double>(i) * sourceRate / outputRate;
+		int64_t first = static_cast<int64_t>(std::floor(position)) - center;
+		double sum = 0.0;
+		double weight = 0.0;
+		for (uint32_t k = 0; k < taps; k++) {
+			int64_t frame = first + k;
+			double t = static_cast<double>(frame) - position;
+			double h = cutoff * Sinc(cutoff * t) * Kaiser(t / (taps / 2.0));
+			weight += h;
+			if (0 <= frame && frame < static_cast<int64_t>(source.size())) {
+				sum += source[frame] * h;
+			}
+		}
+		output[i] = sum / weight;
+	}
+	return output;
+}
+
+// 信号と誤差の比（dB）。両端は無音を含むので窓の幅だけ除く
+double MeasureSnr(
+    const std::vector<float>& output, const std::vector<double>& reference, uint32_t margin) {
+	double signal = 0.0;
+	double noise = 0.0;
+	for (size_t i = margin; i + margin < reference.size(); i++) {
+		// モノラルなので左右は同じ音
+		double left = output[i * 2 + 0];
+		TEST_CHECK(output[i * 2 + 1] == output[i * 2 + 0]);
+		signal += reference[i] * reference[i];
+		noise += (left - reference[i]) * (left - reference[i]);
+	}
+	return 10.0 * std::log10(signal / std::max(noise, 1e-30));
+}
+
+void TestSnr(uint32_t sourceRate, uint32_t outputRate, double frequency) {
+	TestSound sound = MakeSine(sourceRate, frequency, kSourceFrames);
+	SincFilter filter;
+	filter.Initialize(sourceRate, outputRate);
+
+	std::vector<float> sinc;
+	std::vector<float> linear;
+	TEST_CHECK(ConvertSound(sound.view, outputRate, ResampleQuality::Sinc, sinc));
+	TEST_CHECK(ConvertSound(sound.view, outputRate, ResampleQuality::Linear, linear));
+	uint32_t outputFrames = static_cast<uint32_t>(sinc.size() / 2);
+	TEST_CHECK(
+	    outputFrames == (uint64_t(kSourceFrames) * outputRate + sourceRate - 1) / sourceRate);
+	TEST_CHECK(linear.size() == sinc.size());
+
+	std::vector<double> reference =
+	    ReferenceResample(sound.samples, sourceRate, outputRate, filter.GetTaps(), outputFrames);
+	uint32_t margin = filter.GetTaps() * outputRate / sourceRate + 1;
+	double sincSnr = MeasureSnr(sinc, reference, margin);
+	double linearSnr = MeasureSnr(linear, reference, margin);
+	std::printf(
+	    "%u -> %u, %.0f Hz: sinc %.1f dB, linear %.1f dB (%s)\n", sourceRate, outputRate,
+	    frequency, sincSnr, linearSnr, GetResamplerKernelName());
+	// 位相の補間と float の計算による誤差だけ（-90dB 程度）なので、十分に小さい
+	TEST_CHECK(sincSnr > 80.0);
+	TEST_CHECK(sincSnr > linearSnr);
+}
+
+void TestFilterCacheFallback() {
+	// 出力より高い周波数のフィルターは4つまで作り、その後は線形補間で鳴らす
+	const uint32_t kOutputRate = 48000;
+	const uint32_t kRates[] = {50000, 64000, 88200, 96000, 120000, 176400};
+	const uint32_t kFrames = 4096;
+	std::vector<TestSound> sounds;
+	for (uint32_t rate : kRates) {
+		sounds.push_back(MakeSine(rate, 1000.0, kFrames));
+	}
+
+	AudioMixer mixer;
+	mixer.Initialize(kOutputRate);
+	mixer.SetResampleQuality(ResampleQuality::Sinc);
+	std::vector<float> buffer(AudioMixer::kMaxRenderFrames * AudioMixer::kChannels);
+	for (const TestSound& sound : sounds) {
+		TEST_CHECK(mixer.Play(sound.view, true, 0.25f) != 0);
+	}
+	for (int block = 0; block < 100; block++) {
+		mixer.Render(buffer.data(), AudioMixer::kMaxRenderFrames);
+		for (float sample : buffer) {
+			TEST_CHECK(std::isfinite(sample) && std::abs(sample) <= 1.0f);
+		}
+	}
+	mixer.StopAll();
+	mixer.Render(buffer.data(), AudioMixer::kMaxRenderFrames);
+	TEST_CHECK(mixer.GetPlayingVoiceCount() == 0);
+
+	// キャッシュが埋まった後の周波数は、線形補間のミキサーと同じ音になる
+	const TestSound& last = sounds.back();
+	AudioMixer linearMixer;
+	linearMixer.Initialize(kOutputRate);
+	linearMixer.SetResampleQuality(ResampleQuality::Linear);
+	TEST_CHECK(mixer.Play(last.view, false, 0.25f) != 0);
+	TEST_CHECK(linearMixer.Play(last.view, false, 0.25f) != 0);
+	std::vector<float> expected(buffer.size());
+	for (int block = 0; block < 8; block++) {
+		mixer.Render(buffer.data(), AudioMixer::kMaxRenderFrames);
+		linearMixer.Render(expected.data(), AudioMixer::kMaxRenderFrames);
+		for (size_t i = 0; i < buffer.size(); i++) {
+			TEST_CHECK(std::abs(buffer[i] - expected[i]) < 1e-6f);
+		}
+	}
+}
+
+} // namespace
+
+int main() {
+	TestSnr(44100, 48000, 1000.0);
+	TestSnr(44100, 48000, 15000.0);
+	TestSnr(48000, 22050, 1000.0);
+	TestSnr(48000, 22050, 8000.0);
+	TestFilterCacheFallback();
+	return TestExitCode();
+}
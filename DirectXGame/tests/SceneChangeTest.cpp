@@ -0,0 +1,49 @@
+#include "GameSimulation.h"
+#include "HeadlessGame.h"
+#include "TestUtility.h"
+
+namespace {
+
+const uint32_t kSteps = 20000;
+
+// 先読みが間に合わない素材（待つまで読み込み済みにならない）
+class SlowGameAssets : public GameAssets {
+public:
+	void Prefetch(GameSceneId) override {}
+	bool IsReady(GameSceneId scene) override { return ready_[static_cast<size_t>(scene)]; }
+	void Load(GameSceneId scene) override {
+		ready_[static_cast<size_t>(scene)] = true;
+		loadCount_++;
+	}
+
+	uint32_t GetLoadCount() const { return loadCount_; }
+
+private:
+	bool ready_[static_cast<size_t>(GameSceneId::Count)] = {};
+	uint32_t loadCount_ = 0;
+};
+
+uint64_t RunSimulation(GameAssets& assets) {
+	ScriptedGameInput input;
+	input.SetScript(HeadlessGame::AutoPlay);
+	NullGameAudio audio;
+	GameSimulation simulation;
+	simulation.Initialize(&input, &audio, &assets, GameSimulation::Appearances{}, 1);
+	for (uint32_t i = 0; i < kSteps; i++) {
+		input.Advance();
+		simulation.Update();
+	}
+	return simulation.ComputeChecksum();
+}
+
+} // namespace
+
+int main() {
+	// 先読みが間に合わなくても、画面の切り替えは読み込み済みのときと同じステップで起きる
+	NullGameAssets ready;
+	SlowGameAssets slow;
+	TEST_CHECK(RunSimulation(slow) == RunSimulation(ready));
+	// 何度か画面を切り替えている
+	TEST_CHECK(slow.GetLoadCount() > 2);
+	return TestExitCode();
+}
@@ -0,0 +1,114 @@
+#include "ActorComponents.h"
+#include "ActorSystems.h"
+#include "SystemScheduler.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// エンティティの数
+const uint32_t kEntityCount = 100000;
+// 計測するフレーム数
+const uint32_t kFrameCount = 100;
+// 種類の数（種類ごとのシステムは互いに独立で並列に実行できる）
+const uint32_t kKindCount = 8;
+
+// 種類を表すタグ
+template<uint32_t Kind> struct KindTag {};
+
+// 種類ごとの移動（敵の揺れのような三角関数を含む、1エンティティあたり数十ナノ秒の処理）
+template<uint32_t Kind> void MoveKindSystem(EcsWorld& world, int frame) {
+	world.ForEachChunk<KindTag<Kind>, TransformComponent, VelocityComponent>(
+	    [frame](uint32_t count, const Entity*, KindTag<Kind>*, TransformComponent* transforms,
+	            VelocityComponent* velocities) {
+		    for (uint32_t i = 0; i < count; i++) {
+			    float phase = transforms[i].translation.z * 0.1f + frame * 0.05f + Kind;
+			    transforms[i].translation.x += velocities[i].linear.x * std::sin(phase);
+			    transforms[i].translation.y = std::cos(phase) * 0.5f;
+			    transforms[i].translation.z += velocities[i].linear.z;
+			    transforms[i].rotation.x += velocities[i].angular.x;
+		    }
+	    });
+}
+
+template<uint32_t Kind> void CreateKind(EcsWorld& world, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++) {
+		TransformComponent transform;
+		transform.translation = {float(i % 9) - 4.0f, 0.0f, float(i % 1000)};
+		VelocityComponent velocity;
+		velocity.linear = {0.1f, 0.0f, -0.01f};
+		velocity.angular.x = 0.1f;
+		world.Create(KindTag<Kind>{}, transform, velocity);
+	}
+}
+
+template<uint32_t Kind>
+void AddKindSystem(SystemScheduler& scheduler, EcsWorld& world, int& frame) {
+	SystemAccess access;
+	access.required =
+	    MakeComponentMask<KindTag<Kind>, TransformComponent, VelocityComponent>();
+	access.read = MakeComponentMask<VelocityComponent>();
+	access.write = MakeComponentMask<TransformComponent>();
+	scheduler.AddSystem("MoveKind", access, [&world, &frame] {
+		MoveKindSystem<Kind>(world, frame);
+	});
+}
+
+template<uint32_t... Kinds>
+void Setup(
+    SystemScheduler& scheduler, EcsWorld& world, int& frame,
+    std::integer_sequence<uint32_t, Kinds...>) {
+	(CreateKind<Kinds>(world, kEntityCount / kKindCount), ...);
+
+	// 全員の移動前の座標を記録してから、種類ごとに動かし、最後に予約した削除を実行する
+	SystemAccess savePrevious;
+	savePrevious.required = MakeComponentMask<TransformComponent>();
+	savePrevious.write = savePrevious.required;
+	scheduler.AddSystem("SavePrevious", savePrevious, [&world] {
+		SavePreviousPositionSystem(world);
+	});
+	(AddKindSystem<Kinds>(scheduler, world, frame), ...);
+	SystemAccess flush;
+	flush.structural = true;
+	scheduler.AddSystem("Flush", flush, [&world] { world.FlushDeferred(); });
+}
+
+} // namespace
+
+int main() {
+	EcsWorld world;
+	SystemScheduler scheduler;
+	int frame = 0;
+	Setup(scheduler, world, frame, std::make_integer_sequence<uint32_t, kKindCount>{});
+
+	// 1スレッド（登録順に直列）から、ハードウェアのスレッド数まで倍々に増やす
+	uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+	double baseSeconds = 0.0;
+	for (uint32_t threads = 1; threads <= std::max(hardware, 2u); threads *= 2) {
+		if (threads > 1) {
+			JobSystem::GetInstance()->Initialize(threads - 1);
+		}
+		scheduler.SetParallel(threads > 1);
+		double seconds = MeasureSeconds([&] {
+			for (uint32_t i = 0; i < kFrameCount; i++) {
+				scheduler.Run(world);
+				frame++;
+			}
+		});
+		if (threads > 1) {
+			JobSystem::GetInstance()->Finalize();
+		} else {
+			baseSeconds = seconds;
+		}
+		std::printf(
+		    "%2u threads: %.3f ms/frame, speedup %.2fx\n", threads,
+		    seconds * 1000.0 / kFrameCount, baseSeconds / seconds);
+	}
+	if (hardware == 1) {
+		std::printf("(only 1 hardware thread: the 2-thread run shows the scheduling overhead)\n");
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "Random.h"
+#include "SpatialHash.h"
+#include "TestUtility.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// 空間ハッシュの問い合わせを総当たりと比べる（範囲のセルが少ないときと、登録数より多くて
+// 全ての登録を調べるとき）。無限大・NaN・遠すぎる座標でも決まった結果を返すかも確かめる
+
+namespace {
+
+// セルの一辺の長さ（逆数を掛けても割っても同じ値になる2の累乗）
+const float kCellSize = 2.0f;
+const float kInfinity = std::numeric_limits<float>::infinity();
+const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+// 範囲 [min, max] と同じセルに入る座標か（SpatialHash と同じ計算）
+bool IsInCells(float v, float min, float max) {
+	float cell = std::floor(v / kCellSize);
+	return std::floor(min / kCellSize) <= cell && cell <= std::floor(max / kCellSize);
+}
+
+void TestAgainstBruteForce() {
+	Random random(27);
+	const uint32_t kCount = 500;
+	std::vector<float> xs;
+	std::vector<float> zs;
+	SpatialHash hash;
+	hash.Initialize(kCellSize);
+	for (uint32_t id = 0; id < kCount; id++) {
+		xs.push_back(random.NextFloat(-100.0f, 100.0f));
+		zs.push_back(random.NextFloat(-100.0f, 100.0f));
+		hash.Insert(id, xs.back(), zs.back());
+	}
+	hash.Build();
+	TEST_CHECK(hash.GetCount() == kCount);
+
+	// 半径 20 まではセルを回り、40 からはセルが登録数より多いので全ての登録を調べる
+	const float kRadii[] = {0.0f, 1.0f, 5.0f, 20.0f, 40.0f, 150.0f, 1.0e6f};
+	std::vector<uint32_t> result;
+	for (float radius : kRadii) {
+		for (int i = 0; i < 50; i++) {
+			float x = random.NextFloat(-120.0f, 120.0f);
+			float z = random.NextFloat(-120.0f, 120.0f);
+			hash.Query(x, z, radius, result);
+			std::vector<uint32_t> expected;
+			for (uint32_t id = 0; id < kCount; id++) {
+				if (IsInCells(xs[id], x - radius, x + radius) &&
+				    IsInCells(zs[id], z - radius, z + radius)) {
+					expected.push_back(id);
+				}
+			}
+			TEST_CHECK(result == expected);
+		}
+	}
+
+	// ペアの列挙も同じ
+	std::vector<SpatialHash::Pair> pairs;
+	float queryX[] = {0.0f, 50.0f};
+	float queryZ[] = {0.0f, -50.0f};
+	hash.FindPairs(queryX, queryZ, 2, 100.0f, pairs);
+	size_t pairIndex = 0;
+	for (uint32_t q = 0; q < 2; q++) {
+		hash.Query(queryX[q], queryZ[q], 100.0f, result);
+		for (uint32_t id : result) {
+			TEST_CHECK(pairIndex < pairs.size());
+			if (pairIndex < pairs.size()) {
+				TEST_CHECK(pairs[pairIndex].query == q && pairs[pairIndex].id == id);
+			}
+			pairIndex++;
+		}
+	}
+	TEST_CHECK(pairIndex == pairs.size());
+}
+
+void TestNonFinite() {
+	SpatialHash hash;
+	hash.Initialize(kCellSize);
+	hash.Insert(0, 0.0f, 0.0f);
+	hash.Insert(1, 1.0e30f, 0.0f);
+	hash.Insert(2, kInfinity, 0.0f);
+	hash.Insert(3, -kInfinity, -1.0e30f);
+	// NaN は登録しない
+	hash.Insert(4, kNaN, 0.0f);
+	hash.Insert(5, 0.0f, kNaN);
+	hash.Build();
+	TEST_CHECK(hash.GetCount() == 4);
+
+	std::vector<uint32_t> result;
+	// 全体を覆う範囲は、セルを回らずに全ての登録を返す
+	hash.Query(0.0f, 0.0f, kInfinity, result);
+	TEST_CHECK((result == std::vector<uint32_t>{0, 1, 2, 3}));
+	hash.Query(0.0f, 0.0f, 1.0e30f, result);
+	TEST_CHECK((result == std::vector<uint32_t>{0, 1, 2, 3}));
+	// 遠すぎる座標は端のセルに寄るので、同じ端の登録が候補になる
+	hash.Query(kInfinity, 0.0f, 1.0f, result);
+	TEST_CHECK((result == std::vector<uint32_t>{1, 2}));
+	hash.Query(-1.0e35f, -kInfinity, 0.0f, result);
+	TEST_CHECK((result == std::vector<uint32_t>{3}));
+	hash.Query(0.0f, 0.0f, 1.0f, result);
+	TEST_CHECK((result == std::vector<uint32_t>{0}));
+
+	// NaN の範囲・負の半径は何も含まない
+	hash.Query(kNaN, 0.0f, 1.0f, result);
+	TEST_CHECK(result.empty());
+	hash.Query(0.0f, 0.0f, kNaN, result);
+	TEST_CHECK(result.empty());
+	hash.Query(kInfinity, 0.0f, kInfinity, result);
+	TEST_CHECK(result.empty());
+	hash.Query(0.0f, 0.0f, -1.0f, result);
+	TEST_CHECK(result.empty());
+}
+
+} // namespace
+
+int main() {
+	TestAgainstBruteForce();
+	TestNonFinite();
+	return TestExitCode();
+}
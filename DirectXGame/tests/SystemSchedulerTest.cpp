@@ -0,0 +1,123 @@
+#include "SystemScheduler.h"
+#include "TestUtility.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Position {
+	float value;
+};
+struct Velocity {
+	float value;
+};
+struct Tag0 {};
+struct Tag1 {};
+
+// 実行の前後関係を記録する時計
+struct Timeline {
+	std::atomic<int> clock{0};
+	std::vector<int> start;
+	std::vector<int> end;
+
+	explicit Timeline(size_t count) : start(count, -1), end(count, -1) {}
+};
+
+// 構造を変えるシステムで増えたアーキタイプで衝突するようになったシステムは、並べて実行する
+void TestGraphAfterStructuralChange() {
+	EcsWorld world;
+	world.Create(Position{0.0f});
+
+	SystemScheduler scheduler;
+	Timeline timeline(2);
+	SystemAccess spawn;
+	spawn.structural = true;
+	scheduler.AddSystem("Spawn", spawn, [&world] {
+		if (world.GetArchetypeCount() == 1) {
+			world.Create(Position{0.0f}, Velocity{1.0f});
+		}
+	});
+	// Position だけのアーキタイプでは Velocity を持たないので衝突しない
+	SystemAccess writePosition;
+	writePosition.required = MakeComponentMask<Position>();
+	writePosition.write = MakeComponentMask<Position>();
+	scheduler.AddSystem("WritePosition", writePosition, [&timeline] {
+		timeline.start[0] = timeline.clock++;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		timeline.end[0] = timeline.clock++;
+	});
+	SystemAccess readPosition;
+	readPosition.required = MakeComponentMask<Velocity>();
+	readPosition.read = MakeComponentMask<Position>();
+	scheduler.AddSystem("ReadPosition", readPosition, [&timeline] {
+		timeline.start[1] = timeline.clock++;
+		timeline.end[1] = timeline.clock++;
+	});
+
+	// 最初の Run の途中で Position と Velocity のアーキタイプができる
+	scheduler.Run(world);
+	TEST_CHECK(SystemScheduler::Conflicts(writePosition, readPosition, world));
+	TEST_CHECK(timeline.end[0] < timeline.start[1]);
+}
+
+// ランダムなシステムの並びで、衝突する組が登録順に実行される
+void TestRandomSystems() {
+	EcsWorld world;
+	for (int i = 0; i < 2000; i++) {
+		world.Create(Tag0{}, Position{1.0f});
+	}
+	std::mt19937 random(3);
+	const ComponentMask masks[] = {
+	    MakeComponentMask<Position>(), MakeComponentMask<Velocity>(), MakeComponentMask<Tag1>()};
+	const ComponentMask tags[] = {MakeComponentMask<Tag0>(), MakeComponentMask<Tag1>()};
+
+	for (int trial = 0; trial < 200; trial++) {
+		const size_t kSystemCount = 12;
+		SystemScheduler scheduler;
+		std::vector<SystemAccess> accesses(kSystemCount);
+		Timeline timeline(kSystemCount);
+		for (size_t i = 0; i < kSystemCount; i++) {
+			SystemAccess& access = accesses[i];
+			access.required = tags[random() % 2];
+			access.read = masks[random() % 3];
+			access.write = random() % 2 ? masks[random() % 3] : 0;
+			access.resourceWrite = random() % 5 == 0 ? 1 : 0;
+			access.structural = random() % 6 == 0;
+			bool structural = access.structural;
+			scheduler.AddSystem("System", access, [&world, &timeline, i, structural] {
+				timeline.start[i] = timeline.clock++;
+				// 構造を変えるシステムは Tag1 のアーキタイプを増やしていく
+				// （他のシステムは宣言とずれないよう ECS には触らず、少し時間を使うだけ）
+				if (structural) {
+					world.Create(Tag1{}, Position{1.0f}, Velocity{0.0f});
+				} else {
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}
+				timeline.end[i] = timeline.clock++;
+			});
+		}
+		scheduler.Run(world);
+		for (size_t i = 0; i < kSystemCount; i++) {
+			TEST_CHECK(timeline.start[i] >= 0);
+			for (size_t j = i + 1; j < kSystemCount; j++) {
+				if (SystemScheduler::Conflicts(accesses[i], accesses[j], world)) {
+					TEST_CHECK(timeline.end[i] < timeline.start[j]);
+				}
+			}
+		}
+		world.DestroyAll<Tag1>();
+	}
+}
+
+} // namespace
+
+int main() {
+	JobSystem::GetInstance()->Initialize(4);
+	TestGraphAfterStructuralChange();
+	TestRandomSystems();
+	JobSystem::GetInstance()->Finalize();
+	return TestExitCode();
+}
@@ -0,0 +1,104 @@
+#include "BVH.h"
+#include "JobSystem.h"
+#include "TestUtility.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 地形の格子（256x256マス）
+const uint32_t kGridSize = 256;
+// レイの本数
+const uint32_t kRayCount = 1000000;
+// 総当たりで確かめるレイの本数（遅いので一部だけ）
+const uint32_t kBruteForceRayCount = 200;
+
+// Terrain::VertexPosNormalUv と同じ並び（Terrain は D3D12 に依存するので頂点だけ作る）
+struct TerrainVertex {
+	Vector3 pos;
+	Vector3 normal;
+	float uv[2];
+};
+
+// Terrain::DeformRandom の代わりのなだらかな起伏
+std::vector<std::vector<TerrainVertex>> MakeTerrain() {
+	std::vector<std::vector<TerrainVertex>> vertices(
+	    kGridSize + 1, std::vector<TerrainVertex>(kGridSize + 1));
+	for (uint32_t z = 0; z <= kGridSize; z++) {
+		for (uint32_t x = 0; x <= kGridSize; x++) {
+			float height = std::sin(x * 0.1f) * std::cos(z * 0.13f) * 5.0f +
+			               std::sin(x * 0.031f + z * 0.027f) * 12.0f;
+			vertices[z][x].pos = {float(x), height, float(z)};
+		}
+	}
+	return vertices;
+}
+
+// 上空から斜め下へ向かうレイ
+std::vector<BVH::Ray> MakeRays(uint32_t count) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(0.0f, float(kGridSize));
+	std::uniform_real_distribution<float> slope(-0.5f, 0.5f);
+	std::vector<BVH::Ray> rays(count);
+	for (BVH::Ray& ray : rays) {
+		ray.origin = {position(random), 30.0f, position(random)};
+		ray.direction = {slope(random), -1.0f, slope(random)};
+	}
+	return rays;
+}
+
+} // namespace
+
+int main() {
+	std::vector<std::vector<TerrainVertex>> terrain = MakeTerrain();
+	std::vector<BVH::Ray> rays = MakeRays(kRayCount);
+
+	// 構築（1スレッドとジョブシステム）
+	BVH bvh;
+	bvh.AddGrid(terrain);
+	double buildSeconds = MeasureSeconds([&bvh] { bvh.Build(); });
+	JobSystem::GetInstance()->Initialize();
+	BVH parallelBvh;
+	parallelBvh.AddGrid(terrain);
+	double parallelBuildSeconds = MeasureSeconds([&parallelBvh] { parallelBvh.Build(); });
+	uint32_t threadCount = JobSystem::GetInstance()->GetThreadCount();
+	JobSystem::GetInstance()->Finalize();
+	std::printf(
+	    "build: %u triangles %zu nodes, 1 thread %.1f ms, %u threads %.1f ms\n",
+	    uint32_t(kGridSize * kGridSize * 2), bvh.GetNodes().size(), buildSeconds * 1000.0,
+	    threadCount, parallelBuildSeconds * 1000.0);
+
+	// BVH のレイキャスト
+	uint32_t hitCount = 0;
+	double seconds = MeasureSeconds([&] {
+		for (const BVH::Ray& ray : rays) {
+			BVH::RayHit hit;
+			hitCount += bvh.RayCast(ray, hit) ? 1 : 0;
+		}
+	});
+	std::printf(
+	    "bvh:         %u rays %u hits %.3fs %.2f Mrays/s\n", kRayCount, hitCount, seconds,
+	    kRayCount / seconds / 1.0e6);
+
+	// 総当たり（構築していない BVH は全プリミティブを調べる）と結果を比べる
+	BVH bruteForce;
+	bruteForce.AddGrid(terrain);
+	uint32_t mismatchCount = 0;
+	double bruteSeconds = MeasureSeconds([&] {
+		for (uint32_t i = 0; i < kBruteForceRayCount; i++) {
+			BVH::RayHit expected;
+			BVH::RayHit actual;
+			bool isExpected = bruteForce.RayCast(rays[i], expected);
+			bool isActual = bvh.RayCast(rays[i], actual);
+			if (isExpected != isActual ||
+			    (isExpected && std::abs(expected.t - actual.t) > 1.0e-4f)) {
+				mismatchCount++;
+			}
+		}
+	});
+	std::printf(
+	    "brute force: %u rays %.3fs %.4f Mrays/s (mismatches %u)\n", kBruteForceRayCount,
+	    bruteSeconds, kBruteForceRayCount / bruteSeconds / 1.0e6, mismatchCount);
+	return mismatchCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+/// <summary>
+/// テストの確認（assert と違い Release でも確かめ、失敗しても続けて数える）
+/// </summary>
+#define TEST_CHECK(condition)                                                                      \
+	do {                                                                                           \
+		if (!(condition)) {                                                                        \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);     \
+			TestFailureCount()++;                                                                  \
+		}                                                                                          \
+	} while (false)
+
+/// <summary>
+/// 失敗した確認の数
+/// </summary>
+inline int& TestFailureCount() {
+	static int count = 0;
+	return count;
+}
+
+/// <summary>
+/// テストの終了コード（main の最後で返す）
+/// </summary>
+inline int TestExitCode() {
+	if (TestFailureCount() == 0) {
+		std::printf("all checks passed\n");
+		return 0;
+	}
+	std::fprintf(stderr, "%d checks failed\n", TestFailureCount());
+	return 1;
+}
+
+/// <summary>
+/// 処理にかかった秒数の計測（ベンチマーク用）
+/// </summary>
+template<class Function> double MeasureSeconds(Function&& function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
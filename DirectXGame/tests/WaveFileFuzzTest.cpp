@@ -0,0 +1,204 @@
+#include "ImaAdpcm.h"
+#include "TestUtility.h"
+#include "WaveFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+// 壊れたヘッダの WAV を大量に解析して、落ちない・範囲外を指さないことを確かめる
+// （AddressSanitizer でビルドすると、範囲外の読み込みも見つかる）
+
+namespace {
+
+// 試す回数
+const uint32_t kCaseCount = 300000;
+// 種にするファイルの先頭の大きさ（ヘッダと data の先頭が入れば十分）
+const size_t kSeedSize = 4096;
+
+using Bytes = std::vector<uint8_t>;
+
+void AppendId(Bytes& bytes, const char* id) { bytes.insert(bytes.end(), id, id + 4); }
+
+void AppendValue(Bytes& bytes, uint32_t value, int size) {
+	for (int i = 0; i < size; i++) {
+		bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
+
+// LIST の後に WAVE_FORMAT_EXTENSIBLE の浮動小数点の fmt が来るファイル
+Bytes MakeExtensibleSeed() {
+	Bytes bytes;
+	AppendId(bytes, "RIFF");
+	AppendValue(bytes, 200, 4);
+	AppendId(bytes, "WAVE");
+	AppendId(bytes, "LIST");
+	AppendValue(bytes, 5, 4);
+	bytes.insert(bytes.end(), {1, 2, 3, 4, 5, 0}); // 奇数の大きさは2バイト境界まで詰める
+	AppendId(bytes, "fmt ");
+	AppendValue(bytes, 40, 4);
+	AppendValue(bytes, 0xFFFE, 2);
+	AppendValue(bytes, 2, 2);
+	AppendValue(bytes, 48000, 4);
+	AppendValue(bytes, 48000 * 8, 4);
+	AppendValue(bytes, 8, 2);
+	AppendValue(bytes, 32, 2);
+	AppendValue(bytes, 22, 2);
+	AppendValue(bytes, 32, 2);
+	AppendValue(bytes, 3, 4);
+	AppendValue(bytes, kWaveFormatFloat, 2);
+	bytes.resize(bytes.size() + 14);
+	AppendId(bytes, "data");
+	AppendValue(bytes, 64, 4);
+	for (int i = 0; i < 64; i++) {
+		bytes.push_back(static_cast<uint8_t>(i));
+	}
+	return bytes;
+}
+
+// モノラル 256 バイトのブロックの IMA ADPCM（最後のブロックは短い）
+Bytes MakeAdpcmSeed() {
+	Bytes bytes;
+	AppendId(bytes, "RIFF");
+	AppendValue(bytes, 0, 4);
+	AppendId(bytes, "WAVE");
+	AppendId(bytes, "fmt ");
+	AppendValue(bytes, 20, 4);
+	AppendValue(bytes, kWaveFormatImaAdpcm, 2);
+	AppendValue(bytes, 1, 2);
+	AppendValue(bytes, 22050, 4);
+	AppendValue(bytes, 11100, 4);
+	AppendValue(bytes, 256, 2);
+	AppendValue(bytes, 4, 2);
+	AppendValue(bytes, 2, 2);
+	AppendValue(bytes, 505, 2);
+	AppendId(bytes, "data");
+	AppendValue(bytes, 256 * 2 + 100, 4);
+	std::mt19937 random(7);
+	for (int i = 0; i < 256 * 2 + 100; i++) {
+		bytes.push_back(static_cast<uint8_t>(random()));
+	}
+	uint32_t riffSize = static_cast<uint32_t>(bytes.size() - 8);
+	std::memcpy(bytes.data() + 4, &riffSize, 4);
+	return bytes;
+}
+
+std::vector<Bytes> LoadSeeds() {
+	std::vector<Bytes> seeds = {MakeExtensibleSeed(), MakeAdpcmSeed()};
+	for (const auto& entry : std::filesystem::directory_iterator(GAME_AUDIO_DIRECTORY)) {
+		if (entry.path().extension() != ".wav") {
+			continue;
+		}
+		std::ifstream file(entry.path(), std::ios::binary);
+		Bytes bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		bytes.resize(std::min(bytes.size(), kSeedSize));
+		seeds.push_back(std::move(bytes));
+	}
+	return seeds;
+}
+
+// ランダムに壊す（ビット反転・上書き・切り詰め・大きさの破壊・挿入）
+void Mutate(Bytes& bytes, std::mt19937& random) {
+	int mutationCount = 1 + random() % 8;
+	for (int m = 0; m < mutationCount; m++) {
+		switch (random() % 6) {
+		case 0:
+			if (!bytes.empty()) {
+				bytes[random() % bytes.size()] ^= static_cast<uint8_t>(1u << (random() % 8));
+			}
+			break;
+		case 1:
+			if (!bytes.empty()) {
+				bytes[random() % bytes.size()] = static_cast<uint8_t>(random());
+			}
+			break;
+		case 2:
+			bytes.resize(random() % (bytes.size() + 1));
+			break;
+		case 3:
+			// 4バイト境界の値をでたらめな値にする
+			if (bytes.size() >= 4) {
+				uint32_t value = random();
+				size_t position = (random() % (bytes.size() / 4)) * 4;
+				std::memcpy(&bytes[position], &value, 4);
+			}
+			break;
+		case 4: {
+			// ヘッダ付近の大きさに境界の値を入れる
+			const uint32_t kValues[] = {0, 1, 0x7fffffff, 0xffffffff, 0xfffffff8, 16};
+			size_t position = 4 + random() % 60;
+			if (position + 4 <= bytes.size()) {
+				std::memcpy(&bytes[position], &kValues[random() % 6], 4);
+			}
+			break;
+		}
+		default: {
+			size_t position = random() % (bytes.size() + 1);
+			int count = random() % 16;
+			for (int i = 0; i < count; i++) {
+				bytes.insert(bytes.begin() + position, static_cast<uint8_t>(random()));
+			}
+			break;
+		}
+		}
+	}
+}
+
+// 受け付けたときの結果が元のバイト列の中を指し、展開もできるか
+bool IsValidView(const WaveView& view, const uint8_t* begin, size_t size) {
+	const WaveFormat& format = view.format;
+	if (format.channels == 0 || format.blockAlign == 0 || view.data.data() < begin ||
+	    view.data.data() + view.data.size() > begin + size) {
+		return false;
+	}
+	if (format.formatTag != kWaveFormatImaAdpcm) {
+		return view.data.size() % format.blockAlign == 0;
+	}
+	// WaveFile::Open と同じようにブロックごとに展開する
+	uint32_t dataSize = static_cast<uint32_t>(view.data.size());
+	std::vector<int16_t> decoded(
+	    static_cast<size_t>(GetImaAdpcmFrameCount(format, dataSize)) * format.channels);
+	size_t written = 0;
+	for (size_t position = 0; position < view.data.size(); position += format.blockAlign) {
+		uint32_t blockSize =
+		    static_cast<uint32_t>(std::min<size_t>(format.blockAlign, dataSize - position));
+		written += size_t(DecodeImaAdpcmBlock(
+		               view.data.data() + position, blockSize, format,
+		               decoded.data() + written)) *
+		           format.channels;
+	}
+	return written == decoded.size();
+}
+
+} // namespace
+
+int main() {
+	std::vector<Bytes> seeds = LoadSeeds();
+	// 壊す前の種は全て受け付ける
+	for (const Bytes& seed : seeds) {
+		WaveView view;
+		TEST_CHECK(ParseWave(seed, view) && IsValidView(view, seed.data(), seed.size()));
+	}
+
+	std::mt19937 random(12345);
+	uint32_t acceptedCount = 0;
+	uint32_t invalidCount = 0;
+	for (uint32_t n = 0; n < kCaseCount; n++) {
+		Bytes bytes = seeds[random() % seeds.size()];
+		Mutate(bytes, random);
+		// 末尾の外を読むと AddressSanitizer が気づくよう、ちょうどの大きさで確保し直す
+		std::unique_ptr<uint8_t[]> exact = std::make_unique<uint8_t[]>(bytes.size());
+		std::memcpy(exact.get(), bytes.data(), bytes.size());
+		WaveView view;
+		if (ParseWave({exact.get(), bytes.size()}, view)) {
+			acceptedCount++;
+			invalidCount += IsValidView(view, exact.get(), bytes.size()) ? 0 : 1;
+		}
+	}
+	TEST_CHECK(invalidCount == 0);
+	std::printf("%u cases, %u accepted\n", kCaseCount, acceptedCount);
+	return TestExitCode();
+}
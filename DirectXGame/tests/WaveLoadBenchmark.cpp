@@ -0,0 +1,177 @@
+#include "ImaAdpcmEncoder.h"
+#include "TestUtility.h"
+#include "WaveFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 全ファイルを読み込む回数
+const int kRepeatCount = 200;
+
+// 元の Audio::LoadWave と同じ読み込み（ストリームでチャンクを読み、data を vector にコピーする）
+struct CopiedSound {
+	WaveFormat format;
+	std::vector<uint8_t> buffer;
+};
+
+bool LoadCopy(const std::string& fileName, CopiedSound& sound) {
+	std::ifstream file(fileName, std::ios::binary);
+	char riff[12];
+	if (!file.read(riff, sizeof(riff))) {
+		return false;
+	}
+	while (true) {
+		char id[4];
+		uint32_t size = 0;
+		if (!file.read(id, 4) || !file.read(reinterpret_cast<char*>(&size), 4)) {
+			return false;
+		}
+		if (std::memcmp(id, "fmt ", 4) == 0) {
+			std::vector<char> format(size);
+			file.read(format.data(), size);
+			std::memcpy(&sound.format, format.data(), sizeof(WaveFormat));
+		} else if (std::memcmp(id, "data", 4) == 0) {
+			sound.buffer.resize(size);
+			file.read(reinterpret_cast<char*>(sound.buffer.data()), size);
+			return true;
+		} else {
+			file.seekg(size + (size & 1), std::ios::cur);
+		}
+	}
+}
+
+// 読み込んだ PCM のキャッシュラインを全て触る（再生するときと同じくページを読み込ませる）
+uint64_t Touch(const uint8_t* data, size_t size) {
+	uint64_t sum = 0;
+	for (size_t i = 0; i < size; i += 64) {
+		sum += data[i];
+	}
+	return sum;
+}
+
+// 16ビットのPCMのファイルを IMA ADPCM に符号化して一時ファイルに書く（書けたファイル名を返す）
+std::string WriteAdpcmCopy(const std::string& fileName) {
+	WaveFile wave;
+	if (!wave.Open(fileName) || wave.GetFormat().formatTag != kWaveFormatPCM ||
+	    wave.GetFormat().bitsPerSample != 16) {
+		return "";
+	}
+	const WaveFormat& format = wave.GetFormat();
+	std::vector<int16_t> samples(wave.GetData().size() / sizeof(int16_t));
+	std::memcpy(samples.data(), wave.GetData().data(), samples.size() * sizeof(int16_t));
+	// ffmpeg の adpcm_ima_wav と同じく、チャンネルあたり 512 バイトのブロック
+	ImaAdpcmEncoded encoded = EncodeImaAdpcm(
+	    samples, format.channels, format.samplesPerSec,
+	    static_cast<uint16_t>(512 * format.channels));
+	std::vector<uint8_t> bytes = MakeImaAdpcmWave(encoded);
+	std::string adpcmFileName =
+	    (std::filesystem::temp_directory_path() /
+	     ("adpcm_" + std::filesystem::path(fileName).filename().string()))
+	        .string();
+	std::ofstream(adpcmFileName, std::ios::binary)
+	    .write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	return adpcmFileName;
+}
+
+// 開いて全て触るまでの時間（1回あたりの秒数）と、開いたまま持つ PCM のバイト数
+double MeasureOpen(const std::vector<std::string>& fileNames, size_t& heldBytes, uint64_t& sum) {
+	double seconds = MeasureSeconds([&] {
+		for (int repeat = 0; repeat < kRepeatCount; repeat++) {
+			std::vector<WaveFile> waves(fileNames.size());
+			heldBytes = 0;
+			for (size_t i = 0; i < fileNames.size(); i++) {
+				waves[i].Open(fileNames[i]);
+				sum += Touch(waves[i].GetData().data(), waves[i].GetData().size());
+				heldBytes += waves[i].GetData().size();
+			}
+		}
+	});
+	return seconds / kRepeatCount;
+}
+
+} // namespace
+
+int main() {
+	std::vector<std::string> fileNames;
+	for (const auto& entry : std::filesystem::directory_iterator(GAME_AUDIO_DIRECTORY)) {
+		if (entry.path().extension() == ".wav") {
+			fileNames.push_back(entry.path().string());
+		}
+	}
+
+	size_t totalBytes = 0;
+	for (const std::string& fileName : fileNames) {
+		WaveFile wave;
+		if (!wave.Open(fileName)) {
+			std::fprintf(stderr, "failed to open %s\n", fileName.c_str());
+			return 1;
+		}
+		totalBytes += wave.GetData().size();
+	}
+
+	uint64_t sum = 0;
+	for (bool isTouched : {false, true}) {
+		double copySeconds = MeasureSeconds([&] {
+			for (int repeat = 0; repeat < kRepeatCount; repeat++) {
+				std::vector<CopiedSound> sounds(fileNames.size());
+				for (size_t i = 0; i < fileNames.size(); i++) {
+					LoadCopy(fileNames[i], sounds[i]);
+					if (isTouched) {
+						sum += Touch(sounds[i].buffer.data(), sounds[i].buffer.size());
+					}
+				}
+			}
+		});
+		double mapSeconds = MeasureSeconds([&] {
+			for (int repeat = 0; repeat < kRepeatCount; repeat++) {
+				std::vector<WaveFile> waves(fileNames.size());
+				for (size_t i = 0; i < fileNames.size(); i++) {
+					waves[i].Open(fileNames[i]);
+					if (isTouched) {
+						sum += Touch(waves[i].GetData().data(), waves[i].GetData().size());
+					}
+				}
+			}
+		});
+		std::printf(
+		    "%-13s %zu files %zu KB: copy %.0f us, mmap %.0f us (%.1fx)\n",
+		    isTouched ? "load + touch:" : "load only:", fileNames.size(), totalBytes / 1024,
+		    copySeconds * 1.0e6 / kRepeatCount, mapSeconds * 1.0e6 / kRepeatCount,
+		    copySeconds / mapSeconds);
+	}
+
+	// IMA ADPCM（開くときに展開する）と PCM（マップする）の比較
+	std::vector<std::string> pcmFileNames;
+	std::vector<std::string> adpcmFileNames;
+	uintmax_t pcmFileBytes = 0;
+	uintmax_t adpcmFileBytes = 0;
+	for (const std::string& fileName : fileNames) {
+		std::string adpcmFileName = WriteAdpcmCopy(fileName);
+		if (adpcmFileName.empty()) {
+			continue;
+		}
+		pcmFileNames.push_back(fileName);
+		adpcmFileNames.push_back(adpcmFileName);
+		pcmFileBytes += std::filesystem::file_size(fileName);
+		adpcmFileBytes += std::filesystem::file_size(adpcmFileName);
+	}
+	size_t pcmHeldBytes = 0;
+	size_t adpcmHeldBytes = 0;
+	double pcmSeconds = MeasureOpen(pcmFileNames, pcmHeldBytes, sum);
+	double adpcmSeconds = MeasureOpen(adpcmFileNames, adpcmHeldBytes, sum);
+	std::printf(
+	    "pcm vs adpcm: %zu files, on disk %ju KB vs %ju KB (%.2fx), load + touch %.0f us vs "
+	    "%.0f us, held %zu KB vs %zu KB\n",
+	    pcmFileNames.size(), pcmFileBytes / 1024, adpcmFileBytes / 1024,
+	    static_cast<double>(adpcmFileBytes) / pcmFileBytes, pcmSeconds * 1.0e6,
+	    adpcmSeconds * 1.0e6, pcmHeldBytes / 1024, adpcmHeldBytes / 1024);
+	for (const std::string& adpcmFileName : adpcmFileNames) {
+		std::filesystem::remove(adpcmFileName);
+	}
+	std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sum & 0xff));
+	return 0;
+}
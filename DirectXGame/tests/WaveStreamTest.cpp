@@ -0,0 +1,187 @@
+#include "StreamDecoder.h"
+#include "TestUtility.h"
+#include "WaveFile.h"
+#include "WaveStream.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 同梱の WAV をストリーミングで読み、WaveFile::GetData とバイト単位で同じになるかの確認
+// （その場で読む場合と、先読み用のスレッドで読む場合。ループ・Rewind・先読みの遅れも）
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// 先読みが間に合わなかったときの無音か
+bool IsSilence(const WaveStream::Block& block, const WaveFormat& format) {
+	uint8_t silence = format.bitsPerSample == 8 ? 0x80 : 0;
+	return block.size == format.blockAlign * WaveStream::kUnderrunFrames &&
+	       std::all_of(block.data, block.data + block.size, [silence](uint8_t value) {
+		       return value == silence;
+	       });
+}
+
+// 終わりまで（ループなら maxSize バイト以上になるまで）読む。先読みの遅れの無音は除く
+Bytes ReadStream(WaveStream& stream, size_t maxSize) {
+	Bytes bytes;
+	while (bytes.size() < maxSize) {
+		uint32_t underrunCount = stream.GetUnderrunCount();
+		WaveStream::Block block = stream.ReadBlock();
+		if (stream.GetUnderrunCount() != underrunCount) {
+			TEST_CHECK(IsSilence(block, stream.GetFormat()));
+			std::this_thread::yield();
+			continue;
+		}
+		bytes.insert(bytes.end(), block.data, block.data + block.size);
+		if (block.endOfStream) {
+			break;
+		}
+	}
+	return bytes;
+}
+
+// data を count バイトまで繰り返したもの
+Bytes Repeat(std::span<const uint8_t> data, size_t count) {
+	Bytes bytes;
+	while (bytes.size() < count) {
+		size_t size = std::min(data.size(), count - bytes.size());
+		bytes.insert(bytes.end(), data.begin(), data.begin() + size);
+	}
+	return bytes;
+}
+
+// 8ビット モノラルの WAV（ブロック3つより長い）を書き出す
+std::string WritePcm8File() {
+	const uint32_t kFrames = 200000;
+	Bytes bytes;
+	auto append = [&bytes](uint32_t value, int size) {
+		for (int i = 0; i < size; i++) {
+			bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	};
+	auto appendId = [&bytes](const char* id) { bytes.insert(bytes.end(), id, id + 4); };
+	appendId("RIFF");
+	append(4 + 24 + 8 + kFrames, 4);
+	appendId("WAVE");
+	appendId("fmt ");
+	append(16, 4);
+	append(kWaveFormatPCM, 2);
+	append(1, 2);
+	append(22050, 4);
+	append(22050, 4);
+	append(1, 2);
+	append(8, 2);
+	appendId("data");
+	append(kFrames, 4);
+	for (uint32_t i = 0; i < kFrames; i++) {
+		bytes.push_back(static_cast<uint8_t>(i * 7 + i / 300));
+	}
+	std::string fileName =
+	    (std::filesystem::temp_directory_path() / "WaveStreamTestPcm8.wav").string();
+	std::ofstream(fileName, std::ios::binary)
+	    .write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	return fileName;
+}
+
+void TestFile(const std::string& fileName) {
+	WaveFile file;
+	TEST_CHECK(file.Open(fileName));
+	std::span<const uint8_t> data = file.GetData();
+
+	// ループしないときは data チャンクをそのまま
+	WaveStream stream;
+	TEST_CHECK(stream.Open(fileName, false));
+	TEST_CHECK(stream.GetFormat().blockAlign == file.GetFormat().blockAlign);
+	TEST_CHECK(ReadStream(stream, SIZE_MAX) == Bytes(data.begin(), data.end()));
+	TEST_CHECK(stream.IsEnd());
+	TEST_CHECK(stream.ReadBlock().size == 0);
+
+	// 途中で先頭に戻しても最初から読める
+	stream.Rewind();
+	TEST_CHECK(!stream.IsEnd());
+	Bytes head = ReadStream(stream, WaveStream::kBlockSize + 1);
+	TEST_CHECK(std::equal(head.begin(), head.end(), data.begin(), data.begin() + head.size()));
+	stream.Rewind();
+	TEST_CHECK(ReadStream(stream, SIZE_MAX) == Bytes(data.begin(), data.end()));
+
+	// ループするときは末尾から先頭へ続けて読む（2周半）
+	size_t loopSize = data.size() * 5 / 2;
+	TEST_CHECK(stream.Open(fileName, true));
+	Bytes looped = ReadStream(stream, loopSize);
+	TEST_CHECK(looped.size() >= loopSize);
+	TEST_CHECK(looped == Repeat(data, looped.size()));
+	TEST_CHECK(!stream.IsEnd());
+	stream.Rewind();
+	Bytes rewound = ReadStream(stream, data.size());
+	TEST_CHECK(rewound == Repeat(data, rewound.size()));
+}
+
+void TestFiles(const std::vector<std::string>& fileNames) {
+	for (const std::string& fileName : fileNames) {
+		TestFile(fileName);
+	}
+}
+
+void TestUnderrun(const std::string& pcm8FileName, const std::string& pcm16FileName) {
+	// 先読み用のスレッドが埋めなければ、用意してある2ブロックの後は無音でつなぐ
+	// （同じストリームで形式を変えて開き直しても、無音はその形式の無音になる）
+	WaveStream stream;
+	for (const std::string& fileName : {pcm16FileName, pcm8FileName, pcm16FileName}) {
+		TEST_CHECK(stream.Open(fileName, false));
+		StreamDecoder::GetInstance()->Unregister(&stream);
+		uint32_t underrunCount = stream.GetUnderrunCount();
+		Bytes head;
+		for (uint32_t i = 0; i < WaveStream::kBlockCount - 1; i++) {
+			WaveStream::Block block = stream.ReadBlock();
+			TEST_CHECK(block.size > 0 && !block.endOfStream);
+			head.insert(head.end(), block.data, block.data + block.size);
+		}
+		TEST_CHECK(stream.GetUnderrunCount() == underrunCount);
+		for (int i = 0; i < 3; i++) {
+			WaveStream::Block block = stream.ReadBlock();
+			TEST_CHECK(!block.endOfStream);
+			TEST_CHECK(IsSilence(block, stream.GetFormat()));
+		}
+		TEST_CHECK(stream.GetUnderrunCount() == underrunCount + 3);
+
+		// 登録し直せば、無音を挟んだだけで続きから読める
+		StreamDecoder::GetInstance()->Register(&stream);
+		Bytes rest = ReadStream(stream, SIZE_MAX);
+		head.insert(head.end(), rest.begin(), rest.end());
+		WaveFile file;
+		TEST_CHECK(file.Open(fileName));
+		TEST_CHECK(head == Bytes(file.GetData().begin(), file.GetData().end()));
+	}
+}
+
+} // namespace
+
+int main() {
+	std::vector<std::string> fileNames;
+	for (const auto& entry : std::filesystem::directory_iterator(GAME_AUDIO_DIRECTORY)) {
+		if (entry.path().extension() == ".wav") {
+			fileNames.push_back(entry.path().string());
+		}
+	}
+	std::sort(fileNames.begin(), fileNames.end());
+	TEST_CHECK(!fileNames.empty());
+	std::string pcm8FileName = WritePcm8File();
+	fileNames.push_back(pcm8FileName);
+
+	// 先読み用のスレッドが無ければ ReadBlock の中で埋める
+	TEST_CHECK(!StreamDecoder::GetInstance()->IsRunning());
+	TestFiles(fileNames);
+
+	// 先読み用のスレッドが埋める
+	StreamDecoder::GetInstance()->Initialize();
+	TestFiles(fileNames);
+	TestUnderrun(pcm8FileName, fileNames.front());
+	StreamDecoder::GetInstance()->Finalize();
+
+	std::filesystem::remove(pcm8FileName);
+	return TestExitCode();
+}
@@ -8,19 +8,16 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// ライブラリの初期化
 	Novice::Initialize(kWindowTitle, 1280, 720);
 
-	// キー入力結果を受け取る箱
-	char keys[256] = {0};
-	char preKeys[256] = {0};
+	// 終了の操作（ESCキーかゲームパッドのBACK）
+	int exitAction = Novice::AddAction("Exit");
+	Novice::BindKey(exitAction, DIK_ESCAPE);
+	Novice::BindPadButton(exitAction, kPadButton5);
 
 	// ウィンドウの×ボタンが押されるまでループ
 	while (Novice::ProcessMessage() == 0) {
-		// フレームの開始
+		// フレームの開始（キーとアクションの状態もここで進む）
 		Novice::BeginFrame();
 
-		// キー入力を受け取る
-		memcpy(preKeys, keys, 256);
-		Novice::GetHitKeyStateAll(keys);
-
 		///
 		/// ↓更新処理ここから
 		///
@@ -40,8 +37,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		// フレームの終了
 		Novice::EndFrame();
 
-		// ESCキーが押されたらループを抜ける
-		if (preKeys[DIK_ESCAPE] == 0 && keys[DIK_ESCAPE] != 0) {
+		// 終了の操作が押されたらループを抜ける
+		if (Novice::IsTriggerAction(exitAction)) {
 			break;
 		}
 	}